@@ -45,6 +45,8 @@ import re
 
 import genmsg.msgs
 
+from px_perfect_hash import hash_32_fnv1a
+
 
 type_map = {
     'int8': 'int8_t',
@@ -207,17 +209,6 @@ int8 esc_power
     return all_fields_str
 
 
-def hash_32_fnv1a(data: str):
-    hash_val = 0x811c9dc5
-    prime = 0x1000193
-    for i in range(len(data)):
-        value = ord(data[i])
-        hash_val = hash_val ^ value
-        hash_val *= prime
-        hash_val &= 0xffffffff
-    return hash_val
-
-
 def get_message_hash(msg_fields, search_path):
     """
     Get a 32 bit message hash over all fields
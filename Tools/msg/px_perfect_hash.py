@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+#############################################################################
+#
+#   Copyright (C) 2024 PX4 Development Team. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+# 1. Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+# 2. Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in
+#    the documentation and/or other materials provided with the
+#    distribution.
+# 3. Neither the name PX4 nor the names of its contributors may be
+#    used to endorse or promote products derived from this software
+#    without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+# FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+# COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+# INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+# BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+# OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+# AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+# ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+#
+#############################################################################
+
+
+'''
+Minimal perfect hash over a list of names, shared by the uORB topic and the
+parameter code generators. The lookup on the C/C++ side must use the same
+hash function and table layout:
+    seed = displacements[hash_32_fnv1a(name) % len(displacements)]
+    index = table[hash_32_fnv1a(name, seed) % len(table)]
+followed by one string compare against names[index].
+'''
+
+
+def hash_32_fnv1a(data: str, seed: int = 0):
+    """
+    32 bit FNV-1a hash, with the offset basis perturbed by seed
+    """
+    hash_val = 0x811c9dc5 ^ seed
+    prime = 0x1000193
+    for i in range(len(data)):
+        value = ord(data[i])
+        hash_val = hash_val ^ value
+        hash_val *= prime
+        hash_val &= 0xffffffff
+    return hash_val
+
+
+def perfect_hash(names, bucket_size=4):
+    """
+    Build a minimal perfect hash for a list of unique names (hash and displace).
+    Names are distributed into len(names) / bucket_size buckets, and the largest
+    buckets are placed first by searching for a seed that maps all names of the
+    bucket to distinct free slots. Smaller buckets mean smaller seeds, at the
+    cost of a larger displacement table. Seeds fit into uint16.
+    Returns (displacements, table), table holds indices into names.
+    """
+    num_names = len(names)
+
+    if num_names == 0:
+        return [0], [0]
+
+    num_buckets = max(1, (num_names + bucket_size - 1) // bucket_size)
+    buckets = [[] for _ in range(num_buckets)]
+
+    for i, name in enumerate(names):
+        buckets[hash_32_fnv1a(name) % num_buckets].append(i)
+
+    table = [-1] * num_names
+    displacements = [0] * num_buckets
+
+    # place the largest buckets first, while the table is still empty
+    for bucket in sorted(range(num_buckets), key=lambda b: -len(buckets[b])):
+        if not buckets[bucket]:
+            continue
+
+        seed = 1
+
+        while True:
+            slots = [hash_32_fnv1a(names[i], seed) % len(table) for i in buckets[bucket]]
+
+            if len(set(slots)) == len(slots) and all(table[slot] == -1 for slot in slots):
+                break
+
+            seed += 1
+
+            if seed > 0xffff:
+                raise Exception("no perfect hash found")
+
+        displacements[bucket] = seed
+
+        for i, slot in zip(buckets[bucket], slots):
+            table[slot] = i
+
+    # verify every name resolves to its own index
+    for i, name in enumerate(names):
+        seed = displacements[hash_32_fnv1a(name) % num_buckets]
+
+        if table[hash_32_fnv1a(name, seed) % len(table)] != i:
+            raise Exception("perfect hash verification failed for " + name)
+
+    return displacements, table
@@ -45,13 +45,17 @@
 
 #include <uORB/topics/uORBTopics.hpp>
 #include <uORB/uORB.h>
+#include <string.h>
 @{
+from px_perfect_hash import perfect_hash # this is in Tools/msg/
+
 msg_names = list(set([mn.replace(".msg", "") for mn in msgs])) # set() filters duplicates
 msg_names.sort()
 msgs_count = len(msg_names)
 
 topics_count = len(all_topics)
 
+hash_displacements, hash_table = perfect_hash(all_topics)
 }@
 @[for msg_name in msg_names]@
 #include <uORB/topics/@(msg_name).h>
@@ -76,3 +80,51 @@ const struct orb_metadata *get_orb_meta(ORB_ID id)
 
 	return uorb_topics_list[static_cast<orb_id_size_t>(id)];
 }
+
+/*
+ * Perfect hash of the topic names, see perfect_hash() in Tools/msg/px_perfect_hash.py
+ */
+static constexpr uint16_t orb_topic_hash_displacements[@(len(hash_displacements))] = {
+@[for displacement in hash_displacements]@
+	@(displacement),
+@[end for]
+};
+
+static constexpr ORB_ID orb_topic_hash_table[@(len(hash_table))] = {
+@[for idx in hash_table]@
+@[if idx < 0]@
+	ORB_ID::INVALID,
+@[else]@
+	ORB_ID::@(all_topics[idx]),
+@[end if]@
+@[end for]
+};
+
+static inline uint32_t orb_topic_hash(const char *name, uint32_t seed)
+{
+	// 32 bit FNV-1a
+	uint32_t hash = 0x811c9dc5 ^ seed;
+
+	while (*name) {
+		hash ^= (uint8_t)(*name++);
+		hash *= 0x1000193;
+	}
+
+	return hash;
+}
+
+ORB_ID get_orb_id(const char *name)
+{
+	if (name == nullptr) {
+		return ORB_ID::INVALID;
+	}
+
+	const uint32_t seed = orb_topic_hash_displacements[orb_topic_hash(name, 0) % @(len(hash_displacements))];
+	const ORB_ID id = orb_topic_hash_table[orb_topic_hash(name, seed) % @(len(hash_table))];
+
+	if ((id != ORB_ID::INVALID) && (strcmp(uorb_topics_list[static_cast<orb_id_size_t>(id)]->o_name, name) == 0)) {
+		return id;
+	}
+
+	return ORB_ID::INVALID;
+}
@@ -69,3 +69,9 @@ enum class ORB_ID : orb_id_size_t {
 };
 
 const struct orb_metadata *get_orb_meta(ORB_ID id);
+
+/*
+ * Returns the ORB_ID of a topic name (ORB_ID::INVALID if unknown).
+ * Uses a perfect hash generated from the msg definitions: O(1) with a single string compare.
+ */
+ORB_ID get_orb_id(const char *name);
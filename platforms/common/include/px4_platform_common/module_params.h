@@ -40,6 +40,7 @@
 #pragma once
 
 #include <containers/List.hpp>
+#include <uORB/topics/parameter_update.h>
 
 #include "param.h"
 
@@ -90,13 +91,64 @@ protected:
 		updateParamsImpl();
 	}
 
+	/**
+	 * @brief Call this instead of updateParams() with a parameter change notification to skip the update
+	 *        if none of the parameters of this class and its children changed.
+	 *        This relies on DEFINE_PARAMETERS() covering all parameters that the update depends on,
+	 *        so don't use it if a class reads other parameters by handle (classes without
+	 *        DEFINE_PARAMETERS() are always treated as changed).
+	 * @return true if updateParams() was called
+	 */
+	bool updateParamsIfChanged(const parameter_update_s &update)
+	{
+#if defined(__PX4_QURT)
+		// parameter_update is received via muorb from the apps processor, whose parameter indices
+		// do not match the ones of this build, so the changed bitset is meaningless here
+		updateParams();
+		return true;
+#else
+		// the changed bitset only covers the changes since the previous instance
+		const bool missed_update = (update.instance != _param_update_next_instance);
+		_param_update_next_instance = update.instance + 1;
+
+		if (missed_update || paramsChanged(update.changed_bitset)) {
+			updateParams();
+			return true;
+		}
+
+		return false;
+#endif
+	}
+
+	/**
+	 * @brief Check the changed bitset of a parameter change notification against the parameters
+	 *        of this class and its children.
+	 */
+	bool paramsChanged(const uint32_t changed_bitset[])
+	{
+		for (const auto &child : _children) {
+			if (child->paramsChanged(changed_bitset)) {
+				return true;
+			}
+		}
+
+		return paramsChangedImpl(changed_bitset);
+	}
+
 	/**
 	 * @brief The implementation for this is generated with the macro DEFINE_PARAMETERS()
 	 */
 	virtual void updateParamsImpl() {}
 
+	/**
+	 * @brief The implementation for this is generated with the macro DEFINE_PARAMETERS()
+	 */
+	virtual bool paramsChangedImpl(const uint32_t changed_bitset[]) { return true; }
+
 private:
 	/** @list _children The module parameter list of inheriting classes. */
 	List<ModuleParams *> _children;
 	ModuleParams *_parent{nullptr};
+
+	uint32_t _param_update_next_instance{UINT32_MAX};
 };
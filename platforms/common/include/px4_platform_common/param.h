@@ -62,6 +62,9 @@ inline static param_t param_handle(px4::params p)
 #define _CALL_UPDATE(x) \
 	STRIP(x).update();
 
+#define _CHECK_CHANGED(x) \
+	|| param_changed_in(STRIP(x).handle(), changed_bitset)
+
 // define the parameter update method, which will update all parameters.
 // It is marked as 'final', so that wrong usages lead to a compile error (see below)
 #define _DEFINE_PARAMETER_UPDATE_METHOD(...) \
@@ -69,6 +72,9 @@ inline static param_t param_handle(px4::params p)
 	void updateParamsImpl() final { \
 		APPLY_ALL(_CALL_UPDATE, __VA_ARGS__) \
 	} \
+	bool paramsChangedImpl(const uint32_t changed_bitset[]) final { \
+		return false APPLY_ALL(_CHECK_CHANGED, __VA_ARGS__); \
+	} \
 	private:
 
 // Define a list of parameters. This macro also creates code to update parameters.
@@ -88,6 +94,9 @@ inline static param_t param_handle(px4::params p)
 		parent_class::updateParamsImpl(); \
 		APPLY_ALL(_CALL_UPDATE, __VA_ARGS__) \
 	} \
+	bool paramsChangedImpl(const uint32_t changed_bitset[]) override { \
+		return parent_class::paramsChangedImpl(changed_bitset) APPLY_ALL(_CHECK_CHANGED, __VA_ARGS__); \
+	} \
 	private:
 
 #define DEFINE_PARAMETERS_CUSTOM_PARENT(parent_class, ...) \
@@ -72,6 +72,13 @@ public:
 
 	virtual void print_run_status();
 
+	/**
+	 * Print the latency and run time histograms.
+	 */
+	void print_run_histograms(const char *prefix);
+
+	void get_statistics(work_item_stats_t &stats) const;
+
 	/**
 	 * Switch to a different WorkQueue.
 	 * NOTE: Caller is responsible for synchronization.
@@ -108,7 +115,7 @@ protected:
 		}
 	}
 
-	friend void WorkQueue::Run();
+	friend class WorkQueue;
 	virtual void Run() = 0;
 
 	/**
@@ -132,8 +139,42 @@ protected:
 
 private:
 
+	static int histogram_bucket(uint32_t us)
+	{
+		if (us < 2) {
+			return 0;
+		}
+
+		const int bucket = 31 - __builtin_clz(us);
+		return (bucket < WORK_ITEM_HISTOGRAM_BUCKETS) ? bucket : (WORK_ITEM_HISTOGRAM_BUCKETS - 1);
+	}
+
+	// called by the WorkQueue with the work queue lock held
+	void record_latency(hrt_abstime now)
+	{
+		if (_time_scheduled != 0) {
+			const uint32_t latency = (now > _time_scheduled) ? (now - _time_scheduled) : 0;
+			_latency_histogram[histogram_bucket(latency)]++;
+			_latency_max = math::max(_latency_max, latency);
+			_time_scheduled = 0;
+		}
+	}
+
+	void record_run_time(uint32_t run_time)
+	{
+		_run_time_histogram[histogram_bucket(run_time)]++;
+		_run_time_max = math::max(_run_time_max, run_time);
+	}
+
 	WorkQueue	*_wq{nullptr};
 
+	hrt_abstime	_time_scheduled{0}; // set when queued, cleared when run or removed
+
+	uint32_t	_latency_histogram[WORK_ITEM_HISTOGRAM_BUCKETS] {};
+	uint32_t	_run_time_histogram[WORK_ITEM_HISTOGRAM_BUCKETS] {};
+	uint32_t	_latency_max{0};
+	uint32_t	_run_time_max{0};
+
 };
 
 } // namespace px4
@@ -43,6 +43,11 @@
 #include <px4_platform_common/sem.h>
 #include <px4_platform_common/tasks.h>
 
+#if defined(__PX4_LINUX)
+#include <pthread.h>
+#include <sys/types.h>
+#endif // __PX4_LINUX
+
 namespace px4
 {
 
@@ -71,7 +76,21 @@ public:
 
 	void request_stop() { _should_exit.store(true); }
 
-	void print_status(bool last = false);
+	void print_status(bool last = false, bool histograms = false);
+
+	/**
+	 * Get the statistics of the index-th work item of this queue.
+	 * @param index decremented by the number of work items if not in this queue
+	 */
+	bool item_statistics(unsigned &index, work_item_stats_t &stats);
+
+#if defined(__PX4_LINUX)
+	/**
+	 * Change the CPU affinity and/or SCHED_FIFO priority of the work queue thread.
+	 * @see WorkQueueSetSchedPolicy()
+	 */
+	int set_sched_policy(uint32_t cpu_mask, int8_t relative_priority);
+#endif // __PX4_LINUX
 
 	// WorkQueues sorted numerically by relative priority (-1 to -255)
 	bool operator<=(const WorkQueue &rhs) const { return _config.relative_priority >= rhs.get_config().relative_priority; }
@@ -82,6 +101,10 @@ private:
 
 	inline void SignalWorkerThread();
 
+#if defined(__PX4_LINUX)
+	void print_sched_status();
+#endif // __PX4_LINUX
+
 #ifdef __PX4_NUTTX
 	// In NuttX work can be enqueued from an ISR
 	void work_lock() { _flags = enter_critical_section(); }
@@ -95,6 +118,7 @@ private:
 #endif
 
 	IntrusiveQueue<WorkItem *>	_q;
+	WorkItem			*_running_item{nullptr};
 	px4_sem_t			_process_lock;
 	px4_sem_t			_exit_lock;
 	const wq_config_t		&_config;
@@ -105,6 +129,17 @@ private:
 	int _lockstep_component {-1};
 #endif // ENABLE_LOCKSTEP_SCHEDULER
 
+#if defined(__PX4_LINUX)
+	pthread_t			_thread {};
+	pid_t				_tid{0};
+
+	// scheduling latency: time from signalling the worker thread until it runs
+	px4::atomic<uint64_t>		_signal_time{0};
+	uint64_t			_latency_sum{0};
+	uint32_t			_latency_count{0};
+	uint32_t			_latency_max{0};
+#endif // __PX4_LINUX
+
 };
 
 } // namespace px4
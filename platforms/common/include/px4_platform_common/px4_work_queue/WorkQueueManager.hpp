@@ -96,6 +96,36 @@ static constexpr wq_config_t test2{"wq:test2", 2000, 0};
 
 } // namespace wq_configurations
 
+/**
+ * Scheduling policy of a work queue thread (CPU affinity and SCHED_FIFO priority), Linux only.
+ *
+ * Boards can provide a default table with BOARD_WQ_SCHED_POLICIES in board_config.h, eg.
+ * #define BOARD_WQ_SCHED_POLICIES { {"wq:rate_ctrl", 0x80, px4::WQ_PRIORITY_UNCHANGED}, {"wq:INS0", 0x40, -1} }
+ * Entries can be changed at runtime with WorkQueueSetSchedPolicy() (work_queue sched).
+ */
+struct wq_sched_policy_t {
+	const char *name;         // work queue name
+	uint32_t cpu_mask;        // CPUs the thread may run on (bit n = CPU n), 0 = unchanged
+	int8_t relative_priority; // relative to max, WQ_PRIORITY_UNCHANGED keeps the wq_config_t priority
+};
+
+static constexpr int8_t WQ_PRIORITY_UNCHANGED{INT8_MAX};
+
+static constexpr int WORK_ITEM_HISTOGRAM_BUCKETS{16};
+
+/**
+ * Scheduling latency and run time of a work item, as log2 histograms in microseconds
+ * (bucket 0: [0, 2), bucket i: [2^i, 2^(i+1)), the last bucket also counts everything above).
+ */
+struct work_item_stats_t {
+	char item_name[24];
+	const char *wq_name;
+	uint32_t latency_histogram[WORK_ITEM_HISTOGRAM_BUCKETS];
+	uint32_t run_time_histogram[WORK_ITEM_HISTOGRAM_BUCKETS];
+	uint32_t latency_max;
+	uint32_t run_time_max;
+};
+
 /**
  * Start the work queue manager task.
  */
@@ -108,8 +138,30 @@ int WorkQueueManagerStop();
 
 /**
  * Work queue manager status.
+ *
+ * @param histograms	Also print the latency and run time histograms of each work item.
+ */
+int WorkQueueManagerStatus(bool histograms = false);
+
+/**
+ * Get the statistics of a work item.
+ *
+ * @param index		Index of the work item over all work queues.
+ * @param stats		Filled with the work item statistics.
+ * @return		false if there's no work item with this index.
+ */
+bool WorkItemStatistics(unsigned index, work_item_stats_t &stats);
+
+/**
+ * Set the scheduling policy of a work queue. The policy is applied immediately
+ * if the work queue is running, otherwise when it is created.
+ *
+ * @param name			The work queue name (eg wq:rate_ctrl).
+ * @param cpu_mask		CPUs the work queue may run on (bit n = CPU n), 0 = unchanged.
+ * @param relative_priority	SCHED_FIFO priority relative to max, or WQ_PRIORITY_UNCHANGED.
+ * @return		PX4_OK on success.
  */
-int WorkQueueManagerStatus();
+int WorkQueueSetSchedPolicy(const char *name, uint32_t cpu_mask, int8_t relative_priority);
 
 /**
  * Create (or find) a work queue with a particular configuration.
@@ -39,6 +39,8 @@
 #include <px4_platform_common/log.h>
 #include <drivers/drv_hrt.h>
 
+#include <inttypes.h>
+
 namespace px4
 {
 
@@ -140,4 +142,62 @@ void WorkItem::print_run_status()
 	_run_count = 0;
 }
 
+// upper bound (us) of the histogram bucket containing the given percentile, 0 if empty
+static uint32_t histogram_percentile(const uint32_t (&histogram)[WORK_ITEM_HISTOGRAM_BUCKETS], uint32_t total,
+				     uint32_t percentile)
+{
+	const uint64_t threshold = ((uint64_t)total * percentile + 99) / 100;
+	uint64_t count = 0;
+
+	for (int i = 0; i < WORK_ITEM_HISTOGRAM_BUCKETS; i++) {
+		count += histogram[i];
+
+		if ((count > 0) && (count >= threshold)) {
+			return 1u << (i + 1);
+		}
+	}
+
+	return 0;
+}
+
+static void print_histogram(const char *prefix, const char *label, const uint32_t (&histogram)[WORK_ITEM_HISTOGRAM_BUCKETS],
+			    uint32_t max)
+{
+	uint32_t total = 0;
+
+	for (int i = 0; i < WORK_ITEM_HISTOGRAM_BUCKETS; i++) {
+		total += histogram[i];
+	}
+
+	PX4_INFO_RAW("%s%-8s p50 <%6" PRIu32 " us, p99 <%6" PRIu32 " us, max %6" PRIu32 " us |", prefix, label,
+		     histogram_percentile(histogram, total, 50), histogram_percentile(histogram, total, 99), max);
+
+	// non-empty buckets as <lower bound us>:<count>
+	for (int i = 0; i < WORK_ITEM_HISTOGRAM_BUCKETS; i++) {
+		if (histogram[i] > 0) {
+			PX4_INFO_RAW(" %" PRIu32 ":%" PRIu32, (i == 0) ? 0 : (1u << i), histogram[i]);
+		}
+	}
+
+	PX4_INFO_RAW("\n");
+}
+
+void WorkItem::print_run_histograms(const char *prefix)
+{
+	print_histogram(prefix, "latency", _latency_histogram, _latency_max);
+	print_histogram(prefix, "run time", _run_time_histogram, _run_time_max);
+}
+
+void WorkItem::get_statistics(work_item_stats_t &stats) const
+{
+	strncpy(stats.item_name, _item_name, sizeof(stats.item_name) - 1);
+	stats.item_name[sizeof(stats.item_name) - 1] = '\0';
+	stats.wq_name = (_wq != nullptr) ? _wq->get_name() : "";
+
+	memcpy(stats.latency_histogram, _latency_histogram, sizeof(stats.latency_histogram));
+	memcpy(stats.run_time_histogram, _run_time_histogram, sizeof(stats.run_time_histogram));
+	stats.latency_max = _latency_max;
+	stats.run_time_max = _run_time_max;
+}
+
 } // namespace px4
@@ -34,6 +34,7 @@
 #include <px4_platform_common/px4_work_queue/WorkQueue.hpp>
 #include <px4_platform_common/px4_work_queue/WorkItem.hpp>
 
+#include <stdio.h>
 #include <string.h>
 
 #include <px4_platform_common/log.h>
@@ -41,6 +42,14 @@
 #include <px4_platform_common/time.h>
 #include <drivers/drv_hrt.h>
 
+#if defined(__PX4_LINUX)
+#include <inttypes.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif // __PX4_LINUX
+
 namespace px4
 {
 
@@ -54,6 +63,12 @@ WorkQueue::WorkQueue(const wq_config_t &config) :
 	pthread_setname_np(pthread_self(), _config.name);
 #endif
 
+#if defined(__PX4_LINUX)
+	// the WorkQueue is constructed by its own thread
+	_thread = pthread_self();
+	_tid = syscall(SYS_gettid);
+#endif // __PX4_LINUX
+
 #ifndef __PX4_NUTTX
 	px4_sem_init(&_qlock, 0, 1);
 #endif /* __PX4_NUTTX */
@@ -105,6 +120,11 @@ void WorkQueue::Detach(WorkItem *item)
 
 	_work_items.remove(item);
 
+	// the item might be detached (or deleted) from within its Run()
+	if (_running_item == item) {
+		_running_item = nullptr;
+	}
+
 	if (_work_items.size() == 0) {
 		// shutdown, no active WorkItems
 		PX4_DEBUG("stopping: %s, last active WorkItem closing", _config.name);
@@ -138,6 +158,10 @@ void WorkQueue::Add(WorkItem *item)
 
 #endif // ENABLE_LOCKSTEP_SCHEDULER
 
+	if (item->_time_scheduled == 0) {
+		item->_time_scheduled = hrt_absolute_time();
+	}
+
 	_q.push(item);
 	work_unlock();
 
@@ -149,6 +173,12 @@ void WorkQueue::SignalWorkerThread()
 	int sem_val;
 
 	if (px4_sem_getvalue(&_process_lock, &sem_val) == 0 && sem_val <= 0) {
+#if defined(__PX4_LINUX)
+		// keep the earliest pending signal
+		uint64_t expected = 0;
+		_signal_time.compare_exchange(&expected, hrt_absolute_time());
+#endif // __PX4_LINUX
+
 		px4_sem_post(&_process_lock);
 	}
 }
@@ -157,6 +187,7 @@ void WorkQueue::Remove(WorkItem *item)
 {
 	work_lock();
 	_q.remove(item);
+	item->_time_scheduled = 0;
 	work_unlock();
 }
 
@@ -177,17 +208,46 @@ void WorkQueue::Run()
 		// loop as the wait may be interrupted by a signal
 		do {} while (px4_sem_wait(&_process_lock) != 0);
 
+#if defined(__PX4_LINUX)
+		const uint64_t signal_time = _signal_time.load();
+
+		if (signal_time != 0) {
+			_signal_time.store(0);
+
+			const uint64_t now = hrt_absolute_time();
+			const uint32_t latency = (now > signal_time) ? (now - signal_time) : 0;
+
+			_latency_sum += latency;
+			_latency_count++;
+
+			if (latency > _latency_max) {
+				_latency_max = latency;
+			}
+		}
+
+#endif // __PX4_LINUX
+
 		work_lock();
 
 		// process queued work
 		while (!_q.empty()) {
 			WorkItem *work = _q.pop();
 
+			const hrt_abstime time_run_start = hrt_absolute_time();
+			work->record_latency(time_run_start);
+			_running_item = work;
+
 			work_unlock(); // unlock work queue to run (item may requeue itself)
 			work->RunPreamble();
 			work->Run();
 			// Note: after Run() we cannot access work anymore, as it might have been deleted
 			work_lock(); // re-lock
+
+			// still valid unless detached in the meantime
+			if (_running_item != nullptr) {
+				_running_item->record_run_time(hrt_absolute_time() - time_run_start);
+				_running_item = nullptr;
+			}
 		}
 
 #if defined(ENABLE_LOCKSTEP_SCHEDULER)
@@ -205,10 +265,14 @@ void WorkQueue::Run()
 	PX4_DEBUG("%s: exiting", _config.name);
 }
 
-void WorkQueue::print_status(bool last)
+void WorkQueue::print_status(bool last, bool histograms)
 {
 	const size_t num_items = _work_items.size();
-	PX4_INFO_RAW("%-16s\n", get_name());
+	PX4_INFO_RAW("%-16s", get_name());
+#if defined(__PX4_LINUX)
+	print_sched_status();
+#endif // __PX4_LINUX
+	PX4_INFO_RAW("\n");
 	unsigned i = 0;
 
 	for (WorkItem *item : _work_items) {
@@ -229,7 +293,131 @@ void WorkQueue::print_status(bool last)
 		}
 
 		item->print_run_status();
+
+		if (histograms) {
+			// continue the tree lines of the work queue and item lists
+			char prefix[24];
+			snprintf(prefix, sizeof(prefix), "%s%s       ", last ? "    " : "|   ", (i < num_items) ? "|" : " ");
+			item->print_run_histograms(prefix);
+		}
+	}
+}
+
+bool WorkQueue::item_statistics(unsigned &index, work_item_stats_t &stats)
+{
+	LockGuard lg{_work_items.mutex()};
+
+	for (WorkItem *item : _work_items) {
+		if (index == 0) {
+			item->get_statistics(stats);
+			stats.wq_name = get_name();
+			return true;
+		}
+
+		index--;
+	}
+
+	return false;
+}
+
+#if defined(__PX4_LINUX)
+int WorkQueue::set_sched_policy(uint32_t cpu_mask, int8_t relative_priority)
+{
+	int ret = PX4_OK;
+
+	if (cpu_mask != 0) {
+		cpu_set_t cpus;
+		CPU_ZERO(&cpus);
+
+		for (int cpu = 0; cpu < 32; cpu++) {
+			if (cpu_mask & (1u << cpu)) {
+				CPU_SET(cpu, &cpus);
+			}
+		}
+
+		int ret_affinity = pthread_setaffinity_np(_thread, sizeof(cpus), &cpus);
+
+		if (ret_affinity != 0) {
+			PX4_ERR("setting CPU affinity 0x%" PRIx32 " for %s failed (%i)", cpu_mask, get_name(), ret_affinity);
+			ret = PX4_ERROR;
+		}
+	}
+
+	if (relative_priority != WQ_PRIORITY_UNCHANGED) {
+		sched_param param{};
+		param.sched_priority = sched_get_priority_max(SCHED_FIFO) + relative_priority;
+
+		int ret_setschedparam = pthread_setschedparam(_thread, SCHED_FIFO, &param);
+
+		if (ret_setschedparam != 0) {
+			PX4_ERR("setting priority %d for %s failed (%i)", param.sched_priority, get_name(), ret_setschedparam);
+			ret = PX4_ERROR;
+		}
+	}
+
+	return ret;
+}
+
+void WorkQueue::print_sched_status()
+{
+	uint32_t cpu_mask = 0;
+	cpu_set_t cpus;
+
+	if (pthread_getaffinity_np(_thread, sizeof(cpus), &cpus) == 0) {
+		for (int cpu = 0; cpu < 32; cpu++) {
+			if (CPU_ISSET(cpu, &cpus)) {
+				cpu_mask |= 1u << cpu;
+			}
+		}
+	}
+
+	int policy = 0;
+	sched_param param{};
+	pthread_getschedparam(_thread, &policy, &param);
+
+	// context switches and migrations of the thread (-1 if unavailable)
+	long voluntary = -1;
+	long involuntary = -1;
+	long migrations = -1;
+	char path[64];
+	char line[128];
+
+	snprintf(path, sizeof(path), "/proc/self/task/%d/status", (int)_tid);
+	FILE *fp = fopen(path, "r");
+
+	if (fp) {
+		while (fgets(line, sizeof(line), fp)) {
+			sscanf(line, "voluntary_ctxt_switches: %ld", &voluntary);
+			sscanf(line, "nonvoluntary_ctxt_switches: %ld", &involuntary);
+		}
+
+		fclose(fp);
 	}
+
+	// only available with CONFIG_SCHED_DEBUG
+	snprintf(path, sizeof(path), "/proc/self/task/%d/sched", (int)_tid);
+	fp = fopen(path, "r");
+
+	if (fp) {
+		while (fgets(line, sizeof(line), fp)) {
+			if (strncmp(line, "se.nr_migrations", 16) == 0) {
+				const char *value = strchr(line, ':');
+
+				if (value) {
+					migrations = strtol(value + 1, nullptr, 10);
+				}
+			}
+		}
+
+		fclose(fp);
+	}
+
+	const uint32_t latency_count = _latency_count;
+	const uint32_t latency_avg = (latency_count > 0) ? (_latency_sum / latency_count) : 0;
+
+	PX4_INFO_RAW(" prio: %3d, cpus: 0x%02" PRIx32 ", csw: %ld/%ld, migrations: %ld, latency avg/max: %" PRIu32 "/%" PRIu32 " us",
+		     param.sched_priority, cpu_mask, voluntary, involuntary, migrations, latency_avg, _latency_max);
 }
+#endif // __PX4_LINUX
 
 } // namespace px4
@@ -36,6 +36,7 @@
 #include <px4_platform_common/px4_work_queue/WorkQueue.hpp>
 
 #include <drivers/drv_hrt.h>
+#include <px4_platform_common/px4_config.h>
 #include <px4_platform_common/log.h>
 #include <px4_platform_common/posix.h>
 #include <px4_platform_common/tasks.h>
@@ -63,6 +64,31 @@ static BlockingQueue<const wq_config_t *, 1> *_wq_manager_create_queue{nullptr};
 static px4::atomic_bool _wq_manager_should_exit{true};
 static px4::atomic_bool _wq_manager_running{false};
 
+#if defined(__PX4_LINUX)
+// work queue scheduling policies (board defaults and runtime changes)
+struct wq_sched_policy_entry_t {
+	char name[32];
+	uint32_t cpu_mask;
+	int8_t relative_priority;
+};
+
+static constexpr size_t WQ_SCHED_POLICIES_MAX{16};
+static wq_sched_policy_entry_t _wq_sched_policies[WQ_SCHED_POLICIES_MAX] {};
+static pthread_mutex_t _wq_sched_policies_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// apply the policy (if any) of a work queue, _wq_sched_policies_mutex must be held
+static void
+ApplySchedPolicyLocked(WorkQueue &wq)
+{
+	for (const wq_sched_policy_entry_t &policy : _wq_sched_policies) {
+		if (strcmp(policy.name, wq.get_name()) == 0) {
+			wq.set_sched_policy(policy.cpu_mask, policy.relative_priority);
+			return;
+		}
+	}
+}
+#endif // __PX4_LINUX
+
 
 static WorkQueue *
 FindWorkQueueByName(const char *name)
@@ -120,6 +146,75 @@ WorkQueueFindOrCreate(const wq_config_t &new_wq)
 	return wq;
 }
 
+int
+WorkQueueSetSchedPolicy(const char *name, uint32_t cpu_mask, int8_t relative_priority)
+{
+#if defined(__PX4_LINUX)
+
+	if ((name == nullptr) || (strlen(name) >= sizeof(wq_sched_policy_entry_t::name))) {
+		return PX4_ERROR;
+	}
+
+	int ret = PX4_ERROR;
+
+	pthread_mutex_lock(&_wq_sched_policies_mutex);
+
+	wq_sched_policy_entry_t *entry = nullptr;
+
+	for (wq_sched_policy_entry_t &policy : _wq_sched_policies) {
+		if (strcmp(policy.name, name) == 0) {
+			entry = &policy;
+			break;
+
+		} else if ((entry == nullptr) && (policy.name[0] == '\0')) {
+			// first free slot, keep searching for an existing entry
+			entry = &policy;
+		}
+	}
+
+	if (entry != nullptr) {
+		if (entry->name[0] == '\0') {
+			strncpy(entry->name, name, sizeof(entry->name) - 1);
+			entry->cpu_mask = 0;
+			entry->relative_priority = WQ_PRIORITY_UNCHANGED;
+		}
+
+		// merge with the existing policy
+		if (cpu_mask != 0) {
+			entry->cpu_mask = cpu_mask;
+		}
+
+		if (relative_priority != WQ_PRIORITY_UNCHANGED) {
+			entry->relative_priority = relative_priority;
+		}
+
+		ret = PX4_OK;
+
+		// apply immediately if the work queue is already running
+		if (_wq_manager_running.load()) {
+			LockGuard lg{_wq_manager_wqs_list->mutex()};
+
+			for (WorkQueue *wq : *_wq_manager_wqs_list) {
+				if (strcmp(wq->get_name(), name) == 0) {
+					ret = wq->set_sched_policy(entry->cpu_mask, entry->relative_priority);
+					break;
+				}
+			}
+		}
+
+	} else {
+		PX4_ERR("too many work queue scheduling policies (%zu)", WQ_SCHED_POLICIES_MAX);
+	}
+
+	pthread_mutex_unlock(&_wq_sched_policies_mutex);
+
+	return ret;
+#else
+	PX4_ERR("not supported");
+	return PX4_ERROR;
+#endif // __PX4_LINUX
+}
+
 const wq_config_t &
 device_bus_to_wq(uint32_t device_id_int)
 {
@@ -235,6 +330,13 @@ WorkQueueRunner(void *context)
 	// add to work queue list
 	_wq_manager_wqs_list->add(&wq);
 
+#if defined(__PX4_LINUX)
+	// after adding to the list, so that a concurrent WorkQueueSetSchedPolicy() isn't lost
+	pthread_mutex_lock(&_wq_sched_policies_mutex);
+	ApplySchedPolicyLocked(wq);
+	pthread_mutex_unlock(&_wq_sched_policies_mutex);
+#endif // __PX4_LINUX
+
 	wq.Run();
 
 	// remove from work queue list
@@ -259,6 +361,16 @@ WorkQueueManagerRun(int, char **)
 {
 	_wq_manager_wqs_list = new BlockingList<WorkQueue *>();
 	_wq_manager_create_queue = new BlockingQueue<const wq_config_t *, 1>();
+
+#if defined(__PX4_LINUX) && defined(BOARD_WQ_SCHED_POLICIES)
+	static constexpr wq_sched_policy_t board_wq_sched_policies[] = BOARD_WQ_SCHED_POLICIES;
+
+	for (const wq_sched_policy_t &policy : board_wq_sched_policies) {
+		WorkQueueSetSchedPolicy(policy.name, policy.cpu_mask, policy.relative_priority);
+	}
+
+#endif // __PX4_LINUX && BOARD_WQ_SCHED_POLICIES
+
 	_wq_manager_running.store(true);
 
 	while (!_wq_manager_should_exit.load()) {
@@ -462,7 +574,7 @@ WorkQueueManagerStop()
 }
 
 int
-WorkQueueManagerStatus()
+WorkQueueManagerStatus(bool histograms)
 {
 	if (!_wq_manager_should_exit.load() && _wq_manager_running.load()) {
 
@@ -484,7 +596,7 @@ WorkQueueManagerStatus()
 				PX4_INFO_RAW("\\__ %zu) ", i);
 			}
 
-			wq->print_status(last_wq);
+			wq->print_status(last_wq, histograms);
 		}
 
 	} else {
@@ -494,4 +606,22 @@ WorkQueueManagerStatus()
 	return PX4_OK;
 }
 
+bool
+WorkItemStatistics(unsigned index, work_item_stats_t &stats)
+{
+	if (_wq_manager_should_exit.load() || !_wq_manager_running.load()) {
+		return false;
+	}
+
+	LockGuard lg{_wq_manager_wqs_list->mutex()};
+
+	for (WorkQueue *wq : *_wq_manager_wqs_list) {
+		if (wq->item_statistics(index, stats)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
 } // namespace px4
@@ -113,6 +113,37 @@ public:
 
 		return (Manager::orb_publish(get_topic(), _handle, &data) == PX4_OK);
 	}
+
+	/**
+	 * Loan a slot of the topic queue to fill the message in place, which saves
+	 * the copy of publish(). Only available for queued topics with a single
+	 * publisher (see Manager::orb_loan()), use publish() if this returns nullptr.
+	 * The slot contains old data and has to be filled completely.
+	 *
+	 * Topics without a queue (ORB_QUEUE_LENGTH 1, e.g. obstacle_distance,
+	 * vehicle_odometry or sensor_accel_fifo) always return nullptr: their single
+	 * slot holds the latest message, which has to stay readable during the loan.
+	 * Raising the queue length makes a topic loanable, but subscribers then get
+	 * every queued message in order from update() instead of only the latest.
+	 * @return The slot to fill, must be followed by commit().
+	 */
+	T *loan()
+	{
+		if (!advertised()) {
+			advertise();
+		}
+
+		return advertised() ? static_cast<T *>(Manager::orb_loan(_handle)) : nullptr;
+	}
+
+	/**
+	 * Publish the slot obtained with loan()
+	 * @param publish false to drop the slot instead
+	 */
+	bool commit(bool publish = true)
+	{
+		return (Manager::orb_commit(get_topic(), _handle, publish) == PX4_OK);
+	}
 };
 
 /**
@@ -92,6 +92,29 @@ public:
 		return (orb_publish(get_topic(), _handle, &data) == PX4_OK);
 	}
 
+	/**
+	 * Loan a slot of the topic queue to fill the message in place, see Publication<T>::loan().
+	 * Not available for topics without a queue (ORB_QUEUE_LENGTH 1).
+	 * @return The slot to fill (nullptr if not possible), must be followed by commit().
+	 */
+	T *loan()
+	{
+		if (!advertised()) {
+			advertise();
+		}
+
+		return advertised() ? static_cast<T *>(Manager::orb_loan(_handle)) : nullptr;
+	}
+
+	/**
+	 * Publish the slot obtained with loan()
+	 * @param publish false to drop the slot instead
+	 */
+	bool commit(bool publish = true)
+	{
+		return (Manager::orb_commit(get_topic(), _handle, publish) == PX4_OK);
+	}
+
 	int get_instance()
 	{
 		// advertise if not already advertised
@@ -52,6 +52,37 @@ namespace uORB
 
 class SubscriptionCallback;
 
+/**
+ * Const zero-copy view of a message in the topic queue, see Subscription::borrow().
+ *
+ * The publisher can reuse the slot at any time, so valid() has to be checked
+ * after the data was consumed (and the result discarded if it fails).
+ */
+template<typename T>
+class BorrowedMessage
+{
+public:
+	BorrowedMessage() = default;
+	BorrowedMessage(const void *node, const void *data, unsigned slot_generation) :
+		_node(node), _data(static_cast<const T *>(data)), _slot_generation(slot_generation) {}
+
+	explicit operator bool() const { return _data != nullptr; }
+
+	const T *get() const { return _data; }
+	const T *operator->() const { return _data; }
+	const T &operator*() const { return *_data; }
+
+	/**
+	 * Check that the message was not overwritten while it was being read.
+	 */
+	bool valid() const { return (_data != nullptr) && Manager::orb_data_slot_valid(_node, _slot_generation); }
+
+private:
+	const void *_node{nullptr};
+	const T *_data{nullptr};
+	unsigned _slot_generation{0};
+};
+
 // Base subscription wrapper class
 class Subscription
 {
@@ -171,6 +202,29 @@ public:
 		return valid() ? Manager::orb_data_copy(_node, dst, _last_generation, false) : false;
 	}
 
+	/**
+	 * Borrow the next message without copying it (like update(), but zero-copy).
+	 * The returned view is empty if there is no update.
+	 */
+	template<typename T>
+	BorrowedMessage<T> borrow()
+	{
+		if (!valid()) {
+			subscribe();
+		}
+
+		if (valid()) {
+			unsigned slot_generation = 0;
+			const void *data = Manager::orb_data_borrow(_node, _last_generation, slot_generation, true);
+
+			if (data != nullptr) {
+				return BorrowedMessage<T>(_node, data, slot_generation);
+			}
+		}
+
+		return BorrowedMessage<T>();
+	}
+
 	/**
 	 * Change subscription instance
 	 * @param instance The new multi-Subscription instance
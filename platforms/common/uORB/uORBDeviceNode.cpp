@@ -155,19 +155,7 @@ uORB::DeviceNode::write(cdev::file_t *filp, const char *buffer, size_t buflen)
 		if (!up_interrupt_context()) {
 #endif /* __PX4_NUTTX */
 
-			lock();
-
-			/* re-check size */
-			if (nullptr == _data) {
-				const size_t data_size = _meta->o_size * _meta->o_queue;
-				_data = (uint8_t *) px4_cache_aligned_alloc(data_size);
-
-				if (_data) {
-					memset(_data, 0, data_size);
-				}
-			}
-
-			unlock();
+			allocate_data();
 
 #ifdef __PX4_NUTTX
 		}
@@ -185,13 +173,26 @@ uORB::DeviceNode::write(cdev::file_t *filp, const char *buffer, size_t buflen)
 		return -EIO;
 	}
 
-	/* Perform an atomic copy. */
+	/* Serialise writers, readers copy lock-free (see copy()). */
 	ATOMIC_ENTER;
+
+	if (_loaned) {
+		/* the publisher holding the loan owns the next slot */
+		ATOMIC_LEAVE;
+		return -EBUSY;
+	}
+
 	/* wrap-around happens after ~49 days, assuming a publisher rate of 1 kHz */
-	unsigned generation = _generation.fetch_add(1);
+	const unsigned generation = _generation.load();
+
+	/* announce the slot write to concurrent readers before touching the data */
+	_write_generation.store(generation + 1);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
 
 	memcpy(_data + (_meta->o_size * (generation % _meta->o_queue)), buffer, _meta->o_size);
 
+	_generation.store(generation + 1);
+
 	// callbacks
 	for (auto item : _callbacks) {
 		item->call();
@@ -208,6 +209,96 @@ uORB::DeviceNode::write(cdev::file_t *filp, const char *buffer, size_t buflen)
 	return _meta->o_size;
 }
 
+bool
+uORB::DeviceNode::allocate_data()
+{
+	lock();
+
+	/* re-check size */
+	if (nullptr == _data) {
+		const size_t data_size = _meta->o_size * _meta->o_queue;
+		_data = (uint8_t *) px4_cache_aligned_alloc(data_size);
+
+		if (_data) {
+			memset(_data, 0, data_size);
+		}
+	}
+
+	unlock();
+
+	return _data != nullptr;
+}
+
+void *
+uORB::DeviceNode::loan()
+{
+	if (_meta->o_queue < 2) {
+		return nullptr;
+	}
+
+	if ((nullptr == _data) && !allocate_data()) {
+		return nullptr;
+	}
+
+	ATOMIC_ENTER;
+
+	if (_loaned) {
+		ATOMIC_LEAVE;
+		return nullptr;
+	}
+
+	_loaned = true;
+
+	const unsigned generation = _generation.load();
+
+	/* the slot is handed out now, readers treat it as being written until commit_loan() */
+	_write_generation.store(generation + 1);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	ATOMIC_LEAVE;
+
+	return _data + (_meta->o_size * (generation % _meta->o_queue));
+}
+
+int
+uORB::DeviceNode::commit_loan(bool publish)
+{
+	ATOMIC_ENTER;
+
+	if (!_loaned) {
+		ATOMIC_LEAVE;
+		return -EINVAL;
+	}
+
+	if (publish) {
+		_generation.store(_write_generation.load());
+
+		// callbacks
+		for (auto item : _callbacks) {
+			item->call();
+		}
+
+		/* Mark at least one data has been published */
+		_data_valid = true;
+	}
+
+	/*
+	 * A dropped loan keeps _write_generation advanced: the slot content is
+	 * undefined now, so readers must keep considering it as overwritten.
+	 * The next write reuses it.
+	 */
+	_loaned = false;
+
+	ATOMIC_LEAVE;
+
+	if (publish) {
+		/* notify any poll waiters */
+		poll_notify(POLLIN);
+	}
+
+	return PX4_OK;
+}
+
 int
 uORB::DeviceNode::ioctl(cdev::file_t *filp, int cmd, unsigned long arg)
 {
@@ -291,6 +382,53 @@ uORB::DeviceNode::publish(const orb_metadata *meta, orb_advert_t handle, const v
 	return PX4_OK;
 }
 
+int
+uORB::DeviceNode::commit(const orb_metadata *meta, orb_advert_t handle, bool publish)
+{
+	uORB::DeviceNode *devnode = (uORB::DeviceNode *)handle;
+
+	if ((devnode == nullptr) || (meta == nullptr)) {
+		errno = EFAULT;
+		return PX4_ERROR;
+	}
+
+	if (devnode->_meta->o_id != meta->o_id) {
+		errno = EINVAL;
+		return PX4_ERROR;
+	}
+
+	int ret = devnode->commit_loan(publish);
+
+	if (ret < 0) {
+		errno = -ret;
+		return PX4_ERROR;
+	}
+
+#ifdef CONFIG_ORB_COMMUNICATOR
+
+	if (publish) {
+		/*
+		 * send the committed slot over the Multi-ORB link, it is only reused
+		 * after o_queue further writes (o_queue > 1 for loans)
+		 */
+		uORBCommunicator::IChannel *ch = uORB::Manager::get_instance()->get_uorb_communicator();
+
+		if (ch != nullptr) {
+			const unsigned generation = devnode->_generation.load() - 1;
+			uint8_t *data = devnode->_data + (meta->o_size * (generation % meta->o_queue));
+
+			if (ch->send_message(meta->o_name, meta->o_size, data) != 0) {
+				PX4_ERR("Error Sending [%s] topic data over comm_channel", meta->o_name);
+				return PX4_ERROR;
+			}
+		}
+	}
+
+#endif /* CONFIG_ORB_COMMUNICATOR */
+
+	return PX4_OK;
+}
+
 int uORB::DeviceNode::unadvertise(orb_advert_t handle)
 {
 	if (handle == nullptr) {
@@ -358,8 +496,8 @@ uORB::DeviceNode::print_statistics(int max_topic_length)
 
 	unlock();
 
-	PX4_INFO_RAW("%-*s %2i %4i %2i %4i %s\n", max_topic_length, get_meta()->o_name, (int)instance, (int)sub_count,
-		     get_meta()->o_queue, get_meta()->o_size, get_devname());
+	PX4_INFO_RAW("%-*s %2i %4i %2i %4i %5u %s\n", max_topic_length, get_meta()->o_name, (int)instance, (int)sub_count,
+		     get_meta()->o_queue, get_meta()->o_size, copy_retries(), get_devname());
 
 	return true;
 }
@@ -215,6 +215,14 @@ public:
 	 * Copies data and the corresponding generation
 	 * from a node to the buffer provided.
 	 *
+	 * This does not take any lock: the (serialised) writer announces a slot
+	 * write by advancing _write_generation before the memcpy and only advances
+	 * _generation once it is complete. A copy of generation g is therefore valid
+	 * if no write to the same queue slot (g + o_queue) was started while copying,
+	 * otherwise the copy is retried. After COPY_ATTEMPTS failed attempts (e.g. the
+	 * reader preempted a writer of the same slot), the copy is done under the lock
+	 * that serialises the writers, so a reader never spins on a stalled writer.
+	 *
 	 * @param dst
 	 *   The buffer into which the data is copied.
 	 * @param generation
@@ -225,43 +233,106 @@ public:
 	bool copy(void *dst, unsigned &generation)
 	{
 		if ((dst != nullptr) && (_data != nullptr)) {
-			if (_meta->o_queue == 1) {
-				ATOMIC_ENTER;
-				memcpy(dst, _data, _meta->o_size);
-				generation = _generation.load();
-				ATOMIC_LEAVE;
-				return true;
-
-			} else {
-				ATOMIC_ENTER;
+			for (int attempt = 0; attempt < COPY_ATTEMPTS; attempt++) {
 				const unsigned current_generation = _generation.load();
+				const unsigned copy_generation = select_generation(current_generation, generation);
 
-				if (current_generation == generation) {
-					/* The subscriber already read the latest message, but nothing new was published yet.
-					* Return the previous message
-					*/
-					--generation;
-				}
+				memcpy(dst, _data + (_meta->o_size * (copy_generation % _meta->o_queue)), _meta->o_size);
 
-				// Compatible with normal and overflow conditions
-				if (!is_in_range(current_generation - _meta->o_queue, generation, current_generation - 1)) {
-					// Reader is too far behind: some messages are lost
-					generation = current_generation - _meta->o_queue;
+				if (slot_valid(copy_generation)) {
+					generation = (_meta->o_queue == 1) ? current_generation : copy_generation + 1;
+					return true;
 				}
 
-				memcpy(dst, _data + (_meta->o_size * (generation % _meta->o_queue)), _meta->o_size);
-				ATOMIC_LEAVE;
+				// slot was overwritten during the copy
+			}
 
-				++generation;
+			// no write is in progress while holding the lock, and select_generation() skips a loaned slot
+			_copy_retries.fetch_add(1);
 
-				return true;
-			}
+			ATOMIC_ENTER;
+			const unsigned current_generation = _generation.load();
+			const unsigned copy_generation = select_generation(current_generation, generation);
+			memcpy(dst, _data + (_meta->o_size * (copy_generation % _meta->o_queue)), _meta->o_size);
+			ATOMIC_LEAVE;
+
+			generation = (_meta->o_queue == 1) ? current_generation : copy_generation + 1;
+			return true;
 		}
 
 		return false;
+	}
+
+	/**
+	 * Zero-copy variant of copy(): returns a pointer into the queue buffer
+	 * instead of copying the data out.
+	 *
+	 * The slot can be reused by a publisher at any time, so the data must be
+	 * checked with slot_valid(slot_generation) after it was consumed.
+	 *
+	 * @param generation
+	 *   The generation of the subscriber, advanced like in copy().
+	 * @param slot_generation
+	 *   The generation stored in the returned slot.
+	 * @return
+	 *   Pointer to the data or nullptr if nothing was published yet.
+	 */
+	const void *borrow(unsigned &generation, unsigned &slot_generation)
+	{
+		if (_data == nullptr) {
+			return nullptr;
+		}
 
+		const unsigned current_generation = _generation.load();
+		slot_generation = select_generation(current_generation, generation);
+		generation = (_meta->o_queue == 1) ? current_generation : slot_generation + 1;
+
+		return _data + (_meta->o_size * (slot_generation % _meta->o_queue));
 	}
 
+	/**
+	 * Check that the queue slot of a given generation was not (partially)
+	 * overwritten by a publisher.
+	 * Must be called after the data of the slot was read.
+	 */
+	bool slot_valid(unsigned slot_generation) const
+	{
+		// the data loads before must complete before checking for a concurrent write
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		return (_write_generation.load() - slot_generation) <= _meta->o_queue;
+	}
+
+	/**
+	 * Loan the next queue slot to a publisher, so that it can fill the message
+	 * in place instead of copying it with write().
+	 *
+	 * This is only supported for queued topics (o_queue > 1), since the slot
+	 * with the latest data must stay readable while the loan is outstanding.
+	 * Other writes to this node are rejected (-EBUSY) until commit_loan().
+	 * The slot still holds old data and needs to be filled completely.
+	 *
+	 * @return pointer to the slot or nullptr if the loan is not possible.
+	 */
+	void *loan();
+
+	/**
+	 * Finish a loan() started before.
+	 * @param publish
+	 *   true to publish the slot, false to drop it.
+	 * @return PX4_OK on success, negative errno otherwise.
+	 */
+	int commit_loan(bool publish);
+
+	/**
+	 * Method to publish a loaned slot of this node (see loan()).
+	 */
+	static int commit(const orb_metadata *meta, orb_advert_t handle, bool publish);
+
+	/**
+	 * Number of copies that fell back to the lock because of concurrent writes
+	 */
+	unsigned copy_retries() const { return _copy_retries.load(); }
+
 	// add item to list of work items to schedule on node update
 	bool register_callback(SubscriptionCallback *callback_sub);
 
@@ -277,11 +348,15 @@ protected:
 private:
 	friend uORBTest::UnitTest;
 
+	static constexpr int COPY_ATTEMPTS = 3; ///< lock-free copy attempts before copy() takes the lock
+
 	const orb_metadata *_meta; /**< object metadata information */
 
 	uint8_t *_data{nullptr};   /**< allocated object buffer */
 	bool _data_valid{false}; /**< At least one valid data */
-	px4::atomic<unsigned>  _generation{0};  /**< object generation count */
+	px4::atomic<unsigned>  _generation{0};  /**< object generation count (completed writes) */
+	px4::atomic<unsigned>  _write_generation{0};  /**< started writes, leads _generation during a write */
+	px4::atomic<unsigned>  _copy_retries{0};  /**< copies that fell back to the lock due to concurrent writes */
 	List<uORB::SubscriptionCallback *>	_callbacks;
 
 	const uint8_t _instance; /**< orb multi instance identifier */
@@ -289,11 +364,50 @@ private:
 
 	int8_t _subscriber_count{0};
 
+	bool _loaned{false}; /**< a publisher currently holds a loaned slot */
+
+	/**
+	 * Allocate the queue buffer if not done yet (thread context only).
+	 * @return true if the buffer is available
+	 */
+	bool allocate_data();
+
+	/**
+	 * Select the generation to read next for a subscriber
+	 * @param current_generation current (completed) generation of the node
+	 * @param generation generation of the subscriber
+	 */
+	unsigned select_generation(unsigned current_generation, unsigned generation) const
+	{
+		if (_meta->o_queue == 1) {
+			return current_generation - 1;
+		}
+
+		if (current_generation == generation) {
+			/* The subscriber already read the latest message, but nothing new was published yet.
+			* Return the previous message
+			*/
+			--generation;
+		}
+
+		// the oldest slot is not readable while it is being written (or loaned)
+		const unsigned oldest_generation = current_generation - _meta->o_queue
+						   + ((_write_generation.load() != current_generation) ? 1 : 0);
+
+		// Compatible with normal and overflow conditions
+		if (!is_in_range(oldest_generation, generation, current_generation - 1)) {
+			// Reader is too far behind: some messages are lost
+			generation = oldest_generation;
+		}
+
+		return generation;
+	}
+
 
 // Determine the data range
 	static inline bool is_in_range(unsigned left, unsigned value, unsigned right)
 	{
-		if (right > left) {
+		if (right >= left) {
 			return (left <= value) && (value <= right);
 
 		} else {  // Maybe the data overflowed and a wraparound occurred
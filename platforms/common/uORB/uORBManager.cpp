@@ -443,6 +443,36 @@ void uORB::Manager::orb_remove_internal_subscriber(void *node_handle)
 	static_cast<DeviceNode *>(node_handle)->remove_internal_subscriber();
 }
 
+void *uORB::Manager::orb_loan(orb_advert_t handle)
+{
+	if (handle == nullptr) {
+		return nullptr;
+	}
+
+#ifdef ORB_USE_PUBLISHER_RULES
+
+	if (handle == _Instance) {
+		return nullptr; // publications are ignored, nothing to loan
+	}
+
+#endif /* ORB_USE_PUBLISHER_RULES */
+
+	return static_cast<DeviceNode *>(handle)->loan();
+}
+
+int uORB::Manager::orb_commit(const struct orb_metadata *meta, orb_advert_t handle, bool publish)
+{
+#ifdef ORB_USE_PUBLISHER_RULES
+
+	if (handle == _Instance) {
+		return PX4_OK; //pretend success
+	}
+
+#endif /* ORB_USE_PUBLISHER_RULES */
+
+	return uORB::DeviceNode::commit(meta, handle, publish);
+}
+
 uint8_t uORB::Manager::orb_get_queue_size(const void *node_handle) { return static_cast<const DeviceNode *>(node_handle)->get_queue_size(); }
 
 bool uORB::Manager::orb_data_copy(void *node_handle, void *dst, unsigned &generation, bool only_if_updated)
@@ -458,6 +488,25 @@ bool uORB::Manager::orb_data_copy(void *node_handle, void *dst, unsigned &genera
 	return static_cast<DeviceNode *>(node_handle)->copy(dst, generation);
 }
 
+const void *uORB::Manager::orb_data_borrow(void *node_handle, unsigned &generation, unsigned &slot_generation,
+		bool only_if_updated)
+{
+	if (!is_advertised(node_handle)) {
+		return nullptr;
+	}
+
+	if (only_if_updated && !static_cast<const uORB::DeviceNode *>(node_handle)->updates_available(generation)) {
+		return nullptr;
+	}
+
+	return static_cast<DeviceNode *>(node_handle)->borrow(generation, slot_generation);
+}
+
+bool uORB::Manager::orb_data_slot_valid(const void *node_handle, unsigned slot_generation)
+{
+	return static_cast<const DeviceNode *>(node_handle)->slot_valid(slot_generation);
+}
+
 // add item to list of work items to schedule on node update
 bool uORB::Manager::register_callback(void *node_handle, SubscriptionCallback *callback_sub)
 {
@@ -593,15 +642,8 @@ int16_t uORB::Manager::process_remote_topic(const char *topic_name)
 	PX4_DEBUG("entering process_remote_topic: name: %s", topic_name);
 
 	// First make sure this is a valid topic
-	const struct orb_metadata *const *topic_list = orb_get_topics();
-	orb_id_t topic_ptr = nullptr;
-
-	for (size_t i = 0; i < orb_topics_count(); i++) {
-		if (strcmp(topic_list[i]->o_name, topic_name) == 0) {
-			topic_ptr = topic_list[i];
-			break;
-		}
-	}
+	const ORB_ID orb_id = get_orb_id(topic_name);
+	orb_id_t topic_ptr = (orb_id != ORB_ID::INVALID) ? get_orb_meta(orb_id) : nullptr;
 
 	if (! topic_ptr) {
 		PX4_ERR("process_remote_topic meta not found for %s\n", topic_name);
@@ -692,26 +734,35 @@ int16_t uORB::Manager::process_remove_subscription(const char *messageName)
 
 int16_t uORB::Manager::process_received_message(const char *messageName, int32_t length, uint8_t *data)
 {
-	int16_t rc = -1;
-	char nodepath[orb_maxpath];
-	int ret = uORB::Utils::node_mkpath(nodepath, messageName);
-	DeviceMaster *device_master = get_device_master();
+	const ORB_ID orb_id = get_orb_id(messageName);
 
-	if (ret == OK && device_master) {
-		uORB::DeviceNode *node = device_master->getDeviceNode(nodepath);
+	if (orb_id == ORB_ID::INVALID) {
+		PX4_DEBUG("Unknown topic received: [%s]", messageName);
+		return -1;
+	}
 
-		// get the node name.
-		if (node == nullptr) {
-			PX4_DEBUG("No existing subscriber found for message: [%s] nodepath:[%s]", messageName, nodepath);
+	// Nodes are never deleted, so once resolved the node can be reused without
+	// going through the device master lock and list search again.
+	px4::atomic<uORB::DeviceNode *> &cached = _received_nodes[static_cast<size_t>(orb_id)];
+	uORB::DeviceNode *node = cached.load();
 
-		} else {
-			// node is present.
-			node->process_received_message(length, data);
-			rc = 0;
+	if (node == nullptr) {
+		DeviceMaster *device_master = get_device_master();
+
+		if (device_master) {
+			node = device_master->getDeviceNode(get_orb_meta(orb_id), 0);
+		}
+
+		if (node == nullptr) {
+			PX4_DEBUG("No existing subscriber found for message: [%s]", messageName);
+			return -1;
 		}
+
+		cached.store(node);
 	}
 
-	return rc;
+	node->process_received_message(length, data);
+	return 0;
 }
 
 #endif /* CONFIG_ORB_COMMUNICATOR */
@@ -279,6 +279,30 @@ public:
 	 */
 	static int  orb_publish(const struct orb_metadata *meta, orb_advert_t handle, const void *data);
 
+	/**
+	 * Loan the next queue slot of a topic to fill a message in place (zero-copy publication).
+	 *
+	 * Only supported for queued topics (ORB_QUEUE_LENGTH > 1) and in the flat/POSIX build.
+	 * While the loan is outstanding other publications to the topic instance fail,
+	 * so it is meant for topics with a single publisher.
+	 *
+	 * @handle    The handle returned from orb_advertise.
+	 * @return    Pointer to the slot (old content, must be filled completely) or
+	 *            nullptr if loaning is not possible. Must be followed by orb_commit().
+	 */
+	static void *orb_loan(orb_advert_t handle);
+
+	/**
+	 * Publish (or drop) a slot obtained with orb_loan().
+	 *
+	 * @param meta    The uORB metadata (usually from the ORB_ID() macro)
+	 *      for the topic.
+	 * @handle    The handle returned from orb_advertise.
+	 * @param publish    true to publish the slot, false to drop it.
+	 * @return    OK on success, PX4_ERROR otherwise with errno set accordingly.
+	 */
+	static int  orb_commit(const struct orb_metadata *meta, orb_advert_t handle, bool publish);
+
 	/**
 	 * Subscribe to a topic.
 	 *
@@ -442,6 +466,11 @@ public:
 
 	static bool orb_data_copy(void *node_handle, void *dst, unsigned &generation, bool only_if_updated);
 
+	static const void *orb_data_borrow(void *node_handle, unsigned &generation, unsigned &slot_generation,
+					   bool only_if_updated);
+
+	static bool orb_data_slot_valid(const void *node_handle, unsigned slot_generation);
+
 	static bool register_callback(void *node_handle, SubscriptionCallback *callback_sub);
 
 	static void unregister_callback(void *node_handle, SubscriptionCallback *callback_sub);
@@ -498,6 +527,9 @@ private: // data members
 
 	// Track the advertisements we get from the remote side
 	ORBSet _remote_topics;
+
+	// Instance 0 nodes of received remote topics, resolved on first use
+	px4::atomic<uORB::DeviceNode *> _received_nodes[ORB_TOPICS_COUNT] {};
 #endif /* CONFIG_ORB_COMMUNICATOR */
 
 	DeviceMaster *_device_master{nullptr};
@@ -285,6 +285,18 @@ void uORB::Manager::orb_remove_internal_subscriber(void *node_handle)
 	boardctl(ORBIOCDEVREMSUBSCRIBER, reinterpret_cast<unsigned long>(node_handle));
 }
 
+void *uORB::Manager::orb_loan(orb_advert_t handle)
+{
+	// the queue buffer lives in kernel memory, zero-copy is not possible from user space
+	return nullptr;
+}
+
+int uORB::Manager::orb_commit(const struct orb_metadata *meta, orb_advert_t handle, bool publish)
+{
+	errno = ENOTSUP;
+	return PX4_ERROR;
+}
+
 uint8_t uORB::Manager::orb_get_queue_size(const void *node_handle)
 {
 	orbiocdevqueuesize_t data = {node_handle, 0};
@@ -302,6 +314,18 @@ bool uORB::Manager::orb_data_copy(void *node_handle, void *dst, unsigned &genera
 	return data.ret;
 }
 
+const void *uORB::Manager::orb_data_borrow(void *node_handle, unsigned &generation, unsigned &slot_generation,
+		bool only_if_updated)
+{
+	// the queue buffer lives in kernel memory, zero-copy is not possible from user space
+	return nullptr;
+}
+
+bool uORB::Manager::orb_data_slot_valid(const void *node_handle, unsigned slot_generation)
+{
+	return false;
+}
+
 bool uORB::Manager::register_callback(void *node_handle, SubscriptionCallback *callback_sub)
 {
 	orbiocdevregcallback_t data = {node_handle, callback_sub, false};
@@ -39,7 +39,9 @@
 #include <errno.h>
 #include <math.h>
 #include <lib/cdev/CDev.hpp>
+#include <uORB/Publication.hpp>
 #include <uORB/PublicationMulti.hpp>
+#include <uORB/Subscription.hpp>
 #include <uORB/SubscriptionMultiArray.hpp>
 
 uORBTest::UnitTest &uORBTest::UnitTest::instance()
@@ -206,7 +208,19 @@ int uORBTest::UnitTest::test()
 		return ret;
 	}
 
-	return test_queue_poll_notify();
+	ret = test_queue_poll_notify();
+
+	if (ret != OK) {
+		return ret;
+	}
+
+	ret = test_concurrent_copy();
+
+	if (ret != OK) {
+		return ret;
+	}
+
+	return test_loan();
 }
 
 int uORBTest::UnitTest::test_unadvertise()
@@ -1033,6 +1047,174 @@ int uORBTest::UnitTest::test_queue_poll_notify()
 	return test_note("PASS orb queuing (poll & notify), got %i messages", next_expected_val);
 }
 
+int uORBTest::UnitTest::pub_test_concurrent_copy_entry(int argc, char *argv[])
+{
+	uORBTest::UnitTest &t = uORBTest::UnitTest::instance();
+	return t.pub_test_concurrent_copy_main();
+}
+
+int uORBTest::UnitTest::pub_test_concurrent_copy_main()
+{
+	orb_test_large_s t{};
+	orb_advert_t ptopic = orb_advertise(ORB_ID(orb_test_large), &t);
+
+	if (ptopic == nullptr) {
+		_thread_should_exit = true;
+		return test_fail("advertise failed: %d", errno);
+	}
+
+	const int num_messages = 20000;
+
+	for (int i = 1; i <= num_messages; i++) {
+		// every byte of the payload carries the same value so that a torn copy can be detected
+		t.val = i;
+		memset(t.junk, i & 0xff, sizeof(t.junk));
+		orb_publish(ORB_ID(orb_test_large), ptopic, &t);
+
+		if (i % 1000 == 0) {
+			px4_usleep(1000); // give the reader a chance to run
+		}
+	}
+
+	_num_messages_sent = num_messages;
+	_thread_should_exit = true;
+	orb_unadvertise(ptopic);
+
+	return 0;
+}
+
+int uORBTest::UnitTest::test_concurrent_copy()
+{
+	test_note("Testing lock-free copy with concurrent publisher");
+
+	int sfd = orb_subscribe(ORB_ID(orb_test_large));
+
+	if (sfd < 0) {
+		return test_fail("subscribe failed: %d", errno);
+	}
+
+	_thread_should_exit = false;
+
+	char *const args[1] = { nullptr };
+	int pubsub_task = px4_task_spawn_cmd("uorb_test_copy",
+					     SCHED_DEFAULT,
+					     SCHED_PRIORITY_DEFAULT,
+					     2000,
+					     (px4_main_t)&uORBTest::UnitTest::pub_test_concurrent_copy_entry,
+					     args);
+
+	if (pubsub_task < 0) {
+		orb_unsubscribe(sfd);
+		return test_fail("failed launching task");
+	}
+
+	orb_test_large_s t{};
+	int num_copies = 0;
+	int last_val = 0;
+
+	while (!_thread_should_exit) {
+		bool updated = false;
+
+		if ((orb_check(sfd, &updated) != PX4_OK) || !updated) {
+			continue;
+		}
+
+		orb_copy(ORB_ID(orb_test_large), sfd, &t);
+		++num_copies;
+
+		if (t.val < last_val) {
+			orb_unsubscribe(sfd);
+			return test_fail("copy went backwards: %d after %d", t.val, last_val);
+		}
+
+		last_val = t.val;
+
+		for (size_t i = 0; i < sizeof(t.junk); i++) {
+			if (t.junk[i] != (t.val & 0xff)) {
+				orb_unsubscribe(sfd);
+				return test_fail("torn copy: val %d junk[%d] = %d", t.val, (int)i, (int)t.junk[i]);
+			}
+		}
+	}
+
+	orb_unsubscribe(sfd);
+
+	return test_note("PASS lock-free copy, %i copies of %i messages", num_copies, _num_messages_sent);
+}
+
+int uORBTest::UnitTest::test_loan()
+{
+	test_note("Testing zero-copy loan & borrow");
+
+	uORB::Publication<orb_test_large_s> pub_single{ORB_ID(orb_test_large)};
+
+	// queue length 1: the slot with the latest data cannot be loaned out
+	if (pub_single.loan() != nullptr) {
+		return test_fail("loan of a non-queued topic succeeded");
+	}
+
+	uORB::Publication<orb_test_medium_s> pub{ORB_ID(orb_test_medium_queue)};
+	uORB::Subscription sub{ORB_ID(orb_test_medium_queue)};
+	const int queue_size = orb_get_queue_size(ORB_ID(orb_test_medium_queue));
+
+	// drain anything left from previous tests
+	orb_test_medium_s t{};
+
+	while (sub.update(&t)) {}
+
+	for (int i = 0; i < queue_size + 3; i++) {
+		orb_test_medium_s *msg = pub.loan();
+
+		if (msg == nullptr) {
+			return test_fail("loan failed");
+		}
+
+		if (pub.loan() != nullptr) {
+			return test_fail("second loan succeeded");
+		}
+
+		if (pub.publish(t)) {
+			return test_fail("publish during outstanding loan succeeded");
+		}
+
+		msg->timestamp = hrt_absolute_time();
+		msg->val = 1000 + i;
+
+		if (!pub.commit()) {
+			return test_fail("commit failed");
+		}
+
+		uORB::BorrowedMessage<orb_test_medium_s> borrowed = sub.borrow<orb_test_medium_s>();
+
+		if (!borrowed) {
+			return test_fail("borrow failed");
+		}
+
+		if (borrowed->val != 1000 + i) {
+			return test_fail("borrow mismatch: %d expected %d", borrowed->val, 1000 + i);
+		}
+
+		if (!borrowed.valid()) {
+			return test_fail("borrowed message invalid without concurrent write");
+		}
+
+		if (sub.borrow<orb_test_medium_s>()) {
+			return test_fail("borrow without update succeeded");
+		}
+	}
+
+	// a dropped loan is not published
+	if (pub.loan() == nullptr || !pub.commit(false)) {
+		return test_fail("loan drop failed");
+	}
+
+	if (sub.updated()) {
+		return test_fail("dropped loan got published");
+	}
+
+	return test_note("PASS zero-copy loan & borrow");
+}
+
 int uORBTest::UnitTest::latency_test(bool print)
 {
 	test_note("---------------- LATENCY TEST ------------------");
@@ -76,6 +76,7 @@ public:
 	static void set_generation(uORB::DeviceNode &node, unsigned generation)
 	{
 		node._generation.store(generation);
+		node._write_generation.store(generation);
 	}
 
 private:
@@ -115,6 +116,14 @@ private:
 	int test_queue_poll_notify();
 	volatile int _num_messages_sent = 0;
 
+	/* lock-free copy while publishing concurrently */
+	int test_concurrent_copy();
+	static int pub_test_concurrent_copy_entry(int argc, char *argv[]);
+	int pub_test_concurrent_copy_main();
+
+	/* zero-copy publication and subscription */
+	int test_loan();
+
 	int test_fail(const char *fmt, ...);
 	int test_note(const char *fmt, ...);
 };
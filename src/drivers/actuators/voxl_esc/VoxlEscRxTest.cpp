@@ -0,0 +1,313 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * Runs VoxlEscRx against a simulated ESC on the other end of a pseudo terminal
+ * and checks that feedback keeps up with high command rates without loss.
+ */
+
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <drivers/drv_hrt.h>
+#include <px4_platform_common/atomic.h>
+#include <px4_platform_common/posix.h>
+
+#include "voxl_esc_rx.hpp"
+#include "voxl_esc_serial.hpp"
+#include "qc_esc_packet.h"
+#include "qc_esc_packet_types.h"
+
+using namespace time_literals;
+
+namespace
+{
+
+// Answers every RPM command with a feedback packet from the requested ESC, like the real ESCs do.
+// The command counter of the response carries the command sequence number.
+class EscSimulator
+{
+public:
+	explicit EscSimulator(int fd) : _fd(fd) { qc_esc_packet_init(&_packet); }
+
+	void start() { pthread_create(&_thread, nullptr, &EscSimulator::trampoline, this); }
+
+	void stop()
+	{
+		_should_exit.store(true);
+		pthread_join(_thread, nullptr);
+	}
+
+	uint32_t commands_received() const { return _commands_received.load(); }
+
+	// gtest assertions only work on the test thread, failures are counted and checked there
+	uint32_t write_errors() const { return _write_errors.load(); }
+
+private:
+	static void *trampoline(void *context)
+	{
+		static_cast<EscSimulator *>(context)->run();
+		return nullptr;
+	}
+
+	void run()
+	{
+		uint8_t buf[128];
+
+		while (!_should_exit.load()) {
+			pollfd fds[1] {};
+			fds[0].fd = _fd;
+			fds[0].events = POLLIN;
+
+			if (::poll(fds, 1, 10) <= 0) {
+				continue;
+			}
+
+			const int len = ::read(_fd, buf, sizeof(buf));
+
+			for (int i = 0; i < len; i++) {
+				if (qc_esc_packet_process_char(buf[i], &_packet) > 0) {
+					handle_command();
+				}
+			}
+		}
+	}
+
+	void handle_command()
+	{
+		if (qc_esc_packet_get_type(&_packet) != ESC_PACKET_TYPE_RPM_CMD) {
+			return;
+		}
+
+		int16_t rpm[5];
+		memcpy(rpm, qc_esc_packet_get_data_ptr(&_packet), sizeof(rpm));
+
+		const uint8_t sequence = _commands_received.fetch_add(1) & 0xFF;
+
+		for (uint8_t id = 0; id < 4; id++) {
+			// least significant bit requests feedback
+			if (rpm[id] & 0x0001) {
+				QC_ESC_FB_RESPONSE_V2 fb{};
+				fb.id_state = (id << 4) | 0x02;
+				fb.rpm = rpm[id] & ~0x0001;
+				fb.cmd_counter = sequence;
+				fb.voltage = 15800;
+
+				uint8_t out[sizeof(QC_ESC_FB_RESPONSE_V2)];
+				const int len = qc_esc_create_packet(ESC_PACKET_TYPE_FB_RESPONSE, &fb.id_state,
+								     sizeof(fb) - 5, out, sizeof(out));
+				if (::write(_fd, out, len) != len) {
+					_write_errors.fetch_add(1);
+				}
+			}
+		}
+	}
+
+	int _fd;
+	pthread_t _thread{};
+	px4::atomic_bool _should_exit{false};
+	px4::atomic<uint32_t> _commands_received{0};
+	px4::atomic<uint32_t> _write_errors{0};
+	EscPacket _packet;
+};
+
+struct FeedbackStats {
+	px4::atomic<uint64_t> sent_time[256];
+	px4::atomic<uint32_t> received{0};
+	px4::atomic<uint32_t> latency_max{0};
+	uint64_t latency_sum{0};
+};
+
+void feedback_callback(void *context, EscPacket *packet, hrt_abstime timestamp)
+{
+	FeedbackStats *stats = static_cast<FeedbackStats *>(context);
+
+	if (qc_esc_packet_get_type(packet) == ESC_PACKET_TYPE_FB_RESPONSE) {
+		QC_ESC_FB_RESPONSE_V2 fb;
+		memcpy(&fb, packet->buffer, sizeof(fb));
+
+		const uint32_t latency = timestamp - stats->sent_time[fb.cmd_counter].load();
+
+		stats->latency_sum += latency;
+
+		if (latency > stats->latency_max.load()) {
+			stats->latency_max.store(latency);
+		}
+
+		stats->received.fetch_add(1);
+	}
+}
+
+} // namespace
+
+class VoxlEscRxTest : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		_master_fd = posix_openpt(O_RDWR | O_NOCTTY);
+		ASSERT_GE(_master_fd, 0);
+		ASSERT_EQ(grantpt(_master_fd), 0);
+		ASSERT_EQ(unlockpt(_master_fd), 0);
+
+		ASSERT_EQ(_serial.uart_open(ptsname(_master_fd), B921600), 0);
+	}
+
+	void TearDown() override
+	{
+		_serial.uart_close();
+		::close(_master_fd);
+	}
+
+	void run_command_rate(unsigned rate_hz, unsigned duration_ms)
+	{
+		EscSimulator esc(_master_fd);
+		FeedbackStats stats{};
+		VoxlEscRx rx(&_serial, &feedback_callback, &stats);
+
+		esc.start();
+		ASSERT_EQ(rx.start(), PX4_OK);
+
+		const unsigned interval_us = 1000000 / rate_hz;
+		const unsigned commands = rate_hz * duration_ms / 1000;
+
+		uint64_t write_time_sum = 0;
+		hrt_abstime next = hrt_absolute_time();
+
+		for (unsigned i = 0; i < commands; i++) {
+			uint8_t buf[32];
+			const int len = qc_esc_create_rpm_packet4_fb(1000, 2000, 3000, 4000, 0, 0, 0, 0, i % 4, buf, sizeof(buf), 0);
+
+			const hrt_abstime now = hrt_absolute_time();
+			stats.sent_time[i & 0xFF].store(now);
+			ASSERT_EQ(_serial.uart_write(buf, len), len);
+			write_time_sum += hrt_elapsed_time(&now);
+
+			next += interval_us;
+			const hrt_abstime after = hrt_absolute_time();
+
+			if (next > after) {
+				px4_usleep(next - after);
+			}
+		}
+
+		// let the last responses drain
+		const hrt_abstime drain_start = hrt_absolute_time();
+
+		while (stats.received.load() < commands && hrt_elapsed_time(&drain_start) < 1_s) {
+			px4_usleep(1000);
+		}
+
+		rx.stop();
+		esc.stop();
+
+		const uint32_t received = stats.received.load();
+		printf("%u Hz: sent %u, received %u, mean write %.1f us, mean latency %.1f us, max latency %u us\n",
+		       rate_hz, commands, received, (double)write_time_sum / commands,
+		       received ? (double)stats.latency_sum / received : 0.0, (unsigned)stats.latency_max.load());
+
+		EXPECT_EQ(esc.write_errors(), 0u);
+		EXPECT_EQ(esc.commands_received(), commands);
+		EXPECT_EQ(received, commands);
+		EXPECT_EQ(rx.packet_count(), commands);
+		EXPECT_EQ(rx.crc_error_count(), 0u);
+
+		// write time and latency depend on the load of the machine running the test,
+		// they are only printed above
+	}
+
+	int _master_fd{-1};
+	VoxlEscSerial _serial;
+};
+
+TEST_F(VoxlEscRxTest, StartStop)
+{
+	FeedbackStats stats{};
+	VoxlEscRx rx(&_serial, &feedback_callback, &stats);
+
+	ASSERT_EQ(rx.start(), PX4_OK);
+	EXPECT_TRUE(rx.running());
+
+	// nothing is sent, so this has to time out
+	const hrt_abstime start = hrt_absolute_time();
+	EXPECT_FALSE(rx.wait_for_packet(0, 5000));
+	EXPECT_GE(hrt_elapsed_time(&start), 5000u);
+
+	rx.stop();
+	EXPECT_FALSE(rx.running());
+	EXPECT_EQ(rx.packet_count(), 0u);
+}
+
+TEST_F(VoxlEscRxTest, ResyncAfterCorruption)
+{
+	FeedbackStats stats{};
+	VoxlEscRx rx(&_serial, &feedback_callback, &stats);
+	ASSERT_EQ(rx.start(), PX4_OK);
+
+	QC_ESC_FB_RESPONSE_V2 fb{};
+	fb.id_state = 0x12;
+	uint8_t out[sizeof(QC_ESC_FB_RESPONSE_V2)];
+	const int len = qc_esc_create_packet(ESC_PACKET_TYPE_FB_RESPONSE, &fb.id_state, sizeof(fb) - 5, out, sizeof(out));
+
+	// corrupted payload, followed by a valid packet split across two writes
+	uint8_t corrupted[sizeof(out)];
+	memcpy(corrupted, out, len);
+	corrupted[5] ^= 0xFF;
+	ASSERT_EQ(::write(_master_fd, corrupted, len), len);
+	ASSERT_EQ(::write(_master_fd, out, 4), 4);
+	px4_usleep(2000);
+	ASSERT_EQ(::write(_master_fd, out + 4, len - 4), len - 4);
+
+	EXPECT_TRUE(rx.wait_for_packet(0, 100000));
+	rx.stop();
+
+	EXPECT_EQ(rx.packet_count(), 1u);
+	EXPECT_EQ(rx.crc_error_count(), 1u);
+	EXPECT_EQ(stats.received.load(), 1u);
+}
+
+TEST_F(VoxlEscRxTest, CommandRate800Hz)
+{
+	run_command_rate(800, 1500);
+}
+
+TEST_F(VoxlEscRxTest, CommandRate2000Hz)
+{
+	run_command_rate(2000, 1500);
+}
@@ -285,8 +285,8 @@ static inline void qc_esc_packet_reset(EscPacket *packet)
 	packet->len_received = 0;
 }
 
-#endif //QC_ESC_PACKET
-
 #ifdef __cplusplus
 }
 #endif
+
+#endif //QC_ESC_PACKET
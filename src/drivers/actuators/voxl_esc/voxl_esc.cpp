@@ -74,8 +74,6 @@ VoxlEsc::VoxlEsc() :
 		_esc_status.esc[i].esc_power       = 0;
 	}
 
-	qc_esc_packet_init(&_fb_packet);
-
 	_fb_idx = 0;
 }
 
@@ -83,6 +81,9 @@ VoxlEsc::~VoxlEsc()
 {
 	_outputs_on = false;
 
+	delete _rx;
+	_rx = nullptr;
+
 	if (_uart_port) {
 		_uart_port->uart_close();
 		_uart_port = nullptr;
@@ -264,13 +265,6 @@ int VoxlEsc::task_spawn(int argc, char *argv[])
 	return PX4_ERROR;
 }
 
-int VoxlEsc::flush_uart_rx()
-{
-	while (_uart_port->uart_read(_read_buf, sizeof(_read_buf)) > 0) {}
-
-	return 0;
-}
-
 bool VoxlEsc::check_versions_updated()
 {
 	for (int esc_id = 0; esc_id < VOXL_ESC_OUTPUT_CHANNELS; ++esc_id) {
@@ -278,188 +272,165 @@ bool VoxlEsc::check_versions_updated()
 	}
 
 	// PX4_INFO("Got all ESC Version info!");
-	_extended_rpm = true;
-	_need_version_info = false;
+	bool extended_rpm = true;
 
 	for (int esc_id = 0; esc_id < VOXL_ESC_OUTPUT_CHANNELS; ++esc_id) {
-		if (_version_info[esc_id].sw_version < VOXL_ESC_EXT_RPM) { _extended_rpm = false; }
+		if (_version_info[esc_id].sw_version < VOXL_ESC_EXT_RPM) { extended_rpm = false; }
 	}
 
+	_extended_rpm.store(extended_rpm);
+	_need_version_info.store(false);
+
 	return true;
 }
 
-int VoxlEsc::read_response(Command *out_cmd)
+int VoxlEsc::read_response(Command *out_cmd, uint32_t rx_packet_count)
 {
-	px4_usleep(_current_cmd.resp_delay_us);
-
-	int res = _uart_port->uart_read(_read_buf, sizeof(_read_buf));
-
-	if (res > 0) {
-		//PX4_INFO("read %i bytes",res);
-		if (parse_response(_read_buf, res, out_cmd->print_feedback) < 0) {
-			//PX4_ERR("Error parsing response");
-			return -1;
-		}
-
-	} else {
-		//PX4_ERR("Read error: %i", res);
+	// the receive thread parses the response, only wait for it to show up
+	if (!_rx->wait_for_packet(rx_packet_count, out_cmd->resp_delay_us)) {
+		//PX4_ERR("No response");
 		return -1;
 	}
 
-	//_current_cmd.response = false;
-
 	return 0;
 }
 
-int VoxlEsc::parse_response(uint8_t *buf, uint8_t len, bool print_feedback)
+void VoxlEsc::rx_packet_callback(void *context, EscPacket *packet, hrt_abstime timestamp)
 {
-	hrt_abstime tnow = hrt_absolute_time();
-
-	for (int i = 0; i < len; i++) {
-		int16_t ret = qc_esc_packet_process_char(buf[i], &_fb_packet);
+	static_cast<VoxlEsc *>(context)->handle_packet(packet, timestamp);
+}
 
-		if (ret > 0) {
-			//PX4_INFO("got packet of length %i",ret);
-			_rx_packet_count++;
-			uint8_t packet_type = qc_esc_packet_get_type(&_fb_packet);
-			uint8_t packet_size = qc_esc_packet_get_size(&_fb_packet);
+void VoxlEsc::handle_packet(EscPacket *packet, hrt_abstime tnow)
+{
+	// runs on the receive thread
+	const bool print_feedback = _print_feedback.load();
 
-			if (packet_type == ESC_PACKET_TYPE_FB_RESPONSE && packet_size == sizeof(QC_ESC_FB_RESPONSE_V2)) {
-				// PX4_INFO("Got feedback V2 packet!");
-				QC_ESC_FB_RESPONSE_V2 fb;
-				memcpy(&fb, _fb_packet.buffer, packet_size);
+	uint8_t packet_type = qc_esc_packet_get_type(packet);
+	uint8_t packet_size = qc_esc_packet_get_size(packet);
 
-				uint32_t id             = (fb.id_state & 0xF0) >> 4;  //ID of the ESC based on hardware address
+	if (packet_type == ESC_PACKET_TYPE_FB_RESPONSE && packet_size == sizeof(QC_ESC_FB_RESPONSE_V2)) {
+		// PX4_INFO("Got feedback V2 packet!");
+		QC_ESC_FB_RESPONSE_V2 fb;
+		memcpy(&fb, packet->buffer, packet_size);
 
-				if (id < VOXL_ESC_OUTPUT_CHANNELS) {
+		uint32_t id             = (fb.id_state & 0xF0) >> 4;  //ID of the ESC based on hardware address
 
-					int motor_idx = _output_map[id].number - 1; // mapped motor id.. user defined mapping is 1-4, array is 0-3
+		if (id < VOXL_ESC_OUTPUT_CHANNELS) {
 
-					if (print_feedback) {
-						uint32_t rpm         = fb.rpm;
-						uint32_t power       = fb.power;
-						uint32_t voltage     = fb.voltage;
-						int32_t  current     = fb.current * 8;
-						int32_t  temperature = fb.temperature / 100;
-						PX4_INFO("[%" PRId64 "] ID_RAW=%d ID=%d, RPM=%5d, PWR=%3d%%, V=%5dmV, I=%+5dmA, T=%+3dC", tnow, (int)id, motor_idx + 1,
-							 (int)rpm, (int)power, (int)voltage, (int)current, (int)temperature);
-					}
+			int motor_idx = _rx_motor_number[id].load() - 1; // mapped motor id.. user defined mapping is 1-4, array is 0-3
 
-					_esc_chans[id].rate_meas     = fb.rpm;
-					_esc_chans[id].power_applied = fb.power;
-					_esc_chans[id].state         = fb.id_state & 0x0F;
-					_esc_chans[id].cmd_counter   = fb.cmd_counter;
-					_esc_chans[id].voltage       = fb.voltage * 0.001f;
-					_esc_chans[id].current       = fb.current * 0.008f;
-					_esc_chans[id].temperature   = fb.temperature * 0.01f;
-					_esc_chans[id].feedback_time = tnow;
-
-					// also update our internal report for logging
-					_esc_status.esc[id].esc_address  = motor_idx + 1; //remapped motor ID
-					_esc_status.esc[id].timestamp    = tnow;
-					_esc_status.esc[id].esc_rpm      = fb.rpm;
-					_esc_status.esc[id].esc_power    = fb.power;
-					_esc_status.esc[id].esc_state    = fb.id_state & 0x0F;
-					_esc_status.esc[id].esc_cmdcount = fb.cmd_counter;
-					_esc_status.esc[id].esc_voltage  = _esc_chans[id].voltage;
-					_esc_status.esc[id].esc_current  = _esc_chans[id].current;
-					_esc_status.esc[id].failures     = 0; //not implemented
-
-					// this is hacky, but we need to set all 4 to online/armed otherwise commander times out on arming
-					_esc_status.esc_online_flags = (1 << _esc_status.esc_count) - 1;
-					// this is hacky, but we need to set all 4 to armed otherwise commander times out on arming
-					_esc_status.esc_armed_flags = (1 << _esc_status.esc_count) - 1;
-
-
-					int32_t t = fb.temperature / 100;  //divide by 100 to get deg C and cap for int8
-
-					if (t < -127) { t = -127; }
-
-					if (t > +127) { t = +127; }
-
-					_esc_status.esc[id].esc_temperature = t;
-
-					_esc_status.timestamp = _esc_status.esc[id].timestamp;
-					_esc_status.counter++;
-
-					//print ESC status just for debugging
-					/*
-					PX4_INFO("[%lld] ID=%d, ADDR %d, STATE=%d, RPM=%5d, PWR=%3d%%, V=%.2fdV, I=%.2fA, T=%+3dC, CNT %d, FAIL %d",
-						_esc_status.esc[id].timestamp, id, _esc_status.esc[id].esc_address,
-						_esc_status.esc[id].esc_state, _esc_status.esc[id].esc_rpm, _esc_status.esc[id].esc_power,
-						(double)_esc_status.esc[id].esc_voltage, (double)_esc_status.esc[id].esc_current, _esc_status.esc[id].esc_temperature,
-					  _esc_status.esc[id].esc_cmdcount, _esc_status.esc[id].failures);
-					*/
-				}
+			if (print_feedback) {
+				uint32_t rpm         = fb.rpm;
+				uint32_t power       = fb.power;
+				uint32_t voltage     = fb.voltage;
+				int32_t  current     = fb.current * 8;
+				int32_t  temperature = fb.temperature / 100;
+				PX4_INFO("[%" PRId64 "] ID_RAW=%d ID=%d, RPM=%5d, PWR=%3d%%, V=%5dmV, I=%+5dmA, T=%+3dC", tnow, (int)id, motor_idx + 1,
+					 (int)rpm, (int)power, (int)voltage, (int)current, (int)temperature);
 			}
 
-			else if (packet_type == ESC_PACKET_TYPE_VERSION_RESPONSE && packet_size == sizeof(QC_ESC_VERSION_INFO)) {
-				QC_ESC_VERSION_INFO ver;
-				memcpy(&ver, _fb_packet.buffer, packet_size);
-
-				if (_need_version_info) {
-					memcpy(&_version_info[ver.id], &ver, sizeof(QC_ESC_VERSION_INFO));
-					check_versions_updated();
-					break;
-				}
+			_esc_chans[id].rate_meas     = fb.rpm;
+			_esc_chans[id].power_applied = fb.power;
+			_esc_chans[id].state         = fb.id_state & 0x0F;
+			_esc_chans[id].cmd_counter   = fb.cmd_counter;
+			_esc_chans[id].voltage       = fb.voltage * 0.001f;
+			_esc_chans[id].current       = fb.current * 0.008f;
+			_esc_chans[id].temperature   = fb.temperature * 0.01f;
+			_esc_chans[id].feedback_time = tnow;
+
+			// also update our internal report for logging
+			_esc_status.esc[id].esc_address  = motor_idx + 1; //remapped motor ID
+			_esc_status.esc[id].timestamp    = tnow;
+			_esc_status.esc[id].esc_rpm      = fb.rpm;
+			_esc_status.esc[id].esc_power    = fb.power;
+			_esc_status.esc[id].esc_state    = fb.id_state & 0x0F;
+			_esc_status.esc[id].esc_cmdcount = fb.cmd_counter;
+			_esc_status.esc[id].esc_voltage  = _esc_chans[id].voltage;
+			_esc_status.esc[id].esc_current  = _esc_chans[id].current;
+			_esc_status.esc[id].failures     = 0; //not implemented
+
+			// this is hacky, but we need to set all 4 to online/armed otherwise commander times out on arming
+			_esc_status.esc_online_flags = (1 << _esc_status.esc_count) - 1;
+			// this is hacky, but we need to set all 4 to armed otherwise commander times out on arming
+			_esc_status.esc_armed_flags = (1 << _esc_status.esc_count) - 1;
+
+
+			int32_t t = fb.temperature / 100;  //divide by 100 to get deg C and cap for int8
+
+			if (t < -127) { t = -127; }
+
+			if (t > +127) { t = +127; }
+
+			_esc_status.esc[id].esc_temperature = t;
+
+			_esc_status.timestamp = _esc_status.esc[id].timestamp;
+			_esc_status.counter++;
+
+			_esc_status_pub.publish(_esc_status);
+
+			//print ESC status just for debugging
+			/*
+			PX4_INFO("[%lld] ID=%d, ADDR %d, STATE=%d, RPM=%5d, PWR=%3d%%, V=%.2fdV, I=%.2fA, T=%+3dC, CNT %d, FAIL %d",
+				_esc_status.esc[id].timestamp, id, _esc_status.esc[id].esc_address,
+				_esc_status.esc[id].esc_state, _esc_status.esc[id].esc_rpm, _esc_status.esc[id].esc_power,
+				(double)_esc_status.esc[id].esc_voltage, (double)_esc_status.esc[id].esc_current, _esc_status.esc[id].esc_temperature,
+			  _esc_status.esc[id].esc_cmdcount, _esc_status.esc[id].failures);
+			*/
+		}
 
-				PX4_INFO("ESC ID: %i", ver.id);
-				PX4_INFO("HW Version: %i", ver.hw_version);
-				PX4_INFO("SW Version: %i", ver.sw_version);
-				PX4_INFO("Unique ID: %i", (int)ver.unique_id);
+	} else if (packet_type == ESC_PACKET_TYPE_VERSION_RESPONSE && packet_size == sizeof(QC_ESC_VERSION_INFO)) {
+		QC_ESC_VERSION_INFO ver;
+		memcpy(&ver, packet->buffer, packet_size);
 
-			} else if (packet_type == ESC_PACKET_TYPE_VERSION_EXT_RESPONSE && packet_size == sizeof(QC_ESC_EXTENDED_VERSION_INFO)) {
-				QC_ESC_EXTENDED_VERSION_INFO ver;
-				memcpy(&ver, _fb_packet.buffer, packet_size);
-				PX4_INFO("\tESC ID     : %i", ver.id);
-				PX4_INFO("\tBoard      : %i", ver.hw_version);
-				PX4_INFO("\tSW Version : %i", ver.sw_version);
+		if (_need_version_info.load()) {
+			if (ver.id < VOXL_ESC_OUTPUT_CHANNELS) {
+				memcpy(&_version_info[ver.id], &ver, sizeof(QC_ESC_VERSION_INFO));
+				check_versions_updated();
+			}
 
-				uint8_t *u = &ver.unique_id[0];
-				PX4_INFO("\tUnique ID  : 0x%02X%02X%02X%02X%02X%02X%02X%02X%02X%02X%02X%02X",
-					 u[11], u[10], u[9], u[8], u[7], u[6], u[5], u[4], u[3], u[2], u[1], u[0]);
+			return;
+		}
 
-				PX4_INFO("\tFirmware   : version %4d, hash %.12s", ver.sw_version, ver.firmware_git_version);
-				PX4_INFO("\tBootloader : version %4d, hash %.12s", ver.bootloader_version, ver.bootloader_git_version);
+		PX4_INFO("ESC ID: %i", ver.id);
+		PX4_INFO("HW Version: %i", ver.hw_version);
+		PX4_INFO("SW Version: %i", ver.sw_version);
+		PX4_INFO("Unique ID: %i", (int)ver.unique_id);
 
-			} else if (packet_type == ESC_PACKET_TYPE_FB_POWER_STATUS && packet_size == sizeof(QC_ESC_FB_POWER_STATUS)) {
-				QC_ESC_FB_POWER_STATUS packet;
-				memcpy(&packet, _fb_packet.buffer, packet_size);
+	} else if (packet_type == ESC_PACKET_TYPE_VERSION_EXT_RESPONSE && packet_size == sizeof(QC_ESC_EXTENDED_VERSION_INFO)) {
+		QC_ESC_EXTENDED_VERSION_INFO ver;
+		memcpy(&ver, packet->buffer, packet_size);
+		PX4_INFO("\tESC ID     : %i", ver.id);
+		PX4_INFO("\tBoard      : %i", ver.hw_version);
+		PX4_INFO("\tSW Version : %i", ver.sw_version);
 
-				float voltage = packet.voltage * 0.001f; // Voltage is reported at 1 mV resolution
-				float current = packet.current * 0.008f; // Total current is reported at 8mA resolution
+		uint8_t *u = &ver.unique_id[0];
+		PX4_INFO("\tUnique ID  : 0x%02X%02X%02X%02X%02X%02X%02X%02X%02X%02X%02X%02X",
+			 u[11], u[10], u[9], u[8], u[7], u[6], u[5], u[4], u[3], u[2], u[1], u[0]);
 
-				// Limit the frequency of battery status reports
-				if (_parameters.publish_battery_status) {
-					_battery.setConnected(true);
-					_battery.updateVoltage(voltage);
-					_battery.updateCurrent(current);
+		PX4_INFO("\tFirmware   : version %4d, hash %.12s", ver.sw_version, ver.firmware_git_version);
+		PX4_INFO("\tBootloader : version %4d, hash %.12s", ver.bootloader_version, ver.bootloader_git_version);
 
-					hrt_abstime current_time = hrt_absolute_time();
+	} else if (packet_type == ESC_PACKET_TYPE_FB_POWER_STATUS && packet_size == sizeof(QC_ESC_FB_POWER_STATUS)) {
+		QC_ESC_FB_POWER_STATUS power_status;
+		memcpy(&power_status, packet->buffer, packet_size);
 
-					if ((current_time - _last_battery_report_time) >= _battery_report_interval) {
-						_last_battery_report_time = current_time;
-						_battery.updateAndPublishBatteryStatus(current_time);
-					}
-				}
+		float voltage = power_status.voltage * 0.001f; // Voltage is reported at 1 mV resolution
+		float current = power_status.current * 0.008f; // Total current is reported at 8mA resolution
 
-			}
+		// Limit the frequency of battery status reports
+		if (_rx_publish_battery_status.load()) {
+			_battery.setConnected(true);
+			_battery.updateVoltage(voltage);
+			_battery.updateCurrent(current);
 
-		} else { //parser error
-			switch (ret) {
-			case ESC_ERROR_BAD_CHECKSUM:
-				_rx_crc_error_count++;
-				// PX4_INFO("BAD ESC packet checksum");
-				break;
+			hrt_abstime current_time = hrt_absolute_time();
 
-			case ESC_ERROR_BAD_LENGTH:
-				// PX4_INFO("BAD ESC packet length");
-				break;
+			if ((current_time - _last_battery_report_time) >= _battery_report_interval) {
+				_last_battery_report_time = current_time;
+				_battery.updateAndPublishBatteryStatus(current_time);
 			}
 		}
 	}
-
-	return 0;
 }
 
 int VoxlEsc::check_for_esc_timeout()
@@ -685,7 +656,7 @@ int VoxlEsc::custom_command(int argc, char *argv[])
 							       id_fb,
 							       cmd.buf,
 							       sizeof(cmd.buf),
-							       get_instance()->_extended_rpm);
+							       get_instance()->_extended_rpm.load());
 
 			cmd.response        = true;
 			cmd.repeats         = repeat_count;
@@ -759,6 +730,12 @@ int VoxlEsc::update_params()
 	updateParams();
 	ret = load_params(&_parameters, (ch_assign_t *)&_output_map);
 
+	for (int i = 0; i < VOXL_ESC_OUTPUT_CHANNELS; i++) {
+		_rx_motor_number[i].store(_output_map[i].number);
+	}
+
+	_rx_publish_battery_status.store(_parameters.publish_battery_status != 0);
+
 	if (ret == PX4_OK) {
 		_mixing_output.setAllDisarmedValues(0);
 		_mixing_output.setAllFailsafeValues(0);
@@ -1071,7 +1048,7 @@ bool VoxlEsc::updateOutputs(bool stop_motors, uint16_t outputs[MAX_ACTUATORS],
 			_esc_chans[i].rate_req = 0;
 
 		} else {
-			if (_extended_rpm) {
+			if (_extended_rpm.load()) {
 				if (outputs[i] > VOXL_ESC_RPM_MAX_EXT) { outputs[i] = VOXL_ESC_RPM_MAX_EXT; }
 
 			} else {
@@ -1101,7 +1078,7 @@ bool VoxlEsc::updateOutputs(bool stop_motors, uint16_t outputs[MAX_ACTUATORS],
 					       _fb_idx,
 					       cmd.buf,
 					       sizeof(cmd.buf),
-					       _extended_rpm);
+					       _extended_rpm.load());
 
 	if (_uart_port->uart_write(cmd.buf, cmd.len) != cmd.len) {
 		PX4_ERR("Failed to send packet");
@@ -1111,19 +1088,11 @@ bool VoxlEsc::updateOutputs(bool stop_motors, uint16_t outputs[MAX_ACTUATORS],
 	// increment ESC id from which to request feedback in round robin order
 	_fb_idx = (_fb_idx + 1) % VOXL_ESC_OUTPUT_CHANNELS;
 
-
 	/*
-	 * Here we read and parse response from ESCs. Since the latest command has just been sent out,
-	 * the response packet we may read here is probabaly from previous iteration, but it is totally ok.
-	 * uart_read is non-blocking and we will just parse whatever bytes came in up until this point
+	 * The feedback requested above is read, parsed and published as esc_status by the
+	 * receive thread (VoxlEscRx), so the output path never waits for the ESC to respond.
 	 */
 
-	int res = _uart_port->uart_read(_read_buf, sizeof(_read_buf));
-
-	if (res > 0) {
-		parse_response(_read_buf, res, false);
-	}
-
 	/* handle loss of comms / disconnect */
 	// TODO - enable after CRC issues in feedback are addressed
 	//check_for_esc_timeout();
@@ -1143,8 +1112,6 @@ bool VoxlEsc::updateOutputs(bool stop_motors, uint16_t outputs[MAX_ACTUATORS],
 
 	}
 
-	_esc_status_pub.publish(_esc_status);
-
 	// If any extra external modal io data has been received then
 	// send it over as well
 	while (_voxl2_io_data_sub.updated()) {
@@ -1173,6 +1140,10 @@ void VoxlEsc::Run()
 		ScheduleClear();
 		_mixing_output.unregister();
 
+		if (_rx) {
+			_rx->stop();
+		}
+
 		exit_and_cleanup();
 		return;
 	}
@@ -1190,14 +1161,28 @@ void VoxlEsc::Run()
 		}
 	}
 
+	/* Start the receive thread once the port is open */
+	if (_rx == nullptr) {
+		_rx = new VoxlEscRx(_uart_port, &VoxlEsc::rx_packet_callback, this);
+
+		if (_rx == nullptr || _rx->start() != PX4_OK) {
+			PX4_ERR("Failed starting receive thread");
+			delete _rx;
+			_rx = nullptr;
+			return;
+		}
+	}
+
 	/* Get ESC FW version info */
-	if (_need_version_info) {
+	if (_need_version_info.load()) {
 		for (uint8_t esc_id = 0; esc_id < VOXL_ESC_OUTPUT_CHANNELS; ++esc_id) {
 			Command cmd;
 			cmd.len = qc_esc_create_version_request_packet(esc_id, cmd.buf, sizeof(cmd.buf));
 
+			const uint32_t rx_packet_count = _rx->packet_count();
+
 			if (_uart_port->uart_write(cmd.buf, cmd.len) == cmd.len) {
-				if (read_response(&_current_cmd) != 0) { PX4_ERR("Failed to parse version request response packet!"); }
+				if (read_response(&_current_cmd, rx_packet_count) != 0) { PX4_ERR("Failed to parse version request response packet!"); }
 
 			} else {
 				PX4_ERR("Failed to send version request packet!");
@@ -1278,19 +1263,19 @@ void VoxlEsc::Run()
 	if (!_outputs_on) {
 		if (_current_cmd.valid()) {
 			//PX4_INFO("sending %d commands with delay %dus",_current_cmd.repeats,_current_cmd.repeat_delay_us);
-			flush_uart_rx();
+			_print_feedback.store(_current_cmd.print_feedback);
 
 			do {
 				//PX4_INFO("CMDs left %d",_current_cmd.repeats);
+				const uint32_t rx_packet_count = _rx->packet_count();
+
 				if (_uart_port->uart_write(_current_cmd.buf, _current_cmd.len) == _current_cmd.len) {
 					if (_current_cmd.repeats == 0) {
 						_current_cmd.clear();
 					}
 
 					if (_current_cmd.response) {
-						if (read_response(&_current_cmd) == 0) {
-							_esc_status_pub.publish(_esc_status);
-						}
+						read_response(&_current_cmd, rx_packet_count);
 					}
 
 				} else {
@@ -1307,8 +1292,10 @@ void VoxlEsc::Run()
 				px4_usleep(_current_cmd.repeat_delay_us);
 			} while (_current_cmd.repeats-- > 0);
 
-			PX4_INFO("RX packet count: %d", (int)_rx_packet_count);
-			PX4_INFO("CRC error count: %d", (int)_rx_crc_error_count);
+			_print_feedback.store(false);
+
+			PX4_INFO("RX packet count: %d", (int)_rx->packet_count());
+			PX4_INFO("CRC error count: %d", (int)_rx->crc_error_count());
 
 		} else {
 			Command *new_cmd = _pending_cmd.load();
@@ -1340,6 +1327,8 @@ This module is responsible for...
 
 ### Implementation
 By default the module runs on a work queue with a callback on the uORB actuator_controls topic.
+ESC feedback is read and parsed on a separate receive thread, which also publishes esc_status,
+so sending outputs never waits for an ESC response.
 
 ### Examples
 It is typically started with:
@@ -1392,6 +1381,10 @@ int VoxlEsc::print_status()
 	PX4_INFO("UART port: %s", _device);
 	PX4_INFO("UART open: %s", _uart_port->is_open() ? "yes" : "no");
 
+	if (_rx) {
+		_rx->print_status();
+	}
+
 	PX4_INFO("");
 
 	PX4_INFO("Params: VOXL_ESC_CONFIG: %" PRId32, _parameters.config);
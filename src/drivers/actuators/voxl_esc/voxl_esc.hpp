@@ -52,10 +52,16 @@
 #include <uORB/topics/buffer128.h>
 
 #include "voxl_esc_serial.hpp"
+#include "voxl_esc_rx.hpp"
 
 #include "qc_esc_packet.h"
 #include "qc_esc_packet_types.h"
 
+#ifndef VOXL_ESC_DEFAULT_PORT
+// boards without a dedicated ESC port (e.g. SITL test builds) need to pass -d
+#define VOXL_ESC_DEFAULT_PORT "/dev/ttyS1"
+#endif
+
 class VoxlEsc : public ModuleBase<VoxlEsc>, public OutputModuleInterface
 {
 public:
@@ -135,6 +141,7 @@ private:
 	//static constexpr uint16_t max_rpm(uint16_t rpm) { return math::min(rpm, VOXL_ESC_RPM_MAX); }
 
 	VoxlEscSerial 		*_uart_port;
+	VoxlEscRx		*_rx{nullptr};
 
 	typedef struct {
 		int32_t		config{VOXL_ESC_UART_CONFIG};
@@ -201,12 +208,18 @@ private:
 	uORB::Publication<actuator_outputs_s> _outputs_debug_pub{ORB_ID(actuator_outputs_debug)};
 	uORB::Publication<esc_status_s> _esc_status_pub{ORB_ID(esc_status)};
 
-	bool _extended_rpm{false};
-	bool _need_version_info{true};
+	// written by the receive thread once all ESCs reported their version
+	px4::atomic_bool _extended_rpm{false};
+	px4::atomic_bool _need_version_info{true};
 	QC_ESC_VERSION_INFO _version_info[4];
 	bool check_versions_updated();
 
 	voxl_esc_params_t	_parameters;
+
+	// copies of the parameters used by the receive thread, written by update_params()
+	px4::atomic<int32_t>	_rx_motor_number[VOXL_ESC_OUTPUT_CHANNELS] {};
+	px4::atomic_bool	_rx_publish_battery_status{false};
+
 	int			update_params();
 	int			load_params(voxl_esc_params_t *params, ch_assign_t *map);
 
@@ -221,16 +234,11 @@ private:
 
 	EscChan			_esc_chans[VOXL_ESC_OUTPUT_CHANNELS];
 	Command			_esc_cmd;
-	esc_status_s		_esc_status;
-	EscPacket		_fb_packet;
+	esc_status_s		_esc_status;		// owned by the receive thread
+	px4::atomic_bool	_print_feedback{false};
 
 	led_rsc_t	 	_led_rsc;
 	int			_fb_idx;
-	uint32_t		_rx_crc_error_count{0};
-	uint32_t		_rx_packet_count{0};
-
-	static const uint8_t 	READ_BUF_SIZE = 128;
-	uint8_t			_read_buf[READ_BUF_SIZE];
 
 	Battery 		_battery;
 	static constexpr unsigned _battery_report_interval{100_ms};
@@ -238,9 +246,9 @@ private:
 
 	void 			update_leds(vehicle_control_mode_s mode, led_control_s control);
 
-	int 			read_response(Command *out_cmd);
-	int 			parse_response(uint8_t *buf, uint8_t len, bool print_feedback);
-	int			flush_uart_rx();
+	int 			read_response(Command *out_cmd, uint32_t rx_packet_count);
+	static void		rx_packet_callback(void *context, EscPacket *packet, hrt_abstime timestamp);
+	void			handle_packet(EscPacket *packet, hrt_abstime timestamp);
 	int			check_for_esc_timeout();
 	void			mix_turtle_mode(uint16_t outputs[]);
 	void			handle_actuator_test();
@@ -0,0 +1,173 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "voxl_esc_rx.hpp"
+
+#include <inttypes.h>
+
+#include <px4_platform_common/log.h>
+#include <px4_platform_common/posix.h>
+#include <px4_platform_common/tasks.h>
+
+VoxlEscRx::VoxlEscRx(VoxlEscSerial *uart, packet_callback_t callback, void *context) :
+	_uart(uart),
+	_callback(callback),
+	_context(context)
+{
+	qc_esc_packet_init(&_packet);
+}
+
+VoxlEscRx::~VoxlEscRx()
+{
+	stop();
+
+	perf_free(_read_perf);
+	perf_free(_packet_interval_perf);
+}
+
+int VoxlEscRx::start()
+{
+	if (_running.load()) {
+		return PX4_OK;
+	}
+
+	_should_exit.store(false);
+	_running.store(true);
+
+	pthread_attr_t rx_attr;
+	pthread_attr_init(&rx_attr);
+
+	struct sched_param param;
+	(void)pthread_attr_getschedparam(&rx_attr, &param);
+	param.sched_priority = SCHED_PRIORITY_ACTUATOR_OUTPUTS;
+	(void)pthread_attr_setschedparam(&rx_attr, &param);
+
+	pthread_attr_setstacksize(&rx_attr, PX4_STACK_ADJUSTED(2048));
+
+	int ret = pthread_create(&_thread, &rx_attr, VoxlEscRx::start_trampoline, (void *)this);
+
+	pthread_attr_destroy(&rx_attr);
+
+	if (ret != 0) {
+		PX4_ERR("failed to start rx thread (%i)", ret);
+		_running.store(false);
+		return PX4_ERROR;
+	}
+
+	return PX4_OK;
+}
+
+void VoxlEscRx::stop()
+{
+	if (_running.load()) {
+		_should_exit.store(true);
+		pthread_join(_thread, nullptr);
+		_running.store(false);
+	}
+}
+
+void *VoxlEscRx::start_trampoline(void *context)
+{
+	VoxlEscRx *self = reinterpret_cast<VoxlEscRx *>(context);
+	self->run();
+	return nullptr;
+}
+
+void VoxlEscRx::run()
+{
+	while (!_should_exit.load()) {
+		const int poll_ret = _uart->uart_poll(POLL_TIMEOUT_MS);
+
+		if (poll_ret < 0) {
+			// closed port or interrupted, back off instead of spinning
+			px4_usleep(POLL_TIMEOUT_MS * 1000);
+			continue;
+
+		} else if (poll_ret == 0) {
+			continue;
+		}
+
+		const int len = _uart->uart_read(_read_buf, sizeof(_read_buf));
+
+		if (len <= 0) {
+			continue;
+		}
+
+		perf_count(_read_perf);
+
+		const hrt_abstime timestamp = hrt_absolute_time();
+
+		for (int i = 0; i < len; i++) {
+			const int16_t ret = qc_esc_packet_process_char(_read_buf[i], &_packet);
+
+			if (ret > 0) {
+				perf_count(_packet_interval_perf);
+				_callback(_context, &_packet, timestamp);
+
+				// published after the callback so wait_for_packet() sees the updated state
+				_packet_count.fetch_add(1);
+
+			} else if (ret == ESC_ERROR_BAD_CHECKSUM) {
+				_crc_error_count.fetch_add(1);
+
+			} else if (ret == ESC_ERROR_BAD_LENGTH) {
+				_length_error_count.fetch_add(1);
+			}
+		}
+	}
+}
+
+bool VoxlEscRx::wait_for_packet(uint32_t packet_count, uint32_t timeout_us) const
+{
+	const hrt_abstime start = hrt_absolute_time();
+
+	while (_packet_count.load() == packet_count) {
+		if (!_running.load() || hrt_elapsed_time(&start) >= timeout_us) {
+			return false;
+		}
+
+		px4_usleep(100);
+	}
+
+	return true;
+}
+
+void VoxlEscRx::print_status()
+{
+	PX4_INFO("RX thread: %s", _running.load() ? "running" : "stopped");
+	PX4_INFO("RX packet count: %" PRIu32, _packet_count.load());
+	PX4_INFO("RX CRC error count: %" PRIu32, _crc_error_count.load());
+	PX4_INFO("RX length error count: %" PRIu32, _length_error_count.load());
+	perf_print_counter(_read_perf);
+	perf_print_counter(_packet_interval_perf);
+}
@@ -0,0 +1,116 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file voxl_esc_rx.hpp
+ *
+ * Receive thread for the VOXL ESC UART. Feedback packets are parsed
+ * incrementally as bytes arrive and handed to a callback, so the output
+ * path never has to wait for an ESC response.
+ */
+
+#pragma once
+
+#include <pthread.h>
+
+#include <drivers/drv_hrt.h>
+#include <lib/perf/perf_counter.h>
+#include <px4_platform_common/atomic.h>
+
+#include "voxl_esc_serial.hpp"
+#include "qc_esc_packet.h"
+
+class VoxlEscRx
+{
+public:
+	/**
+	 * Called on the receive thread for every complete packet with a valid checksum.
+	 * @param context user context passed to the constructor
+	 * @param packet parsed packet, only valid for the duration of the call
+	 * @param timestamp time the bytes containing the end of the packet were read
+	 */
+	typedef void (*packet_callback_t)(void *context, EscPacket *packet, hrt_abstime timestamp);
+
+	VoxlEscRx(VoxlEscSerial *uart, packet_callback_t callback, void *context);
+	~VoxlEscRx();
+
+	/**
+	 * Start the receive thread. The UART must already be open.
+	 */
+	int start();
+
+	/**
+	 * Request the receive thread to exit and wait for it.
+	 */
+	void stop();
+
+	bool running() const { return _running.load(); }
+
+	/**
+	 * Wait until more than packet_count packets have been received in total.
+	 * @param packet_count value of packet_count() sampled before the request was sent
+	 * @param timeout_us maximum time to wait
+	 * @return true if a packet arrived in time
+	 */
+	bool wait_for_packet(uint32_t packet_count, uint32_t timeout_us) const;
+
+	uint32_t packet_count() const { return _packet_count.load(); }
+	uint32_t crc_error_count() const { return _crc_error_count.load(); }
+	uint32_t length_error_count() const { return _length_error_count.load(); }
+
+	void print_status();
+
+private:
+	static constexpr int POLL_TIMEOUT_MS = 10;
+
+	static void *start_trampoline(void *context);
+	void run();
+
+	VoxlEscSerial		*_uart;
+	packet_callback_t	_callback;
+	void			*_context;
+
+	pthread_t		_thread{};
+	px4::atomic_bool	_should_exit{false};
+	px4::atomic_bool	_running{false};
+
+	px4::atomic<uint32_t>	_packet_count{0};
+	px4::atomic<uint32_t>	_crc_error_count{0};
+	px4::atomic<uint32_t>	_length_error_count{0};
+
+	EscPacket		_packet;
+	uint8_t			_read_buf[128];
+
+	perf_counter_t		_read_perf{perf_alloc(PC_COUNT, "voxl_esc: rx read")};
+	perf_counter_t		_packet_interval_perf{perf_alloc(PC_INTERVAL, "voxl_esc: rx packet interval")};
+};
@@ -34,6 +34,10 @@
 #include "string.h"
 #include "voxl_esc_serial.hpp"
 
+#ifndef __PX4_QURT
+#include <poll.h>
+#endif
+
 VoxlEscSerial::VoxlEscSerial()
 {
 }
@@ -189,3 +193,21 @@ int VoxlEscSerial::uart_read(FAR void *buf, size_t len)
 	return read(_uart_fd, buf, len);
 #endif
 }
+
+int VoxlEscSerial::uart_poll(int timeout_ms)
+{
+	if (_uart_fd < 0) {
+		return -1;
+	}
+
+#ifdef __PX4_QURT
+	// no poll on SLPI, uart_read() itself waits for data with a timeout
+	return 1;
+#else
+	pollfd fds[1] {};
+	fds[0].fd = _uart_fd;
+	fds[0].events = POLLIN;
+
+	return ::poll(fds, 1, timeout_ms);
+#endif
+}
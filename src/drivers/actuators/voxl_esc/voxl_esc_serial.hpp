@@ -54,6 +54,7 @@ public:
 	int		uart_close();
 	int		uart_write(FAR void *buf, size_t len);
 	int		uart_read(FAR void *buf, size_t len);
+	int		uart_poll(int timeout_ms);
 	bool		is_open() { return _uart_fd >= 0; };
 	int		uart_get_baud() {return _speed; }
 
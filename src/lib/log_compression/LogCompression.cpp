@@ -0,0 +1,575 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "LogCompression.hpp"
+
+#include <stdlib.h>
+#include <string.h>
+
+namespace log_compression
+{
+
+static constexpr int MIN_MATCH = 4;
+static constexpr int LAST_LITERALS = 5; ///< the last 5 bytes of a block are always literals
+static constexpr int MF_LIMIT = 12; ///< the last match must start at least 12 bytes before the end of the block
+static constexpr int SKIP_TRIGGER = 6;
+static constexpr size_t MAX_OFFSET = 65535;
+
+static constexpr uint8_t FRAME_FLG = (1 << 6) | (1 << 5) | (1 << 3); ///< version 1, independent blocks, content size
+static constexpr uint8_t FRAME_BD = 4 << 4; ///< 64KB maximum block size
+static constexpr uint32_t UNCOMPRESSED_BLOCK = 0x80000000u;
+
+static inline uint32_t read32(const uint8_t *p)
+{
+	uint32_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline uint32_t readLE32(const uint8_t *p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void writeLE32(uint8_t *p, uint32_t v)
+{
+	p[0] = v;
+	p[1] = v >> 8;
+	p[2] = v >> 16;
+	p[3] = v >> 24;
+}
+
+static inline uint32_t hash(uint32_t sequence)
+{
+	return (sequence * 2654435761u) >> (32 - HASH_LOG);
+}
+
+static inline uint32_t rotl32(uint32_t x, int r)
+{
+	return (x << r) | (x >> (32 - r));
+}
+
+/**
+ * xxHash32 (seed 0) of less than 16 bytes, as used for the frame header checksum
+ */
+static uint32_t xxh32Short(const uint8_t *p, size_t len)
+{
+	static constexpr uint32_t PRIME1 = 2654435761u;
+	static constexpr uint32_t PRIME2 = 2246822519u;
+	static constexpr uint32_t PRIME3 = 3266489917u;
+	static constexpr uint32_t PRIME4 = 668265263u;
+	static constexpr uint32_t PRIME5 = 374761393u;
+
+	uint32_t h = PRIME5 + (uint32_t)len;
+	const uint8_t *end = p + len;
+
+	while (p + 4 <= end) {
+		h += readLE32(p) * PRIME3;
+		h = rotl32(h, 17) * PRIME4;
+		p += 4;
+	}
+
+	while (p < end) {
+		h += (*p) * PRIME5;
+		h = rotl32(h, 11) * PRIME1;
+		++p;
+	}
+
+	h ^= h >> 15;
+	h *= PRIME2;
+	h ^= h >> 13;
+	h *= PRIME3;
+	h ^= h >> 16;
+	return h;
+}
+
+static inline uint8_t *writeLength(uint8_t *op, size_t length)
+{
+	while (length >= 255) {
+		*op++ = 255;
+		length -= 255;
+	}
+
+	*op++ = (uint8_t)length;
+	return op;
+}
+
+static inline size_t sequenceSize(size_t literals, size_t match_length)
+{
+	// token, literal length bytes, literals, offset, match length bytes
+	return 1 + (literals + 240) / 255 + literals + 2 + (match_length + 240) / 255;
+}
+
+size_t compressBlock(const uint8_t *src, size_t src_size, uint8_t *dst, size_t dst_capacity, int acceleration,
+		     uint16_t *hash_table)
+{
+	const uint8_t *ip = src;
+	const uint8_t *anchor = src;
+	const uint8_t *const iend = src + src_size;
+	uint8_t *op = dst;
+	uint8_t *const oend = dst + dst_capacity;
+
+	if (acceleration < 1) {
+		acceleration = 1;
+	}
+
+	if (src_size > MAX_OFFSET + 1) {
+		return 0; // positions must fit into the hash table
+	}
+
+	if (src_size >= (size_t)MF_LIMIT + 1) {
+		const uint8_t *const mflimit = iend - MF_LIMIT;
+		const uint8_t *const matchlimit = iend - LAST_LITERALS;
+
+		memset(hash_table, 0, HASH_TABLE_SIZE * sizeof(hash_table[0]));
+		++ip;
+
+		while (true) {
+			// find a match
+			const uint8_t *match;
+			const uint8_t *forward_ip = ip;
+			unsigned search_match_nb = (unsigned)acceleration << SKIP_TRIGGER;
+
+			do {
+				const uint32_t h = hash(read32(forward_ip));
+				ip = forward_ip;
+				forward_ip += search_match_nb++ >> SKIP_TRIGGER;
+
+				if (forward_ip > mflimit) {
+					goto last_literals;
+				}
+
+				match = src + hash_table[h];
+				hash_table[h] = (uint16_t)(ip - src);
+
+			} while (match >= ip || read32(match) != read32(ip));
+
+			// extend backwards
+			while (ip > anchor && match > src && ip[-1] == match[-1]) {
+				--ip;
+				--match;
+			}
+
+			// match length
+			const uint8_t *mp = match + MIN_MATCH;
+			const uint8_t *p = ip + MIN_MATCH;
+
+			while (p < matchlimit && *p == *mp) {
+				++p;
+				++mp;
+			}
+
+			const size_t literals = ip - anchor;
+			const size_t match_length = p - ip - MIN_MATCH;
+
+			if (op + sequenceSize(literals, match_length) > oend) {
+				return 0;
+			}
+
+			uint8_t *token = op++;
+
+			if (literals >= 15) {
+				*token = 15 << 4;
+				op = writeLength(op, literals - 15);
+
+			} else {
+				*token = literals << 4;
+			}
+
+			memcpy(op, anchor, literals);
+			op += literals;
+
+			const size_t offset = ip - match;
+			*op++ = offset;
+			*op++ = offset >> 8;
+
+			if (match_length >= 15) {
+				*token |= 15;
+				op = writeLength(op, match_length - 15);
+
+			} else {
+				*token |= match_length;
+			}
+
+			ip = p;
+			anchor = ip;
+
+			if (ip > mflimit) {
+				break;
+			}
+
+			hash_table[hash(read32(ip - 2))] = (uint16_t)(ip - 2 - src);
+		}
+	}
+
+last_literals:
+	const size_t literals = iend - anchor;
+
+	if (op + 1 + (literals + 240) / 255 + literals > oend) {
+		return 0;
+	}
+
+	if (literals >= 15) {
+		*op++ = 15 << 4;
+		op = writeLength(op, literals - 15);
+
+	} else {
+		*op++ = literals << 4;
+	}
+
+	memcpy(op, anchor, literals);
+	op += literals;
+
+	return op - dst;
+}
+
+int decompressBlock(const uint8_t *src, size_t src_size, uint8_t *dst, size_t dst_capacity)
+{
+	const uint8_t *ip = src;
+	const uint8_t *const iend = src + src_size;
+	uint8_t *op = dst;
+	uint8_t *const oend = dst + dst_capacity;
+
+	while (ip < iend) {
+		const uint8_t token = *ip++;
+
+		// literals
+		size_t length = token >> 4;
+
+		if (length == 15) {
+			uint8_t b;
+
+			do {
+				if (ip >= iend) {
+					return -1;
+				}
+
+				b = *ip++;
+				length += b;
+			} while (b == 255);
+		}
+
+		if (length > (size_t)(iend - ip) || length > (size_t)(oend - op)) {
+			return -1;
+		}
+
+		memcpy(op, ip, length);
+		ip += length;
+		op += length;
+
+		if (ip == iend) {
+			break; // the last sequence only contains literals
+		}
+
+		// match
+		if (iend - ip < 2) {
+			return -1;
+		}
+
+		const size_t offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+
+		if (offset == 0 || offset > (size_t)(op - dst)) {
+			return -1;
+		}
+
+		length = token & 15;
+
+		if (length == 15) {
+			uint8_t b;
+
+			do {
+				if (ip >= iend) {
+					return -1;
+				}
+
+				b = *ip++;
+				length += b;
+			} while (b == 255);
+		}
+
+		length += MIN_MATCH;
+
+		if (length > (size_t)(oend - op)) {
+			return -1;
+		}
+
+		// the match can overlap with the output, so copy byte by byte
+		const uint8_t *match = op - offset;
+
+		for (size_t i = 0; i < length; ++i) {
+			op[i] = match[i];
+		}
+
+		op += length;
+	}
+
+	return op - dst;
+}
+
+bool FrameEncoder::allocate(int acceleration)
+{
+	_acceleration = acceleration;
+	_block_size = 0;
+
+	if (_block == nullptr) {
+		_block = (uint8_t *)malloc(BLOCK_SIZE);
+		_hash_table = (uint16_t *)malloc(HASH_TABLE_SIZE * sizeof(uint16_t));
+
+		if (_block == nullptr || _hash_table == nullptr) {
+			deallocate();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void FrameEncoder::deallocate()
+{
+	free(_block);
+	_block = nullptr;
+	free(_hash_table);
+	_hash_table = nullptr;
+	_block_size = 0;
+}
+
+size_t FrameEncoder::append(const void *data, size_t size)
+{
+	if (size > BLOCK_SIZE - _block_size) {
+		size = BLOCK_SIZE - _block_size;
+	}
+
+	memcpy(_block + _block_size, data, size);
+	_block_size += size;
+	return size;
+}
+
+size_t FrameEncoder::encodeFrame(uint8_t *frame)
+{
+	if (_block_size == 0) {
+		return 0;
+	}
+
+	// frame header
+	writeLE32(frame, FRAME_MAGIC);
+	frame[4] = FRAME_FLG;
+	frame[5] = FRAME_BD;
+
+	for (int i = 0; i < 8; ++i) {
+		frame[6 + i] = (uint8_t)((uint64_t)_block_size >> (8 * i));
+	}
+
+	frame[14] = (xxh32Short(frame + 4, 10) >> 8) & 0xff;
+
+	// single data block, stored uncompressed if it does not get smaller
+	uint8_t *block = frame + FRAME_HEADER_SIZE;
+	size_t block_size = compressBlock(_block, _block_size, block + 4, _block_size - 1, _acceleration, _hash_table);
+
+	if (block_size == 0) {
+		memcpy(block + 4, _block, _block_size);
+		block_size = _block_size;
+		writeLE32(block, block_size | UNCOMPRESSED_BLOCK);
+
+	} else {
+		writeLE32(block, block_size);
+	}
+
+	// end mark
+	writeLE32(block + 4 + block_size, 0);
+
+	_block_size = 0;
+	return FRAME_OVERHEAD + block_size;
+}
+
+bool isCompressed(const uint8_t *data, size_t size)
+{
+	return size >= 4 && readLE32(data) == FRAME_MAGIC;
+}
+
+bool parseFrame(const uint8_t *data, size_t size, FrameInfo &info)
+{
+	if (size < 8) {
+		return false;
+	}
+
+	const uint32_t magic = readLE32(data);
+
+	if ((magic & 0xfffffff0u) == 0x184D2A50u) {
+		// skippable frame: magic, size, user data
+		info.header_size = 8;
+		info.frame_size = 8 + (size_t)readLE32(data + 4);
+		info.content_size = 0;
+		info.content_size_exact = true;
+		info.skippable = true;
+		return info.frame_size <= size;
+	}
+
+	if (magic != FRAME_MAGIC || size < 7) {
+		return false;
+	}
+
+	const uint8_t flg = data[4];
+	const uint8_t bd = data[5];
+
+	if ((flg >> 6) != 1 || !(flg & (1 << 5)) || (flg & (1 << 0))) {
+		return false; // unsupported version, linked blocks or dictionary
+	}
+
+	const bool has_block_checksum = flg & (1 << 4);
+	const bool has_content_size = flg & (1 << 3);
+	const bool has_content_checksum = flg & (1 << 2);
+	const size_t max_block_size = (size_t)1 << (8 + 2 * ((bd >> 4) & 7));
+
+	info.header_size = 4 + 2 + (has_content_size ? 8 : 0) + 1;
+	info.content_size = 0;
+	info.content_size_exact = has_content_size;
+	info.skippable = false;
+
+	if (size < info.header_size) {
+		return false;
+	}
+
+	if (has_content_size) {
+		for (int i = 0; i < 8; ++i) {
+			info.content_size |= (uint64_t)data[6 + i] << (8 * i);
+		}
+	}
+
+	// walk the blocks
+	size_t position = info.header_size;
+	uint64_t max_content_size = 0;
+
+	while (true) {
+		if (size - position < 4) {
+			return false;
+		}
+
+		const uint32_t block_size = readLE32(data + position) & ~UNCOMPRESSED_BLOCK;
+		position += 4;
+
+		if (block_size == 0) {
+			break; // end mark
+		}
+
+		const size_t block_total = block_size + (has_block_checksum ? 4 : 0);
+
+		if (size - position < block_total) {
+			return false;
+		}
+
+		position += block_total;
+		max_content_size += max_block_size;
+	}
+
+	if (has_content_checksum) {
+		if (size - position < 4) {
+			return false;
+		}
+
+		position += 4;
+	}
+
+	if (!has_content_size) {
+		info.content_size = max_content_size;
+	}
+
+	info.frame_size = position;
+	return true;
+}
+
+uint64_t decompressedSize(const uint8_t *data, size_t size)
+{
+	uint64_t total = 0;
+	size_t position = 0;
+	FrameInfo info;
+
+	while (position < size && parseFrame(data + position, size - position, info)) {
+		total += info.content_size;
+		position += info.frame_size;
+	}
+
+	return total;
+}
+
+int64_t decompress(const uint8_t *data, size_t size, uint8_t *dst, uint64_t dst_capacity)
+{
+	uint64_t written = 0;
+	size_t position = 0;
+	FrameInfo info;
+
+	while (position < size && parseFrame(data + position, size - position, info)) {
+		if (!info.skippable) {
+			const bool has_block_checksum = data[position + 4] & (1 << 4);
+			size_t block_position = position + info.header_size;
+
+			while (true) {
+				const uint32_t block_header = readLE32(data + block_position);
+				const uint32_t block_size = block_header & ~UNCOMPRESSED_BLOCK;
+				block_position += 4;
+
+				if (block_size == 0) {
+					break;
+				}
+
+				const uint64_t capacity = dst_capacity - written;
+
+				if (block_header & UNCOMPRESSED_BLOCK) {
+					if (block_size > capacity) {
+						return -1;
+					}
+
+					memcpy(dst + written, data + block_position, block_size);
+					written += block_size;
+
+				} else {
+					const int ret = decompressBlock(data + block_position, block_size, dst + written, (size_t)capacity);
+
+					if (ret < 0) {
+						return -1;
+					}
+
+					written += ret;
+				}
+
+				block_position += block_size + (has_block_checksum ? 4 : 0);
+			}
+		}
+
+		position += info.frame_size;
+	}
+
+	return written;
+}
+
+} // namespace log_compression
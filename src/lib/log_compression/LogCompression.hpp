@@ -0,0 +1,169 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file LogCompression.hpp
+ *
+ * Streaming LZ4 compression for log files.
+ *
+ * The output is a sequence of LZ4 frames (https://github.com/lz4/lz4/blob/dev/doc/lz4_Frame_format.md),
+ * one per block of input data. Each frame stores the uncompressed size of its block in the frame header,
+ * so a reader can build an index of the file by walking the frame headers, and then decompress any block
+ * independently. The files can be decompressed with the standard lz4 tools.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace log_compression
+{
+
+static constexpr uint32_t FRAME_MAGIC = 0x184D2204;
+static constexpr size_t FRAME_HEADER_SIZE = 4 + 2 + 8 + 1; ///< magic, FLG & BD, content size, header checksum
+static constexpr size_t FRAME_OVERHEAD = FRAME_HEADER_SIZE + 4 + 4; ///< frame header, block size, end mark
+
+#if defined(__PX4_NUTTX)
+static constexpr size_t BLOCK_SIZE = 16 * 1024;
+#else
+static constexpr size_t BLOCK_SIZE = 64 * 1024; ///< maximum LZ4 block size of the frames (must be <= 64KB)
+#endif
+
+/** maximum size of a frame for BLOCK_SIZE input bytes (a block is stored uncompressed if it does not compress) */
+static constexpr size_t MAX_FRAME_SIZE = BLOCK_SIZE + FRAME_OVERHEAD;
+
+/**
+ * Compress a block in the LZ4 block format (greedy match search).
+ * @param acceleration >= 1, higher values are faster but compress less
+ * @param hash_table scratch space of HASH_TABLE_SIZE entries
+ * @return compressed size, or 0 if the output does not fit into dst_capacity
+ */
+size_t compressBlock(const uint8_t *src, size_t src_size, uint8_t *dst, size_t dst_capacity, int acceleration,
+		     uint16_t *hash_table);
+
+static constexpr int HASH_LOG = 12;
+static constexpr size_t HASH_TABLE_SIZE = 1 << HASH_LOG;
+
+/**
+ * Decompress an LZ4 block
+ * @return decompressed size, or -1 if the input is corrupt or does not fit into dst_capacity
+ */
+int decompressBlock(const uint8_t *src, size_t src_size, uint8_t *dst, size_t dst_capacity);
+
+/**
+ * @class FrameEncoder
+ * Collects input data into blocks of BLOCK_SIZE and encodes each block as an LZ4 frame.
+ */
+class FrameEncoder
+{
+public:
+	FrameEncoder() = default;
+	~FrameEncoder() { deallocate(); }
+
+	FrameEncoder(const FrameEncoder &) = delete;
+	FrameEncoder &operator=(const FrameEncoder &) = delete;
+
+	/**
+	 * Allocate the input block and the hash table
+	 * @param acceleration see compressBlock()
+	 * @return false if the allocation failed
+	 */
+	bool allocate(int acceleration);
+
+	void deallocate();
+
+	bool allocated() const { return _block != nullptr; }
+
+	/**
+	 * Add data to the current block
+	 * @return number of bytes consumed (less than size if the block is full)
+	 */
+	size_t append(const void *data, size_t size);
+
+	bool full() const { return _block_size == BLOCK_SIZE; }
+
+	/** @return number of buffered input bytes */
+	size_t pending() const { return _block_size; }
+
+	/**
+	 * Encode the buffered data as a frame and clear the block
+	 * @param frame output buffer of at least MAX_FRAME_SIZE bytes
+	 * @return frame size (0 if there was no data)
+	 */
+	size_t encodeFrame(uint8_t *frame);
+
+	void reset() { _block_size = 0; }
+
+private:
+	uint8_t *_block{nullptr};
+	size_t _block_size{0};
+	uint16_t *_hash_table{nullptr};
+	int _acceleration{1};
+};
+
+/**
+ * Information about a frame, parsed from its header
+ */
+struct FrameInfo {
+	size_t header_size;  ///< size of the frame header
+	size_t frame_size;   ///< total size of the frame (0 for skippable frames if the size is unknown)
+	uint64_t content_size; ///< uncompressed size
+	bool content_size_exact; ///< false if the frame header has no content size and content_size is an upper bound
+	bool skippable;
+};
+
+/**
+ * Parse the frame starting at data. Frames without a content size in the header are scanned block by block,
+ * and their content size is set to the sum of the (maximum) block sizes. Only frames with independent
+ * blocks are supported.
+ * @return false if the data does not start with a valid or complete frame
+ */
+bool parseFrame(const uint8_t *data, size_t size, FrameInfo &info);
+
+/** @return true if data starts with the LZ4 frame magic */
+bool isCompressed(const uint8_t *data, size_t size);
+
+/**
+ * Get the uncompressed size of a sequence of frames by walking the frame headers.
+ * A truncated last frame is ignored (e.g. after a power loss).
+ */
+uint64_t decompressedSize(const uint8_t *data, size_t size);
+
+/**
+ * Decompress a sequence of frames
+ * @return number of decompressed bytes, or -1 on error
+ */
+int64_t decompress(const uint8_t *data, size_t size, uint8_t *dst, uint64_t dst_capacity);
+
+} // namespace log_compression
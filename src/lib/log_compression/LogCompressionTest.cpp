@@ -0,0 +1,202 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+#include "LogCompression.hpp"
+
+using namespace log_compression;
+
+static std::vector<uint8_t> encode(const std::vector<uint8_t> &data, int acceleration)
+{
+	FrameEncoder encoder;
+	EXPECT_TRUE(encoder.allocate(acceleration));
+
+	std::vector<uint8_t> output;
+	std::vector<uint8_t> frame(MAX_FRAME_SIZE);
+	size_t position = 0;
+
+	while (position < data.size()) {
+		position += encoder.append(data.data() + position, data.size() - position);
+
+		if (encoder.full() || position == data.size()) {
+			const size_t frame_size = encoder.encodeFrame(frame.data());
+			EXPECT_LE(frame_size, MAX_FRAME_SIZE);
+			output.insert(output.end(), frame.begin(), frame.begin() + frame_size);
+		}
+	}
+
+	return output;
+}
+
+static std::vector<uint8_t> logLikeData(size_t size)
+{
+	// fixed size records with a timestamp and slowly changing values, similar to ULog data messages
+	std::vector<uint8_t> data;
+	uint64_t timestamp = 1000000;
+	uint32_t seed = 1;
+
+	while (data.size() < size) {
+		uint8_t record[48] {};
+		record[0] = sizeof(record) - 3;
+		record[2] = 'D';
+		record[3] = (timestamp / 4000) % 7;
+		memcpy(&record[5], &timestamp, sizeof(timestamp));
+
+		for (size_t i = 13; i + sizeof(float) <= sizeof(record); i += sizeof(float)) {
+			seed = seed * 1103515245 + 12345;
+			float value = (float)((seed >> 16) % 4) * 0.5f;
+			memcpy(&record[i], &value, sizeof(value));
+		}
+
+		data.insert(data.end(), record, record + sizeof(record));
+		timestamp += 4000;
+	}
+
+	data.resize(size);
+	return data;
+}
+
+static void expectRoundTrip(const std::vector<uint8_t> &data, int acceleration)
+{
+	const std::vector<uint8_t> compressed = encode(data, acceleration);
+	ASSERT_TRUE(data.empty() || isCompressed(compressed.data(), compressed.size()));
+	ASSERT_EQ(decompressedSize(compressed.data(), compressed.size()), data.size());
+
+	std::vector<uint8_t> decompressed(data.size() + 1);
+	ASSERT_EQ(decompress(compressed.data(), compressed.size(), decompressed.data(), decompressed.size()),
+		  (int64_t)data.size());
+	EXPECT_EQ(memcmp(decompressed.data(), data.data(), data.size()), 0);
+}
+
+TEST(LogCompressionTest, RoundTripLogData)
+{
+	const std::vector<uint8_t> data = logLikeData(5 * BLOCK_SIZE + 123);
+
+	for (int acceleration : {1, 4, 16}) {
+		expectRoundTrip(data, acceleration);
+	}
+
+	// log data is expected to compress well
+	EXPECT_LT(encode(data, 1).size(), data.size() * 3 / 4);
+}
+
+TEST(LogCompressionTest, RoundTripIncompressible)
+{
+	std::vector<uint8_t> data(2 * BLOCK_SIZE + 7);
+	uint32_t seed = 42;
+
+	for (uint8_t &byte : data) {
+		seed = seed * 1664525 + 1013904223;
+		byte = seed >> 24;
+	}
+
+	expectRoundTrip(data, 1);
+
+	// stored as uncompressed blocks: bounded overhead
+	EXPECT_LE(encode(data, 1).size(), data.size() + 3 * FRAME_OVERHEAD);
+}
+
+TEST(LogCompressionTest, RoundTripSmallAndRepetitive)
+{
+	for (size_t size : {0, 1, 5, 12, 13, 17, 100, 1000}) {
+		std::vector<uint8_t> data(size, 'a');
+		expectRoundTrip(data, 1);
+		expectRoundTrip(logLikeData(size), 1);
+	}
+
+	// long runs need length extension bytes
+	expectRoundTrip(std::vector<uint8_t>(BLOCK_SIZE, 0), 1);
+}
+
+TEST(LogCompressionTest, RandomAccess)
+{
+	const std::vector<uint8_t> data = logLikeData(3 * BLOCK_SIZE + 1000);
+	const std::vector<uint8_t> compressed = encode(data, 1);
+
+	// walk the frames, and decompress each one on its own
+	size_t position = 0;
+	uint64_t content_position = 0;
+	FrameInfo info;
+	int frames = 0;
+
+	while (position < compressed.size()) {
+		ASSERT_TRUE(parseFrame(compressed.data() + position, compressed.size() - position, info));
+		EXPECT_FALSE(info.skippable);
+		EXPECT_TRUE(info.content_size_exact);
+
+		std::vector<uint8_t> block(info.content_size);
+		ASSERT_EQ(decompress(compressed.data() + position, info.frame_size, block.data(), block.size()),
+			  (int64_t)info.content_size);
+		EXPECT_EQ(memcmp(block.data(), data.data() + content_position, block.size()), 0);
+
+		position += info.frame_size;
+		content_position += info.content_size;
+		++frames;
+	}
+
+	EXPECT_EQ(frames, 4);
+	EXPECT_EQ(content_position, data.size());
+}
+
+TEST(LogCompressionTest, TruncatedFile)
+{
+	const std::vector<uint8_t> data = logLikeData(2 * BLOCK_SIZE + 1000);
+	const std::vector<uint8_t> compressed = encode(data, 1);
+
+	// a partially written last frame (e.g. power loss) is ignored
+	const size_t truncated_size = compressed.size() - 10;
+	ASSERT_EQ(decompressedSize(compressed.data(), truncated_size), 2 * BLOCK_SIZE);
+
+	std::vector<uint8_t> decompressed(2 * BLOCK_SIZE);
+	ASSERT_EQ(decompress(compressed.data(), truncated_size, decompressed.data(), decompressed.size()),
+		  (int64_t)(2 * BLOCK_SIZE));
+	EXPECT_EQ(memcmp(decompressed.data(), data.data(), decompressed.size()), 0);
+}
+
+TEST(LogCompressionTest, CorruptBlock)
+{
+	const std::vector<uint8_t> data = logLikeData(1000);
+	std::vector<uint8_t> compressed = encode(data, 1);
+
+	// a match offset pointing before the start of the output
+	uint8_t block[] = {0x10, 'a', 0x05, 0x00};
+	uint8_t output[64];
+	EXPECT_EQ(decompressBlock(block, sizeof(block), output, sizeof(output)), -1);
+
+	// output too small
+	EXPECT_EQ(decompress(compressed.data(), compressed.size(), output, sizeof(output)), -1);
+}
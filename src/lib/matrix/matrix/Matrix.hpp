@@ -13,6 +13,7 @@
 #include <cstring>
 
 #include "helper_functions.hpp"
+#include "simd.hpp"
 #include "Slice.hpp"
 
 namespace matrix
@@ -151,6 +152,17 @@ public:
 		const Matrix<Type, M, N> &self = *this;
 		Matrix<Type, M, P> res{};
 
+		if (simd::enabled<Type>(P)) {
+			// accumulate scaled rows of other, same summation order as below
+			for (size_t i = 0; i < M; i++) {
+				for (size_t j = 0; j < N; j++) {
+					simd::axpy(&res(i, 0), self(i, j), &other(j, 0), P);
+				}
+			}
+
+			return res;
+		}
+
 		for (size_t i = 0; i < M; i++) {
 			for (size_t k = 0; k < P; k++) {
 				for (size_t j = 0; j < N; j++) {
@@ -440,8 +452,23 @@ public:
 		Matrix<Type, N, M> res;
 		const Matrix<Type, M, N> &self = *this;
 
+		// rows and columns already covered by 4x4 tiles
+		size_t i0 = 0;
+		size_t j0 = 0;
+
+		if (simd::enabled<Type>(M) && simd::enabled<Type>(N)) {
+			i0 = M - M % 4;
+			j0 = N - N % 4;
+
+			for (size_t i = 0; i < i0; i += 4) {
+				for (size_t j = 0; j < j0; j += 4) {
+					simd::transpose4x4(&self(i, j), N, &res(j, i), M);
+				}
+			}
+		}
+
 		for (size_t i = 0; i < M; i++) {
-			for (size_t j = 0; j < N; j++) {
+			for (size_t j = (i < i0) ? j0 : 0; j < N; j++) {
 				res(j, i) = self(i, j);
 			}
 		}
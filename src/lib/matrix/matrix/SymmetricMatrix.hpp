@@ -0,0 +1,312 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file SymmetricMatrix.hpp
+ *
+ * A symmetric square matrix, only the upper triangle is stored
+ * (row-major, M * (M + 1) / 2 elements).
+ *
+ * Element (i, j) and (j, i) are the same storage, so writing one of them
+ * writes both.
+ */
+
+#pragma once
+
+#include "SquareMatrix.hpp"
+#include "Vector.hpp"
+
+namespace matrix
+{
+
+template<typename Type, size_t M>
+class SymmetricMatrix
+{
+	Type _data[M * (M + 1) / 2] {};
+
+	// offset of element (i, j) in the packed upper triangle, i <= j
+	static constexpr size_t index(size_t i, size_t j)
+	{
+		return i * (2 * M - i - 1) / 2 + j;
+	}
+
+public:
+	SymmetricMatrix() = default;
+
+	// takes the upper triangle of a (symmetric) square matrix
+	explicit SymmetricMatrix(const Matrix<Type, M, M> &other)
+	{
+		for (size_t i = 0; i < M; i++) {
+			for (size_t j = i; j < M; j++) {
+				_data[index(i, j)] = other(i, j);
+			}
+		}
+	}
+
+	inline const Type &operator()(size_t i, size_t j) const
+	{
+		assert(i < M);
+		assert(j < M);
+
+		return (i <= j) ? _data[index(i, j)] : _data[index(j, i)];
+	}
+
+	inline Type &operator()(size_t i, size_t j)
+	{
+		assert(i < M);
+		assert(j < M);
+
+		return (i <= j) ? _data[index(i, j)] : _data[index(j, i)];
+	}
+
+	// number of elements stored
+	static constexpr size_t size()
+	{
+		return M * (M + 1) / 2;
+	}
+
+	SquareMatrix<Type, M> unpack() const
+	{
+		SquareMatrix<Type, M> res;
+		const SymmetricMatrix<Type, M> &self = *this;
+
+		for (size_t i = 0; i < M; i++) {
+			for (size_t j = 0; j < M; j++) {
+				res(i, j) = self(i, j);
+			}
+		}
+
+		return res;
+	}
+
+	// same summation order as the full matrix product
+	Vector<Type, M> operator*(const Matrix<Type, M, 1> &other) const
+	{
+		Vector<Type, M> res;
+
+		for (size_t i = 0; i < M; i++) {
+			Type sum = 0;
+
+			// column i of the upper triangle, then the contiguous part of row i
+			for (size_t j = 0; j < i; j++) {
+				sum += _data[index(j, i)] * other(j, 0);
+			}
+
+			const Type *row_i = &_data[index(i, i)];
+
+			for (size_t j = i; j < M; j++) {
+				sum += row_i[j - i] * other(j, 0);
+			}
+
+			res(i) = sum;
+		}
+
+		return res;
+	}
+
+	Vector<Type, M> row(size_t i) const
+	{
+		Vector<Type, M> res;
+		const SymmetricMatrix<Type, M> &self = *this;
+
+		for (size_t j = 0; j < M; j++) {
+			res(j) = self(i, j);
+		}
+
+		return res;
+	}
+
+	Vector<Type, M> col(size_t j) const
+	{
+		return row(j);
+	}
+
+	Vector<Type, M> diag() const
+	{
+		Vector<Type, M> res;
+
+		for (size_t i = 0; i < M; i++) {
+			res(i) = _data[index(i, i)];
+		}
+
+		return res;
+	}
+
+	template <size_t Width>
+	Type trace(size_t first) const
+	{
+		static_assert(Width <= M, "Width bigger than matrix");
+		assert(first + Width <= M);
+
+		Type res = 0;
+
+		for (size_t i = first; i < (first + Width); i++) {
+			res += _data[index(i, i)];
+		}
+
+		return res;
+	}
+
+	// diagonal block starting at (first, first)
+	template <size_t Width>
+	SquareMatrix<Type, Width> block(size_t first) const
+	{
+		static_assert(Width <= M, "Width bigger than matrix");
+		assert(first + Width <= M);
+
+		SquareMatrix<Type, Width> res;
+		const SymmetricMatrix<Type, M> &self = *this;
+
+		for (size_t i = 0; i < Width; i++) {
+			for (size_t j = 0; j < Width; j++) {
+				res(i, j) = self(first + i, first + j);
+			}
+		}
+
+		return res;
+	}
+
+	// set the diagonal block starting at (first, first) from the upper triangle of block
+	template <size_t Width>
+	void setBlock(size_t first, const SquareMatrix<Type, Width> &block)
+	{
+		static_assert(Width <= M, "Width bigger than matrix");
+		assert(first + Width <= M);
+
+		for (size_t i = 0; i < Width; i++) {
+			for (size_t j = i; j < Width; j++) {
+				_data[index(first + i, first + j)] = block(i, j);
+			}
+		}
+	}
+
+	void setZero()
+	{
+		memset(_data, 0, sizeof(_data));
+	}
+
+	inline void zero()
+	{
+		setZero();
+	}
+
+	// keep the sub covariance matrix and zero all covariance elements related
+	// to the rest of the matrix
+	template <size_t Width>
+	void uncorrelateCovarianceBlock(size_t first)
+	{
+		static_assert(Width <= M, "Width bigger than matrix");
+		assert(first + Width <= M);
+
+		SymmetricMatrix<Type, M> &self = *this;
+
+		for (size_t i = first; i < first + Width; i++) {
+			for (size_t j = 0; j < first; j++) {
+				self(i, j) = Type(0);
+			}
+
+			for (size_t j = first + Width; j < M; j++) {
+				self(i, j) = Type(0);
+			}
+		}
+	}
+
+	// zero all offdiagonal elements and keep corresponding diagonal elements
+	template <size_t Width>
+	void uncorrelateCovariance(size_t first)
+	{
+		static_assert(Width <= M, "Width bigger than matrix");
+		assert(first + Width <= M);
+
+		Vector<Type, Width> diag_elements;
+
+		for (size_t i = 0; i < Width; i++) {
+			diag_elements(i) = _data[index(first + i, first + i)];
+		}
+
+		uncorrelateCovarianceSetVariance(first, diag_elements);
+	}
+
+	template <size_t Width>
+	void uncorrelateCovarianceSetVariance(size_t first, const Vector<Type, Width> &vec)
+	{
+		static_assert(Width <= M, "Width bigger than matrix");
+		assert(first + Width <= M);
+
+		uncorrelateCovarianceSetVariance<Width>(first, Type(0));
+
+		// set diagonals
+		for (size_t i = 0; i < Width; i++) {
+			_data[index(first + i, first + i)] = vec(i);
+		}
+	}
+
+	template <size_t Width>
+	void uncorrelateCovarianceSetVariance(size_t first, Type val)
+	{
+		static_assert(Width <= M, "Width bigger than matrix");
+		assert(first + Width <= M);
+
+		SymmetricMatrix<Type, M> &self = *this;
+
+		// zero rows and columns
+		for (size_t i = first; i < first + Width; i++) {
+			for (size_t j = 0; j < M; j++) {
+				self(i, j) = Type(0);
+			}
+		}
+
+		// set diagonals
+		for (size_t i = first; i < first + Width; i++) {
+			_data[index(i, i)] = val;
+		}
+	}
+
+	bool isAllFinite() const
+	{
+		for (size_t i = 0; i < size(); i++) {
+			if (!std::isfinite(_data[i])) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	void print(float eps = 1e-9) const
+	{
+		unpack().print(eps);
+	}
+};
+
+} // namespace matrix
@@ -0,0 +1,142 @@
+/**
+ * @file simd.hpp
+ *
+ * Vectorised row kernels for single precision matrices.
+ *
+ * The kernels keep the per-element order of operations of the scalar loops,
+ * so they give the same results as the scalar code (on aarch64 the multiply-add
+ * is fused, like the compiler contracts the scalar loops there).
+ *
+ * Enabled on targets with SSE or NEON, define MATRIX_NO_SIMD to disable.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#if !defined(MATRIX_NO_SIMD) && (defined(__SSE__) || defined(__ARM_NEON))
+#define MATRIX_SIMD 1
+#endif
+
+#if defined(MATRIX_SIMD) && defined(__SSE__)
+#include <xmmintrin.h>
+#elif defined(MATRIX_SIMD)
+#include <arm_neon.h>
+#endif
+
+namespace matrix
+{
+
+namespace simd
+{
+
+// vector width in elements of Type, 1 if there are no vector kernels for Type
+template<typename Type>
+struct lanes {
+	static constexpr size_t value = 1;
+};
+
+#if defined(MATRIX_SIMD)
+template<>
+struct lanes<float> {
+	static constexpr size_t value = 4;
+};
+#endif
+
+// whether the vector kernels pay off for rows of n elements of Type
+template<typename Type>
+constexpr bool enabled(size_t n)
+{
+	return lanes<Type>::value > 1 && n >= lanes<Type>::value;
+}
+
+// y[0..n) += a * x[0..n)
+template<typename Type>
+inline void axpy(Type *y, Type a, const Type *x, size_t n)
+{
+	for (size_t i = 0; i < n; i++) {
+		y[i] += a * x[i];
+	}
+}
+
+// 4x4 tile transpose, src and dst rows are src_stride / dst_stride elements apart
+template<typename Type>
+inline void transpose4x4(const Type *src, size_t src_stride, Type *dst, size_t dst_stride)
+{
+	for (size_t i = 0; i < 4; i++) {
+		for (size_t j = 0; j < 4; j++) {
+			dst[j * dst_stride + i] = src[i * src_stride + j];
+		}
+	}
+}
+
+#if defined(MATRIX_SIMD) && defined(__SSE__)
+
+template<>
+inline void axpy<float>(float *y, float a, const float *x, size_t n)
+{
+	const __m128 va = _mm_set1_ps(a);
+	const size_t n4 = n - n % 4;
+	size_t i = 0;
+
+	for (; i < n4; i += 4) {
+		_mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(va, _mm_loadu_ps(x + i))));
+	}
+
+	for (; i < n; i++) {
+		y[i] += a * x[i];
+	}
+}
+
+template<>
+inline void transpose4x4<float>(const float *src, size_t src_stride, float *dst, size_t dst_stride)
+{
+	__m128 r0 = _mm_loadu_ps(src);
+	__m128 r1 = _mm_loadu_ps(src + src_stride);
+	__m128 r2 = _mm_loadu_ps(src + 2 * src_stride);
+	__m128 r3 = _mm_loadu_ps(src + 3 * src_stride);
+	_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+	_mm_storeu_ps(dst, r0);
+	_mm_storeu_ps(dst + dst_stride, r1);
+	_mm_storeu_ps(dst + 2 * dst_stride, r2);
+	_mm_storeu_ps(dst + 3 * dst_stride, r3);
+}
+
+#elif defined(MATRIX_SIMD)
+
+template<>
+inline void axpy<float>(float *y, float a, const float *x, size_t n)
+{
+	const size_t n4 = n - n % 4;
+	size_t i = 0;
+
+	for (; i < n4; i += 4) {
+#if defined(__aarch64__)
+		vst1q_f32(y + i, vfmaq_n_f32(vld1q_f32(y + i), vld1q_f32(x + i), a));
+#else
+		vst1q_f32(y + i, vmlaq_n_f32(vld1q_f32(y + i), vld1q_f32(x + i), a));
+#endif
+	}
+
+	for (; i < n; i++) {
+		y[i] += a * x[i];
+	}
+}
+
+template<>
+inline void transpose4x4<float>(const float *src, size_t src_stride, float *dst, size_t dst_stride)
+{
+	// interleave pairs of rows, then swap the 2x2 blocks
+	const float32x4x2_t t01 = vtrnq_f32(vld1q_f32(src), vld1q_f32(src + src_stride));
+	const float32x4x2_t t23 = vtrnq_f32(vld1q_f32(src + 2 * src_stride), vld1q_f32(src + 3 * src_stride));
+	vst1q_f32(dst, vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0])));
+	vst1q_f32(dst + dst_stride, vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1])));
+	vst1q_f32(dst + 2 * dst_stride, vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0])));
+	vst1q_f32(dst + 3 * dst_stride, vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1])));
+}
+
+#endif // MATRIX_SIMD
+
+} // namespace simd
+
+} // namespace matrix
@@ -98,3 +98,44 @@ TEST(MatrixMultiplicationTest, Multiplication)
 	Matrix<float, 4, 2> m42_plus2 = m42 - (-2);
 	EXPECT_EQ(m42_plus2, m42_plus2_check);
 }
+
+TEST(MatrixMultiplicationTest, MultiplicationVectorised)
+{
+	// integer valued entries keep the float products exact,
+	// so the (vectorised) float result has to match the integer one
+	// for row lengths that are and aren't a multiple of the vector width
+	Matrix<float, 5, 7> A;
+	Matrix<float, 7, 9> B;
+	Matrix<int, 5, 7> A_int;
+	Matrix<int, 7, 9> B_int;
+
+	for (size_t i = 0; i < 7; i++) {
+		for (size_t j = 0; j < 9; j++) {
+			B_int(i, j) = int((i * 9 + j) % 11) - 5;
+			B(i, j) = float(B_int(i, j));
+
+			if (i < 5 && j < 7) {
+				A_int(i, j) = int((i * 7 + j) % 13) - 6;
+				A(i, j) = float(A_int(i, j));
+			}
+		}
+	}
+
+	const Matrix<float, 5, 9> C = A * B;
+	const Matrix<int, 5, 9> C_int = A_int * B_int;
+
+	for (size_t i = 0; i < 5; i++) {
+		for (size_t j = 0; j < 9; j++) {
+			EXPECT_EQ(C(i, j), float(C_int(i, j)));
+		}
+	}
+
+	const Matrix<float, 5, 5> D = A * A.T();
+	const Matrix<int, 5, 5> D_int = A_int * A_int.T();
+
+	for (size_t i = 0; i < 5; i++) {
+		for (size_t j = 0; j < 5; j++) {
+			EXPECT_EQ(D(i, j), float(D_int(i, j)));
+		}
+	}
+}
@@ -45,3 +45,25 @@ TEST(MatrixTransposeTest, Transpose)
 	Matrix<float, 3, 2> A_T_check(data_check);
 	EXPECT_EQ(A_T, A_T_check);
 }
+
+TEST(MatrixTransposeTest, TransposeVectorised)
+{
+	// sizes with full 4x4 tiles and remaining rows and columns
+	Matrix<float, 9, 6> A;
+
+	for (size_t i = 0; i < 9; i++) {
+		for (size_t j = 0; j < 6; j++) {
+			A(i, j) = float(i * 6 + j);
+		}
+	}
+
+	const Matrix<float, 6, 9> A_T = A.transpose();
+
+	for (size_t i = 0; i < 9; i++) {
+		for (size_t j = 0; j < 6; j++) {
+			EXPECT_EQ(A_T(j, i), A(i, j));
+		}
+	}
+
+	EXPECT_EQ(A_T.transpose(), A);
+}
@@ -36,6 +36,10 @@
 #include <uORB/topics/obstacle_distance.h>
 #include <uORB/uORBManager.hpp>
 
+#include <limits.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <gtest/gtest.h>
 
 class ParameterTest : public ::testing::Test
@@ -78,6 +82,116 @@ TEST_F(ParameterTest, testParamReadWrite)
 	EXPECT_FLOAT_EQ(42.f, value2);
 }
 
+TEST_F(ParameterTest, testParamFind)
+{
+	// GIVEN: all parameters
+	for (unsigned i = 0; i < param_count(); i++) {
+		const param_t param = param_for_index(i);
+		const char *name = param_name(param);
+
+		// WHEN: we look up the parameter by name
+		// THEN: we get the same handle back
+		EXPECT_EQ(param, param_find_no_notification(name)) << name;
+	}
+
+	// WHEN: we look up names that do not exist (including prefixes and extensions of valid names)
+	// THEN: the lookup fails
+	EXPECT_EQ(PARAM_INVALID, param_find_no_notification(""));
+	EXPECT_EQ(PARAM_INVALID, param_find_no_notification("CP_DIS"));
+	EXPECT_EQ(PARAM_INVALID, param_find_no_notification("CP_DIST_"));
+	EXPECT_EQ(PARAM_INVALID, param_find_no_notification("cp_dist"));
+	EXPECT_EQ(PARAM_INVALID, param_find_no_notification("ZZZZZZZZZZZZZZZZ"));
+}
+
+TEST_F(ParameterTest, testNotifyBatch)
+{
+	// GIVEN: a parameter_update subscriber that is up to date
+	uORB::Subscription parameter_update_sub{ORB_ID(parameter_update)};
+	param_notify_changes();
+	parameter_update_s update{};
+	parameter_update_sub.update(&update);
+	const uint32_t instance = update.instance;
+
+	// WHEN: we change several parameters within a batch
+	param_notify_batch_begin();
+	const param_t param_a = param_handle(px4::params::CP_DIST);
+	const param_t param_b = param_handle(px4::params::CP_DELAY);
+	float value = 3.f;
+	EXPECT_EQ(0, param_set(param_a, &value));
+	EXPECT_EQ(0, param_set(param_b, &value));
+	param_reset(param_a);
+
+	// THEN: nothing is published until the batch ends
+	EXPECT_FALSE(parameter_update_sub.updated());
+	param_notify_batch_end();
+
+	// AND: then a single notification with both parameters marked as changed
+	ASSERT_TRUE(parameter_update_sub.update(&update));
+	EXPECT_EQ(instance + 1, update.instance);
+	EXPECT_TRUE(param_changed_in(param_a, update.changed_bitset));
+	EXPECT_TRUE(param_changed_in(param_b, update.changed_bitset));
+	EXPECT_FALSE(parameter_update_sub.updated());
+
+	// WHEN: setting a parameter to its current value
+	EXPECT_EQ(0, param_set(param_b, &value));
+	param_notify_changes();
+
+	// THEN: it is not marked as changed
+	ASSERT_TRUE(parameter_update_sub.update(&update));
+	EXPECT_FALSE(param_changed_in(param_b, update.changed_bitset));
+}
+
+TEST_F(ParameterTest, testSaveJournal)
+{
+	// GIVEN: a parameter file with a snapshot of the changed parameters
+	char previous_file[PATH_MAX] {};
+
+	if (param_get_default_file()) {
+		strncpy(previous_file, param_get_default_file(), sizeof(previous_file) - 1);
+	}
+
+	const char *filename = "parameter_test_journal.bson";
+	unlink(filename);
+	ASSERT_EQ(0, param_set_default_file(filename));
+
+	const param_t param_a = param_handle(px4::params::CP_DIST);
+	const param_t param_b = param_handle(px4::params::CP_DELAY);
+	float value = 3.f;
+	EXPECT_EQ(0, param_set(param_a, &value));
+	EXPECT_EQ(0, param_set(param_b, &value));
+	ASSERT_EQ(0, param_save_default(true));
+
+	struct stat st {};
+	ASSERT_EQ(0, stat(filename, &st));
+	const off_t snapshot_size = st.st_size;
+
+	// WHEN: we change and reset a parameter and save again
+	value = 4.f;
+	EXPECT_EQ(0, param_set(param_a, &value));
+	param_reset(param_b);
+	ASSERT_EQ(0, param_save_default(true));
+
+	// THEN: only the changes are appended to the file
+	ASSERT_EQ(0, stat(filename, &st));
+	EXPECT_GT(st.st_size, snapshot_size);
+	EXPECT_LE(st.st_size, snapshot_size + 2 * 32);
+
+	// AND: loading the file restores the latest values
+	param_reset_all();
+	EXPECT_EQ(0, param_load_default());
+
+	float value_a = 0.f;
+	float value_b = 0.f;
+	float default_b = 0.f;
+	param_get(param_a, &value_a);
+	param_get(param_b, &value_b);
+	param_get_system_default_value(param_b, &default_b);
+	EXPECT_FLOAT_EQ(4.f, value_a);
+	EXPECT_FLOAT_EQ(default_b, value_b);
+
+	unlink(filename);
+	param_set_default_file(previous_file[0] ? previous_file : nullptr);
+}
 
 TEST_F(ParameterTest, testUorbSendReceive)
 {
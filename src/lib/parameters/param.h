@@ -285,6 +285,42 @@ __EXPORT int		param_set_no_remote_update(param_t param, const void *val, bool no
  */
 __EXPORT void		param_notify_changes(void);
 
+/**
+ * Start a batch of parameter changes. Until the matching param_notify_batch_end(), notifications
+ * (from param_notify_changes(), param_set(), param_reset() etc.) are only recorded, and
+ * param_notify_batch_end() publishes a single notification for all of them.
+ * Batches can be nested. They are global and hold back the notifications of all threads,
+ * so keep them short.
+ */
+__EXPORT void		param_notify_batch_begin(void);
+
+/**
+ * End a batch of parameter changes started with param_notify_batch_begin().
+ * Publishes the pending notification if this ends the outermost batch.
+ */
+__EXPORT void		param_notify_batch_end(void);
+
+/**
+ * Size of the changed parameter bitset of the parameter_update notification, in 32 bit words.
+ * Parameter indices are folded into the bitset (index % (32 * PARAM_CHANGED_BITSET_WORDS)).
+ */
+#define PARAM_CHANGED_BITSET_WORDS 8
+
+/**
+ * Check a parameter against the changed bitset of a parameter_update notification.
+ * Only valid for notifications published by the same build: the parameter indices of another
+ * processor (e.g. parameter_update received via muorb on the VOXL2 SLPI) do not match.
+ *
+ * @param param		A handle returned by param_find or passed by param_foreach.
+ * @param changed_bitset	parameter_update_s::changed_bitset
+ * @return		true if the parameter (or another parameter folded into the same bit) changed
+ */
+static inline bool	param_changed_in(param_t param, const uint32_t changed_bitset[PARAM_CHANGED_BITSET_WORDS])
+{
+	const unsigned bit = (unsigned)param % (32 * PARAM_CHANGED_BITSET_WORDS);
+	return (param != PARAM_INVALID) && (changed_bitset[bit / 32] & (1u << (bit % 32)));
+}
+
 /**
  * Reset a parameter to its default value.
  *
@@ -0,0 +1,219 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "param_journal.h"
+
+#include <crc32.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <px4_platform_common/log.h>
+#include <px4_platform_common/posix.h>
+
+namespace param_journal
+{
+
+size_t encode(const Record &record, uint32_t snapshot_crc, uint8_t *buffer)
+{
+	const size_t name_length = strnlen(record.name, sizeof(record.name));
+
+	if (name_length == 0 || name_length > MAX_NAME_LENGTH) {
+		return 0;
+	}
+
+	size_t size = 0;
+	buffer[size++] = RECORD_MAGIC;
+	buffer[size++] = (uint8_t)record.type;
+	buffer[size++] = (uint8_t)name_length;
+	memcpy(&buffer[size], record.name, name_length);
+	size += name_length;
+
+	const int32_t value = (record.type == RecordType::Reset) ? 0 : record.i;
+	memcpy(&buffer[size], &value, sizeof(value));
+	size += sizeof(value);
+
+	const uint32_t crc = crc32part(buffer, size, snapshot_crc);
+	memcpy(&buffer[size], &crc, sizeof(crc));
+	size += sizeof(crc);
+
+	return size;
+}
+
+size_t read(int fd, uint32_t snapshot_crc, Record &record)
+{
+	uint8_t buffer[MAX_RECORD_SIZE];
+
+	if (::read(fd, buffer, 3) != 3) {
+		return 0;
+	}
+
+	const size_t name_length = buffer[2];
+
+	if (buffer[0] != RECORD_MAGIC || name_length == 0 || name_length > MAX_NAME_LENGTH
+	    || buffer[1] < (uint8_t)RecordType::Int32 || buffer[1] > (uint8_t)RecordType::Reset) {
+		return 0;
+	}
+
+	const size_t remaining = name_length + 4 + 4;
+
+	if (::read(fd, &buffer[3], remaining) != (ssize_t)remaining) {
+		return 0;
+	}
+
+	const size_t size = 3 + remaining;
+	uint32_t crc;
+	memcpy(&crc, &buffer[size - sizeof(crc)], sizeof(crc));
+
+	if (crc32part(buffer, size - sizeof(crc), snapshot_crc) != crc) {
+		return 0;
+	}
+
+	record.type = (RecordType)buffer[1];
+	memcpy(record.name, &buffer[3], name_length);
+	record.name[name_length] = '\0';
+	memcpy(&record.i, &buffer[3 + name_length], sizeof(record.i));
+
+	return size;
+}
+
+int read_snapshot(int fd, FileState &state)
+{
+	state.invalidate();
+
+	if (lseek(fd, 0, SEEK_SET) != 0) {
+		return -1;
+	}
+
+	// the BSON document starts with its total size
+	int32_t document_size = 0;
+
+	if (::read(fd, &document_size, sizeof(document_size)) != sizeof(document_size) || document_size < 5) {
+		return -1;
+	}
+
+	uint32_t crc = crc32part((const uint8_t *)&document_size, sizeof(document_size), 0);
+	int32_t remaining = document_size - sizeof(document_size);
+	uint8_t buffer[64];
+
+	while (remaining > 0) {
+		const ssize_t chunk = ((size_t)remaining < sizeof(buffer)) ? remaining : sizeof(buffer);
+
+		if (::read(fd, buffer, chunk) != chunk) {
+			return -1;
+		}
+
+		crc = crc32part(buffer, chunk, crc);
+		remaining -= chunk;
+	}
+
+	state.snapshot_size = document_size;
+	state.snapshot_crc = crc;
+	state.end = document_size;
+	return 0;
+}
+
+bool Writer::open(const char *filename)
+{
+	if (!_state.valid()) {
+		return false;
+	}
+
+	_fd = ::open(filename, O_WRONLY);
+	_failed = (_fd < 0) || (ftruncate(_fd, _state.end) != 0) || (lseek(_fd, _state.end, SEEK_SET) != _state.end);
+	_written = 0;
+	_buffered = 0;
+
+	if (_failed) {
+		PX4_ERR("journal open %s failed (%d)", filename, errno);
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+bool Writer::append(const Record &record)
+{
+	if (_buffered + MAX_RECORD_SIZE > sizeof(_buffer)) {
+		flush();
+	}
+
+	const size_t size = encode(record, _state.snapshot_crc, &_buffer[_buffered]);
+
+	if (size == 0) {
+		_failed = true;
+	}
+
+	_buffered += size;
+	return !_failed;
+}
+
+bool Writer::flush()
+{
+	if (_buffered > 0 && !_failed) {
+		_failed = (::write(_fd, _buffer, _buffered) != (ssize_t)_buffered);
+		_written += _buffered;
+	}
+
+	_buffered = 0;
+	return !_failed;
+}
+
+bool Writer::close()
+{
+	if (_fd < 0) {
+		return false;
+	}
+
+	flush();
+
+	if (!_failed && fsync(_fd) != 0) {
+		_failed = true;
+	}
+
+	::close(_fd);
+	_fd = -1;
+
+	if (_failed) {
+		PX4_ERR("journal append failed (%d)", errno);
+		_state.invalidate();
+		return false;
+	}
+
+	_state.end += _written;
+	return true;
+}
+
+} // namespace param_journal
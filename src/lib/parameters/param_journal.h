@@ -0,0 +1,148 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file param_journal.h
+ *
+ * Append-only journal for the parameter file.
+ *
+ * The parameter file starts with the BSON snapshot written by param_export, followed by
+ * journal records for the parameters changed since. Each record stores the name and new value
+ * (or a reset to the default) of one parameter and is protected by a CRC that is seeded with
+ * the CRC of the snapshot, so records only apply to the snapshot they were written for.
+ * Reading stops at the first invalid record (e.g. a torn write).
+ *
+ * Record layout (little endian):
+ * | magic (1) | type (1) | name length n (1) | name (n) | value (4) | crc32 (4) |
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+namespace param_journal
+{
+
+static constexpr uint8_t RECORD_MAGIC = 0xa5;
+static constexpr size_t MAX_NAME_LENGTH = 16;
+static constexpr size_t MAX_RECORD_SIZE = 3 + MAX_NAME_LENGTH + 4 + 4;
+
+enum class RecordType : uint8_t {
+	Int32 = 1,
+	Float = 2,
+	Reset = 3, ///< parameter is at its default value
+};
+
+struct Record {
+	RecordType type;
+	char name[MAX_NAME_LENGTH + 1];
+
+	union {
+		int32_t i;
+		float f;
+	};
+};
+
+/**
+ * State of a parameter file that is written incrementally.
+ */
+struct FileState {
+	off_t end{-1}; ///< end of the valid data (snapshot and journal), -1 if unknown
+	off_t snapshot_size{0};
+	uint32_t snapshot_crc{0};
+
+	bool valid() const { return end >= 0; }
+	size_t journal_size() const { return valid() ? end - snapshot_size : 0; }
+	void invalidate() { end = -1; }
+};
+
+/**
+ * Encode a record.
+ *
+ * @param buffer at least MAX_RECORD_SIZE bytes
+ * @return encoded size, 0 if the name is invalid
+ */
+size_t encode(const Record &record, uint32_t snapshot_crc, uint8_t *buffer);
+
+/**
+ * Read the record at the current file position.
+ *
+ * @return size of the record, 0 at the end of the journal (end of file, truncated or invalid record)
+ */
+size_t read(int fd, uint32_t snapshot_crc, Record &record);
+
+/**
+ * Read size and CRC of the BSON snapshot at the start of a file, and
+ * leave the file position at the end of the snapshot (the start of the journal).
+ *
+ * @return 0 on success
+ */
+int read_snapshot(int fd, FileState &state);
+
+/**
+ * Appends records at the end of the valid data of a parameter file.
+ * Any invalid data after the end (e.g. a torn record) is truncated first.
+ */
+class Writer
+{
+public:
+	explicit Writer(FileState &state) : _state(state) {}
+	~Writer() { close(); }
+
+	Writer(const Writer &) = delete;
+	Writer &operator=(const Writer &) = delete;
+
+	bool open(const char *filename);
+
+	bool append(const Record &record);
+
+	/**
+	 * Flush and sync the file.
+	 * @return true on success, the end of the file state is then advanced, otherwise invalidated
+	 */
+	bool close();
+
+private:
+	bool flush();
+
+	FileState &_state;
+	int _fd{-1};
+	bool _failed{false};
+	size_t _written{0};
+	size_t _buffered{0};
+	uint8_t _buffer[256];
+};
+
+} // namespace param_journal
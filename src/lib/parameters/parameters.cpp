@@ -55,6 +55,7 @@
 #include <drivers/drv_hrt.h>
 #include <lib/perf/perf_counter.h>
 #include <px4_platform_common/px4_config.h>
+#include <px4_platform_common/atomic.h>
 #include <px4_platform_common/atomic_bitset.h>
 #include <px4_platform_common/defines.h>
 #include <px4_platform_common/posix.h>
@@ -74,6 +75,7 @@ using namespace time_literals;
 #include "StaticSparseLayer.h"
 
 #include "atomic_transaction.h"
+#include "param_journal.h"
 
 /* Include functions common to user and kernel sides */
 #include "parameters_common.cpp"
@@ -94,11 +96,19 @@ inline static int flash_param_import() { return -1; }
 static char *param_default_file = nullptr;
 static char *param_backup_file = nullptr;
 
+// parameter files are saved incrementally by appending to a journal, see param_journal.h
+static constexpr size_t PARAM_JOURNAL_MAX_SIZE = 4096;    ///< compact the file once the journal reaches this size
+static constexpr unsigned PARAM_JOURNAL_MAX_RECORDS = 64; ///< save more changes at once with a full export
+static param_journal::FileState param_default_file_state;
+static param_journal::FileState param_backup_file_state;
+static param_journal::FileState param_import_file_state; ///< state of the file of the last import
+
 #include "autosave.h"
 static ParamAutosave *autosave_instance {nullptr};
 
 static px4::AtomicBitset<param_info_count> params_active;  // params found
 static px4::AtomicBitset<param_info_count> params_unsaved;
+static px4::AtomicBitset<param_info_count> params_journal_pending; // params changed since the last save to file
 
 static ConstLayer firmware_defaults;
 static DynamicSparseLayer runtime_defaults{&firmware_defaults};
@@ -115,6 +125,22 @@ static perf_counter_t param_find_perf;
 static perf_counter_t param_get_perf;
 static perf_counter_t param_set_perf;
 
+/** notification batching, see param_notify_batch_begin() */
+static px4::atomic<int> param_notify_batch_depth{0};
+static px4::atomic_bool param_notify_pending{false};
+
+/** parameters changed since the last notification (folded, see param_changed_in()) */
+static px4::atomic<uint32_t> params_changed_bitset[PARAM_CHANGED_BITSET_WORDS] {};
+static_assert(PARAM_CHANGED_BITSET_WORDS == parameter_update_s::CHANGED_BITSET_WORDS, "changed bitset size");
+
+static void param_mark_changed(param_t param)
+{
+	const unsigned bit = param % (32 * PARAM_CHANGED_BITSET_WORDS);
+	params_changed_bitset[bit / 32].fetch_or(1u << (bit % 32));
+
+	params_journal_pending.set(param);
+}
+
 static pthread_mutex_t file_mutex  =
 	PTHREAD_MUTEX_INITIALIZER; ///< this protects against concurrent param saves (file or flash access).
 
@@ -158,6 +184,13 @@ param_notify_changes()
 // Don't send if this is a remote node. Only the primary
 // sends out update notices
 #if not defined(CONFIG_PARAM_REMOTE)
+
+	if (param_notify_batch_depth.load() > 0) {
+		// published by param_notify_batch_end()
+		param_notify_pending.store(true);
+		return;
+	}
+
 	parameter_update_s pup {};
 	pup.instance = param_instance++;
 	pup.get_count = perf_event_count(param_get_perf);
@@ -167,6 +200,11 @@ param_notify_changes()
 	pup.active = params_active.count();
 	pup.changed = user_config.size();
 	pup.custom_default = runtime_defaults.size();
+
+	for (unsigned i = 0; i < PARAM_CHANGED_BITSET_WORDS; i++) {
+		pup.changed_bitset[i] = params_changed_bitset[i].fetch_and(0);
+	}
+
 	pup.timestamp = hrt_absolute_time();
 
 	if (param_topic == nullptr) {
@@ -179,37 +217,41 @@ param_notify_changes()
 #endif
 }
 
-static param_t param_find_internal(const char *name, bool notification)
+void
+param_notify_batch_begin()
 {
-	perf_count(param_find_perf);
-
-	param_t middle;
-	param_t front = 0;
-	param_t last = param_info_count;
-
-	/* perform a binary search of the known parameters */
+	param_notify_batch_depth.fetch_add(1);
+}
 
-	while (front <= last) {
-		middle = front + (last - front) / 2;
-		int ret = strcmp(name, param_name(middle));
+void
+param_notify_batch_end()
+{
+	if (param_notify_batch_depth.fetch_sub(1) == 1) {
+		bool pending = true;
 
-		if (ret == 0) {
-			if (notification) {
-				param_set_used(middle);
-			}
+		if (param_notify_pending.compare_exchange(&pending, false)) {
+			param_notify_changes();
+		}
+	}
+}
 
-			return middle;
+static param_t param_find_internal(const char *name, bool notification)
+{
+	perf_count(param_find_perf);
 
-		} else if (middle == front) {
-			/* An end point has been hit, but there has been no match */
-			break;
+	/* resolve the only candidate through the generated perfect hash */
+	static constexpr unsigned hash_buckets = sizeof(px4::parameters_hash_displacement) / sizeof(uint16_t);
+	static_assert(sizeof(px4::parameters_hash_slots) / sizeof(uint16_t) == param_info_count, "hash table size");
 
-		} else if (ret < 0) {
-			last = middle;
+	const uint16_t seed = px4::parameters_hash_displacement[px4::param_name_hash(name, 0) % hash_buckets];
+	const param_t param = px4::parameters_hash_slots[px4::param_name_hash(name, seed) % param_info_count];
 
-		} else {
-			front = middle;
+	if (strcmp(name, param_name(param)) == 0) {
+		if (notification) {
+			param_set_used(param);
 		}
+
+		return param;
 	}
 
 	/* not found */
@@ -437,6 +479,10 @@ param_set_internal(param_t param, const void *val, bool mark_saved, bool notify_
 		params_unsaved.set(param, !mark_saved);
 		result = PX4_OK;
 
+		if (param_changed) {
+			param_mark_changed(param);
+		}
+
 	} else {
 		PX4_ERR("param_set failed to store param %s", param_name(param));
 		result = PX4_ERROR;
@@ -590,9 +636,13 @@ int param_set_default_value(param_t param, const void *val)
 	}
 
 
-	if ((result == PX4_OK) && param_used(param)) {
-		// send notification if param is already in use
-		param_notify_changes();
+	if (result == PX4_OK) {
+		param_mark_changed(param);
+
+		if (param_used(param)) {
+			// send notification if param is already in use
+			param_notify_changes();
+		}
 	}
 
 	return result;
@@ -609,6 +659,10 @@ static int param_reset_internal(param_t param, bool notify = true, bool autosave
 
 	if (handle_in_range(param)) {
 		user_config.reset(param);
+
+		if (param_found) {
+			param_mark_changed(param);
+		}
 	}
 
 	if (autosave) {
@@ -731,6 +785,8 @@ param_set_default_file(const char *filename)
 		param_default_file = strdup(filename);
 	}
 
+	param_default_file_state.invalidate();
+
 #endif /* FLASH_BASED_PARAMS */
 
 	return 0;
@@ -761,6 +817,8 @@ int param_set_backup_file(const char *filename)
 		param_backup_file = nullptr; // backup disabled
 	}
 
+	param_backup_file_state.invalidate();
+
 	return 0;
 }
 
@@ -771,6 +829,103 @@ const char *param_get_backup_file()
 
 static int param_export_internal(int fd, param_filter_func filter);
 static int param_verify(int fd);
+static int param_import_callback(bson_decoder_t decoder, bson_node_t node);
+
+/**
+ * Save the current state of the given parameters by appending it to the journal of a parameter file.
+ * Caller is responsible for locking.
+ *
+ * @return PX4_OK on success, otherwise the file needs a full export (which also compacts the journal)
+ */
+static int param_journal_save(const char *filename, param_journal::FileState &state,
+			      const px4::Bitset<param_info_count> &params)
+{
+	const size_t count = params.count();
+
+	if (!state.valid() || (count > PARAM_JOURNAL_MAX_RECORDS)
+	    || (state.journal_size() + count * param_journal::MAX_RECORD_SIZE > PARAM_JOURNAL_MAX_SIZE)) {
+		return PX4_ERROR;
+	}
+
+	if (count == 0) {
+		return PX4_OK;
+	}
+
+	param_journal::Writer writer{state};
+
+	if (!writer.open(filename)) {
+		return PX4_ERROR;
+	}
+
+	for (param_t param = 0; handle_in_range(param); param++) {
+		if (!params[param]) {
+			continue;
+		}
+
+		param_journal::Record record{};
+		strncpy(record.name, param_name(param), sizeof(record.name) - 1);
+		record.type = param_journal::RecordType::Reset;
+
+		// like param_export_internal(), values equal to the default are not stored
+		if (user_config.contains(param)) {
+			const param_value_u runtime_default_value = runtime_defaults.get(param);
+			const param_value_u user_config_value = user_config.get(param);
+
+			switch (param_type(param)) {
+			case PARAM_TYPE_INT32:
+				if (user_config_value.i != runtime_default_value.i) {
+					record.type = param_journal::RecordType::Int32;
+					record.i = user_config_value.i;
+				}
+
+				break;
+
+			case PARAM_TYPE_FLOAT:
+				if (fabsf(user_config_value.f - runtime_default_value.f) > FLT_EPSILON) {
+					record.type = param_journal::RecordType::Float;
+					record.f = user_config_value.f;
+				}
+
+				break;
+			}
+		}
+
+		writer.append(record);
+	}
+
+	return writer.close() ? PX4_OK : PX4_ERROR;
+}
+
+/**
+ * Apply a journal record of the file being imported.
+ */
+static void param_journal_import_record(const param_journal::Record &record)
+{
+	if (record.type == param_journal::RecordType::Reset) {
+		param_t param = param_find_no_notification(record.name);
+
+		if (param != PARAM_INVALID) {
+			param_reset_internal(param, true, false);
+		}
+
+		return;
+	}
+
+	// same handling as a BSON node, including parameter translations
+	bson_node_s node{};
+	strncpy(node.name, record.name, sizeof(node.name) - 1);
+
+	if (record.type == param_journal::RecordType::Int32) {
+		node.type = BSON_INT32;
+		node.i32 = record.i;
+
+	} else {
+		node.type = BSON_DOUBLE;
+		node.d = (double)record.f;
+	}
+
+	param_import_callback(nullptr, &node);
+}
 
 int param_save_default(bool blocking)
 {
@@ -796,10 +951,23 @@ int param_save_default(bool blocking)
 	int res = PX4_ERROR;
 	const char *filename = param_get_default_file();
 
+	// take the parameters changed since the last save (changes from now on are saved next time)
+	px4::Bitset<param_info_count> changed_params;
+
+	for (param_t param = 0; handle_in_range(param); param++) {
+		if (params_journal_pending[param]) {
+			changed_params.set(param);
+			params_journal_pending.set(param, false);
+		}
+	}
+
 	if (filename) {
+		// append the changes to the journal if possible, otherwise rewrite the file
+		res = param_journal_save(filename, param_default_file_state, changed_params);
+
 		static constexpr int MAX_ATTEMPTS = 3;
 
-		for (int attempt = 1; attempt <= MAX_ATTEMPTS; attempt++) {
+		for (int attempt = 1; (attempt <= MAX_ATTEMPTS) && (res != PX4_OK); attempt++) {
 			// write parameters to file
 			int fd = ::open(filename, O_WRONLY | O_CREAT | O_TRUNC, PX4_O_MODE_666);
 
@@ -813,6 +981,12 @@ int param_save_default(bool blocking)
 					// reopen file to verify
 					int fd_verify = ::open(filename, O_RDONLY, PX4_O_MODE_666);
 					res = param_verify(fd_verify) || lseek(fd_verify, 0, SEEK_SET) || param_verify(fd_verify);
+
+					// the journal starts after the new snapshot
+					if (res != PX4_OK || param_journal::read_snapshot(fd_verify, param_default_file_state) != 0) {
+						param_default_file_state.invalidate();
+					}
+
 					::close(fd_verify);
 				}
 			}
@@ -835,11 +1009,18 @@ int param_save_default(bool blocking)
 	if (res != PX4_OK) {
 		PX4_ERR("param export failed (%d)", res);
 
+		// retry with the next save
+		for (param_t param = 0; handle_in_range(param); param++) {
+			if (changed_params[param]) {
+				params_journal_pending.set(param);
+			}
+		}
+
 	} else {
 		params_unsaved.reset();
 
 		// backup file
-		if (param_backup_file) {
+		if (param_backup_file && (param_journal_save(param_backup_file, param_backup_file_state, changed_params) != PX4_OK)) {
 			int fd_backup_file = ::open(param_backup_file, O_WRONLY | O_CREAT | O_TRUNC, PX4_O_MODE_666);
 
 			if (fd_backup_file > -1) {
@@ -852,7 +1033,11 @@ int param_save_default(bool blocking)
 				} else {
 					// verify export
 					int fd_verify = ::open(param_backup_file, O_RDONLY, PX4_O_MODE_666);
-					param_verify(fd_verify);
+
+					if (param_verify(fd_verify) != 0 || param_journal::read_snapshot(fd_verify, param_backup_file_state) != 0) {
+						param_backup_file_state.invalidate();
+					}
+
 					::close(fd_verify);
 				}
 			}
@@ -898,9 +1083,14 @@ param_load_default()
 
 	if (result != 0) {
 		PX4_ERR("error reading parameters from '%s'", filename);
+		param_default_file_state.invalidate();
 		return -2;
 	}
 
+	// the parameters now match the file, subsequent changes can be appended to it
+	param_default_file_state = param_import_file_state;
+	params_journal_pending.reset();
+
 	return res;
 }
 
@@ -1199,8 +1389,31 @@ param_import_callback(bson_decoder_t decoder, bson_node_t node)
 	return 1;
 }
 
+static void
+param_journal_import(int fd)
+{
+	param_journal::FileState &state = param_import_file_state;
+
+	if (param_journal::read_snapshot(fd, state) != 0) {
+		return;
+	}
+
+	param_journal::Record record;
+	unsigned count = 0;
+
+	while (const size_t size = param_journal::read(fd, state.snapshot_crc, record)) {
+		param_journal_import_record(record);
+		state.end += size;
+		count++;
+	}
+
+	if (count > 0) {
+		PX4_INFO("journal %u bytes, imported %u records", (unsigned)state.journal_size(), count);
+	}
+}
+
 static int
-param_import_internal(int fd)
+param_import_bson(int fd)
 {
 	static constexpr int MAX_ATTEMPTS = 3;
 
@@ -1221,6 +1434,8 @@ param_import_internal(int fd)
 						 decoder.total_document_size, decoder.total_decoded_size,
 						 decoder.count_node_int32, decoder.count_node_double);
 
+					// apply the changes appended after the snapshot
+					param_journal_import(fd);
 					return 0;
 
 				} else {
@@ -1255,6 +1470,19 @@ param_import_internal(int fd)
 	return -1;
 }
 
+static int
+param_import_internal(int fd)
+{
+	param_import_file_state.invalidate();
+
+	// publish a single notification for all imported parameters
+	param_notify_batch_begin();
+	const int ret = param_import_bson(fd);
+	param_notify_batch_end();
+
+	return ret;
+}
+
 int
 param_import(int fd)
 {
@@ -1272,8 +1500,12 @@ param_load(int fd)
 		return flash_param_load();
 	}
 
+	param_notify_batch_begin();
 	param_reset_all_internal(false);
-	return param_import_internal(fd);
+	const int ret = param_import_internal(fd);
+	param_notify_batch_end();
+
+	return ret;
 }
 
 void
@@ -1325,6 +1557,10 @@ void param_print_status()
 
 	if (filename != nullptr) {
 		PX4_INFO("file: %s", param_get_default_file());
+
+		if (param_default_file_state.valid()) {
+			PX4_INFO("file journal: %zu/%zu bytes", param_default_file_state.journal_size(), PARAM_JOURNAL_MAX_SIZE);
+		}
 	}
 
 	if (param_backup_file) {
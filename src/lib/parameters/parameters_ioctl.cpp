@@ -190,6 +190,18 @@ int	param_ioctl(unsigned int cmd, unsigned long arg)
 		}
 		break;
 
+	case PARAMIOCNOTIFYBATCH: {
+			paramiocnotifybatch_t *data = (paramiocnotifybatch_t *)arg;
+
+			if (data->begin) {
+				param_notify_batch_begin();
+
+			} else {
+				param_notify_batch_end();
+			}
+		}
+		break;
+
 	default:
 		ret = -ENOTTY;
 		break;
@@ -161,4 +161,9 @@ typedef struct paramiochash {
 	uint32_t ret;
 } paramiochash_t;
 
+#define PARAMIOCNOTIFYBATCH	_PARAMIOC(19)
+typedef struct paramiocnotifybatch {
+	const bool begin;
+} paramiocnotifybatch_t;
+
 int param_ioctl(unsigned int cmd, unsigned long arg);
@@ -19,6 +19,9 @@ except ImportError as e:
 
 import os
 
+sys.path.append(os.path.join(os.path.dirname(os.path.realpath(__file__)), '../../../Tools/msg'))
+from px_perfect_hash import perfect_hash
+
 def generate(xml_file, dest='.'):
     """
     Generate px4 param source from xml.
@@ -39,6 +42,10 @@ def generate(xml_file, dest='.'):
 
     params = sorted(params, key=lambda name: name.attrib["name"])
 
+    # param_find() lookup tables, see param_name_hash() in px4_parameters.hpp.jinja
+    hash_displacement, hash_slots = perfect_hash(
+        [param.attrib["name"] for param in params], bucket_size=2)
+
     script_path = os.path.dirname(os.path.realpath(__file__))
 
     # for jinja docs see: http://jinja.pocoo.org/docs/2.9/api/
@@ -55,7 +62,9 @@ def generate(xml_file, dest='.'):
         template = env.get_template(template_file)
         with open(os.path.join(
                 dest, template_file.replace('.jinja','')), 'w') as fid:
-            fid.write(template.render(params=params))
+            fid.write(template.render(params=params,
+                                      hash_displacement=hash_displacement,
+                                      hash_slots=hash_slots))
 
 if __name__ == "__main__":
     arg_parser = argparse.ArgumentParser()
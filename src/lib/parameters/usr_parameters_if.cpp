@@ -52,6 +52,20 @@ param_notify_changes()
 	boardctl(PARAMIOCNOTIFY, NULL);
 }
 
+void
+param_notify_batch_begin()
+{
+	paramiocnotifybatch_t data = {true};
+	boardctl(PARAMIOCNOTIFYBATCH, reinterpret_cast<unsigned long>(&data));
+}
+
+void
+param_notify_batch_end()
+{
+	paramiocnotifybatch_t data = {false};
+	boardctl(PARAMIOCNOTIFYBATCH, reinterpret_cast<unsigned long>(&data));
+}
+
 param_t param_find(const char *name)
 {
 	paramiocfind_t data = {name, true, PARAM_INVALID};
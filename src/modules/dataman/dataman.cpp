@@ -59,6 +59,14 @@
 
 #include "dataman.h"
 
+#if defined(__PX4_POSIX)
+#include <crc32.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 __BEGIN_DECLS
 __EXPORT int dataman_main(int argc, char *argv[]);
 __END_DECLS
@@ -79,6 +87,15 @@ static int  _ram_clear(dm_item_t item);
 static int _ram_initialize(unsigned max_offset);
 static void _ram_shutdown();
 
+#if defined(__PX4_POSIX)
+/* Private memory mapped file Operations with write-ahead journal */
+static ssize_t _mmap_write(dm_item_t item, unsigned index, const void *buf, size_t count);
+static ssize_t _mmap_read(dm_item_t item, unsigned index, void *buf, size_t count);
+static int  _mmap_clear(dm_item_t item);
+static int _mmap_initialize(unsigned max_offset);
+static void _mmap_shutdown();
+#endif
+
 typedef struct dm_operations_t {
 	ssize_t (*write)(dm_item_t item, unsigned index, const void *buf, size_t count);
 	ssize_t (*read)(dm_item_t item, unsigned index, void *buf, size_t count);
@@ -106,6 +123,40 @@ static constexpr dm_operations_t dm_ram_operations = {
 	.wait = px4_sem_wait,
 };
 
+#if defined(__PX4_POSIX)
+static constexpr dm_operations_t dm_mmap_operations = {
+	.write   = _mmap_write,
+	.read    = _mmap_read,
+	.clear   = _mmap_clear,
+	.initialize = _mmap_initialize,
+	.shutdown = _mmap_shutdown,
+	.wait = px4_sem_wait,
+};
+
+/* Journal file layout: a header followed by the records of the open transaction */
+static constexpr uint32_t DM_JOURNAL_MAGIC = 0x4a4d4450;	/* "PDMJ" */
+static constexpr uint32_t DM_JOURNAL_SIZE = 256 * 1024;	/* ~3500 mission items per transaction */
+
+struct dm_journal_header_s {
+	uint32_t magic;
+	uint32_t sequence;	/* incremented on every commit */
+	uint32_t length;	/* bytes of committed records following the header, 0 if nothing to replay */
+	uint32_t crc;		/* crc32 of the records */
+};
+
+struct dm_journal_record_s {
+	uint32_t offset;	/* offset of the item in the data file */
+	uint16_t length;	/* item length including header, 0 clears all items of the key */
+	uint8_t item;		/* dm_item_t */
+	uint8_t reserved;
+};
+
+static constexpr uint32_t dm_journal_record_size(uint32_t length)
+{
+	return (sizeof(dm_journal_record_s) + length + 3) & ~3u;
+}
+#endif
+
 static const dm_operations_t *g_dm_ops;
 
 static struct {
@@ -117,6 +168,20 @@ static struct {
 			uint8_t *data;
 			uint8_t *data_end;
 		} ram;
+#if defined(__PX4_POSIX)
+		struct {
+			int fd;
+			int journal_fd;
+			uint8_t *data;
+			size_t data_size;
+			uint8_t *journal;
+			uint32_t journal_length;	/* bytes of records in the open transaction */
+			uint32_t sequence;
+			uint32_t commits;
+			unsigned pending_first[DM_KEY_NUM_KEYS];	/* index range with uncommitted writes per key */
+			unsigned pending_last[DM_KEY_NUM_KEYS];
+		} mmap;
+#endif
 	};
 	bool running;
 	bool silence = false;
@@ -157,6 +222,7 @@ static enum {
 	BACKEND_NONE = 0,
 	BACKEND_FILE,
 	BACKEND_RAM,
+	BACKEND_MMAP,
 	BACKEND_LAST
 } backend = BACKEND_NONE;
 
@@ -529,27 +595,10 @@ _file_clear(dm_item_t item)
 	return result;
 }
 
-static int
-_file_initialize(unsigned max_offset)
+/* Reset the storage if it was just created or has an incompatible layout */
+static void
+check_compat(bool file_existed)
 {
-	const bool file_existed = (access(k_data_manager_device_path, F_OK) == 0);
-
-	/* Open or create the data manager file */
-	dm_operations_data.file.fd = open(k_data_manager_device_path, O_RDWR | O_CREAT | O_BINARY, PX4_O_MODE_666);
-
-	if (dm_operations_data.file.fd < 0) {
-		PX4_WARN("Could not open data manager file %s", k_data_manager_device_path);
-		px4_sem_post(&g_init_sema); /* Don't want to hang startup */
-		return -1;
-	}
-
-	if ((unsigned)lseek(dm_operations_data.file.fd, max_offset, SEEK_SET) != max_offset) {
-		close(dm_operations_data.file.fd);
-		PX4_WARN("Could not seek data manager file %s", k_data_manager_device_path);
-		px4_sem_post(&g_init_sema); /* Don't want to hang startup */
-		return -1;
-	}
-
 	dataman_compat_s compat_state{};
 
 	dm_operations_data.silence = true;
@@ -589,6 +638,30 @@ _file_initialize(unsigned max_offset)
 		g_dm_ops->write(DM_KEY_FENCE_POINTS_STATE, 0, reinterpret_cast<uint8_t *>(&stats), sizeof(mission_stats_entry_s));
 		g_dm_ops->write(DM_KEY_SAFE_POINTS_STATE, 0, reinterpret_cast<uint8_t *>(&stats), sizeof(mission_stats_entry_s));
 	}
+}
+
+static int
+_file_initialize(unsigned max_offset)
+{
+	const bool file_existed = (access(k_data_manager_device_path, F_OK) == 0);
+
+	/* Open or create the data manager file */
+	dm_operations_data.file.fd = open(k_data_manager_device_path, O_RDWR | O_CREAT | O_BINARY, PX4_O_MODE_666);
+
+	if (dm_operations_data.file.fd < 0) {
+		PX4_WARN("Could not open data manager file %s", k_data_manager_device_path);
+		px4_sem_post(&g_init_sema); /* Don't want to hang startup */
+		return -1;
+	}
+
+	if ((unsigned)lseek(dm_operations_data.file.fd, max_offset, SEEK_SET) != max_offset) {
+		close(dm_operations_data.file.fd);
+		PX4_WARN("Could not seek data manager file %s", k_data_manager_device_path);
+		px4_sem_post(&g_init_sema); /* Don't want to hang startup */
+		return -1;
+	}
+
+	check_compat(file_existed);
 
 	dm_operations_data.running = true;
 
@@ -628,6 +701,416 @@ _ram_shutdown()
 	dm_operations_data.running = false;
 }
 
+#if defined(__PX4_POSIX)
+static dm_journal_header_s *
+_mmap_journal_header()
+{
+	return reinterpret_cast<dm_journal_header_s *>(dm_operations_data.mmap.journal);
+}
+
+static uint8_t *
+_mmap_journal_records()
+{
+	return dm_operations_data.mmap.journal + sizeof(dm_journal_header_s);
+}
+
+static void
+_mmap_reset_pending()
+{
+	for (unsigned i = 0; i < DM_KEY_NUM_KEYS; i++) {
+		dm_operations_data.mmap.pending_first[i] = UINT_MAX;
+		dm_operations_data.mmap.pending_last[i] = 0;
+	}
+
+	dm_operations_data.mmap.journal_length = 0;
+}
+
+static void
+_mmap_mark_pending(dm_item_t item, unsigned first, unsigned last)
+{
+	if (first < dm_operations_data.mmap.pending_first[item]) {
+		dm_operations_data.mmap.pending_first[item] = first;
+	}
+
+	if (last > dm_operations_data.mmap.pending_last[item]) {
+		dm_operations_data.mmap.pending_last[item] = last;
+	}
+}
+
+/* Apply the records in the journal to the mapped data file and make them persistent */
+static int
+_mmap_journal_apply(uint32_t length)
+{
+	const uint8_t *records = _mmap_journal_records();
+	size_t dirty_start = dm_operations_data.mmap.data_size;
+	size_t dirty_end = 0;
+
+	for (uint32_t pos = 0; pos + sizeof(dm_journal_record_s) <= length;) {
+		dm_journal_record_s record;
+		memcpy(&record, &records[pos], sizeof(record));
+
+		if (record.item >= DM_KEY_NUM_KEYS) {
+			return -1;
+		}
+
+		const size_t item_size = g_per_item_size_with_hdr[record.item];
+		size_t end = record.offset + (record.length > 0 ? record.length : g_per_item_max_index[record.item] * item_size);
+
+		if (end > dm_operations_data.mmap.data_size) {
+			return -1;
+		}
+
+		if (record.length > 0) {
+			memcpy(&dm_operations_data.mmap.data[record.offset], &records[pos + sizeof(record)], record.length);
+
+		} else {
+			/* clear: only the length byte of every item needs to be reset */
+			for (size_t offset = record.offset; offset < end; offset += item_size) {
+				dm_operations_data.mmap.data[offset] = 0;
+			}
+		}
+
+		if (record.offset < dirty_start) {
+			dirty_start = record.offset;
+		}
+
+		if (end > dirty_end) {
+			dirty_end = end;
+		}
+
+		pos += dm_journal_record_size(record.length);
+	}
+
+	if (dirty_end > dirty_start) {
+		/* msync needs a page aligned address */
+		const size_t page_size = sysconf(_SC_PAGESIZE);
+		dirty_start -= dirty_start % page_size;
+
+		if (msync(dm_operations_data.mmap.data + dirty_start, dirty_end - dirty_start, MS_SYNC) != 0) {
+			PX4_ERR("data msync failed %d", errno);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/* Make the open transaction persistent: journal first, then the data file */
+static int
+_mmap_commit()
+{
+	const uint32_t length = dm_operations_data.mmap.journal_length;
+
+	if (length == 0) {
+		return 0;
+	}
+
+	dm_journal_header_s *header = _mmap_journal_header();
+	header->magic = DM_JOURNAL_MAGIC;
+	header->sequence = ++dm_operations_data.mmap.sequence;
+	header->length = length;
+	header->crc = crc32part(_mmap_journal_records(), length, 0);
+
+	if (msync(dm_operations_data.mmap.journal, sizeof(dm_journal_header_s) + length, MS_SYNC) != 0) {
+		/* without a durable journal an interrupted apply would tear the data file: keep the transaction open */
+		PX4_ERR("journal msync failed %d", errno);
+		return -1;
+	}
+
+	int ret = 0;
+
+	/* if this is interrupted the journal is replayed on the next start */
+	if (_mmap_journal_apply(length) != 0) {
+		ret = -1;
+	}
+
+	/* data is persistent, retire the transaction */
+	header->length = 0;
+	msync(dm_operations_data.mmap.journal, sizeof(dm_journal_header_s), MS_SYNC);
+
+	dm_operations_data.mmap.commits++;
+	_mmap_reset_pending();
+
+	return ret;
+}
+
+/* Append a record to the open transaction, returns a pointer to its payload */
+static uint8_t *
+_mmap_journal_append(dm_item_t item, uint32_t offset, uint16_t length)
+{
+	const uint32_t record_size = dm_journal_record_size(length);
+
+	if (sizeof(dm_journal_header_s) + dm_operations_data.mmap.journal_length + record_size > DM_JOURNAL_SIZE) {
+		/* journal full, split the transaction */
+		if (_mmap_commit() != 0) {
+			return nullptr;
+		}
+	}
+
+	uint8_t *record = _mmap_journal_records() + dm_operations_data.mmap.journal_length;
+
+	dm_journal_record_s header{};
+	header.offset = offset;
+	header.length = length;
+	header.item = item;
+	memcpy(record, &header, sizeof(header));
+
+	dm_operations_data.mmap.journal_length += record_size;
+
+	return record + sizeof(header);
+}
+
+/* Find the latest uncommitted version of an item, nullptr if it has none */
+static const uint8_t *
+_mmap_journal_find(dm_item_t item, unsigned index, uint32_t offset)
+{
+	static constexpr uint8_t cleared_item[DM_SECTOR_HDR_SIZE] {};
+
+	if (index < dm_operations_data.mmap.pending_first[item] || index > dm_operations_data.mmap.pending_last[item]) {
+		return nullptr;
+	}
+
+	const uint8_t *records = _mmap_journal_records();
+	const uint8_t *found = nullptr;
+
+	for (uint32_t pos = 0; pos < dm_operations_data.mmap.journal_length;) {
+		dm_journal_record_s record;
+		memcpy(&record, &records[pos], sizeof(record));
+
+		if (record.item == item) {
+			if (record.length == 0) {
+				found = cleared_item;
+
+			} else if (record.offset == offset) {
+				found = &records[pos + sizeof(record)];
+			}
+		}
+
+		pos += dm_journal_record_size(record.length);
+	}
+
+	return found;
+}
+
+static ssize_t
+_mmap_write(dm_item_t item, unsigned index, const void *buf, size_t count)
+{
+	if (item >= DM_KEY_NUM_KEYS) {
+		return -1;
+	}
+
+	/* Get the offset for this item */
+	const int offset = calculate_offset(item, index);
+
+	/* If item type or index out of range, return error */
+	if (offset < 0) {
+		return -1;
+	}
+
+	/* Make sure caller has not given us more data than we can handle */
+	if (count > (g_per_item_size_with_hdr[item] - DM_SECTOR_HDR_SIZE)) {
+		return -E2BIG;
+	}
+
+	uint8_t *buffer = _mmap_journal_append(item, offset, count + DM_SECTOR_HDR_SIZE);
+
+	if (buffer == nullptr) {
+		return -1;
+	}
+
+	/* Write out the data, prefixed with length */
+	buffer[0] = count;
+	buffer[1] = 0;
+	buffer[2] = 0;
+	buffer[3] = 0;
+
+	if (count > 0) {
+		memcpy(buffer + DM_SECTOR_HDR_SIZE, buf, count);
+	}
+
+	_mmap_mark_pending(item, index, index);
+
+	/* Writing a state item completes an upload, which makes it the natural end of a transaction */
+	if (item == DM_KEY_SAFE_POINTS_STATE || item == DM_KEY_FENCE_POINTS_STATE
+	    || item == DM_KEY_MISSION_STATE || item == DM_KEY_COMPAT) {
+		if (_mmap_commit() != 0) {
+			return -1;
+		}
+	}
+
+	/* All is well... return the number of user data written */
+	return count;
+}
+
+static ssize_t
+_mmap_read(dm_item_t item, unsigned index, void *buf, size_t count)
+{
+	if (item >= DM_KEY_NUM_KEYS) {
+		return -1;
+	}
+
+	/* Get the offset for this item */
+	const int offset = calculate_offset(item, index);
+
+	/* If item type or index out of range, return error */
+	if (offset < 0) {
+		return -1;
+	}
+
+	/* Make sure the caller hasn't asked for more data than we can handle */
+	if (count > (g_per_item_size_with_hdr[item] - DM_SECTOR_HDR_SIZE)) {
+		return -E2BIG;
+	}
+
+	/* Uncommitted writes take precedence over the data file */
+	const uint8_t *buffer = _mmap_journal_find(item, index, offset);
+
+	if (buffer == nullptr) {
+		buffer = &dm_operations_data.mmap.data[offset];
+	}
+
+	/* See if we got data */
+	if (buffer[0] > 0) {
+		/* We got more than requested!!! */
+		if (buffer[0] > count) {
+			return -1;
+		}
+
+		/* Looks good, copy it to the caller's buffer */
+		memcpy(buf, buffer + DM_SECTOR_HDR_SIZE, buffer[0]);
+
+	} else {
+		memset(buf, 0, count);
+	}
+
+	/* Return the number of bytes of caller data read */
+	return buffer[0];
+}
+
+static int
+_mmap_clear(dm_item_t item)
+{
+	if (item >= DM_KEY_NUM_KEYS) {
+		return -1;
+	}
+
+	/* Get the offset of 1st item of this type */
+	const int offset = calculate_offset(item, 0);
+
+	/* Check for item type out of range */
+	if (offset < 0) {
+		return -1;
+	}
+
+	if (_mmap_journal_append(item, offset, 0) == nullptr) {
+		return -1;
+	}
+
+	_mmap_mark_pending(item, 0, g_per_item_max_index[item] - 1);
+
+	return 0;
+}
+
+static void *
+_mmap_open(const char *path, size_t size, int *fd)
+{
+	*fd = open(path, O_RDWR | O_CREAT | O_BINARY, PX4_O_MODE_666);
+
+	if (*fd < 0) {
+		PX4_WARN("Could not open %s", path);
+		return nullptr;
+	}
+
+	struct stat st {};
+
+	/* Grow the file (sparse) so that the whole mapping is backed */
+	if (fstat(*fd, &st) != 0 || ((size_t)st.st_size < size && ftruncate(*fd, size) != 0)) {
+		PX4_WARN("Could not resize %s", path);
+		close(*fd);
+		return nullptr;
+	}
+
+	void *map = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, *fd, 0);
+
+	if (map == MAP_FAILED) {
+		PX4_WARN("Could not map %s (%i)", path, errno);
+		close(*fd);
+		return nullptr;
+	}
+
+	return map;
+}
+
+static int
+_mmap_initialize(unsigned max_offset)
+{
+	const bool file_existed = (access(k_data_manager_device_path, F_OK) == 0);
+
+	char journal_path[PATH_MAX];
+	snprintf(journal_path, sizeof(journal_path), "%s.journal", k_data_manager_device_path);
+
+	dm_operations_data.mmap.data_size = max_offset;
+	dm_operations_data.mmap.data = (uint8_t *)_mmap_open(k_data_manager_device_path, max_offset,
+				       &dm_operations_data.mmap.fd);
+	dm_operations_data.mmap.journal = (uint8_t *)_mmap_open(journal_path, DM_JOURNAL_SIZE,
+					  &dm_operations_data.mmap.journal_fd);
+
+	if (dm_operations_data.mmap.data == nullptr || dm_operations_data.mmap.journal == nullptr) {
+		if (dm_operations_data.mmap.data) {
+			munmap(dm_operations_data.mmap.data, max_offset);
+			close(dm_operations_data.mmap.fd);
+		}
+
+		if (dm_operations_data.mmap.journal) {
+			munmap(dm_operations_data.mmap.journal, DM_JOURNAL_SIZE);
+			close(dm_operations_data.mmap.journal_fd);
+		}
+
+		px4_sem_post(&g_init_sema); /* Don't want to hang startup */
+		return -1;
+	}
+
+	_mmap_reset_pending();
+	dm_operations_data.mmap.commits = 0;
+
+	/* Replay a transaction that was committed to the journal but not completely applied */
+	const dm_journal_header_s *header = _mmap_journal_header();
+	dm_operations_data.mmap.sequence = (header->magic == DM_JOURNAL_MAGIC) ? header->sequence : 0;
+
+	if (header->magic == DM_JOURNAL_MAGIC && header->length > 0) {
+		if (header->length <= DM_JOURNAL_SIZE - sizeof(dm_journal_header_s)
+		    && header->crc == crc32part(_mmap_journal_records(), header->length, 0)
+		    && _mmap_journal_apply(header->length) == 0) {
+			PX4_INFO("replayed journal transaction %" PRIu32, header->sequence);
+
+		} else {
+			PX4_WARN("discarding incomplete journal transaction");
+		}
+
+		_mmap_journal_header()->length = 0;
+		msync(dm_operations_data.mmap.journal, sizeof(dm_journal_header_s), MS_SYNC);
+	}
+
+	check_compat(file_existed);
+
+	dm_operations_data.running = true;
+
+	return 0;
+}
+
+static void
+_mmap_shutdown()
+{
+	_mmap_commit();
+
+	munmap(dm_operations_data.mmap.data, dm_operations_data.mmap.data_size);
+	munmap(dm_operations_data.mmap.journal, DM_JOURNAL_SIZE);
+	close(dm_operations_data.mmap.fd);
+	close(dm_operations_data.mmap.journal_fd);
+	dm_operations_data.running = false;
+}
+#endif // __PX4_POSIX
+
 static int
 task_main(int argc, char *argv[])
 {
@@ -641,6 +1124,13 @@ task_main(int argc, char *argv[])
 		g_dm_ops = &dm_ram_operations;
 		break;
 
+#if defined(__PX4_POSIX)
+
+	case BACKEND_MMAP:
+		g_dm_ops = &dm_mmap_operations;
+		break;
+#endif
+
 	default:
 		PX4_WARN("No valid backend set.");
 		return -1;
@@ -689,6 +1179,10 @@ task_main(int argc, char *argv[])
 		PX4_INFO("data manager RAM size is %u bytes", max_offset);
 		break;
 
+	case BACKEND_MMAP:
+		PX4_INFO("data manager mapped file '%s' size is %u bytes", k_data_manager_device_path, max_offset);
+		break;
+
 	default:
 		break;
 	}
@@ -853,6 +1347,14 @@ status()
 	PX4_INFO("Reads    %u", g_func_counts[DM_READ]);
 	PX4_INFO("Clears   %u", g_func_counts[DM_CLEAR]);
 
+#if defined(__PX4_POSIX)
+
+	if (backend == BACKEND_MMAP) {
+		PX4_INFO("Commits  %" PRIu32, dm_operations_data.mmap.commits);
+	}
+
+#endif
+
 	perf_print_counter(_dm_read_perf);
 	perf_print_counter(_dm_write_perf);
 }
@@ -873,6 +1375,9 @@ usage()
 Module to provide persistent storage for the rest of the system in form of a simple database through a C API.
 Multiple backends are supported:
 - a file (eg. on the SD card)
+- a memory mapped file with a write-ahead journal (POSIX only). Writes are grouped into transactions,
+  which are committed when a mission, geofence or safe point state is written, when the journal is full
+  (about 3500 mission items) or when dataman stops. Until then they are not persistent.
 - RAM (this is obviously not persistent)
 
 It is used to store structured data of different types: mission waypoints, mission state and geofence polygons.
@@ -880,6 +1385,8 @@ Each type has a specific type and a fixed maximum amount of storage items, so th
 
 ### Implementation
 Reading and writing a single item is always atomic.
+With the memory mapped backend, an upload that ends with a state write and fits into the journal is also atomic
+across a power loss.
 
 )DESCR_STR");
 
@@ -887,6 +1394,9 @@ Reading and writing a single item is always atomic.
 	PRINT_MODULE_USAGE_COMMAND("start");
 	PRINT_MODULE_USAGE_PARAM_STRING('f', nullptr, "<file>", "Storage file", true);
 	PRINT_MODULE_USAGE_PARAM_FLAG('r', "Use RAM backend (NOT persistent)", true);
+#if defined(__PX4_POSIX)
+	PRINT_MODULE_USAGE_PARAM_FLAG('m', "Use memory mapped file backend with write-ahead journal", true);
+#endif
 	PRINT_MODULE_USAGE_PARAM_COMMENT("The options -f and -r are mutually exclusive. If nothing is specified, a file 'dataman' is used");
 	PRINT_MODULE_USAGE_DEFAULT_COMMANDS();
 }
@@ -902,6 +1412,22 @@ static int backend_check()
 	return 0;
 }
 
+#if defined(__PX4_POSIX)
+bool
+dataman_get_start_options(char *path, size_t path_len, bool &use_mmap)
+{
+	if (!is_running() || path_len == 0) {
+		return false;
+	}
+
+	const bool file = (backend == BACKEND_FILE || backend == BACKEND_MMAP) && k_data_manager_device_path;
+	strncpy(path, file ? k_data_manager_device_path : "", path_len);
+	path[path_len - 1] = '\0';
+	use_mmap = (backend == BACKEND_MMAP);
+	return true;
+}
+#endif
+
 int
 dataman_main(int argc, char *argv[])
 {
@@ -920,10 +1446,11 @@ dataman_main(int argc, char *argv[])
 		int ch;
 		int dmoptind = 1;
 		const char *dmoptarg = nullptr;
+		bool use_mmap = false;
 
 		/* jump over start and look at options first */
 
-		while ((ch = px4_getopt(argc, argv, "f:r", &dmoptind, &dmoptarg)) != EOF) {
+		while ((ch = px4_getopt(argc, argv, "f:rm", &dmoptind, &dmoptarg)) != EOF) {
 			switch (ch) {
 			case 'f':
 				if (backend_check()) {
@@ -943,6 +1470,13 @@ dataman_main(int argc, char *argv[])
 				backend = BACKEND_RAM;
 				break;
 
+#if defined(__PX4_POSIX)
+
+			case 'm':
+				use_mmap = true;
+				break;
+#endif
+
 			//no break
 			default:
 				usage();
@@ -955,6 +1489,16 @@ dataman_main(int argc, char *argv[])
 			k_data_manager_device_path = strdup(default_device_path);
 		}
 
+		if (use_mmap) {
+			if (backend != BACKEND_FILE) {
+				PX4_WARN("-m requires a file");
+				usage();
+				return -1;
+			}
+
+			backend = BACKEND_MMAP;
+		}
+
 		start();
 
 		if (!is_running()) {
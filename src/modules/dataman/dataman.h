@@ -82,7 +82,11 @@ enum {
 enum {
 	DM_KEY_SAFE_POINTS_MAX = 32,
 	DM_KEY_SAFE_POINTS_STATE_MAX = 1,
+#if defined(__PX4_POSIX)
+	DM_KEY_FENCE_POINTS_MAX = 4096, // large survey fences, the navigator geofence is indexed
+#else
 	DM_KEY_FENCE_POINTS_MAX = 64,
+#endif
 	DM_KEY_FENCE_POINTS_STATE_MAX = 1,
 	DM_KEY_WAYPOINTS_OFFBOARD_0_MAX = NUM_MISSIONS_SUPPORTED,
 	DM_KEY_WAYPOINTS_OFFBOARD_1_MAX = NUM_MISSIONS_SUPPORTED,
@@ -134,7 +138,20 @@ static constexpr size_t g_per_item_size[DM_KEY_NUM_KEYS] = {
 /* increment this define whenever a binary incompatible change is performed */
 #define DM_COMPAT_VERSION	5ULL
 
+/* more fence points than the original 64 move the following items, smaller layouts keep their key */
+#define DM_COMPAT_FENCE_KEY ((DM_KEY_FENCE_POINTS_MAX > 64) ? ((uint64_t)DM_KEY_FENCE_POINTS_MAX << 40) : 0ULL)
+
 #define DM_COMPAT_KEY ((DM_COMPAT_VERSION << 32) + (sizeof(struct mission_item_s) << 24) + \
 		       (sizeof(struct mission_s) << 16) + (sizeof(struct mission_stats_entry_s) << 12) + \
 		       (sizeof(struct mission_fence_point_s) << 8) + (sizeof(struct mission_item_s) << 4) + \
-		       sizeof(struct dataman_compat_s))
+		       sizeof(struct dataman_compat_s) + DM_COMPAT_FENCE_KEY)
+
+#if defined(__PX4_POSIX)
+/**
+ * Get how the running dataman was started, so that it can be restarted the same way (used by the tests)
+ * @param path buffer for the storage file, empty for the RAM backend
+ * @param use_mmap set if the memory mapped backend is used
+ * @return false if dataman is not running
+ */
+__EXPORT bool dataman_get_start_options(char *path, size_t path_len, bool &use_mmap);
+#endif
@@ -199,13 +199,6 @@ void Ekf::predictCovariance(const imuSample &imu_delayed)
 #endif // CONFIG_EKF2_WIND
 
 
-	// covariance matrix is symmetrical, so copy upper half to lower half
-	for (unsigned row = 0; row < State::size; row++) {
-		for (unsigned column = 0; column < row; column++) {
-			P(row, column) = P(column, row);
-		}
-	}
-
 	constrainStateVariances();
 }
 
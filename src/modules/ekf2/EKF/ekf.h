@@ -72,7 +72,7 @@ class Ekf final : public EstimatorInterface
 {
 public:
 	typedef matrix::Vector<float, State::size> VectorState;
-	typedef matrix::SquareMatrix<float, State::size> SquareMatrixState;
+	typedef matrix::SymmetricMatrix<float, State::size> SymmetricMatrixState;
 	typedef matrix::SquareMatrix<float, 2> Matrix2f;
 
 	Ekf()
@@ -242,13 +242,13 @@ public:
 #endif // CONFIG_EKF2_WIND
 
 	template <const IdxDof &S>
-	matrix::Vector<float, S.dof>getStateVariance() const { return P.slice<S.dof, S.dof>(S.idx, S.idx).diag(); } // calling getStateCovariance().diag() uses more flash space
+	matrix::Vector<float, S.dof>getStateVariance() const { return P.block<S.dof>(S.idx).diag(); }
 
 	template <const IdxDof &S>
-	matrix::SquareMatrix<float, S.dof>getStateCovariance() const { return P.slice<S.dof, S.dof>(S.idx, S.idx); }
+	matrix::SquareMatrix<float, S.dof>getStateCovariance() const { return P.block<S.dof>(S.idx); }
 
-	// get the full covariance matrix
-	const matrix::SquareMatrix<float, State::size> &covariances() const { return P; }
+	// get the full covariance matrix (upper triangle storage)
+	const SymmetricMatrixState &covariances() const { return P; }
 	float stateCovariance(unsigned r, unsigned c) const { return P(r, c); }
 
 	// get the diagonal elements of the covariance matrix
@@ -477,11 +477,12 @@ public:
 		// This is extremely expensive to compute. Use for debugging purposes only.
 		auto A = matrix::eye<float, State::size>();
 		A -= K.multiplyByTranspose(H);
-		P = A * P;
-		P = P.multiplyByTranspose(A);
+		matrix::SquareMatrix<float, State::size> P_full = A * P.unpack();
+		P_full = P_full.multiplyByTranspose(A);
 
 		const VectorState KR = K * R;
-		P += KR.multiplyByTranspose(K);
+		P_full += KR.multiplyByTranspose(K);
+		P = SymmetricMatrixState(P_full);
 #else
 		// Efficient implementation of the Joseph stabilized covariance update
 		// Based on "G. J. Bierman. Factorization Methods for Discrete Sequential Estimation. Academic Press, Dover Publications, New York, 1977, 2006"
@@ -490,23 +491,15 @@ public:
 		//   =      P_temp - P_temp * H.T * K.T  + K * R * K.T
 
 		// Step 1: conventional update
-		// Compute P_temp and store it in P to avoid allocating more memory
-		// P is symmetric, so PH == H.T * P.T == H.T * P. Taking the row is faster as matrices are row-major
-		VectorState PH = P * H; // H is stored as a column vector. H is in fact H.T
+		// P_temp = P - K * PH.T is not symmetrical if K is not optimal (e.g.: some gains have been zeroed),
+		// so it can't be stored in P. Only P_temp * H = PH - K * (H.T * PH) is needed for the stabilized update.
+		const VectorState PH = P * H; // H is stored as a column vector. H is in fact H.T
+		const VectorState PtempH = PH - K * H.dot(PH);
 
+		// Step 2: stabilized update, P is symmetric so only the stored upper triangle is computed (row by row)
 		for (unsigned i = 0; i < State::size; i++) {
-			for (unsigned j = 0; j < State::size; j++) {
-				P(i, j) -= K(i) * PH(j); // P is now not symmetrical if K is not optimal (e.g.: some gains have been zeroed)
-			}
-		}
-
-		// Step 2: stabilized update
-		PH = P * H; // H is stored as a column vector. H is in fact H.T
-
-		for (unsigned i = 0; i < State::size; i++) {
-			for (unsigned j = 0; j <= i; j++) {
-				P(i, j) = P(i, j) - PH(i) * K(j) + K(i) * R * K(j);
-				P(j, i) = P(i, j);
+			for (unsigned j = i; j < State::size; j++) {
+				P(i, j) = (P(i, j) - K(j) * PH(i)) - PtempH(j) * K(i) + K(j) * R * K(i);
 			}
 		}
 #endif
@@ -592,7 +585,7 @@ private:
 	Vector2f _accel_lpf_NE{};			///< Low pass filtered horizontal earth frame acceleration (m/sec**2)
 	float _height_rate_lpf{0.0f};
 
-	SquareMatrixState P{};	///< state covariance matrix
+	SymmetricMatrixState P{};	///< state covariance matrix
 
 #if defined(CONFIG_EKF2_DRAG_FUSION)
 	estimator_aid_source2d_s _aid_src_drag{};
@@ -765,7 +758,7 @@ private:
 	void resetStateCovariance(const matrix::SquareMatrix<float, S.dof> &cov)
 	{
 		P.uncorrelateCovarianceSetVariance<S.dof>(S.idx, 0.0f);
-		P.slice<S.dof, S.dof>(S.idx, S.idx) = cov;
+		P.setBlock<S.dof>(S.idx, cov);
 	}
 
 	// update quaternion states and covariances using an innovation, observation variance and Jacobian vector
@@ -857,11 +857,12 @@ bool Ekf::fuseDirectStateMeasurement(const float innov, const float innov_var, c
 	VectorState H;
 	H(state_index) = 1.f;
 	A -= K.multiplyByTranspose(H);
-	P = A * P;
-	P = P.multiplyByTranspose(A);
+	matrix::SquareMatrix<float, State::size> P_full = A * P.unpack();
+	P_full = P_full.multiplyByTranspose(A);
 
 	const VectorState KR = K * R;
-	P += KR.multiplyByTranspose(K);
+	P_full += KR.multiplyByTranspose(K);
+	P = SymmetricMatrixState(P_full);
 #else
 	// Efficient implementation of the Joseph stabilized covariance update
 	// Based on "G. J. Bierman. Factorization Methods for Discrete Sequential Estimation. Academic Press, Dover Publications, New York, 1977, 2006"
@@ -870,24 +871,20 @@ bool Ekf::fuseDirectStateMeasurement(const float innov, const float innov_var, c
 	//   =      P_temp - P_temp * H.T * K.T  + K * R * K.T
 
 	// Step 1: conventional update
-	// Compute P_temp and store it in P to avoid allocating more memory
-	// P is symmetric, so PH == H.T * P.T == H.T * P. Taking the row is faster as matrices are row-major
-	VectorState PH = P.row(state_index);
+	// P_temp = P - K * PH.T is not symmetric if K is not optimal (e.g.: some gains have been zeroed),
+	// so it can't be stored in P. Only the column of P_temp at state_index is needed for step 2.
+	// P is symmetric, so PH == H.T * P.T == H.T * P == row of P at state_index
+	const VectorState PH = P.row(state_index);
+	VectorState PtempH;
 
 	for (unsigned i = 0; i < State::size; i++) {
-		for (unsigned j = 0; j < State::size; j++) {
-			P(i, j) -= K(i) * PH(j); // P is now not symmetric if K is not optimal (e.g.: some gains have been zeroed)
-		}
+		PtempH(i) = P(i, state_index) - K(i) * PH(state_index);
 	}
 
-	// Step 2: stabilized update
-	// P (or "P_temp") is not symmetric so we must take the column
-	PH = P.col(state_index);
-
+	// Step 2: stabilized update, P is symmetric so only the stored upper triangle is computed (row by row)
 	for (unsigned i = 0; i < State::size; i++) {
-		for (unsigned j = 0; j <= i; j++) {
-			P(i, j) = P(i, j) - PH(i) * K(j) + K(i) * R * K(j);
-			P(j, i) = P(i, j);
+		for (unsigned j = i; j < State::size; j++) {
+			P(i, j) = (P(i, j) - K(j) * PH(i)) - PtempH(j) * K(i) + K(j) * R * K(i);
 		}
 	}
 #endif
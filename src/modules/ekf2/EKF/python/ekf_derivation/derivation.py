@@ -611,29 +611,29 @@ def compute_gravity_z_innov_var_and_h(
     return (innov_var, H.T)
 
 print("Derive EKF2 equations...")
-generate_px4_function(predict_covariance, output_names=None)
+generate_px4_function(predict_covariance, output_names=None, symmetric_dim=State.tangent_dim())
 
 if not args.disable_mag:
-    generate_px4_function(compute_mag_declination_pred_innov_var_and_h, output_names=["pred", "innov_var", "H"])
-    generate_px4_function(compute_mag_innov_innov_var_and_hx, output_names=["innov", "innov_var", "Hx"])
-    generate_px4_function(compute_mag_y_innov_var_and_h, output_names=["innov_var", "H"])
-    generate_px4_function(compute_mag_z_innov_var_and_h, output_names=["innov_var", "H"])
+    generate_px4_function(compute_mag_declination_pred_innov_var_and_h, output_names=["pred", "innov_var", "H"], symmetric_dim=State.tangent_dim())
+    generate_px4_function(compute_mag_innov_innov_var_and_hx, output_names=["innov", "innov_var", "Hx"], symmetric_dim=State.tangent_dim())
+    generate_px4_function(compute_mag_y_innov_var_and_h, output_names=["innov_var", "H"], symmetric_dim=State.tangent_dim())
+    generate_px4_function(compute_mag_z_innov_var_and_h, output_names=["innov_var", "H"], symmetric_dim=State.tangent_dim())
 
 if not args.disable_wind:
-    generate_px4_function(compute_airspeed_h_and_k, output_names=["H", "K"])
-    generate_px4_function(compute_airspeed_innov_and_innov_var, output_names=["innov", "innov_var"])
-    generate_px4_function(compute_drag_x_innov_var_and_h, output_names=["innov_var", "Hx"])
-    generate_px4_function(compute_drag_y_innov_var_and_h, output_names=["innov_var", "Hy"])
-    generate_px4_function(compute_sideslip_h_and_k, output_names=["H", "K"])
-    generate_px4_function(compute_sideslip_innov_and_innov_var, output_names=["innov", "innov_var"])
-    generate_px4_function(compute_wind_init_and_cov_from_airspeed, output_names=["wind", "P_wind"])
-
-generate_px4_function(compute_yaw_innov_var_and_h, output_names=["innov_var", "H"])
-generate_px4_function(compute_flow_xy_innov_var_and_hx, output_names=["innov_var", "H"])
-generate_px4_function(compute_flow_y_innov_var_and_h, output_names=["innov_var", "H"])
-generate_px4_function(compute_gnss_yaw_pred_innov_var_and_h, output_names=["meas_pred", "innov_var", "H"])
-generate_px4_function(compute_gravity_xyz_innov_var_and_hx, output_names=["innov_var", "Hx"])
-generate_px4_function(compute_gravity_y_innov_var_and_h, output_names=["innov_var", "Hy"])
-generate_px4_function(compute_gravity_z_innov_var_and_h, output_names=["innov_var", "Hz"])
+    generate_px4_function(compute_airspeed_h_and_k, output_names=["H", "K"], symmetric_dim=State.tangent_dim())
+    generate_px4_function(compute_airspeed_innov_and_innov_var, output_names=["innov", "innov_var"], symmetric_dim=State.tangent_dim())
+    generate_px4_function(compute_drag_x_innov_var_and_h, output_names=["innov_var", "Hx"], symmetric_dim=State.tangent_dim())
+    generate_px4_function(compute_drag_y_innov_var_and_h, output_names=["innov_var", "Hy"], symmetric_dim=State.tangent_dim())
+    generate_px4_function(compute_sideslip_h_and_k, output_names=["H", "K"], symmetric_dim=State.tangent_dim())
+    generate_px4_function(compute_sideslip_innov_and_innov_var, output_names=["innov", "innov_var"], symmetric_dim=State.tangent_dim())
+    generate_px4_function(compute_wind_init_and_cov_from_airspeed, output_names=["wind", "P_wind"], symmetric_dim=State.tangent_dim())
+
+generate_px4_function(compute_yaw_innov_var_and_h, output_names=["innov_var", "H"], symmetric_dim=State.tangent_dim())
+generate_px4_function(compute_flow_xy_innov_var_and_hx, output_names=["innov_var", "H"], symmetric_dim=State.tangent_dim())
+generate_px4_function(compute_flow_y_innov_var_and_h, output_names=["innov_var", "H"], symmetric_dim=State.tangent_dim())
+generate_px4_function(compute_gnss_yaw_pred_innov_var_and_h, output_names=["meas_pred", "innov_var", "H"], symmetric_dim=State.tangent_dim())
+generate_px4_function(compute_gravity_xyz_innov_var_and_hx, output_names=["innov_var", "Hx"], symmetric_dim=State.tangent_dim())
+generate_px4_function(compute_gravity_y_innov_var_and_h, output_names=["innov_var", "Hy"], symmetric_dim=State.tangent_dim())
+generate_px4_function(compute_gravity_z_innov_var_and_h, output_names=["innov_var", "Hz"], symmetric_dim=State.tangent_dim())
 
 generate_px4_state(State, tangent_idx)
@@ -48,7 +48,11 @@ def add_epsilon_sign(expr, var, eps):
     # Avoids a singularity at 0 while keeping the derivative correct
     return expr.subs(var, var + eps * sign_no_zero(var))
 
-def generate_px4_function(function_name, output_names):
+def generate_px4_function(function_name, output_names, symmetric_dim=None):
+    """
+    symmetric_dim: size of the symmetric matrices (e.g.: the state covariance) that
+    are passed and returned as packed matrix::SymmetricMatrix
+    """
     from symforce.codegen import Codegen, CppConfig
     import os
     import fileinput
@@ -75,6 +79,17 @@ def generate_px4_function(function_name, output_names):
             # don't allow underscore + uppercase identifier naming (always reserved for any use)
             line = re.sub(r'_([A-Z])', lambda x: '_' + x.group(1).lower(), line)
 
+            if symmetric_dim is not None:
+                line = line.replace(f"matrix::Matrix<Scalar, {symmetric_dim}, {symmetric_dim}>",
+                                    f"matrix::SymmetricMatrix<Scalar, {symmetric_dim}>")
+
+                # the lower triangle of a symmetric result is not derived (set to 0) and shares
+                # its storage with the upper triangle, don't overwrite it
+                match = re.match(r'\s*_res\((\d+), (\d+)\) = 0;$', line)
+
+                if match and int(match.group(1)) > int(match.group(2)):
+                    continue
+
             print(line, end='')
 
 def generate_python_function(function_name, output_names):
@@ -30,7 +30,7 @@ namespace sym {
  */
 template <typename Scalar>
 void ComputeDragYInnovVarAndH(const matrix::Matrix<Scalar, 24, 1>& state,
-                              const matrix::Matrix<Scalar, 23, 23>& P, const Scalar rho,
+                              const matrix::SymmetricMatrix<Scalar, 23>& P, const Scalar rho,
                               const Scalar cd, const Scalar cm, const Scalar R,
                               const Scalar epsilon, Scalar* const innov_var = nullptr,
                               matrix::Matrix<Scalar, 23, 1>* const Hy = nullptr) {
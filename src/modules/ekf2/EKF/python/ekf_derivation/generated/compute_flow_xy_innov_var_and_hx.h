@@ -28,7 +28,7 @@ namespace sym {
  */
 template <typename Scalar>
 void ComputeFlowXyInnovVarAndHx(const matrix::Matrix<Scalar, 24, 1>& state,
-                                const matrix::Matrix<Scalar, 23, 23>& P, const Scalar distance,
+                                const matrix::SymmetricMatrix<Scalar, 23>& P, const Scalar distance,
                                 const Scalar R, const Scalar epsilon,
                                 matrix::Matrix<Scalar, 2, 1>* const innov_var = nullptr,
                                 matrix::Matrix<Scalar, 23, 1>* const H = nullptr) {
@@ -29,7 +29,7 @@ namespace sym {
  */
 template <typename Scalar>
 void ComputeGnssYawPredInnovVarAndH(const matrix::Matrix<Scalar, 24, 1>& state,
-                                    const matrix::Matrix<Scalar, 23, 23>& P,
+                                    const matrix::SymmetricMatrix<Scalar, 23>& P,
                                     const Scalar antenna_yaw_offset, const Scalar R,
                                     const Scalar epsilon, Scalar* const meas_pred = nullptr,
                                     Scalar* const innov_var = nullptr,
@@ -26,7 +26,7 @@ namespace sym {
  */
 template <typename Scalar>
 void ComputeGravityXyzInnovVarAndHx(const matrix::Matrix<Scalar, 24, 1>& state,
-                                    const matrix::Matrix<Scalar, 23, 23>& P, const Scalar R,
+                                    const matrix::SymmetricMatrix<Scalar, 23>& P, const Scalar R,
                                     matrix::Matrix<Scalar, 3, 1>* const innov_var = nullptr,
                                     matrix::Matrix<Scalar, 23, 1>* const Hx = nullptr) {
   // Total ops: 51
@@ -26,7 +26,7 @@ namespace sym {
  */
 template <typename Scalar>
 void ComputeGravityZInnovVarAndH(const matrix::Matrix<Scalar, 24, 1>& state,
-                                 const matrix::Matrix<Scalar, 23, 23>& P, const Scalar R,
+                                 const matrix::SymmetricMatrix<Scalar, 23>& P, const Scalar R,
                                  Scalar* const innov_var = nullptr,
                                  matrix::Matrix<Scalar, 23, 1>* const Hz = nullptr) {
   // Total ops: 18
@@ -28,7 +28,7 @@ namespace sym {
  */
 template <typename Scalar>
 void ComputeMagDeclinationPredInnovVarAndH(const matrix::Matrix<Scalar, 24, 1>& state,
-                                           const matrix::Matrix<Scalar, 23, 23>& P, const Scalar R,
+                                           const matrix::SymmetricMatrix<Scalar, 23>& P, const Scalar R,
                                            const Scalar epsilon, Scalar* const pred = nullptr,
                                            Scalar* const innov_var = nullptr,
                                            matrix::Matrix<Scalar, 23, 1>* const H = nullptr) {
@@ -29,7 +29,7 @@ namespace sym {
  */
 template <typename Scalar>
 void ComputeMagInnovInnovVarAndHx(const matrix::Matrix<Scalar, 24, 1>& state,
-                                  const matrix::Matrix<Scalar, 23, 23>& P,
+                                  const matrix::SymmetricMatrix<Scalar, 23>& P,
                                   const matrix::Matrix<Scalar, 3, 1>& meas, const Scalar R,
                                   const Scalar epsilon,
                                   matrix::Matrix<Scalar, 3, 1>* const innov = nullptr,
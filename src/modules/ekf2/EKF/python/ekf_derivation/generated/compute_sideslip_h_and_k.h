@@ -27,7 +27,7 @@ namespace sym {
  */
 template <typename Scalar>
 void ComputeSideslipHAndK(const matrix::Matrix<Scalar, 24, 1>& state,
-                          const matrix::Matrix<Scalar, 23, 23>& P, const Scalar innov_var,
+                          const matrix::SymmetricMatrix<Scalar, 23>& P, const Scalar innov_var,
                           const Scalar epsilon, matrix::Matrix<Scalar, 23, 1>* const H = nullptr,
                           matrix::Matrix<Scalar, 23, 1>* const K = nullptr) {
   // Total ops: 469
@@ -27,7 +27,7 @@ namespace sym {
  */
 template <typename Scalar>
 void ComputeSideslipInnovAndInnovVar(const matrix::Matrix<Scalar, 24, 1>& state,
-                                     const matrix::Matrix<Scalar, 23, 23>& P, const Scalar R,
+                                     const matrix::SymmetricMatrix<Scalar, 23>& P, const Scalar R,
                                      const Scalar epsilon, Scalar* const innov = nullptr,
                                      Scalar* const innov_var = nullptr) {
   // Total ops: 235
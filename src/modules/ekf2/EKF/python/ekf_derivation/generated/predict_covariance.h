@@ -28,8 +28,8 @@ namespace sym {
  *     res: Matrix23_23
  */
 template <typename Scalar>
-matrix::Matrix<Scalar, 23, 23> PredictCovariance(const matrix::Matrix<Scalar, 24, 1>& state,
-                                                const matrix::Matrix<Scalar, 23, 23>& P,
+matrix::SymmetricMatrix<Scalar, 23> PredictCovariance(const matrix::Matrix<Scalar, 24, 1>& state,
+                                                const matrix::SymmetricMatrix<Scalar, 23>& P,
                                                 const matrix::Matrix<Scalar, 3, 1>& accel,
                                                 const matrix::Matrix<Scalar, 3, 1>& accel_var,
                                                 const matrix::Matrix<Scalar, 3, 1>& gyro,
@@ -197,77 +197,14 @@ matrix::Matrix<Scalar, 23, 23> PredictCovariance(const matrix::Matrix<Scalar, 24
                          P(13, 5) * _tmp119 - P(14, 5) * _tmp117 + P(2, 5) * _tmp120 + P(5, 5);
 
   // Output terms (1)
-  matrix::Matrix<Scalar, 23, 23> _res;
+  matrix::SymmetricMatrix<Scalar, 23> _res;
 
   _res(0, 0) = _tmp10 + _tmp11 + _tmp2 * _tmp6 + _tmp5 * _tmp7 - _tmp8 * dt;
-  _res(1, 0) = 0;
-  _res(2, 0) = 0;
-  _res(3, 0) = 0;
-  _res(4, 0) = 0;
-  _res(5, 0) = 0;
-  _res(6, 0) = 0;
-  _res(7, 0) = 0;
-  _res(8, 0) = 0;
-  _res(9, 0) = 0;
-  _res(10, 0) = 0;
-  _res(11, 0) = 0;
-  _res(12, 0) = 0;
-  _res(13, 0) = 0;
-  _res(14, 0) = 0;
-  _res(15, 0) = 0;
-  _res(16, 0) = 0;
-  _res(17, 0) = 0;
-  _res(18, 0) = 0;
-  _res(19, 0) = 0;
-  _res(20, 0) = 0;
-  _res(21, 0) = 0;
-  _res(22, 0) = 0;
   _res(0, 1) = _tmp11 * _tmp13 - _tmp12 * dt + _tmp16 * _tmp6 + _tmp7;
   _res(1, 1) = _tmp10 + _tmp13 * _tmp18 + _tmp16 * _tmp19 - _tmp17 * dt + _tmp20;
-  _res(2, 1) = 0;
-  _res(3, 1) = 0;
-  _res(4, 1) = 0;
-  _res(5, 1) = 0;
-  _res(6, 1) = 0;
-  _res(7, 1) = 0;
-  _res(8, 1) = 0;
-  _res(9, 1) = 0;
-  _res(10, 1) = 0;
-  _res(11, 1) = 0;
-  _res(12, 1) = 0;
-  _res(13, 1) = 0;
-  _res(14, 1) = 0;
-  _res(15, 1) = 0;
-  _res(16, 1) = 0;
-  _res(17, 1) = 0;
-  _res(18, 1) = 0;
-  _res(19, 1) = 0;
-  _res(20, 1) = 0;
-  _res(21, 1) = 0;
-  _res(22, 1) = 0;
   _res(0, 2) = _tmp11 * _tmp22 - _tmp21 * dt + _tmp23 * _tmp7 + _tmp6;
   _res(1, 2) = _tmp18 * _tmp22 + _tmp19 + _tmp20 * _tmp23 - _tmp24 * dt;
   _res(2, 2) = _tmp10 + _tmp22 * _tmp27 + _tmp23 * _tmp26 - _tmp25 * dt + _tmp28;
-  _res(3, 2) = 0;
-  _res(4, 2) = 0;
-  _res(5, 2) = 0;
-  _res(6, 2) = 0;
-  _res(7, 2) = 0;
-  _res(8, 2) = 0;
-  _res(9, 2) = 0;
-  _res(10, 2) = 0;
-  _res(11, 2) = 0;
-  _res(12, 2) = 0;
-  _res(13, 2) = 0;
-  _res(14, 2) = 0;
-  _res(15, 2) = 0;
-  _res(16, 2) = 0;
-  _res(17, 2) = 0;
-  _res(18, 2) = 0;
-  _res(19, 2) = 0;
-  _res(20, 2) = 0;
-  _res(21, 2) = 0;
-  _res(22, 2) = 0;
   _res(0, 3) = _tmp11 * _tmp63 + _tmp45 * _tmp6 - _tmp46 * _tmp50 + _tmp60 * _tmp7 -
                _tmp64 * _tmp65 - _tmp66 * _tmp67 + _tmp68;
   _res(1, 3) = _tmp18 * _tmp63 + _tmp19 * _tmp45 + _tmp20 * _tmp60 - _tmp50 * _tmp71 -
@@ -278,25 +215,6 @@ matrix::Matrix<Scalar, 23, 23> PredictCovariance(const matrix::Matrix<Scalar, 24
                std::pow(_tmp49, Scalar(2)) * _tmp81 - _tmp50 * _tmp85 + _tmp60 * _tmp77 +
                std::pow(_tmp61, Scalar(2)) * _tmp84 + _tmp63 * _tmp80 - _tmp65 * _tmp79 -
                _tmp67 * _tmp78 + _tmp86;
-  _res(4, 3) = 0;
-  _res(5, 3) = 0;
-  _res(6, 3) = 0;
-  _res(7, 3) = 0;
-  _res(8, 3) = 0;
-  _res(9, 3) = 0;
-  _res(10, 3) = 0;
-  _res(11, 3) = 0;
-  _res(12, 3) = 0;
-  _res(13, 3) = 0;
-  _res(14, 3) = 0;
-  _res(15, 3) = 0;
-  _res(16, 3) = 0;
-  _res(17, 3) = 0;
-  _res(18, 3) = 0;
-  _res(19, 3) = 0;
-  _res(20, 3) = 0;
-  _res(21, 3) = 0;
-  _res(22, 3) = 0;
   _res(0, 4) = -_tmp100 * _tmp46 + _tmp101 + _tmp11 * _tmp91 + _tmp6 * _tmp92 - _tmp64 * _tmp95 -
                _tmp66 * _tmp96 + _tmp7 * _tmp99;
   _res(1, 4) = -_tmp100 * _tmp71 + _tmp102 + _tmp18 * _tmp91 + _tmp19 * _tmp92 + _tmp20 * _tmp99 -
@@ -310,24 +228,6 @@ matrix::Matrix<Scalar, 23, 23> PredictCovariance(const matrix::Matrix<Scalar, 24
                _tmp112 * _tmp99 + _tmp113 * _tmp92 + _tmp114 +
                _tmp81 * std::pow(_tmp97, Scalar(2)) + _tmp83 * std::pow(_tmp94, Scalar(2)) +
                _tmp84 * std::pow(_tmp90, Scalar(2));
-  _res(5, 4) = 0;
-  _res(6, 4) = 0;
-  _res(7, 4) = 0;
-  _res(8, 4) = 0;
-  _res(9, 4) = 0;
-  _res(10, 4) = 0;
-  _res(11, 4) = 0;
-  _res(12, 4) = 0;
-  _res(13, 4) = 0;
-  _res(14, 4) = 0;
-  _res(15, 4) = 0;
-  _res(16, 4) = 0;
-  _res(17, 4) = 0;
-  _res(18, 4) = 0;
-  _res(19, 4) = 0;
-  _res(20, 4) = 0;
-  _res(21, 4) = 0;
-  _res(22, 4) = 0;
   _res(0, 5) = _tmp11 * _tmp115 - _tmp117 * _tmp66 - _tmp119 * _tmp64 + _tmp120 * _tmp6 +
                _tmp122 * _tmp7 - _tmp123 * _tmp46 + _tmp124;
   _res(1, 5) = _tmp115 * _tmp18 - _tmp117 * _tmp70 - _tmp119 * _tmp69 + _tmp120 * _tmp19 +
@@ -350,23 +250,6 @@ matrix::Matrix<Scalar, 23, 23> PredictCovariance(const matrix::Matrix<Scalar, 24
                _tmp122 * (P(0, 1) * _tmp115 + P(1, 1) * _tmp122 - P(12, 1) * _tmp123 -
                           P(13, 1) * _tmp119 - P(14, 1) * _tmp117 + P(2, 1) * _tmp120 + P(5, 1)) -
                _tmp123 * _tmp132 + _tmp133;
-  _res(6, 5) = 0;
-  _res(7, 5) = 0;
-  _res(8, 5) = 0;
-  _res(9, 5) = 0;
-  _res(10, 5) = 0;
-  _res(11, 5) = 0;
-  _res(12, 5) = 0;
-  _res(13, 5) = 0;
-  _res(14, 5) = 0;
-  _res(15, 5) = 0;
-  _res(16, 5) = 0;
-  _res(17, 5) = 0;
-  _res(18, 5) = 0;
-  _res(19, 5) = 0;
-  _res(20, 5) = 0;
-  _res(21, 5) = 0;
-  _res(22, 5) = 0;
   _res(0, 6) = P(0, 6) + P(1, 6) * _tmp5 + P(2, 6) * _tmp2 - P(9, 6) * dt + _tmp68 * dt;
   _res(1, 6) = P(0, 6) * _tmp13 + P(1, 6) - P(10, 6) * dt + P(2, 6) * _tmp16 + _tmp72 * dt;
   _res(2, 6) = P(0, 6) * _tmp22 + P(1, 6) * _tmp23 - P(11, 6) * dt + P(2, 6) + _tmp76 * dt;
@@ -381,22 +264,6 @@ matrix::Matrix<Scalar, 23, 23> PredictCovariance(const matrix::Matrix<Scalar, 24
                dt * (P(0, 3) * _tmp115 + P(1, 3) * _tmp122 - P(12, 3) * _tmp123 -
                      P(13, 3) * _tmp119 - P(14, 3) * _tmp117 + P(2, 3) * _tmp120 + P(5, 3));
   _res(6, 6) = P(3, 6) * dt + P(6, 6) + dt * (P(3, 3) * dt + P(6, 3));
-  _res(7, 6) = 0;
-  _res(8, 6) = 0;
-  _res(9, 6) = 0;
-  _res(10, 6) = 0;
-  _res(11, 6) = 0;
-  _res(12, 6) = 0;
-  _res(13, 6) = 0;
-  _res(14, 6) = 0;
-  _res(15, 6) = 0;
-  _res(16, 6) = 0;
-  _res(17, 6) = 0;
-  _res(18, 6) = 0;
-  _res(19, 6) = 0;
-  _res(20, 6) = 0;
-  _res(21, 6) = 0;
-  _res(22, 6) = 0;
   _res(0, 7) = P(0, 7) + P(1, 7) * _tmp5 + P(2, 7) * _tmp2 - P(9, 7) * dt + _tmp101 * dt;
   _res(1, 7) = P(0, 7) * _tmp13 + P(1, 7) - P(10, 7) * dt + P(2, 7) * _tmp16 + _tmp102 * dt;
   _res(2, 7) = P(0, 7) * _tmp22 + P(1, 7) * _tmp23 - P(11, 7) * dt + P(2, 7) + _tmp104 * dt;
@@ -410,21 +277,6 @@ matrix::Matrix<Scalar, 23, 23> PredictCovariance(const matrix::Matrix<Scalar, 24
                      P(13, 4) * _tmp119 - P(14, 4) * _tmp117 + P(2, 4) * _tmp120 + P(5, 4));
   _res(6, 7) = P(3, 7) * dt + P(6, 7) + dt * (P(3, 4) * dt + P(6, 4));
   _res(7, 7) = P(4, 7) * dt + P(7, 7) + dt * (P(4, 4) * dt + P(7, 4));
-  _res(8, 7) = 0;
-  _res(9, 7) = 0;
-  _res(10, 7) = 0;
-  _res(11, 7) = 0;
-  _res(12, 7) = 0;
-  _res(13, 7) = 0;
-  _res(14, 7) = 0;
-  _res(15, 7) = 0;
-  _res(16, 7) = 0;
-  _res(17, 7) = 0;
-  _res(18, 7) = 0;
-  _res(19, 7) = 0;
-  _res(20, 7) = 0;
-  _res(21, 7) = 0;
-  _res(22, 7) = 0;
   _res(0, 8) = P(0, 8) + P(1, 8) * _tmp5 + P(2, 8) * _tmp2 - P(9, 8) * dt + _tmp124 * dt;
   _res(1, 8) = P(0, 8) * _tmp13 + P(1, 8) - P(10, 8) * dt + P(2, 8) * _tmp16 + _tmp125 * dt;
   _res(2, 8) = P(0, 8) * _tmp22 + P(1, 8) * _tmp23 - P(11, 8) * dt + P(2, 8) + _tmp126 * dt;
@@ -437,20 +289,6 @@ matrix::Matrix<Scalar, 23, 23> PredictCovariance(const matrix::Matrix<Scalar, 24
   _res(6, 8) = P(3, 8) * dt + P(6, 8) + dt * (P(3, 5) * dt + P(6, 5));
   _res(7, 8) = P(4, 8) * dt + P(7, 8) + dt * (P(4, 5) * dt + P(7, 5));
   _res(8, 8) = P(5, 8) * dt + P(8, 8) + dt * (P(5, 5) * dt + P(8, 5));
-  _res(9, 8) = 0;
-  _res(10, 8) = 0;
-  _res(11, 8) = 0;
-  _res(12, 8) = 0;
-  _res(13, 8) = 0;
-  _res(14, 8) = 0;
-  _res(15, 8) = 0;
-  _res(16, 8) = 0;
-  _res(17, 8) = 0;
-  _res(18, 8) = 0;
-  _res(19, 8) = 0;
-  _res(20, 8) = 0;
-  _res(21, 8) = 0;
-  _res(22, 8) = 0;
   _res(0, 9) = _tmp8;
   _res(1, 9) = P(0, 9) * _tmp13 + P(1, 9) - P(10, 9) * dt + P(2, 9) * _tmp16;
   _res(2, 9) = P(0, 9) * _tmp22 + P(1, 9) * _tmp23 - P(11, 9) * dt + P(2, 9);
@@ -464,19 +302,6 @@ matrix::Matrix<Scalar, 23, 23> PredictCovariance(const matrix::Matrix<Scalar, 24
   _res(7, 9) = P(4, 9) * dt + P(7, 9);
   _res(8, 9) = P(5, 9) * dt + P(8, 9);
   _res(9, 9) = P(9, 9);
-  _res(10, 9) = 0;
-  _res(11, 9) = 0;
-  _res(12, 9) = 0;
-  _res(13, 9) = 0;
-  _res(14, 9) = 0;
-  _res(15, 9) = 0;
-  _res(16, 9) = 0;
-  _res(17, 9) = 0;
-  _res(18, 9) = 0;
-  _res(19, 9) = 0;
-  _res(20, 9) = 0;
-  _res(21, 9) = 0;
-  _res(22, 9) = 0;
   _res(0, 10) = _tmp12;
   _res(1, 10) = _tmp17;
   _res(2, 10) = P(0, 10) * _tmp22 + P(1, 10) * _tmp23 - P(11, 10) * dt + P(2, 10);
@@ -491,18 +316,6 @@ matrix::Matrix<Scalar, 23, 23> PredictCovariance(const matrix::Matrix<Scalar, 24
   _res(8, 10) = P(5, 10) * dt + P(8, 10);
   _res(9, 10) = P(9, 10);
   _res(10, 10) = P(10, 10);
-  _res(11, 10) = 0;
-  _res(12, 10) = 0;
-  _res(13, 10) = 0;
-  _res(14, 10) = 0;
-  _res(15, 10) = 0;
-  _res(16, 10) = 0;
-  _res(17, 10) = 0;
-  _res(18, 10) = 0;
-  _res(19, 10) = 0;
-  _res(20, 10) = 0;
-  _res(21, 10) = 0;
-  _res(22, 10) = 0;
   _res(0, 11) = _tmp21;
   _res(1, 11) = _tmp24;
   _res(2, 11) = _tmp25;
@@ -518,17 +331,6 @@ matrix::Matrix<Scalar, 23, 23> PredictCovariance(const matrix::Matrix<Scalar, 24
   _res(9, 11) = P(9, 11);
   _res(10, 11) = P(10, 11);
   _res(11, 11) = P(11, 11);
-  _res(12, 11) = 0;
-  _res(13, 11) = 0;
-  _res(14, 11) = 0;
-  _res(15, 11) = 0;
-  _res(16, 11) = 0;
-  _res(17, 11) = 0;
-  _res(18, 11) = 0;
-  _res(19, 11) = 0;
-  _res(20, 11) = 0;
-  _res(21, 11) = 0;
-  _res(22, 11) = 0;
   _res(0, 12) = _tmp46;
   _res(1, 12) = _tmp71;
   _res(2, 12) = _tmp75;
@@ -542,16 +344,6 @@ matrix::Matrix<Scalar, 23, 23> PredictCovariance(const matrix::Matrix<Scalar, 24
   _res(10, 12) = P(10, 12);
   _res(11, 12) = P(11, 12);
   _res(12, 12) = P(12, 12);
-  _res(13, 12) = 0;
-  _res(14, 12) = 0;
-  _res(15, 12) = 0;
-  _res(16, 12) = 0;
-  _res(17, 12) = 0;
-  _res(18, 12) = 0;
-  _res(19, 12) = 0;
-  _res(20, 12) = 0;
-  _res(21, 12) = 0;
-  _res(22, 12) = 0;
   _res(0, 13) = _tmp64;
   _res(1, 13) = _tmp69;
   _res(2, 13) = _tmp74;
@@ -566,15 +358,6 @@ matrix::Matrix<Scalar, 23, 23> PredictCovariance(const matrix::Matrix<Scalar, 24
   _res(11, 13) = P(11, 13);
   _res(12, 13) = P(12, 13);
   _res(13, 13) = P(13, 13);
-  _res(14, 13) = 0;
-  _res(15, 13) = 0;
-  _res(16, 13) = 0;
-  _res(17, 13) = 0;
-  _res(18, 13) = 0;
-  _res(19, 13) = 0;
-  _res(20, 13) = 0;
-  _res(21, 13) = 0;
-  _res(22, 13) = 0;
   _res(0, 14) = _tmp66;
   _res(1, 14) = _tmp70;
   _res(2, 14) = _tmp73;
@@ -590,14 +373,6 @@ matrix::Matrix<Scalar, 23, 23> PredictCovariance(const matrix::Matrix<Scalar, 24
   _res(12, 14) = P(12, 14);
   _res(13, 14) = P(13, 14);
   _res(14, 14) = P(14, 14);
-  _res(15, 14) = 0;
-  _res(16, 14) = 0;
-  _res(17, 14) = 0;
-  _res(18, 14) = 0;
-  _res(19, 14) = 0;
-  _res(20, 14) = 0;
-  _res(21, 14) = 0;
-  _res(22, 14) = 0;
   _res(0, 15) = P(0, 15) + P(1, 15) * _tmp5 + P(2, 15) * _tmp2 - P(9, 15) * dt;
   _res(1, 15) = P(0, 15) * _tmp13 + P(1, 15) - P(10, 15) * dt + P(2, 15) * _tmp16;
   _res(2, 15) = P(0, 15) * _tmp22 + P(1, 15) * _tmp23 - P(11, 15) * dt + P(2, 15);
@@ -617,13 +392,6 @@ matrix::Matrix<Scalar, 23, 23> PredictCovariance(const matrix::Matrix<Scalar, 24
   _res(13, 15) = P(13, 15);
   _res(14, 15) = P(14, 15);
   _res(15, 15) = P(15, 15);
-  _res(16, 15) = 0;
-  _res(17, 15) = 0;
-  _res(18, 15) = 0;
-  _res(19, 15) = 0;
-  _res(20, 15) = 0;
-  _res(21, 15) = 0;
-  _res(22, 15) = 0;
   _res(0, 16) = P(0, 16) + P(1, 16) * _tmp5 + P(2, 16) * _tmp2 - P(9, 16) * dt;
   _res(1, 16) = P(0, 16) * _tmp13 + P(1, 16) - P(10, 16) * dt + P(2, 16) * _tmp16;
   _res(2, 16) = P(0, 16) * _tmp22 + P(1, 16) * _tmp23 - P(11, 16) * dt + P(2, 16);
@@ -644,12 +412,6 @@ matrix::Matrix<Scalar, 23, 23> PredictCovariance(const matrix::Matrix<Scalar, 24
   _res(14, 16) = P(14, 16);
   _res(15, 16) = P(15, 16);
   _res(16, 16) = P(16, 16);
-  _res(17, 16) = 0;
-  _res(18, 16) = 0;
-  _res(19, 16) = 0;
-  _res(20, 16) = 0;
-  _res(21, 16) = 0;
-  _res(22, 16) = 0;
   _res(0, 17) = P(0, 17) + P(1, 17) * _tmp5 + P(2, 17) * _tmp2 - P(9, 17) * dt;
   _res(1, 17) = P(0, 17) * _tmp13 + P(1, 17) - P(10, 17) * dt + P(2, 17) * _tmp16;
   _res(2, 17) = P(0, 17) * _tmp22 + P(1, 17) * _tmp23 - P(11, 17) * dt + P(2, 17);
@@ -671,11 +433,6 @@ matrix::Matrix<Scalar, 23, 23> PredictCovariance(const matrix::Matrix<Scalar, 24
   _res(15, 17) = P(15, 17);
   _res(16, 17) = P(16, 17);
   _res(17, 17) = P(17, 17);
-  _res(18, 17) = 0;
-  _res(19, 17) = 0;
-  _res(20, 17) = 0;
-  _res(21, 17) = 0;
-  _res(22, 17) = 0;
   _res(0, 18) = P(0, 18) + P(1, 18) * _tmp5 + P(2, 18) * _tmp2 - P(9, 18) * dt;
   _res(1, 18) = P(0, 18) * _tmp13 + P(1, 18) - P(10, 18) * dt + P(2, 18) * _tmp16;
   _res(2, 18) = P(0, 18) * _tmp22 + P(1, 18) * _tmp23 - P(11, 18) * dt + P(2, 18);
@@ -698,10 +455,6 @@ matrix::Matrix<Scalar, 23, 23> PredictCovariance(const matrix::Matrix<Scalar, 24
   _res(16, 18) = P(16, 18);
   _res(17, 18) = P(17, 18);
   _res(18, 18) = P(18, 18);
-  _res(19, 18) = 0;
-  _res(20, 18) = 0;
-  _res(21, 18) = 0;
-  _res(22, 18) = 0;
   _res(0, 19) = P(0, 19) + P(1, 19) * _tmp5 + P(2, 19) * _tmp2 - P(9, 19) * dt;
   _res(1, 19) = P(0, 19) * _tmp13 + P(1, 19) - P(10, 19) * dt + P(2, 19) * _tmp16;
   _res(2, 19) = P(0, 19) * _tmp22 + P(1, 19) * _tmp23 - P(11, 19) * dt + P(2, 19);
@@ -725,9 +478,6 @@ matrix::Matrix<Scalar, 23, 23> PredictCovariance(const matrix::Matrix<Scalar, 24
   _res(17, 19) = P(17, 19);
   _res(18, 19) = P(18, 19);
   _res(19, 19) = P(19, 19);
-  _res(20, 19) = 0;
-  _res(21, 19) = 0;
-  _res(22, 19) = 0;
   _res(0, 20) = P(0, 20) + P(1, 20) * _tmp5 + P(2, 20) * _tmp2 - P(9, 20) * dt;
   _res(1, 20) = P(0, 20) * _tmp13 + P(1, 20) - P(10, 20) * dt + P(2, 20) * _tmp16;
   _res(2, 20) = P(0, 20) * _tmp22 + P(1, 20) * _tmp23 - P(11, 20) * dt + P(2, 20);
@@ -752,8 +502,6 @@ matrix::Matrix<Scalar, 23, 23> PredictCovariance(const matrix::Matrix<Scalar, 24
   _res(18, 20) = P(18, 20);
   _res(19, 20) = P(19, 20);
   _res(20, 20) = P(20, 20);
-  _res(21, 20) = 0;
-  _res(22, 20) = 0;
   _res(0, 21) = P(0, 21) + P(1, 21) * _tmp5 + P(2, 21) * _tmp2 - P(9, 21) * dt;
   _res(1, 21) = P(0, 21) * _tmp13 + P(1, 21) - P(10, 21) * dt + P(2, 21) * _tmp16;
   _res(2, 21) = P(0, 21) * _tmp22 + P(1, 21) * _tmp23 - P(11, 21) * dt + P(2, 21);
@@ -779,7 +527,6 @@ matrix::Matrix<Scalar, 23, 23> PredictCovariance(const matrix::Matrix<Scalar, 24
   _res(19, 21) = P(19, 21);
   _res(20, 21) = P(20, 21);
   _res(21, 21) = P(21, 21);
-  _res(22, 21) = 0;
   _res(0, 22) = P(0, 22) + P(1, 22) * _tmp5 + P(2, 22) * _tmp2 - P(9, 22) * dt;
   _res(1, 22) = P(0, 22) * _tmp13 + P(1, 22) - P(10, 22) * dt + P(2, 22) * _tmp16;
   _res(2, 22) = P(0, 22) * _tmp22 + P(1, 22) * _tmp23 - P(11, 22) * dt + P(2, 22);
@@ -0,0 +1,514 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "batch_replay.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace
+{
+
+struct FloatParam {
+	const char *name;
+	float parameters::*field;
+};
+
+struct IntParam {
+	const char *name;
+	int32_t parameters::*field;
+};
+
+// EKF2_* parameters that can be swept, mirroring the mapping in EKF2.cpp
+const FloatParam float_params[] = {
+	{"EKF2_GYR_NOISE", &parameters::gyro_noise},
+	{"EKF2_ACC_NOISE", &parameters::accel_noise},
+	{"EKF2_GYR_B_NOISE", &parameters::gyro_bias_p_noise},
+	{"EKF2_ACC_B_NOISE", &parameters::accel_bias_p_noise},
+	{"EKF2_NOAID_NOISE", &parameters::pos_noaid_noise},
+#if defined(CONFIG_EKF2_WIND)
+	{"EKF2_WIND_NSD", &parameters::wind_vel_nsd},
+#endif // CONFIG_EKF2_WIND
+#if defined(CONFIG_EKF2_BAROMETER)
+	{"EKF2_BARO_DELAY", &parameters::baro_delay_ms},
+	{"EKF2_BARO_NOISE", &parameters::baro_noise},
+	{"EKF2_BARO_GATE", &parameters::baro_innov_gate},
+#endif // CONFIG_EKF2_BAROMETER
+#if defined(CONFIG_EKF2_GNSS)
+	{"EKF2_GPS_DELAY", &parameters::gps_delay_ms},
+	{"EKF2_GPS_V_NOISE", &parameters::gps_vel_noise},
+	{"EKF2_GPS_P_NOISE", &parameters::gps_pos_noise},
+	{"EKF2_GPS_P_GATE", &parameters::gps_pos_innov_gate},
+	{"EKF2_GPS_V_GATE", &parameters::gps_vel_innov_gate},
+#endif // CONFIG_EKF2_GNSS
+#if defined(CONFIG_EKF2_MAGNETOMETER)
+	{"EKF2_MAG_DELAY", &parameters::mag_delay_ms},
+	{"EKF2_MAG_E_NOISE", &parameters::mage_p_noise},
+	{"EKF2_MAG_B_NOISE", &parameters::magb_p_noise},
+	{"EKF2_HEAD_NOISE", &parameters::mag_heading_noise},
+	{"EKF2_MAG_NOISE", &parameters::mag_noise},
+	{"EKF2_HDG_GATE", &parameters::heading_innov_gate},
+	{"EKF2_MAG_GATE", &parameters::mag_innov_gate},
+#endif // CONFIG_EKF2_MAGNETOMETER
+#if defined(CONFIG_EKF2_AIRSPEED)
+	{"EKF2_ASP_DELAY", &parameters::airspeed_delay_ms},
+	{"EKF2_TAS_GATE", &parameters::tas_innov_gate},
+	{"EKF2_EAS_NOISE", &parameters::eas_noise},
+#endif // CONFIG_EKF2_AIRSPEED
+#if defined(CONFIG_EKF2_RANGE_FINDER)
+	{"EKF2_RNG_DELAY", &parameters::range_delay_ms},
+	{"EKF2_RNG_NOISE", &parameters::range_noise},
+	{"EKF2_RNG_SFE", &parameters::range_noise_scaler},
+	{"EKF2_RNG_GATE", &parameters::range_innov_gate},
+#endif // CONFIG_EKF2_RANGE_FINDER
+#if defined(CONFIG_EKF2_OPTICAL_FLOW)
+	{"EKF2_OF_DELAY", &parameters::flow_delay_ms},
+	{"EKF2_OF_N_MIN", &parameters::flow_noise},
+	{"EKF2_OF_N_MAX", &parameters::flow_noise_qual_min},
+	{"EKF2_OF_GATE", &parameters::flow_innov_gate},
+#endif // CONFIG_EKF2_OPTICAL_FLOW
+#if defined(CONFIG_EKF2_GRAVITY_FUSION)
+	{"EKF2_GRAV_NOISE", &parameters::gravity_noise},
+#endif // CONFIG_EKF2_GRAVITY_FUSION
+};
+
+const IntParam int_params[] = {
+	{"EKF2_IMU_CTRL", &parameters::imu_ctrl},
+	{"EKF2_HGT_REF", &parameters::height_sensor_ref},
+#if defined(CONFIG_EKF2_BAROMETER)
+	{"EKF2_BARO_CTRL", &parameters::baro_ctrl},
+#endif // CONFIG_EKF2_BAROMETER
+#if defined(CONFIG_EKF2_GNSS)
+	{"EKF2_GPS_CTRL", &parameters::gnss_ctrl},
+	{"EKF2_GPS_CHECK", &parameters::gps_check_mask},
+#endif // CONFIG_EKF2_GNSS
+#if defined(CONFIG_EKF2_MAGNETOMETER)
+	{"EKF2_MAG_TYPE", &parameters::mag_fusion_type},
+	{"EKF2_DECL_TYPE", &parameters::mag_declination_source},
+#endif // CONFIG_EKF2_MAGNETOMETER
+#if defined(CONFIG_EKF2_RANGE_FINDER)
+	{"EKF2_RNG_CTRL", &parameters::rng_ctrl},
+#endif // CONFIG_EKF2_RANGE_FINDER
+#if defined(CONFIG_EKF2_OPTICAL_FLOW)
+	{"EKF2_OF_CTRL", &parameters::flow_ctrl},
+#endif // CONFIG_EKF2_OPTICAL_FLOW
+};
+
+std::string trim(const std::string &s)
+{
+	const size_t first = s.find_first_not_of(" \t\r");
+
+	if (first == std::string::npos) {
+		return std::string();
+	}
+
+	const size_t last = s.find_last_not_of(" \t\r");
+	return s.substr(first, last - first + 1);
+}
+
+std::vector<std::string> splitCsvLine(const std::string &line)
+{
+	std::vector<std::string> fields;
+	std::stringstream ss(line);
+	std::string field;
+
+	while (getline(ss, field, ',')) {
+		fields.push_back(trim(field));
+	}
+
+	return fields;
+}
+
+template<size_t N>
+void accumulate(const float (&innovation)[N], const float (&innovation_variance)[N], const float (&test_ratio)[N],
+		BatchReplay::InnovationStatistics &statistics)
+{
+	statistics.components = N;
+
+	for (size_t i = 0; i < N; i++) {
+		statistics.innovation_sum += innovation[i];
+		statistics.innovation_sq_sum += (double)innovation[i] * innovation[i];
+
+		if (innovation_variance[i] > 0.f) {
+			statistics.nis_sum += (double)innovation[i] * innovation[i] / innovation_variance[i];
+		}
+
+		statistics.test_ratio_max = std::max(statistics.test_ratio_max, test_ratio[i]);
+	}
+}
+
+void accumulate(const float &innovation, const float &innovation_variance, const float &test_ratio,
+		BatchReplay::InnovationStatistics &statistics)
+{
+	const float innovation_array[1] {innovation};
+	const float innovation_variance_array[1] {innovation_variance};
+	const float test_ratio_array[1] {test_ratio};
+	accumulate(innovation_array, innovation_variance_array, test_ratio_array, statistics);
+}
+
+// Counts every new sample of an aiding source once, whether fused or not.
+// Samples taken while the innovation has no valid reference (e.g. before
+// alignment or before the GNSS origin is set) are skipped.
+template<typename T>
+void updateStatistics(const T &aid_src, bool valid_reference, uint64_t &timestamp_sample_last,
+		      BatchReplay::InnovationStatistics &statistics)
+{
+	if ((aid_src.timestamp_sample == 0) || (aid_src.timestamp_sample == timestamp_sample_last)) {
+		return;
+	}
+
+	timestamp_sample_last = aid_src.timestamp_sample;
+
+	if (!valid_reference) {
+		return;
+	}
+
+	statistics.samples++;
+
+	if (aid_src.fused) {
+		statistics.fused++;
+	}
+
+	if (aid_src.innovation_rejected) {
+		statistics.rejected++;
+	}
+
+	accumulate(aid_src.innovation, aid_src.innovation_variance, aid_src.test_ratio, statistics);
+}
+
+} // namespace
+
+bool BatchReplay::loadSensorData(const std::string &file_name)
+{
+	std::ifstream file(file_name);
+
+	if (!file) {
+		fprintf(stderr, "failed to open sensor data %s\n", file_name.c_str());
+		return false;
+	}
+
+	file.close();
+
+	setSensorData(SensorSimulator::loadReplayData(file_name));
+	return _replay_data && !_replay_data->empty();
+}
+
+void BatchReplay::setSensorData(std::shared_ptr<const SensorSimulator::ReplayData> replay_data)
+{
+	_replay_data = replay_data;
+
+	_has_gps = false;
+	_has_airspeed = false;
+	_has_range = false;
+	_has_flow = false;
+
+	if (!_replay_data) {
+		return;
+	}
+
+	for (const sensor_info &sample : *_replay_data) {
+		switch (sample.sensor_type) {
+		case sensor_info::measurement_t::GPS: _has_gps = true; break;
+
+		case sensor_info::measurement_t::AIRSPEED: _has_airspeed = true; break;
+
+		case sensor_info::measurement_t::RANGE: _has_range = true; break;
+
+		case sensor_info::measurement_t::FLOW: _has_flow = true; break;
+
+		default: break;
+		}
+	}
+}
+
+bool BatchReplay::loadParamSets(const std::string &file_name)
+{
+	std::ifstream file(file_name);
+
+	if (!file) {
+		fprintf(stderr, "failed to open parameter sets %s\n", file_name.c_str());
+		return false;
+	}
+
+	std::string line;
+	std::vector<std::string> header;
+
+	while (getline(file, line)) {
+		if (trim(line).empty() || (line[0] == '#')) {
+			continue;
+		}
+
+		const std::vector<std::string> fields = splitCsvLine(line);
+
+		if (header.empty()) {
+			header = fields;
+
+			if (header[0] != "name") {
+				fprintf(stderr, "parameter sets: first column must be 'name'\n");
+				return false;
+			}
+
+			continue;
+		}
+
+		if (fields.size() != header.size()) {
+			fprintf(stderr, "parameter sets: expected %zu columns, got %zu\n", header.size(), fields.size());
+			return false;
+		}
+
+		ParamSet param_set;
+		param_set.name = fields[0];
+
+		for (size_t i = 1; i < fields.size(); i++) {
+			char *end = nullptr;
+			const float value = strtof(fields[i].c_str(), &end);
+
+			if (fields[i].empty() || (*end != '\0')) {
+				fprintf(stderr, "parameter sets: invalid value '%s' for %s\n", fields[i].c_str(), header[i].c_str());
+				return false;
+			}
+
+			param_set.values.emplace_back(header[i], value);
+		}
+
+		_param_sets.push_back(param_set);
+	}
+
+	return !_param_sets.empty();
+}
+
+bool BatchReplay::setParameter(parameters &params, const std::string &name, float value)
+{
+	for (const FloatParam &param : float_params) {
+		if (name == param.name) {
+			params.*param.field = value;
+			return true;
+		}
+	}
+
+	for (const IntParam &param : int_params) {
+		if (name == param.name) {
+			params.*param.field = static_cast<int32_t>(value);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+const char *BatchReplay::aidSourceName(AidSource source)
+{
+	switch (source) {
+	case AidSource::BARO_HGT: return "baro_hgt";
+
+	case AidSource::GNSS_HGT: return "gnss_hgt";
+
+	case AidSource::GNSS_POS: return "gnss_pos";
+
+	case AidSource::GNSS_VEL: return "gnss_vel";
+
+	case AidSource::MAG: return "mag";
+
+	case AidSource::MAG_HEADING: return "mag_heading";
+
+	case AidSource::AIRSPEED: return "airspeed";
+
+	case AidSource::RNG_HGT: return "rng_hgt";
+
+	case AidSource::OPTICAL_FLOW: return "optical_flow";
+
+	case AidSource::GRAVITY: return "gravity";
+
+	case AidSource::COUNT: break;
+	}
+
+	return "unknown";
+}
+
+bool BatchReplay::run(unsigned num_threads)
+{
+	if (!_replay_data || _replay_data->empty() || _param_sets.empty()) {
+		return false;
+	}
+
+	_results.clear();
+	_results.resize(_param_sets.size());
+
+	if (num_threads == 0) {
+		num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+
+	num_threads = std::min(num_threads, static_cast<unsigned>(_param_sets.size()));
+
+	// instances are independent, each worker picks the next one until all are done
+	std::atomic<size_t> next_instance{0};
+
+	auto worker = [this, &next_instance]() {
+		for (size_t i = next_instance++; i < _param_sets.size(); i = next_instance++) {
+			runInstance(_param_sets[i], _results[i]);
+		}
+	};
+
+	std::vector<std::thread> threads;
+
+	for (unsigned i = 1; i < num_threads; i++) {
+		threads.emplace_back(worker);
+	}
+
+	worker();
+
+	for (std::thread &thread : threads) {
+		thread.join();
+	}
+
+	return std::all_of(_results.begin(), _results.end(), [](const InstanceResult & result) { return result.valid; });
+}
+
+void BatchReplay::runInstance(const ParamSet &param_set, InstanceResult &result) const
+{
+	result.name = param_set.name;
+
+	std::shared_ptr<Ekf> ekf = std::make_shared<Ekf>();
+	parameters *params = ekf->getParamHandle();
+
+	for (const auto &value : param_set.values) {
+		if (!setParameter(*params, value.first, value.second)) {
+			fprintf(stderr, "%s: unknown parameter %s\n", param_set.name.c_str(), value.first.c_str());
+			return;
+		}
+	}
+
+	SensorSimulator sensor_simulator(ekf);
+	sensor_simulator.setReplayData(_replay_data);
+
+	// IMU, baro and mag are started by default
+	if (_has_gps) {
+		sensor_simulator.startGps();
+	}
+
+	if (_has_airspeed) {
+		sensor_simulator.startAirspeedSensor();
+	}
+
+	if (_has_range) {
+		sensor_simulator.startRangeFinder();
+	}
+
+	if (_has_flow) {
+		sensor_simulator.startFlow();
+	}
+
+	uint64_t timestamp_sample_last[static_cast<size_t>(AidSource::COUNT)] {};
+
+	auto update = [&](AidSource source, const auto & aid_src, bool valid_reference) {
+		const size_t index = static_cast<size_t>(source);
+		updateStatistics(aid_src, valid_reference, timestamp_sample_last[index], result.statistics[index]);
+	};
+
+	while (!sensor_simulator.isReplayFinished()) {
+		// step at the simulator resolution so that no aiding source sample is missed
+		sensor_simulator.runReplayMicroseconds(1000);
+
+		const bool aligned = ekf->control_status_flags().tilt_align;
+		const bool origin_valid = aligned && ekf->global_origin_valid();
+
+#if defined(CONFIG_EKF2_BAROMETER)
+		update(AidSource::BARO_HGT, ekf->aid_src_baro_hgt(), aligned);
+#endif // CONFIG_EKF2_BAROMETER
+#if defined(CONFIG_EKF2_GNSS)
+		update(AidSource::GNSS_HGT, ekf->aid_src_gnss_hgt(), origin_valid);
+		update(AidSource::GNSS_POS, ekf->aid_src_gnss_pos(), origin_valid);
+		update(AidSource::GNSS_VEL, ekf->aid_src_gnss_vel(), aligned);
+#endif // CONFIG_EKF2_GNSS
+#if defined(CONFIG_EKF2_MAGNETOMETER)
+		update(AidSource::MAG, ekf->aid_src_mag(), aligned);
+		update(AidSource::MAG_HEADING, ekf->aid_src_mag_heading(), aligned);
+#endif // CONFIG_EKF2_MAGNETOMETER
+#if defined(CONFIG_EKF2_AIRSPEED)
+		update(AidSource::AIRSPEED, ekf->aid_src_airspeed(), aligned);
+#endif // CONFIG_EKF2_AIRSPEED
+#if defined(CONFIG_EKF2_RANGE_FINDER)
+		update(AidSource::RNG_HGT, ekf->aid_src_rng_hgt(), aligned);
+#endif // CONFIG_EKF2_RANGE_FINDER
+#if defined(CONFIG_EKF2_OPTICAL_FLOW)
+		update(AidSource::OPTICAL_FLOW, ekf->aid_src_optical_flow(), aligned);
+#endif // CONFIG_EKF2_OPTICAL_FLOW
+#if defined(CONFIG_EKF2_GRAVITY_FUSION)
+		update(AidSource::GRAVITY, ekf->aid_src_gravity(), aligned);
+#endif // CONFIG_EKF2_GRAVITY_FUSION
+	}
+
+	result.duration_us = sensor_simulator.getTime();
+	result.valid = true;
+}
+
+bool BatchReplay::writeSummary(const std::string &file_name) const
+{
+	FILE *file = fopen(file_name.c_str(), "w");
+
+	if (file == nullptr) {
+		fprintf(stderr, "failed to open summary %s\n", file_name.c_str());
+		return false;
+	}
+
+	fprintf(file, "instance,source,samples,fused,rejected,innov_mean,innov_rms,nis_mean,test_ratio_max\n");
+
+	for (const InstanceResult &result : _results) {
+		if (!result.valid) {
+			fprintf(file, "%s,invalid,0,0,0,0,0,0,0\n", result.name.c_str());
+			continue;
+		}
+
+		for (size_t i = 0; i < result.statistics.size(); i++) {
+			const InnovationStatistics &statistics = result.statistics[i];
+
+			if (statistics.samples == 0) {
+				continue;
+			}
+
+			fprintf(file, "%s,%s,%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%.6g,%.6g,%.6g,%.6g\n",
+				result.name.c_str(), aidSourceName(static_cast<AidSource>(i)),
+				statistics.samples, statistics.fused, statistics.rejected,
+				statistics.innovationMean(), statistics.innovationRms(), statistics.nisMean(),
+				(double)statistics.test_ratio_max);
+		}
+	}
+
+	fclose(file);
+	return true;
+}
@@ -0,0 +1,141 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * Runs several independent Ekf instances, each with its own parameter set,
+ * over the same decoded sensor stream in parallel threads and collects
+ * innovation statistics per instance and aiding source.
+ *
+ * The sensor stream is the replay csv format produced by
+ * convertULogToSensorData.py and used by the sensor simulator. It is
+ * decoded once and shared read-only between all instances; no uORB,
+ * parameter system or work queue is involved.
+ */
+
+#ifndef EKF_BATCH_REPLAY_H
+#define EKF_BATCH_REPLAY_H
+
+#include <array>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "EKF/ekf.h"
+#include "sensor_simulator/sensor_simulator.h"
+
+class BatchReplay
+{
+public:
+	enum class AidSource {
+		BARO_HGT,
+		GNSS_HGT,
+		GNSS_POS,
+		GNSS_VEL,
+		MAG,
+		MAG_HEADING,
+		AIRSPEED,
+		RNG_HGT,
+		OPTICAL_FLOW,
+		GRAVITY,
+		COUNT
+	};
+
+	struct ParamSet {
+		std::string name;
+		std::vector<std::pair<std::string, float>> values; ///< EKF2_* parameter name and value
+	};
+
+	struct InnovationStatistics {
+		uint32_t samples{0};
+		uint32_t fused{0};
+		uint32_t rejected{0};
+		double innovation_sum{0.0};     ///< sum over all components
+		double innovation_sq_sum{0.0};  ///< sum over all components
+		double nis_sum{0.0};            ///< normalised innovation squared, summed over components per sample
+		float test_ratio_max{0.f};
+		uint32_t components{0};         ///< number of innovation components per sample
+
+		double innovationMean() const { return (samples > 0) ? innovation_sum / (samples * components) : 0.0; }
+		double innovationRms() const { return (samples > 0) ? sqrt(innovation_sq_sum / (samples * components)) : 0.0; }
+		double nisMean() const { return (samples > 0) ? nis_sum / samples : 0.0; }
+	};
+
+	struct InstanceResult {
+		std::string name;
+		bool valid{false};    ///< false if the parameter set could not be applied
+		uint64_t duration_us{0};
+		std::array<InnovationStatistics, static_cast<size_t>(AidSource::COUNT)> statistics{};
+	};
+
+	BatchReplay() = default;
+	~BatchReplay() = default;
+
+	bool loadSensorData(const std::string &file_name);
+	void setSensorData(std::shared_ptr<const SensorSimulator::ReplayData> replay_data);
+
+	/**
+	 * Load parameter sets from a csv file. The header row is "name" followed by
+	 * EKF2_* parameter names, every following row is one instance.
+	 */
+	bool loadParamSets(const std::string &file_name);
+	void addParamSet(const ParamSet &param_set) { _param_sets.push_back(param_set); }
+	size_t numInstances() const { return _param_sets.size(); }
+
+	/**
+	 * Run all instances over the sensor data.
+	 * @param num_threads number of worker threads, 0 to use the hardware concurrency
+	 */
+	bool run(unsigned num_threads = 0);
+
+	const std::vector<InstanceResult> &results() const { return _results; }
+	bool writeSummary(const std::string &file_name) const;
+
+	static bool setParameter(parameters &params, const std::string &name, float value);
+	static const char *aidSourceName(AidSource source);
+
+private:
+	void runInstance(const ParamSet &param_set, InstanceResult &result) const;
+
+	std::shared_ptr<const SensorSimulator::ReplayData> _replay_data{nullptr};
+
+	bool _has_gps{false};
+	bool _has_airspeed{false};
+	bool _has_range{false};
+	bool _has_flow{false};
+
+	std::vector<ParamSet> _param_sets{};
+	std::vector<InstanceResult> _results{};
+};
+
+#endif // !EKF_BATCH_REPLAY_H
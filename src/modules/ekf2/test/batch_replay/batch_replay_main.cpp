@@ -0,0 +1,81 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * Headless EKF parameter sweep over a decoded sensor stream.
+ *
+ * usage: ekf2_batch_replay <sensor_data.csv> <param_sets.csv> <summary.csv> [num_threads]
+ *
+ * sensor_data.csv is generated from a ULog with convertULogToSensorData.py,
+ * param_sets.csv has a header row "name,EKF2_...,..." and one instance per row.
+ */
+
+#include "batch_replay.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+int main(int argc, char *argv[])
+{
+	if (argc < 4) {
+		fprintf(stderr, "usage: %s <sensor_data.csv> <param_sets.csv> <summary.csv> [num_threads]\n", argv[0]);
+		return 1;
+	}
+
+	const unsigned num_threads = (argc > 4) ? static_cast<unsigned>(atoi(argv[4])) : 0;
+
+	BatchReplay batch_replay;
+
+	if (!batch_replay.loadSensorData(argv[1])) {
+		fprintf(stderr, "no sensor data loaded from %s\n", argv[1]);
+		return 1;
+	}
+
+	if (!batch_replay.loadParamSets(argv[2])) {
+		fprintf(stderr, "no parameter sets loaded from %s\n", argv[2]);
+		return 1;
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	const bool success = batch_replay.run(num_threads);
+	const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	printf("replayed %zu instances in %.2f s\n", batch_replay.numInstances(), elapsed);
+
+	if (!batch_replay.writeSummary(argv[3])) {
+		return 1;
+	}
+
+	return success ? 0 : 1;
+}
@@ -25,6 +25,24 @@ SensorSimulator::SensorSimulator(std::shared_ptr<Ekf> ekf):
 
 void SensorSimulator::loadSensorDataFromFile(std::string file_name)
 {
+	setReplayData(loadReplayData(file_name));
+}
+
+void SensorSimulator::setReplayData(std::shared_ptr<const ReplayData> replay_data)
+{
+	_replay_data = replay_data;
+	_current_replay_data_index = 0;
+	_has_replay_data = (_replay_data != nullptr);
+}
+
+bool SensorSimulator::isReplayFinished() const
+{
+	return !_has_replay_data || (_current_replay_data_index >= _replay_data->size());
+}
+
+std::shared_ptr<const SensorSimulator::ReplayData> SensorSimulator::loadReplayData(const std::string &file_name)
+{
+	auto replay_data = std::make_shared<ReplayData>();
 	std::ifstream file(file_name);
 	std::string line;
 
@@ -42,8 +60,8 @@ void SensorSimulator::loadSensorDataFromFile(std::string file_name)
 
 		sensor_sample.timestamp = std::stoul(timestamp);
 
-		if (_replay_data.size() > 0) {
-			sensor_info last_sample = _replay_data.back();
+		if (replay_data->size() > 0) {
+			const sensor_info &last_sample = replay_data->back();
 
 			if (sensor_sample.timestamp < last_sample.timestamp) {
 				std::cout << "Timestamps not sorted ascendingly" << std::endl;
@@ -106,11 +124,11 @@ void SensorSimulator::loadSensorDataFromFile(std::string file_name)
 			i++;
 		}
 
-		_replay_data.emplace_back(sensor_sample);
+		replay_data->emplace_back(sensor_sample);
 	}
 
 	file.close();
-	_has_replay_data = true;
+	return replay_data;
 }
 
 void SensorSimulator::setSensorRateToDefault()
@@ -214,20 +232,11 @@ void SensorSimulator::runReplayMicroseconds(uint32_t duration)
 
 void SensorSimulator::setSensorDataFromReplayData()
 {
-	if (_replay_data.size() > 0) {
-		sensor_info sample = _replay_data[_current_replay_data_index];
-
-		while (sample.timestamp < _time) {
-			setSingleReplaySample(sample);
-
-			if (_current_replay_data_index < _replay_data.size()) {
-				_current_replay_data_index ++;
-
-			} else {
-				break;
-			}
-
-			sample = _replay_data[_current_replay_data_index];
+	if (_replay_data->size() > 0) {
+		while ((_current_replay_data_index < _replay_data->size())
+		       && ((*_replay_data)[_current_replay_data_index].timestamp < _time)) {
+			setSingleReplaySample((*_replay_data)[_current_replay_data_index]);
+			_current_replay_data_index++;
 		}
 
 	} else {
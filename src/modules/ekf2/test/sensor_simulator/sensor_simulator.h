@@ -119,6 +119,13 @@ public:
 
 	void loadSensorDataFromFile(std::string filename);
 
+	using ReplayData = std::vector<sensor_info>;
+
+	// Decode a replay file once so it can be shared read-only between several simulators
+	static std::shared_ptr<const ReplayData> loadReplayData(const std::string &filename);
+	void setReplayData(std::shared_ptr<const ReplayData> replay_data);
+	bool isReplayFinished() const;
+
 	Airspeed    _airspeed;
 	Baro        _baro;
 	Flow        _flow;
@@ -141,7 +148,7 @@ private:
 
 	std::shared_ptr<Ekf> _ekf{nullptr};
 
-	std::vector<sensor_info> _replay_data{};
+	std::shared_ptr<const ReplayData> _replay_data{nullptr};
 
 	bool _has_replay_data{false};
 
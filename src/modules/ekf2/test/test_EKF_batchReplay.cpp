@@ -0,0 +1,143 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include "batch_replay/batch_replay.h"
+
+class EkfBatchReplayTest : public ::testing::Test
+{
+public:
+	void SetUp() override
+	{
+		_replay_data = SensorSimulator::loadReplayData(TEST_DATA_PATH"/replay_data/iris_gps.csv");
+		ASSERT_TRUE(_replay_data);
+		ASSERT_FALSE(_replay_data->empty());
+	}
+
+	void addParamSets(BatchReplay &batch_replay)
+	{
+		batch_replay.setSensorData(_replay_data);
+		batch_replay.addParamSet({"default", {}});
+		batch_replay.addParamSet({"tight_gates", {{"EKF2_GPS_P_GATE", 1.f}, {"EKF2_GPS_V_GATE", 1.f}}});
+		batch_replay.addParamSet({"low_acc_noise", {{"EKF2_ACC_NOISE", 0.1f}}});
+		batch_replay.addParamSet({"high_gps_noise", {{"EKF2_GPS_V_NOISE", 1.f}, {"EKF2_GPS_P_NOISE", 2.f}}});
+	}
+
+	std::shared_ptr<const SensorSimulator::ReplayData> _replay_data;
+};
+
+TEST_F(EkfBatchReplayTest, parallelMatchesSerial)
+{
+	BatchReplay serial;
+	addParamSets(serial);
+	ASSERT_TRUE(serial.run(1));
+
+	BatchReplay parallel;
+	addParamSets(parallel);
+	ASSERT_TRUE(parallel.run(4));
+
+	ASSERT_EQ(serial.results().size(), 4u);
+	ASSERT_EQ(parallel.results().size(), 4u);
+
+	for (size_t i = 0; i < serial.results().size(); i++) {
+		const BatchReplay::InstanceResult &a = serial.results()[i];
+		const BatchReplay::InstanceResult &b = parallel.results()[i];
+		EXPECT_EQ(a.name, b.name);
+		EXPECT_EQ(a.duration_us, b.duration_us);
+
+		for (size_t k = 0; k < a.statistics.size(); k++) {
+			EXPECT_EQ(a.statistics[k].samples, b.statistics[k].samples);
+			EXPECT_EQ(a.statistics[k].fused, b.statistics[k].fused);
+			EXPECT_EQ(a.statistics[k].innovation_sq_sum, b.statistics[k].innovation_sq_sum);
+			EXPECT_EQ(a.statistics[k].nis_sum, b.statistics[k].nis_sum);
+		}
+	}
+
+	// the parameter sets must actually change the filter
+	const size_t gnss_vel = static_cast<size_t>(BatchReplay::AidSource::GNSS_VEL);
+	const BatchReplay::InnovationStatistics &nominal = serial.results()[0].statistics[gnss_vel];
+	const BatchReplay::InnovationStatistics &tight = serial.results()[1].statistics[gnss_vel];
+	EXPECT_GT(nominal.samples, 0u);
+	EXPECT_GT(nominal.fused, 0u);
+	EXPECT_GT(tight.rejected, nominal.rejected);
+	EXPECT_NE(serial.results()[2].statistics[gnss_vel].nis_sum, nominal.nis_sum);
+}
+
+TEST_F(EkfBatchReplayTest, unknownParameter)
+{
+	BatchReplay batch_replay;
+	batch_replay.setSensorData(_replay_data);
+	batch_replay.addParamSet({"typo", {{"EKF2_GYR_NOSIE", 0.1f}}});
+
+	EXPECT_FALSE(batch_replay.run());
+	ASSERT_EQ(batch_replay.results().size(), 1u);
+	EXPECT_FALSE(batch_replay.results()[0].valid);
+}
+
+TEST_F(EkfBatchReplayTest, paramSetsFromFile)
+{
+	const char *param_file = "ekf2_batch_replay_params.csv";
+	const char *summary_file = "ekf2_batch_replay_summary.csv";
+
+	{
+		std::ofstream file(param_file);
+		file << "name,EKF2_GYR_NOISE,EKF2_GPS_CTRL\n";
+		file << "# comment\n";
+		file << "a,0.015,7\n";
+		file << "b, 0.03 ,7\n";
+	}
+
+	BatchReplay batch_replay;
+	batch_replay.setSensorData(_replay_data);
+	ASSERT_TRUE(batch_replay.loadParamSets(param_file));
+	ASSERT_EQ(batch_replay.numInstances(), 2u);
+	ASSERT_TRUE(batch_replay.run());
+
+	ASSERT_TRUE(batch_replay.writeSummary(summary_file));
+
+	std::ifstream summary(summary_file);
+	std::string line;
+	int lines = 0;
+
+	while (getline(summary, line)) {
+		lines++;
+	}
+
+	// header and at least one aiding source per instance
+	EXPECT_GE(lines, 3);
+
+	remove(param_file);
+	remove(summary_file);
+}
@@ -0,0 +1,158 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * Compares the Joseph covariance update on the packed (upper triangle)
+ * covariance storage with the dense implementation it replaces and
+ * reports the cost per update of both.
+ */
+
+#include <chrono>
+#include <gtest/gtest.h>
+#include "EKF/ekf.h"
+#include "test_helper/comparison_helper.h"
+
+// Joseph stabilized update on a dense covariance matrix (reference)
+static void denseMeasurementUpdate(SquareMatrixState &P, const VectorState &K, const VectorState &H, const float R)
+{
+	VectorState PH = P * H;
+
+	for (unsigned i = 0; i < State::size; i++) {
+		for (unsigned j = 0; j < State::size; j++) {
+			P(i, j) -= K(i) * PH(j);
+		}
+	}
+
+	PH = P * H;
+
+	for (unsigned i = 0; i < State::size; i++) {
+		for (unsigned j = 0; j <= i; j++) {
+			P(i, j) = P(i, j) - PH(i) * K(j) + K(i) * R * K(j);
+			P(j, i) = P(i, j);
+		}
+	}
+}
+
+static VectorState randomObservationJacobian()
+{
+	VectorState H;
+
+	for (unsigned i = 0; i < State::size; i++) {
+		H(i) = 2.f * (randf() - 0.5f);
+	}
+
+	return H;
+}
+
+class EkfCovarianceUpdateTest : public ::testing::Test
+{
+public:
+	void SetUp() override
+	{
+		srand(1);
+		_ekf.init(0);
+	}
+
+	// optimal Kalman gain for an observation with Jacobian H and variance R
+	VectorState kalmanGain(const VectorState &H, const float R) const
+	{
+		const VectorState PH = _ekf.covariances() * H;
+		return PH / (H.dot(PH) + R);
+	}
+
+	Ekf _ekf{};
+
+	static constexpr float _R{1.f};
+	static constexpr int _num_updates{10000};
+};
+
+TEST_F(EkfCovarianceUpdateTest, packedMatchesDense)
+{
+	for (int n = 0; n < 20; n++) {
+		// GIVEN: the current covariance in dense form
+		SquareMatrixState P_dense = _ekf.covariances().unpack();
+		const VectorState H = randomObservationJacobian();
+		VectorState K = kalmanGain(H, _R);
+
+		// WHEN: the update is applied to the packed covariance and to the dense reference
+		// (the gains of inhibited states are cleared by measurementUpdate)
+		_ekf.measurementUpdate(K, H, _R, 0.f);
+		denseMeasurementUpdate(P_dense, K, H, _R);
+
+		// THEN: both give the same covariance
+		const SquareMatrixState P = _ekf.covariances().unpack();
+
+		for (unsigned i = 0; i < State::size; i++) {
+			for (unsigned j = 0; j < State::size; j++) {
+				EXPECT_NEAR(P(i, j), P_dense(i, j), 1e-6f * fmaxf(fabsf(P_dense(i, j)), 1.f)) << i << ", " << j;
+			}
+		}
+	}
+}
+
+TEST_F(EkfCovarianceUpdateTest, updateCost)
+{
+	const VectorState H = randomObservationJacobian();
+	VectorState K = kalmanGain(H, _R);
+	_ekf.measurementUpdate(K, H, _R, 0.f);
+
+	SquareMatrixState P_dense = _ekf.covariances().unpack();
+
+	// small gains keep the covariance from collapsing over the iterations
+	K *= 1e-3f;
+	const VectorState K_in = K;
+
+	const auto t_packed_start = std::chrono::steady_clock::now();
+
+	for (int n = 0; n < _num_updates; n++) {
+		K = K_in;
+		_ekf.measurementUpdate(K, H, _R, 0.f);
+	}
+
+	const auto t_dense_start = std::chrono::steady_clock::now();
+
+	for (int n = 0; n < _num_updates; n++) {
+		denseMeasurementUpdate(P_dense, K, H, _R);
+	}
+
+	const auto t_dense_end = std::chrono::steady_clock::now();
+
+	const double packed_ns = std::chrono::duration<double, std::nano>(t_dense_start - t_packed_start).count() / _num_updates;
+	const double dense_ns = std::chrono::duration<double, std::nano>(t_dense_end - t_dense_start).count() / _num_updates;
+
+	printf("covariance update: packed %.0f ns (%u floats), dense %.0f ns (%u floats)\n",
+	       packed_ns, (unsigned)SymmetricMatrixState::size(), dense_ns, (unsigned)(State::size * State::size));
+
+	EXPECT_TRUE(_ekf.covariances().isAllFinite());
+	EXPECT_TRUE(P_dense.isAllFinite());
+}
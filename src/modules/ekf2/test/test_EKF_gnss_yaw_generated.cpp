@@ -46,7 +46,7 @@ TEST(GnssYawFusionGenerated, SingularityPitch90)
 	state.quat_nominal = Eulerf(0.f, -M_PI_F / 2.f, 0.f);
 	const float yaw_offset = M_PI_F;
 
-	SquareMatrixState P = createRandomCovarianceMatrix();
+	SymmetricMatrixState P = createRandomCovarianceMatrix();
 	const float R_YAW = sq(0.3f);
 
 	float meas_pred;
@@ -69,7 +69,7 @@ TEST(GnssYawFusionGenerated, SingularityRoll90)
 	state.quat_nominal = Eulerf(-M_PI_F / 2.f, 0.f, 0.f);
 	const float yaw_offset = M_PI_F / 2.f;
 
-	SquareMatrixState P = createRandomCovarianceMatrix();
+	SymmetricMatrixState P = createRandomCovarianceMatrix();
 	const float R_YAW = sq(0.3f);
 
 	float meas_pred;
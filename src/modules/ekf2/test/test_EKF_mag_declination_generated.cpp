@@ -48,7 +48,7 @@ TEST(MagDeclinationGenerated, declination90deg)
 	state.mag_I(1) = 0.2f; // East mag field
 
 	const float R = sq(radians(sq(0.5f)));
-	SquareMatrixState P = createRandomCovarianceMatrix();
+	SymmetricMatrixState P = createRandomCovarianceMatrix();
 
 	VectorState H;
 	float decl_pred;
@@ -70,7 +70,7 @@ TEST(MagDeclinationGenerated, declinationUndefined)
 	state.mag_I(1) = 0.f; // East mag field
 
 	const float R = sq(radians(sq(0.5f)));
-	SquareMatrixState P = createRandomCovarianceMatrix();
+	SymmetricMatrixState P = createRandomCovarianceMatrix();
 
 	VectorState H;
 	float decl_pred;
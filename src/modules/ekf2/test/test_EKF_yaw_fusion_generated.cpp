@@ -39,10 +39,10 @@
 
 using namespace matrix;
 
-Vector3f getRotVarNed(const Quatf &q, const SquareMatrixState &P)
+Vector3f getRotVarNed(const Quatf &q, const SymmetricMatrixState &P)
 {
 	constexpr auto S = State::quat_nominal;
-	matrix::SquareMatrix3f rot_cov_body = P.slice<S.dof, S.dof>(S.idx, S.idx);
+	matrix::SquareMatrix3f rot_cov_body = P.block<S.dof>(S.idx);
 	auto R_to_earth = Dcmf(q);
 	return matrix::SquareMatrix<float, State::quat_nominal.dof>(R_to_earth * rot_cov_body * R_to_earth.T()).diag();
 }
@@ -50,7 +50,7 @@ Vector3f getRotVarNed(const Quatf &q, const SquareMatrixState &P)
 TEST(YawFusionGenerated, positiveVarianceAllOrientations)
 {
 	const float R = sq(radians(10.f));
-	SquareMatrixState P = createRandomCovarianceMatrix();
+	SymmetricMatrixState P = createRandomCovarianceMatrix();
 
 	VectorState H;
 	float innov_var;
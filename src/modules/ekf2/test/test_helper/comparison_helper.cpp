@@ -38,7 +38,7 @@ float randf()
 	return (float)rand() / (float)RAND_MAX;
 }
 
-SquareMatrixState createRandomCovarianceMatrix()
+SymmetricMatrixState createRandomCovarianceMatrix()
 {
 	// Create a symmetric square matrix
 	SquareMatrixState P;
@@ -55,7 +55,5 @@ SquareMatrixState createRandomCovarianceMatrix()
 	}
 
 	// Make it positive definite
-	P = P.transpose() * P;
-
-	return P;
+	return SymmetricMatrixState(P.transpose() * P);
 }
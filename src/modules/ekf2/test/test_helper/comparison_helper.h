@@ -38,9 +38,10 @@
 
 typedef matrix::Vector<float, State::size> VectorState;
 typedef matrix::SquareMatrix<float, State::size> SquareMatrixState;
+typedef matrix::SymmetricMatrix<float, State::size> SymmetricMatrixState;
 
 float randf();
 
 // Create a symmetrical positive dfinite matrix with off diagonals between -1 and 1 and diagonals between 0 and 1
-SquareMatrixState createRandomCovarianceMatrix();
+SymmetricMatrixState createRandomCovarianceMatrix();
 #endif
@@ -0,0 +1,175 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "FFTFloat.hpp"
+
+#include <math.h>
+#include <new>
+
+FFTFloat::~FFTFloat()
+{
+	free();
+}
+
+void FFTFloat::free()
+{
+	delete[] _twiddle_real;
+	delete[] _twiddle_imag;
+	delete[] _bit_reverse;
+	delete[] _real;
+	delete[] _imag;
+
+	_twiddle_real = nullptr;
+	_twiddle_imag = nullptr;
+	_bit_reverse = nullptr;
+	_real = nullptr;
+	_imag = nullptr;
+
+	_length = 0;
+	_half_length = 0;
+}
+
+bool FFTFloat::init(int length)
+{
+	free();
+
+	if ((length < MIN_LENGTH) || (length > MAX_LENGTH) || ((length & (length - 1)) != 0)) {
+		return false;
+	}
+
+	const int half_length = length / 2;
+
+	_twiddle_real = new (std::nothrow) float[half_length];
+	_twiddle_imag = new (std::nothrow) float[half_length];
+	_bit_reverse = new (std::nothrow) uint16_t[half_length];
+	_real = new (std::nothrow) vec4[half_length];
+	_imag = new (std::nothrow) vec4[half_length];
+
+	if (!_twiddle_real || !_twiddle_imag || !_bit_reverse || !_real || !_imag) {
+		free();
+		return false;
+	}
+
+	for (int k = 0; k < half_length; k++) {
+		const double angle = 2.0 * M_PI * k / length;
+		_twiddle_real[k] = (float)cos(angle);
+		_twiddle_imag[k] = (float) - sin(angle);
+	}
+
+	int log2_half_length = 0;
+
+	while ((1 << log2_half_length) < half_length) {
+		log2_half_length++;
+	}
+
+	for (int i = 0; i < half_length; i++) {
+		int reversed = 0;
+
+		for (int bit = 0; bit < log2_half_length; bit++) {
+			if (i & (1 << bit)) {
+				reversed |= 1 << (log2_half_length - 1 - bit);
+			}
+		}
+
+		_bit_reverse[i] = reversed;
+	}
+
+	_length = length;
+	_half_length = half_length;
+
+	return true;
+}
+
+void FFTFloat::forward(const vec4 *input, const float *window, vec4 *output)
+{
+	const int M = _half_length;
+
+	// pack the real input as M complex values z[n] = x[2n] + i x[2n+1], in bit reversed order
+	for (int n = 0; n < M; n++) {
+		const int i = _bit_reverse[n];
+
+		if (window) {
+			_real[i] = input[2 * n] * window[2 * n];
+			_imag[i] = input[2 * n + 1] * window[2 * n + 1];
+
+		} else {
+			_real[i] = input[2 * n];
+			_imag[i] = input[2 * n + 1];
+		}
+	}
+
+	// iterative radix-2 decimation in time complex FFT of length M
+	for (int size = 2; size <= M; size *= 2) {
+		const int half_size = size / 2;
+		const int twiddle_step = _length / size; // W_size^j = W_N^(j * N / size)
+
+		for (int j = 0; j < half_size; j++) {
+			const float wr = _twiddle_real[j * twiddle_step];
+			const float wi = _twiddle_imag[j * twiddle_step];
+
+			for (int a = j; a < M; a += size) {
+				const int b = a + half_size;
+
+				const vec4 tr = _real[b] * wr - _imag[b] * wi;
+				const vec4 ti = _imag[b] * wr + _real[b] * wi;
+
+				_real[b] = _real[a] - tr;
+				_imag[b] = _imag[a] - ti;
+				_real[a] = _real[a] + tr;
+				_imag[a] = _imag[a] + ti;
+			}
+		}
+	}
+
+	// split into the spectrum of the real input
+	//  X[k] = E[k] + W_N^k O[k]
+	//  E[k] = (Z[k] + conj(Z[M-k])) / 2, O[k] = -i (Z[k] - conj(Z[M-k])) / 2
+	for (int k = 0; k < M; k++) {
+		const int mk = (k == 0) ? 0 : (M - k);
+
+		const vec4 er = 0.5f * (_real[k] + _real[mk]);
+		const vec4 ei = 0.5f * (_imag[k] - _imag[mk]);
+		const vec4 orr = 0.5f * (_imag[k] + _imag[mk]);
+		const vec4 oi = -0.5f * (_real[k] - _real[mk]);
+
+		const float wr = _twiddle_real[k];
+		const float wi = _twiddle_imag[k];
+
+		output[2 * k]     = er + orr * wr - oi * wi;
+		output[2 * k + 1] = ei + orr * wi + oi * wr;
+	}
+
+	// Nyquist
+	output[2 * M]     = _real[0] - _imag[0];
+	output[2 * M + 1] = vec4{};
+}
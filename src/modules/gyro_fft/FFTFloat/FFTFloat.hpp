@@ -0,0 +1,100 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file FFTFloat.hpp
+ *
+ * float32 real FFT of up to 4 channels at once.
+ *
+ * Each sample is a vector of 4 floats (one channel per lane), so every butterfly
+ * processes all channels with a single SIMD instruction (NEON on ARM, SSE on x86,
+ * through the GCC vector extensions). Transforming the three gyro axes costs
+ * about the same as transforming one.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+class FFTFloat
+{
+public:
+	// four float lanes (x, y, z, unused) mapped to NEON/SSE by the compiler; alignment
+	// is relaxed to that of float so plain new[] (C++14, no over-aligned new) is safe
+	typedef float vec4 __attribute__((vector_size(4 * sizeof(float)), aligned(__alignof__(float))));
+
+	static constexpr int MIN_LENGTH = 16;
+	static constexpr int MAX_LENGTH = 8192;
+
+	FFTFloat() = default;
+	~FFTFloat();
+
+	// no copy, assignment, move, move assignment
+	FFTFloat(const FFTFloat &) = delete;
+	FFTFloat &operator=(const FFTFloat &) = delete;
+	FFTFloat(FFTFloat &&) = delete;
+	FFTFloat &operator=(FFTFloat &&) = delete;
+
+	/**
+	 * Allocate the buffers and tables for a transform length.
+	 *
+	 * @param length power of 2 between MIN_LENGTH and MAX_LENGTH
+	 * @return true on success
+	 */
+	bool init(int length);
+
+	int length() const { return _length; }
+
+	/**
+	 * Forward real FFT (unnormalized).
+	 *
+	 * @param input  length() samples
+	 * @param window length() window coefficients applied to the input, or nullptr
+	 * @param output length() + 2 values, ordered like arm_rfft_q15:
+	 *               [real[0], imag[0], real[1], imag[1], ... real[N/2], imag[N/2]]
+	 */
+	void forward(const vec4 *input, const float *window, vec4 *output);
+
+private:
+	void free();
+
+	int _length{0};
+	int _half_length{0}; // length of the complex FFT
+
+	float *_twiddle_real{nullptr}; // cos(2 pi k / N), k < N/2
+	float *_twiddle_imag{nullptr}; // -sin(2 pi k / N), k < N/2
+	uint16_t *_bit_reverse{nullptr};
+
+	vec4 *_real{nullptr};
+	vec4 *_imag{nullptr};
+};
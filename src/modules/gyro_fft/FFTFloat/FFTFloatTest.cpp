@@ -0,0 +1,338 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * Tests the float32 FFT against a reference DFT and compares it with the CMSIS q15
+ * FFT (the GyroFFT backend on microcontrollers) in peak detection and run time.
+ *
+ * The gyro data is simulated: three axes sampled at 8 kHz with motor vibration peaks,
+ * flight motion and sensor noise, quantised like raw int16 FIFO samples.
+ */
+
+#include <gtest/gtest.h>
+
+#include "FFTFloat.hpp"
+
+#include "arm_math.h"
+#include "arm_const_structs.h"
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+static constexpr float SAMPLE_RATE_HZ = 8000.f;
+
+// vibration peak of each axis (Hz)
+static constexpr float PEAK_HZ[3] {87.f, 131.5f, 210.f};
+
+class FFTFloatTest : public ::testing::Test
+{
+public:
+	// simulated raw gyro FIFO data (int16), 3 axes
+	static void gyroData(int length, std::vector<int16_t> axes[3])
+	{
+		uint32_t seed = 1;
+
+		for (int axis = 0; axis < 3; axis++) {
+			axes[axis].resize(length);
+
+			for (int n = 0; n < length; n++) {
+				const float t = n / SAMPLE_RATE_HZ;
+
+				// deterministic uniform noise [-1, 1]
+				seed = seed * 1664525u + 1013904223u;
+				const float noise = (seed >> 8) / float(1 << 23) - 1.f;
+
+				const float value = 2000.f * sinf(2.f * (float)M_PI * PEAK_HZ[axis] * t)       // motor vibration
+						    + 600.f * sinf(2.f * (float)M_PI * 2.f * PEAK_HZ[axis] * t) // harmonic
+						    + 1500.f * sinf(2.f * (float)M_PI * 1.5f * t)               // vehicle motion
+						    + 300.f * noise;
+
+				axes[axis][n] = (int16_t)roundf(value);
+			}
+		}
+	}
+
+	static std::vector<float> hanning(int length)
+	{
+		std::vector<float> window(length);
+
+		for (int n = 0; n < length; n++) {
+			window[n] = 0.5f * (1.f - cosf(2.f * (float)M_PI * n / (length - 1)));
+		}
+
+		return window;
+	}
+
+	// index of the largest bin magnitude (excluding DC) of an interleaved [real, imag] spectrum
+	template<typename T>
+	static int peakBin(const T *spectrum, int length)
+	{
+		float largest = 0.f;
+		int largest_bin = 0;
+
+		for (int bin = 1; bin < length / 2; bin++) {
+			const float real = spectrum[2 * bin];
+			const float imag = spectrum[2 * bin + 1];
+			const float magnitude = real * real + imag * imag;
+
+			if (magnitude > largest) {
+				largest = magnitude;
+				largest_bin = bin;
+			}
+		}
+
+		return largest_bin;
+	}
+};
+
+TEST_F(FFTFloatTest, InitLength)
+{
+	FFTFloat fft;
+	EXPECT_FALSE(fft.init(0));
+	EXPECT_FALSE(fft.init(8));
+	EXPECT_FALSE(fft.init(1000));
+	EXPECT_FALSE(fft.init(2 * FFTFloat::MAX_LENGTH));
+	EXPECT_TRUE(fft.init(256));
+	EXPECT_EQ(fft.length(), 256);
+	EXPECT_TRUE(fft.init(4096));
+	EXPECT_EQ(fft.length(), 4096);
+}
+
+TEST_F(FFTFloatTest, MatchesDFT)
+{
+	for (int length : {16, 256, 2048}) {
+		FFTFloat fft;
+		ASSERT_TRUE(fft.init(length));
+
+		std::vector<int16_t> axes[3];
+		gyroData(length, axes);
+
+		std::vector<FFTFloat::vec4> input(length);
+
+		for (int n = 0; n < length; n++) {
+			input[n] = FFTFloat::vec4{(float)axes[0][n], (float)axes[1][n], (float)axes[2][n], 0.f};
+		}
+
+		std::vector<FFTFloat::vec4> output(length + 2);
+		fft.forward(input.data(), nullptr, output.data());
+
+		for (int axis = 0; axis < 3; axis++) {
+			double max_error = 0.0;
+			double max_magnitude = 0.0;
+
+			for (int k = 0; k <= length / 2; k++) {
+				double real = 0.0;
+				double imag = 0.0;
+
+				for (int n = 0; n < length; n++) {
+					real += axes[axis][n] * cos(2.0 * M_PI * k * n / length);
+					imag -= axes[axis][n] * sin(2.0 * M_PI * k * n / length);
+				}
+
+				max_error = fmax(max_error, fabs(real - output[2 * k][axis]));
+				max_error = fmax(max_error, fabs(imag - output[2 * k + 1][axis]));
+				max_magnitude = fmax(max_magnitude, hypot(real, imag));
+			}
+
+			EXPECT_LT(max_error / max_magnitude, 1e-5) << "length " << length << " axis " << axis;
+		}
+
+		// unused lane stays zero
+		for (int i = 0; i < length + 2; i++) {
+			EXPECT_EQ(output[i][3], 0.f);
+		}
+	}
+}
+
+TEST_F(FFTFloatTest, PeaksMatchQ15)
+{
+	for (int length : {256, 512, 1024}) {
+		std::vector<int16_t> axes[3];
+		gyroData(length, axes);
+		const std::vector<float> window = hanning(length);
+
+		// float32: all axes in one pass
+		FFTFloat fft;
+		ASSERT_TRUE(fft.init(length));
+
+		std::vector<FFTFloat::vec4> input(length);
+
+		for (int n = 0; n < length; n++) {
+			input[n] = FFTFloat::vec4{(float)axes[0][n], (float)axes[1][n], (float)axes[2][n], 0.f};
+		}
+
+		std::vector<FFTFloat::vec4> output(length + 2);
+		fft.forward(input.data(), window.data(), output.data());
+
+		// q15: one axis at a time, like GyroFFT
+		arm_rfft_instance_q15 rfft_q15;
+		ASSERT_EQ(arm_rfft_init_q15(&rfft_q15, length, 0, 1), ARM_MATH_SUCCESS);
+
+		std::vector<q15_t> window_q15(length);
+		arm_float_to_q15(window.data(), window_q15.data(), length);
+
+		std::vector<q15_t> data_q15(length);
+		std::vector<q15_t> input_q15(length);
+		std::vector<q15_t> output_q15(length * 2);
+
+		const float resolution_hz = SAMPLE_RATE_HZ / length;
+
+		for (int axis = 0; axis < 3; axis++) {
+			for (int n = 0; n < length; n++) {
+				data_q15[n] = axes[axis][n] / 2;
+			}
+
+			arm_mult_q15(data_q15.data(), window_q15.data(), input_q15.data(), length);
+			arm_rfft_q15(&rfft_q15, input_q15.data(), output_q15.data());
+
+			std::vector<float> spectrum(length + 2);
+
+			for (int i = 0; i < length + 2; i++) {
+				spectrum[i] = output[i][axis];
+			}
+
+			const int peak_float = peakBin(spectrum.data(), length);
+			const int peak_q15 = peakBin(output_q15.data(), length);
+
+			EXPECT_EQ(peak_float, peak_q15) << "length " << length << " axis " << axis;
+			EXPECT_NEAR(peak_float * resolution_hz, PEAK_HZ[axis], resolution_hz) << "length " << length << " axis " << axis;
+		}
+	}
+}
+
+TEST_F(FFTFloatTest, LongTransformResolution)
+{
+	// lengths only supported by the float backend resolve the peaks more finely
+	for (int length : {2048, 4096}) {
+		std::vector<int16_t> axes[3];
+		gyroData(length, axes);
+		const std::vector<float> window = hanning(length);
+
+		FFTFloat fft;
+		ASSERT_TRUE(fft.init(length));
+
+		std::vector<FFTFloat::vec4> input(length);
+
+		for (int n = 0; n < length; n++) {
+			input[n] = FFTFloat::vec4{(float)axes[0][n], (float)axes[1][n], (float)axes[2][n], 0.f};
+		}
+
+		std::vector<FFTFloat::vec4> output(length + 2);
+		fft.forward(input.data(), window.data(), output.data());
+
+		const float resolution_hz = SAMPLE_RATE_HZ / length;
+
+		for (int axis = 0; axis < 3; axis++) {
+			std::vector<float> spectrum(length + 2);
+
+			for (int i = 0; i < length + 2; i++) {
+				spectrum[i] = output[i][axis];
+			}
+
+			EXPECT_NEAR(peakBin(spectrum.data(), length) * resolution_hz, PEAK_HZ[axis], resolution_hz);
+		}
+	}
+}
+
+TEST_F(FFTFloatTest, Benchmark)
+{
+	static constexpr int ITERATIONS = 200;
+
+	for (int length : {256, 512, 1024}) {
+		std::vector<int16_t> axes[3];
+		gyroData(length, axes);
+		const std::vector<float> window = hanning(length);
+
+		// q15: windowing and FFT per axis
+		arm_rfft_instance_q15 rfft_q15;
+		ASSERT_EQ(arm_rfft_init_q15(&rfft_q15, length, 0, 1), ARM_MATH_SUCCESS);
+
+		std::vector<q15_t> window_q15(length);
+		arm_float_to_q15(window.data(), window_q15.data(), length);
+
+		std::vector<q15_t> data_q15[3];
+
+		for (int axis = 0; axis < 3; axis++) {
+			data_q15[axis].resize(length);
+
+			for (int n = 0; n < length; n++) {
+				data_q15[axis][n] = axes[axis][n] / 2;
+			}
+		}
+
+		std::vector<q15_t> input_q15(length);
+		std::vector<q15_t> output_q15(length * 2);
+
+		const auto q15_start = std::chrono::steady_clock::now();
+
+		for (int i = 0; i < ITERATIONS; i++) {
+			for (int axis = 0; axis < 3; axis++) {
+				arm_mult_q15(data_q15[axis].data(), window_q15.data(), input_q15.data(), length);
+				arm_rfft_q15(&rfft_q15, input_q15.data(), output_q15.data());
+			}
+		}
+
+		const auto q15_end = std::chrono::steady_clock::now();
+
+		// float32: windowing and FFT of all axes in one pass
+		FFTFloat fft;
+		ASSERT_TRUE(fft.init(length));
+
+		std::vector<FFTFloat::vec4> input(length);
+
+		for (int n = 0; n < length; n++) {
+			input[n] = FFTFloat::vec4{(float)axes[0][n], (float)axes[1][n], (float)axes[2][n], 0.f};
+		}
+
+		std::vector<FFTFloat::vec4> output(length + 2);
+
+		const auto float_start = std::chrono::steady_clock::now();
+
+		for (int i = 0; i < ITERATIONS; i++) {
+			fft.forward(input.data(), window.data(), output.data());
+		}
+
+		const auto float_end = std::chrono::steady_clock::now();
+
+		const double q15_us = std::chrono::duration<double, std::micro>(q15_end - q15_start).count() / ITERATIONS;
+		const double float_us = std::chrono::duration<double, std::micro>(float_end - float_start).count() / ITERATIONS;
+
+		printf("FFT length %4d, 3 axes: q15 %8.2f us, float32 %8.2f us\n", length, q15_us, float_us);
+
+		// keep the results alive
+		EXPECT_GE(peakBin(output_q15.data(), length), 0);
+		EXPECT_GE(output[2][0] * output[2][0], 0.f);
+	}
+}
@@ -60,19 +60,73 @@ GyroFFT::~GyroFFT()
 	perf_free(_gyro_generation_gap_perf);
 	perf_free(_gyro_fifo_generation_gap_perf);
 
+	FreeBuffers();
+}
+
+void GyroFFT::FreeBuffers()
+{
+#if defined(CONFIG_GYRO_FFT_FLOAT)
+	delete[] _gyro_data_buffer;
+	delete[] _fft_vector_output_buffer;
+	_gyro_data_buffer = nullptr;
+	_fft_vector_output_buffer = nullptr;
+#else
 	delete[] _gyro_data_buffer_x;
 	delete[] _gyro_data_buffer_y;
 	delete[] _gyro_data_buffer_z;
-	delete[] _hanning_window;
 	delete[] _fft_input_buffer;
+	_gyro_data_buffer_x = nullptr;
+	_gyro_data_buffer_y = nullptr;
+	_gyro_data_buffer_z = nullptr;
+	_fft_input_buffer = nullptr;
+#endif // CONFIG_GYRO_FFT_FLOAT
+
+	delete[] _hanning_window;
 	delete[] _fft_outupt_buffer;
 	delete[] _peak_magnitudes_all;
+	_hanning_window = nullptr;
+	_fft_outupt_buffer = nullptr;
+	_peak_magnitudes_all = nullptr;
 }
 
 bool GyroFFT::init()
 {
 	bool buffers_allocated = false;
 
+#if defined(CONFIG_GYRO_FFT_FLOAT)
+
+	switch (_param_imu_gyro_fft_len.get()) {
+	case 256:
+		buffers_allocated = AllocateBuffers<256>();
+		break;
+
+	case 512:
+		buffers_allocated = AllocateBuffers<512>();
+		break;
+
+	case 1024:
+		buffers_allocated = AllocateBuffers<1024>();
+		break;
+
+	case 2048:
+		buffers_allocated = AllocateBuffers<2048>();
+		break;
+
+	case 4096:
+		buffers_allocated = AllocateBuffers<4096>();
+		break;
+
+	default:
+		// otherwise default to 256
+		PX4_ERR("Invalid IMU_GYRO_FFT_LEN=%" PRId32 ", resetting", _param_imu_gyro_fft_len.get());
+		buffers_allocated = AllocateBuffers<256>();
+		_param_imu_gyro_fft_len.set(256);
+		_param_imu_gyro_fft_len.commit();
+		break;
+	}
+
+#else
+
 	// arm_rfft_init_q15(&_rfft_q15, _imu_gyro_fft_len, 0, 1) manually inlined to save flash
 	_rfft_q15.pTwiddleAReal = (q15_t *) realCoefAQ15;
 	_rfft_q15.pTwiddleBReal = (q15_t *) realCoefBQ15;
@@ -138,13 +192,19 @@ bool GyroFFT::init()
 		break;
 	}
 
+#endif // CONFIG_GYRO_FFT_FLOAT
+
 	if (buffers_allocated) {
 		_imu_gyro_fft_len = _param_imu_gyro_fft_len.get();
 
 		// init Hanning window
 		for (int n = 0; n < _imu_gyro_fft_len; n++) {
 			const float hanning_value = 0.5f * (1.f - cosf(2.f * M_PI_F * n / (_imu_gyro_fft_len - 1)));
+#if defined(CONFIG_GYRO_FFT_FLOAT)
+			_hanning_window[n] = hanning_value;
+#else
 			arm_float_to_q15(&hanning_value, &_hanning_window[n], 1);
+#endif // CONFIG_GYRO_FFT_FLOAT
 		}
 
 		if (!SensorSelectionUpdate(true)) {
@@ -155,12 +215,7 @@ bool GyroFFT::init()
 	}
 
 	PX4_ERR("failed to allocate buffers");
-	delete[] _gyro_data_buffer_x;
-	delete[] _gyro_data_buffer_y;
-	delete[] _gyro_data_buffer_z;
-	delete[] _hanning_window;
-	delete[] _fft_input_buffer;
-	delete[] _fft_outupt_buffer;
+	FreeBuffers();
 
 	return false;
 }
@@ -266,7 +321,7 @@ static inline float tau(float x)
 	return (0.25f * p1 - sqrtf(6.f) / 24.f * p2);
 }
 
-float GyroFFT::EstimatePeakFrequencyBin(q15_t fft[], int peak_index)
+float GyroFFT::EstimatePeakFrequencyBin(fft_t fft[], int peak_index)
 {
 	if (peak_index >= 2) {
 		// find peak location using Quinn's Second Estimator (2020-06-14: http://dspguru.com/dsp/howtos/how-to-interpolate-fft-peak/)
@@ -394,6 +449,43 @@ void GyroFFT::Run()
 
 void GyroFFT::Update(const hrt_abstime &timestamp_sample, int16_t *input[], uint8_t N)
 {
+#if defined(CONFIG_GYRO_FFT_FLOAT)
+	// the axes are always reset together, buffer them interleaved and transform all of them at once
+	int &buffer_index = _fft_buffer_index[0];
+
+	for (int n = 0; n < N; n++) {
+		if (buffer_index < _imu_gyro_fft_len) {
+			_gyro_data_buffer[buffer_index] = FFTFloat::vec4{(float)input[0][n], (float)input[1][n], (float)input[2][n], 0.f};
+			buffer_index++;
+		}
+
+		// if we have enough samples begin processing, but only one FFT per cycle
+		if ((buffer_index >= _imu_gyro_fft_len) && !_fft_updated) {
+			perf_begin(_fft_perf);
+
+			_fft.forward(_gyro_data_buffer, _hanning_window, _fft_vector_output_buffer);
+
+			_fft_updated = true;
+
+			for (int axis = 0; axis < 3; axis++) {
+				for (int i = 0; i < _imu_gyro_fft_len + 2; i++) {
+					_fft_outupt_buffer[i] = _fft_vector_output_buffer[i][axis];
+				}
+
+				FindPeaks(timestamp_sample, axis, _fft_outupt_buffer);
+			}
+
+			// reset
+			// shift buffer (3/4 overlap)
+			const int overlap_start = _imu_gyro_fft_len / 4;
+			memmove(&_gyro_data_buffer[0], &_gyro_data_buffer[overlap_start], sizeof(FFTFloat::vec4) * overlap_start * 3);
+			buffer_index = overlap_start * 3;
+
+			perf_end(_fft_perf);
+		}
+	}
+
+#else
 	q15_t *gyro_data_buffer[] {_gyro_data_buffer_x, _gyro_data_buffer_y, _gyro_data_buffer_z};
 
 	for (int axis = 0; axis < 3; axis++) {
@@ -427,9 +519,11 @@ void GyroFFT::Update(const hrt_abstime &timestamp_sample, int16_t *input[], uint
 			}
 		}
 	}
+
+#endif // CONFIG_GYRO_FFT_FLOAT
 }
 
-void GyroFFT::FindPeaks(const hrt_abstime &timestamp_sample, int axis, q15_t *fft_outupt_buffer)
+void GyroFFT::FindPeaks(const hrt_abstime &timestamp_sample, int axis, fft_t *fft_outupt_buffer)
 {
 	const float resolution_hz = _gyro_sample_rate_hz / _imu_gyro_fft_len;
 
@@ -703,6 +797,11 @@ int GyroFFT::task_spawn(int argc, char *argv[])
 int GyroFFT::print_status()
 {
 	PX4_INFO("gyro sample rate: %.3f Hz", (double)_gyro_sample_rate_hz);
+#if defined(CONFIG_GYRO_FFT_FLOAT)
+	PX4_INFO("FFT: float32, length %" PRId32, _imu_gyro_fft_len);
+#else
+	PX4_INFO("FFT: q15, length %" PRId32, _imu_gyro_fft_len);
+#endif // CONFIG_GYRO_FFT_FLOAT
 	perf_print_counter(_cycle_perf);
 	perf_print_counter(_cycle_interval_perf);
 	perf_print_counter(_fft_perf);
@@ -725,6 +824,12 @@ int GyroFFT::print_usage(const char *reason)
 	PRINT_MODULE_DESCRIPTION(
 		R"DESCR_STR(
 ### Description
+Estimates the dominant vibration frequencies (peaks) of each gyro axis with a real FFT and publishes them
+(`sensor_gyro_fft`) for the dynamic notch filters.
+
+The FFT backend is selected at build time: the CMSIS fixed point (q15) FFT for microcontrollers, or with
+CONFIG_GYRO_FFT_FLOAT a float32 FFT that transforms all three axes in one SIMD pass and supports longer
+transform lengths (IMU_GYRO_FFT_LEN up to 4096).
 
 )DESCR_STR");
 
@@ -53,8 +53,12 @@
 #include <uORB/topics/sensor_selection.h>
 #include <uORB/topics/vehicle_imu_status.h>
 
+#if defined(CONFIG_GYRO_FFT_FLOAT)
+#include "FFTFloat.hpp"
+#else
 #include "arm_math.h"
 #include "arm_const_structs.h"
+#endif // CONFIG_GYRO_FFT_FLOAT
 
 using namespace time_literals;
 
@@ -84,9 +88,15 @@ private:
 	static constexpr int MAX_NUM_PEAKS = sizeof(sensor_gyro_fft_s::peak_frequencies_x) / sizeof(
 			sensor_gyro_fft_s::peak_frequencies_x[0]);
 
+#if defined(CONFIG_GYRO_FFT_FLOAT)
+	using fft_t = float;
+#else
+	using fft_t = q15_t;
+#endif // CONFIG_GYRO_FFT_FLOAT
+
 	void Run() override;
-	inline void FindPeaks(const hrt_abstime &timestamp_sample, int axis, q15_t *fft_outupt_buffer);
-	inline float EstimatePeakFrequencyBin(q15_t fft[], int peak_index);
+	inline void FindPeaks(const hrt_abstime &timestamp_sample, int axis, fft_t *fft_outupt_buffer);
+	inline float EstimatePeakFrequencyBin(fft_t fft[], int peak_index);
 	inline void Publish();
 	bool SensorSelectionUpdate(bool force = false);
 	void Update(const hrt_abstime &timestamp_sample, int16_t *input[], uint8_t N);
@@ -97,6 +107,19 @@ private:
 	template<size_t N>
 	bool AllocateBuffers()
 	{
+#if defined(CONFIG_GYRO_FFT_FLOAT)
+		_gyro_data_buffer = new FFTFloat::vec4[N];
+		_fft_vector_output_buffer = new FFTFloat::vec4[N + 2];
+		_hanning_window = new fft_t[N];
+		_fft_outupt_buffer = new fft_t[N * 2] {};
+
+		_peak_magnitudes_all = new float[N];
+
+		return (_gyro_data_buffer && _fft_vector_output_buffer
+			&& _fft.init(N)
+			&& _hanning_window
+			&& _fft_outupt_buffer);
+#else
 		_gyro_data_buffer_x = new q15_t[N];
 		_gyro_data_buffer_y = new q15_t[N];
 		_gyro_data_buffer_z = new q15_t[N];
@@ -110,8 +133,11 @@ private:
 			&& _hanning_window
 			&& _fft_input_buffer
 			&& _fft_outupt_buffer);
+#endif // CONFIG_GYRO_FFT_FLOAT
 	}
 
+	void FreeBuffers();
+
 	uORB::Publication<sensor_gyro_fft_s> _sensor_gyro_fft_pub{ORB_ID(sensor_gyro_fft)};
 
 	uORB::SubscriptionInterval _parameter_update_sub{ORB_ID(parameter_update), 1_s};
@@ -132,14 +158,23 @@ private:
 
 	bool _gyro_fifo{false};
 
+#if defined(CONFIG_GYRO_FFT_FLOAT)
+	FFTFloat _fft;
+
+	// all axes interleaved (x, y, z, unused) and transformed in one pass
+	FFTFloat::vec4 *_gyro_data_buffer{nullptr};
+	FFTFloat::vec4 *_fft_vector_output_buffer{nullptr};
+#else
 	arm_rfft_instance_q15 _rfft_q15;
 
 	q15_t *_gyro_data_buffer_x{nullptr};
 	q15_t *_gyro_data_buffer_y{nullptr};
 	q15_t *_gyro_data_buffer_z{nullptr};
-	q15_t *_hanning_window{nullptr};
 	q15_t *_fft_input_buffer{nullptr};
-	q15_t *_fft_outupt_buffer{nullptr};
+#endif // CONFIG_GYRO_FFT_FLOAT
+
+	fft_t *_hanning_window{nullptr};
+	fft_t *_fft_outupt_buffer{nullptr};
 
 	float *_peak_magnitudes_all{nullptr};
 
@@ -101,6 +101,8 @@ void LoadMon::Run()
 
 	cpuload();
 
+	work_item_stats();
+
 #if defined(__PX4_NUTTX)
 
 	if (_param_sys_stck_en.get()) {
@@ -247,6 +249,40 @@ void LoadMon::cpuload()
 #endif
 }
 
+void LoadMon::work_item_stats()
+{
+	// a few work items per cycle (limited by the queue length), continue with the next ones in the next cycle
+	for (unsigned i = 0; i < work_item_stats_s::ORB_QUEUE_LENGTH; i++) {
+		px4::work_item_stats_t stats;
+
+		if (!px4::WorkItemStatistics(_work_item_index, stats)) {
+			if (_work_item_index == 0) {
+				return;
+			}
+
+			// wrap around
+			_work_item_index = 0;
+			continue;
+		}
+
+		_work_item_index++;
+
+		work_item_stats_s work_item_stats{};
+		static_assert(sizeof(work_item_stats.item_name) == sizeof(stats.item_name), "item_name size mismatch");
+		static_assert(sizeof(work_item_stats.latency_histogram) == sizeof(stats.latency_histogram), "histogram size mismatch");
+
+		memcpy(work_item_stats.item_name, stats.item_name, sizeof(work_item_stats.item_name));
+		strncpy(work_item_stats.wq_name, stats.wq_name, sizeof(work_item_stats.wq_name) - 1);
+		memcpy(work_item_stats.latency_histogram, stats.latency_histogram, sizeof(work_item_stats.latency_histogram));
+		memcpy(work_item_stats.run_time_histogram, stats.run_time_histogram, sizeof(work_item_stats.run_time_histogram));
+		work_item_stats.latency_max = stats.latency_max;
+		work_item_stats.run_time_max = stats.run_time_max;
+		work_item_stats.timestamp = hrt_absolute_time();
+
+		_work_item_stats_pub.publish(work_item_stats);
+	}
+}
+
 #if defined(__PX4_NUTTX)
 void LoadMon::stack_usage()
 {
@@ -317,6 +353,9 @@ usage and publish the `cpuload` topic.
 
 On NuttX it also checks the stack usage of each process and if it falls below 300 bytes, a warning is output,
 which will also appear in the log file.
+
+It also publishes the scheduling latency and run time histograms of all work items (`work_item_stats`),
+a few work items per cycle.
 )DESCR_STR");
 
 	PRINT_MODULE_USAGE_NAME("load_mon", "system");
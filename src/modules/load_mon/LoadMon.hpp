@@ -47,6 +47,7 @@
 #include <uORB/Publication.hpp>
 #include <uORB/topics/cpuload.h>
 #include <uORB/topics/task_stack_info.h>
+#include <uORB/topics/work_item_stats.h>
 
 #if defined(__PX4_LINUX)
 #include <sys/times.h>
@@ -81,6 +82,13 @@ private:
 	/** Do a calculation of the CPU load and publish it. */
 	void cpuload();
 
+	/** Publish the latency and run time statistics of the next work items. */
+	void work_item_stats();
+
+	unsigned _work_item_index{0};
+
+	uORB::Publication<work_item_stats_s> _work_item_stats_pub{ORB_ID(work_item_stats)};
+
 	/* Stack check only available on Nuttx */
 #if defined(__PX4_NUTTX)
 	/* Calculate stack usage */
@@ -0,0 +1,176 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * Writes a file through both FileWriteQueue backends and checks the file contents and
+ * that an fsync only completes after the writes submitted before it.
+ */
+
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <vector>
+
+#include "file_write_queue.h"
+
+#if defined(LOGGER_ASYNC_FILE_IO)
+
+using namespace px4::logger;
+
+namespace
+{
+
+static constexpr uint32_t FSYNC_TAG = 0x10000;
+
+struct Completions {
+	pthread_mutex_t mtx = PTHREAD_MUTEX_INITIALIZER;
+	pthread_cond_t cv = PTHREAD_COND_INITIALIZER;
+	std::vector<uint32_t> tags;
+	std::vector<ssize_t> results;
+};
+
+void completion_callback(void *context, uint32_t tag, ssize_t result, hrt_abstime latency)
+{
+	Completions *completions = static_cast<Completions *>(context);
+	pthread_mutex_lock(&completions->mtx);
+	completions->tags.push_back(tag);
+	completions->results.push_back(result);
+	pthread_cond_broadcast(&completions->cv);
+	pthread_mutex_unlock(&completions->mtx);
+}
+
+class FileWriteQueueTest : public ::testing::TestWithParam<FileWriteQueue::Mode>
+{
+public:
+	void SetUp() override
+	{
+		char path[] = "/tmp/file_write_queue_test_XXXXXX";
+		_fd = mkstemp(path);
+		ASSERT_GE(_fd, 0);
+		unlink(path);
+	}
+
+	void TearDown() override
+	{
+		close(_fd);
+	}
+
+	void wait_for(size_t count)
+	{
+		pthread_mutex_lock(&_completions.mtx);
+
+		while (_completions.tags.size() < count) {
+			pthread_cond_wait(&_completions.cv, &_completions.mtx);
+		}
+
+		pthread_mutex_unlock(&_completions.mtx);
+	}
+
+	int _fd{-1};
+	Completions _completions;
+};
+
+} // namespace
+
+TEST_P(FileWriteQueueTest, WriteAndFsync)
+{
+	FileWriteQueue queue(&completion_callback, &_completions);
+
+	if (!queue.start(GetParam())) {
+		GTEST_SKIP() << "async file I/O not available";
+	}
+
+	if (GetParam() == FileWriteQueue::Mode::Auto && queue.backend() != FileWriteQueue::Backend::IoUring) {
+		queue.stop();
+		GTEST_SKIP() << "io_uring not available";
+	}
+
+	// rounds of writes (large enough to take a while) each followed by an fsync
+	static constexpr unsigned rounds = 20;
+	static constexpr unsigned writes_per_round = FileWriteQueue::QUEUE_DEPTH - 1;
+	static constexpr size_t write_size = 256 * 1024;
+
+	std::vector<uint8_t> data(rounds * writes_per_round * write_size);
+
+	for (size_t i = 0; i < data.size(); i++) {
+		data[i] = (i * 7 + i / 4096) & 0xff;
+	}
+
+	size_t submitted = 0;
+
+	for (unsigned round = 0; round < rounds; round++) {
+		for (unsigned i = 0; i < writes_per_round; i++) {
+			const uint32_t tag = round * writes_per_round + i;
+			const off_t offset = tag * write_size;
+			ASSERT_TRUE(queue.submit_write(_fd, &data[offset], write_size, offset, tag));
+		}
+
+		ASSERT_TRUE(queue.submit_fsync(_fd, FSYNC_TAG | round));
+		submitted += writes_per_round + 1;
+
+		// wait until the queue is empty again
+		wait_for(submitted);
+	}
+
+	queue.stop();
+
+	ASSERT_EQ(_completions.tags.size(), rounds * (writes_per_round + 1));
+
+	size_t writes_completed = 0;
+
+	for (size_t i = 0; i < _completions.tags.size(); i++) {
+		const uint32_t tag = _completions.tags[i];
+
+		if (tag & FSYNC_TAG) {
+			// every write of the round completed before its fsync
+			EXPECT_EQ(_completions.results[i], 0);
+			EXPECT_EQ(writes_completed, ((tag & ~FSYNC_TAG) + 1) * writes_per_round);
+
+		} else {
+			EXPECT_EQ(_completions.results[i], (ssize_t)write_size);
+			++writes_completed;
+		}
+	}
+
+	std::vector<uint8_t> file(data.size());
+	ASSERT_EQ(pread(_fd, file.data(), file.size(), 0), (ssize_t)file.size());
+	EXPECT_TRUE(file == data);
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends, FileWriteQueueTest,
+			 ::testing::Values(FileWriteQueue::Mode::Auto, FileWriteQueue::Mode::ThreadPool));
+
+#endif /* LOGGER_ASYNC_FILE_IO */
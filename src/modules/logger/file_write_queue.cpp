@@ -0,0 +1,512 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "file_write_queue.h"
+
+#if defined(LOGGER_ASYNC_FILE_IO)
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include <px4_platform_common/log.h>
+#include <px4_platform_common/posix.h>
+#include <px4_platform_common/tasks.h>
+
+namespace px4
+{
+namespace logger
+{
+
+#if defined(LOGGER_HAVE_IO_URING)
+static constexpr uint64_t IO_URING_WAKEUP = UINT64_MAX; ///< user_data of the NOP used to wake up the reaper
+#endif
+
+FileWriteQueue::FileWriteQueue(CompletionCallback callback, void *context)
+	: _callback(callback), _context(context)
+{
+	pthread_mutex_init(&_mtx, nullptr);
+	pthread_cond_init(&_cv, nullptr);
+}
+
+FileWriteQueue::~FileWriteQueue()
+{
+	stop();
+
+	pthread_mutex_destroy(&_mtx);
+	pthread_cond_destroy(&_cv);
+}
+
+const char *FileWriteQueue::backend_str(Backend backend)
+{
+	switch (backend) {
+	case Backend::None: return "sync";
+
+	case Backend::IoUring: return "io_uring";
+
+	case Backend::ThreadPool: return "thread pool";
+	}
+
+	return "unknown";
+}
+
+bool FileWriteQueue::start_thread(pthread_t &thread, void *(*entry)(void *))
+{
+	pthread_attr_t thr_attr;
+	pthread_attr_init(&thr_attr);
+
+	sched_param param;
+	/* same priority as the writer thread */
+	param.sched_priority = SCHED_PRIORITY_DEFAULT - 40;
+	(void)pthread_attr_setschedparam(&thr_attr, &param);
+
+	pthread_attr_setstacksize(&thr_attr, PX4_STACK_ADJUSTED(1170));
+
+	int ret = pthread_create(&thread, &thr_attr, entry, this);
+	pthread_attr_destroy(&thr_attr);
+
+	if (ret) {
+		PX4_ERR("failed to create I/O thread (%i)", ret);
+	}
+
+	return ret == 0;
+}
+
+bool FileWriteQueue::start(Mode mode)
+{
+	if (_backend != Backend::None || mode == Mode::Disabled) {
+		return _backend != Backend::None;
+	}
+
+	_exit = false;
+
+#if defined(LOGGER_HAVE_IO_URING)
+
+	if (mode == Mode::Auto && io_uring_setup()) {
+		if (start_thread(_reaper_thread, &FileWriteQueue::io_uring_reaper_helper)) {
+			_backend = Backend::IoUring;
+			return true;
+		}
+
+		io_uring_teardown();
+	}
+
+#endif /* LOGGER_HAVE_IO_URING */
+
+	for (int i = 0; i < NUM_WORKERS; ++i) {
+		if (start_thread(_workers[i], &FileWriteQueue::worker_helper)) {
+			++_num_workers;
+		}
+	}
+
+	if (_num_workers > 0) {
+		_backend = Backend::ThreadPool;
+		return true;
+	}
+
+	return false;
+}
+
+void FileWriteQueue::stop()
+{
+	if (_backend == Backend::None) {
+		return;
+	}
+
+	pthread_mutex_lock(&_mtx);
+
+	while (_in_flight > 0) {
+		pthread_cond_wait(&_cv, &_mtx);
+	}
+
+	_exit = true;
+	pthread_cond_broadcast(&_cv);
+	pthread_mutex_unlock(&_mtx);
+
+#if defined(LOGGER_HAVE_IO_URING)
+
+	if (_backend == Backend::IoUring) {
+		// wake up the reaper with a NOP request
+		pthread_mutex_lock(&_mtx);
+		const unsigned tail = *_sq_tail;
+		const unsigned index = tail & *_sq_mask;
+		io_uring_sqe &sqe = _sqes[index];
+		memset(&sqe, 0, sizeof(sqe));
+		sqe.opcode = IORING_OP_NOP;
+		sqe.user_data = IO_URING_WAKEUP;
+		_sq_array[index] = index;
+		__atomic_store_n(_sq_tail, tail + 1, __ATOMIC_RELEASE);
+		pthread_mutex_unlock(&_mtx);
+
+		syscall(__NR_io_uring_enter, _ring_fd, 1, 0, 0, nullptr, 0);
+
+		pthread_join(_reaper_thread, nullptr);
+		io_uring_teardown();
+	}
+
+#endif /* LOGGER_HAVE_IO_URING */
+
+	for (int i = 0; i < _num_workers; ++i) {
+		pthread_join(_workers[i], nullptr);
+	}
+
+	_num_workers = 0;
+	_backend = Backend::None;
+}
+
+bool FileWriteQueue::submit_write(int fd, const void *buffer, size_t size, off_t offset, uint32_t tag)
+{
+	return submit(Request{fd, buffer, size, offset, false, tag, 0});
+}
+
+bool FileWriteQueue::submit_fsync(int fd, uint32_t tag)
+{
+	return submit(Request{fd, nullptr, 0, 0, true, tag, 0});
+}
+
+bool FileWriteQueue::submit(const Request &request)
+{
+	if (_backend == Backend::None) {
+		return false;
+	}
+
+	pthread_mutex_lock(&_mtx);
+
+	unsigned slot = 0;
+
+	while (slot < QUEUE_DEPTH && _slot_used[slot]) {
+		++slot;
+	}
+
+	if (slot == QUEUE_DEPTH || _exit) {
+		pthread_mutex_unlock(&_mtx);
+		return false;
+	}
+
+	_requests[slot] = request;
+	_requests[slot].submit_time = hrt_absolute_time();
+	_slot_used[slot] = true;
+	++_in_flight;
+
+	if (_backend == Backend::ThreadPool) {
+		_queued[(_queued_head + _queued_count) % QUEUE_DEPTH] = slot;
+		++_queued_count;
+		pthread_cond_broadcast(&_cv);
+	}
+
+#if defined(LOGGER_HAVE_IO_URING)
+
+	if (_backend == Backend::IoUring) {
+		const unsigned tail = *_sq_tail;
+		const unsigned index = tail & *_sq_mask;
+		io_uring_sqe &sqe = _sqes[index];
+		memset(&sqe, 0, sizeof(sqe));
+		sqe.fd = request.fd;
+		sqe.user_data = slot;
+
+		if (request.fsync) {
+			// do not start before the writes submitted earlier completed
+			sqe.opcode = IORING_OP_FSYNC;
+			sqe.flags = IOSQE_IO_DRAIN;
+
+		} else {
+			// IORING_OP_WRITEV is supported by all io_uring capable kernels
+			_iov[slot].iov_base = const_cast<void *>(request.buffer);
+			_iov[slot].iov_len = request.size;
+			sqe.opcode = IORING_OP_WRITEV;
+			sqe.addr = (uint64_t)(uintptr_t)&_iov[slot];
+			sqe.len = 1;
+			sqe.off = request.offset;
+		}
+
+		_sq_array[index] = index;
+		__atomic_store_n(_sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+		// the completion can only arrive after io_uring_enter(), the slot is already marked as used
+		pthread_mutex_unlock(&_mtx);
+
+		int ret;
+
+		do {
+			ret = syscall(__NR_io_uring_enter, _ring_fd, 1, 0, 0, nullptr, 0);
+		} while (ret < 0 && errno == EINTR);
+
+		if (ret != 1) {
+			// not consumed by the kernel: revert (there is only a single submitter)
+			PX4_ERR("io_uring submit failed (%i)", errno);
+			pthread_mutex_lock(&_mtx);
+			__atomic_store_n(_sq_tail, tail, __ATOMIC_RELEASE);
+			release_slot(slot);
+			pthread_mutex_unlock(&_mtx);
+			return false;
+		}
+
+		return true;
+	}
+
+#endif /* LOGGER_HAVE_IO_URING */
+
+	pthread_mutex_unlock(&_mtx);
+	return true;
+}
+
+void FileWriteQueue::release_slot(unsigned slot)
+{
+	_slot_used[slot] = false;
+	--_in_flight;
+	pthread_cond_broadcast(&_cv);
+}
+
+void FileWriteQueue::complete(const Request &request, ssize_t result)
+{
+	// the slot is already released, so the callback can immediately queue the next request
+	_callback(_context, request.tag, result, hrt_elapsed_time(&request.submit_time));
+}
+
+void *FileWriteQueue::worker_helper(void *context)
+{
+	px4_prctl(PR_SET_NAME, "log_writer_io", px4_getpid());
+
+	static_cast<FileWriteQueue *>(context)->worker();
+	return nullptr;
+}
+
+void FileWriteQueue::worker()
+{
+	pthread_mutex_lock(&_mtx);
+
+	while (true) {
+		// an fsync waits until the requests taken before it completed
+		while ((!_exit && _queued_count == 0)
+		       || (_queued_count > 0 && _requests[_queued[_queued_head]].fsync && _running > 0)) {
+			pthread_cond_wait(&_cv, &_mtx);
+		}
+
+		if (_queued_count == 0) {
+			break;
+		}
+
+		const unsigned slot = _queued[_queued_head];
+		_queued_head = (_queued_head + 1) % QUEUE_DEPTH;
+		--_queued_count;
+		++_running;
+		const Request request = _requests[slot];
+		pthread_mutex_unlock(&_mtx);
+
+		ssize_t result = 0;
+
+		if (request.fsync) {
+			if (::fsync(request.fd) != 0) {
+				result = -errno;
+			}
+
+		} else {
+			const uint8_t *buffer = static_cast<const uint8_t *>(request.buffer);
+
+			while ((size_t)result < request.size) {
+				const ssize_t ret = ::pwrite(request.fd, buffer + result, request.size - result, request.offset + result);
+
+				if (ret < 0 && errno == EINTR) {
+					continue;
+				}
+
+				if (ret <= 0) {
+					result = ret < 0 ? -errno : result;
+					break;
+				}
+
+				result += ret;
+			}
+		}
+
+		pthread_mutex_lock(&_mtx);
+		--_running;
+		release_slot(slot);
+		pthread_mutex_unlock(&_mtx);
+
+		complete(request, result);
+
+		pthread_mutex_lock(&_mtx);
+	}
+
+	pthread_mutex_unlock(&_mtx);
+}
+
+#if defined(LOGGER_HAVE_IO_URING)
+
+bool FileWriteQueue::io_uring_setup()
+{
+	io_uring_params params{};
+	_ring_fd = syscall(__NR_io_uring_setup, QUEUE_DEPTH + 1, &params);
+
+	if (_ring_fd < 0) {
+		PX4_INFO("io_uring not available (%i), using worker threads", errno);
+		return false;
+	}
+
+	_sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+	_cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+	_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+
+	const bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+
+	if (single_mmap) {
+		if (_cq_ring_size > _sq_ring_size) {
+			_sq_ring_size = _cq_ring_size;
+		}
+
+		_cq_ring_size = _sq_ring_size;
+	}
+
+	_sq_ring = mmap(nullptr, _sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring_fd, IORING_OFF_SQ_RING);
+
+	if (_sq_ring == MAP_FAILED) {
+		_sq_ring = nullptr;
+		io_uring_teardown();
+		return false;
+	}
+
+	if (single_mmap) {
+		_cq_ring = _sq_ring;
+
+	} else {
+		_cq_ring = mmap(nullptr, _cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring_fd,
+				IORING_OFF_CQ_RING);
+
+		if (_cq_ring == MAP_FAILED) {
+			_cq_ring = nullptr;
+			io_uring_teardown();
+			return false;
+		}
+	}
+
+	void *sqes = mmap(nullptr, _sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring_fd, IORING_OFF_SQES);
+
+	if (sqes == MAP_FAILED) {
+		io_uring_teardown();
+		return false;
+	}
+
+	_sqes = static_cast<io_uring_sqe *>(sqes);
+
+	uint8_t *sq = static_cast<uint8_t *>(_sq_ring);
+	_sq_tail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+	_sq_mask = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+	_sq_array = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+
+	uint8_t *cq = static_cast<uint8_t *>(_cq_ring);
+	_cq_head = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+	_cq_tail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+	_cq_mask = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+	_cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+
+	return true;
+}
+
+void FileWriteQueue::io_uring_teardown()
+{
+	if (_sqes) {
+		munmap(_sqes, _sqes_size);
+		_sqes = nullptr;
+	}
+
+	if (_cq_ring && _cq_ring != _sq_ring) {
+		munmap(_cq_ring, _cq_ring_size);
+	}
+
+	_cq_ring = nullptr;
+
+	if (_sq_ring) {
+		munmap(_sq_ring, _sq_ring_size);
+		_sq_ring = nullptr;
+	}
+
+	if (_ring_fd >= 0) {
+		close(_ring_fd);
+		_ring_fd = -1;
+	}
+}
+
+void *FileWriteQueue::io_uring_reaper_helper(void *context)
+{
+	px4_prctl(PR_SET_NAME, "log_writer_io", px4_getpid());
+
+	static_cast<FileWriteQueue *>(context)->io_uring_reaper();
+	return nullptr;
+}
+
+void FileWriteQueue::io_uring_reaper()
+{
+	bool exit = false;
+
+	while (!exit) {
+		int ret = syscall(__NR_io_uring_enter, _ring_fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+
+		if (ret < 0 && errno != EINTR) {
+			PX4_ERR("io_uring wait failed (%i)", errno);
+			px4_usleep(10000);
+		}
+
+		unsigned head = *_cq_head;
+
+		while (head != __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE)) {
+			const io_uring_cqe &cqe = _cqes[head & *_cq_mask];
+			const uint64_t user_data = cqe.user_data;
+			const ssize_t result = cqe.res;
+			++head;
+			__atomic_store_n(_cq_head, head, __ATOMIC_RELEASE);
+
+			if (user_data == IO_URING_WAKEUP) {
+				exit = true;
+				continue;
+			}
+
+			const unsigned slot = (unsigned)user_data;
+
+			pthread_mutex_lock(&_mtx);
+			const Request request = _requests[slot];
+			release_slot(slot);
+			pthread_mutex_unlock(&_mtx);
+
+			complete(request, result);
+		}
+	}
+}
+
+#endif /* LOGGER_HAVE_IO_URING */
+
+} // namespace logger
+} // namespace px4
+
+#endif /* LOGGER_ASYNC_FILE_IO */
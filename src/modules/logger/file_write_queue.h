@@ -0,0 +1,211 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <px4_platform_common/defines.h>
+#include <drivers/drv_hrt.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#if defined(__PX4_LINUX)
+#define LOGGER_ASYNC_FILE_IO
+
+#include <pthread.h>
+#include <sys/uio.h>
+
+#if __has_include(<linux/io_uring.h>)
+#include <sys/syscall.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define LOGGER_HAVE_IO_URING
+#include <linux/io_uring.h>
+#endif
+#endif
+#endif /* __PX4_LINUX */
+
+namespace px4
+{
+namespace logger
+{
+
+#if defined(LOGGER_ASYNC_FILE_IO)
+
+/**
+ * @class FileWriteQueue
+ * Asynchronous file write & fsync submission queue used by the file writer thread.
+ *
+ * Requests are executed via io_uring if supported by the kernel, otherwise by a small pool
+ * of worker threads doing blocking pwrite()/fsync(). Completions are reported through a
+ * callback, which is called from the io_uring reaper thread or from a worker thread.
+ *
+ * The queue only has a single submitter (the file writer thread). The memory passed to
+ * submit_write() must stay valid until the completion is reported.
+ */
+class FileWriteQueue
+{
+public:
+	/** Values of SDLOG_ASYNC_IO */
+	enum class Mode : int32_t {
+		Disabled = 0,
+		Auto = 1,       ///< io_uring, or worker threads if io_uring is not available
+		ThreadPool = 2, ///< always use worker threads
+	};
+
+	enum class Backend {
+		None = 0,
+		IoUring,
+		ThreadPool,
+	};
+
+	/**
+	 * @param context user context
+	 * @param tag tag passed on submission
+	 * @param result number of bytes written (0 for fsync), or -errno on failure
+	 * @param latency time from submission until completion [us]
+	 */
+	using CompletionCallback = void (*)(void *context, uint32_t tag, ssize_t result, hrt_abstime latency);
+
+	static constexpr unsigned QUEUE_DEPTH = 8; ///< maximum number of requests in flight
+
+	FileWriteQueue(CompletionCallback callback, void *context);
+	~FileWriteQueue();
+
+	FileWriteQueue(const FileWriteQueue &) = delete;
+	FileWriteQueue &operator=(const FileWriteQueue &) = delete;
+
+	/**
+	 * Setup the backend and start the completion thread(s)
+	 * @return true on success, false if async I/O is disabled or not available
+	 */
+	bool start(Mode mode);
+
+	/**
+	 * Wait for all requests in flight to complete and stop the completion thread(s).
+	 * Must not be called with a lock held that the completion callback takes.
+	 */
+	void stop();
+
+	Backend backend() const { return _backend; }
+
+	static const char *backend_str(Backend backend);
+
+	/**
+	 * Queue a write of size bytes at the given file offset.
+	 * @return false if the queue is full (or not started)
+	 */
+	bool submit_write(int fd, const void *buffer, size_t size, off_t offset, uint32_t tag);
+
+	/**
+	 * Queue an fsync of fd. It starts once all requests submitted before it completed.
+	 * @return false if the queue is full (or not started)
+	 */
+	bool submit_fsync(int fd, uint32_t tag);
+
+private:
+	struct Request {
+		int fd;
+		const void *buffer;
+		size_t size;
+		off_t offset;
+		bool fsync;
+		uint32_t tag;
+		hrt_abstime submit_time;
+	};
+
+	bool submit(const Request &request);
+
+	void release_slot(unsigned slot);
+
+	void complete(const Request &request, ssize_t result);
+
+	bool start_thread(pthread_t &thread, void *(*entry)(void *));
+
+	CompletionCallback _callback;
+	void *_context;
+
+	Backend _backend{Backend::None};
+
+	/* request slots, used by both backends. Protected by _mtx */
+	Request _requests[QUEUE_DEPTH] {};
+	bool _slot_used[QUEUE_DEPTH] {};
+	unsigned _in_flight{0};
+	bool _exit{false};
+
+	pthread_mutex_t _mtx;
+	pthread_cond_t _cv; ///< signalled on new requests (thread pool) and on completion
+
+#if defined(LOGGER_HAVE_IO_URING)
+	bool io_uring_setup();
+	void io_uring_teardown();
+	static void *io_uring_reaper_helper(void *context);
+	void io_uring_reaper();
+
+	iovec _iov[QUEUE_DEPTH] {};
+
+	int _ring_fd{-1};
+	void *_sq_ring{nullptr};
+	size_t _sq_ring_size{0};
+	void *_cq_ring{nullptr};
+	size_t _cq_ring_size{0};
+	io_uring_sqe *_sqes{nullptr};
+	size_t _sqes_size{0};
+
+	unsigned *_sq_tail{nullptr};
+	unsigned *_sq_mask{nullptr};
+	unsigned *_sq_array{nullptr};
+	unsigned *_cq_head{nullptr};
+	unsigned *_cq_tail{nullptr};
+	unsigned *_cq_mask{nullptr};
+	io_uring_cqe *_cqes{nullptr};
+
+	pthread_t _reaper_thread{0};
+#endif /* LOGGER_HAVE_IO_URING */
+
+	static void *worker_helper(void *context);
+	void worker();
+
+	static constexpr int NUM_WORKERS = 2;
+	pthread_t _workers[NUM_WORKERS] {};
+	int _num_workers{0};
+
+	/* thread pool: FIFO of request slots waiting for a worker. Protected by _mtx */
+	uint8_t _queued[QUEUE_DEPTH] {};
+	unsigned _queued_head{0};
+	unsigned _queued_count{0};
+	unsigned _running{0}; ///< requests taken from the FIFO and not completed yet
+};
+
+#endif /* LOGGER_ASYNC_FILE_IO */
+
+} // namespace logger
+} // namespace px4
@@ -123,10 +123,10 @@ bool LogWriter::is_started(LogType type, Backend query_backend) const
 	return false;
 }
 
-bool LogWriter::start_log_file(LogType type, const char *filename)
+bool LogWriter::start_log_file(LogType type, const char *filename, int32_t compression)
 {
 	if (_log_writer_file) {
-		return _log_writer_file->start_log(type, filename);
+		return _log_writer_file->start_log(type, filename, compression);
 	}
 
 	return false;
@@ -65,7 +65,8 @@ public:
 	/** stop all running threads and wait for them to exit */
 	void thread_stop();
 
-	bool start_log_file(LogType type, const char *filename);
+	/** @see LogWriterFile::start_log() */
+	bool start_log_file(LogType type, const char *filename, int32_t compression = 0);
 
 	void stop_log_file(LogType type);
 
@@ -126,6 +127,13 @@ public:
 		return 0;
 	}
 
+	size_t get_file_size_file(LogType type) const
+	{
+		if (_log_writer_file) { return _log_writer_file->get_file_size(type); }
+
+		return 0;
+	}
+
 	size_t get_buffer_size_file(LogType type) const
 	{
 		if (_log_writer_file) { return _log_writer_file->get_buffer_size(type); }
@@ -140,6 +148,25 @@ public:
 		return 0;
 	}
 
+	/** @see LogWriterFile::get_write_latency_histogram() */
+	void get_write_latency_histogram_file(LogType type, uint16_t histogram[LogWriterFile::WRITE_LATENCY_BUCKETS])
+	{
+		if (_log_writer_file) { _log_writer_file->get_write_latency_histogram(type, histogram); }
+	}
+
+	/** @see LogWriterFile::set_async_io_mode() */
+	void set_async_io_mode_file(int32_t mode)
+	{
+		if (_log_writer_file) { _log_writer_file->set_async_io_mode(mode); }
+	}
+
+	const char *io_backend_str_file() const
+	{
+		if (_log_writer_file) { return _log_writer_file->io_backend_str(); }
+
+		return "none";
+	}
+
 	pthread_t thread_id_file() const
 	{
 		if (_log_writer_file) { return _log_writer_file->thread_id(); }
@@ -74,15 +74,36 @@ LogWriterFile::LogWriterFile(size_t buffer_size)
 
 bool LogWriterFile::init()
 {
+#if defined(LOGGER_ASYNC_FILE_IO)
+
+	if (_write_queue.start((FileWriteQueue::Mode)_async_io_mode)) {
+		PX4_INFO("log file writes using %s", io_backend_str());
+	}
+
+#endif /* LOGGER_ASYNC_FILE_IO */
+
 	return true;
 }
 
 LogWriterFile::~LogWriterFile()
 {
+#if defined(LOGGER_ASYNC_FILE_IO)
+	_write_queue.stop();
+#endif /* LOGGER_ASYNC_FILE_IO */
+
 	pthread_mutex_destroy(&_mtx);
 	pthread_cond_destroy(&_cv);
 }
 
+const char *LogWriterFile::io_backend_str() const
+{
+#if defined(LOGGER_ASYNC_FILE_IO)
+	return FileWriteQueue::backend_str(_write_queue.backend());
+#else
+	return "sync";
+#endif /* LOGGER_ASYNC_FILE_IO */
+}
+
 #if defined(PX4_CRYPTO)
 bool LogWriterFile::init_logfile_encryption(const char *filename)
 {
@@ -211,7 +232,7 @@ bool LogWriterFile::init_logfile_encryption(const char *filename)
 #endif // PX4_CRYPTO
 
 
-bool LogWriterFile::start_log(LogType type, const char *filename)
+bool LogWriterFile::start_log(LogType type, const char *filename, int32_t compression)
 {
 	// At this point we don't expect the file to be open, but it can happen for very fast consecutive stop & start
 	// calls. In that case we wait for the thread to close the file first.
@@ -248,7 +269,16 @@ bool LogWriterFile::start_log(LogType type, const char *filename)
 
 #endif
 
-	if (_buffers[(int)type].start_log(filename)) {
+#if defined(PX4_CRYPTO)
+
+	if (compression > 0 && _algorithm != CRYPTO_NONE) {
+		PX4_WARN("compression is not supported for encrypted logs");
+		compression = 0;
+	}
+
+#endif
+
+	if (_buffers[(int)type].start_log(filename, compression)) {
 		PX4_INFO("Opened %s log file: %s", log_type_str(type), filename);
 		notify();
 		return true;
@@ -362,11 +392,23 @@ void LogWriterFile::run()
 			break;
 		}
 
+		pthread_mutex_lock(&_mtx);
+
+#if defined(LOGGER_ASYNC_FILE_IO)
+
+		if (_write_queue.backend() != FileWriteQueue::Backend::None) {
+			run_async();
+
+			// go back to idle
+			pthread_mutex_unlock(&_mtx);
+			continue;
+		}
+
+#endif /* LOGGER_ASYNC_FILE_IO */
+
 		int poll_count = 0;
 		hrt_abstime last_fsync = hrt_absolute_time();
 
-		pthread_mutex_lock(&_mtx);
-
 		while (true) {
 
 			const hrt_abstime now = hrt_absolute_time();
@@ -429,9 +471,18 @@ void LogWriterFile::run()
 
 #endif
 
-					int written = buffer.write_to_file(read_ptr, available, call_fsync);
+					const hrt_abstime write_start = hrt_absolute_time();
+					int written;
+
+					if (buffer.compressing()) {
+						// retries internally, the input is consumed by the encoder
+						written = buffer.compress_to_file(read_ptr, available, call_fsync);
+
+					} else {
+						written = buffer.write_to_file(read_ptr, available, call_fsync);
+					}
 
-					if (written < 0) {
+					if (written < 0 && !buffer.compressing()) {
 						// retry once
 						PX4_ERR("write failed errno:%i (%s), retrying", errno, strerror(errno));
 						px4_usleep(10000); // 10 milliseconds
@@ -441,6 +492,8 @@ void LogWriterFile::run()
 					/* buffer.mark_read() requires _mtx to be locked */
 					pthread_mutex_lock(&_mtx);
 
+					buffer.record_write_latency(hrt_elapsed_time(&write_start));
+
 					if (written >= 0) {
 						/* subtract bytes written from number in buffer (count -= written) */
 						buffer.mark_read(written);
@@ -509,6 +562,217 @@ void LogWriterFile::run()
 	}
 }
 
+#if defined(LOGGER_ASYNC_FILE_IO)
+void LogWriterFile::run_async()
+{
+	int poll_count = 0;
+	hrt_abstime last_fsync = hrt_absolute_time();
+
+	while (true) {
+
+		const hrt_abstime now = hrt_absolute_time();
+
+		/* call fsync periodically to minimize potential loss of data */
+		const bool call_fsync = ++poll_count >= 100 || now - last_fsync > 1_s || _want_fsync.load();
+		_want_fsync.store(false);
+
+		if (call_fsync) {
+			last_fsync = now;
+			poll_count = 0;
+		}
+
+		constexpr size_t min_available[(int)LogType::Count] = {
+			_min_write_chunk,
+			1 // For the mission log, write as soon as there is data available
+		};
+
+		/* Check all buffers for available data. Mission log is first to avoid drops */
+		for (int i = (int)LogType::Count - 1; i >= 0; --i) {
+			LogFileBuffer &buffer = _buffers[i];
+
+			if (buffer.fd() < 0) {
+				continue;
+			}
+
+			handle_completed_writes(i);
+
+			if (call_fsync && buffer._should_run && !buffer._fsync_in_flight) {
+				buffer._fsync_in_flight = _write_queue.submit_fsync(buffer.fd(), (i << 8) | FSYNC_TAG);
+			}
+
+			if (buffer.compressing()) {
+				compress_async(i, call_fsync);
+			}
+
+			/* queue as many writes as possible, each write keeps its part of the buffer until completion */
+			while (!buffer.compressing() && buffer.can_submit() && !buffer._had_write_error.load()) {
+				void *read_ptr;
+				bool is_part;
+				size_t available = buffer.get_unsubmitted_read_ptr(&read_ptr, &is_part);
+
+				if (available > buffer.max_write_size()) {
+					available = buffer.max_write_size();
+					is_part = true;
+				}
+
+#if defined(PX4_CRYPTO)
+				// Split into min blocksize chunks, so it is good for encrypting in pieces
+				available = (available / _min_blocksize) * _min_blocksize;
+#endif
+
+				if (available == 0 || !(available >= min_available[i] || is_part || !buffer._should_run)) {
+					break;
+				}
+
+#if defined(PX4_CRYPTO)
+
+				if (_algorithm != CRYPTO_NONE) {
+					/* new data is only appended at the head, so this part of the buffer does not change while unlocked */
+					pthread_mutex_unlock(&_mtx);
+					size_t out = available;
+					_crypto.encrypt_data(_key_idx, (uint8_t *)read_ptr, available, (uint8_t *)read_ptr, &out);
+
+					if (out != available) {
+						PX4_ERR("Encryption output size mismatch, logfile corrupted");
+					}
+
+					pthread_mutex_lock(&_mtx);
+				}
+
+#endif
+
+				const uint32_t tag = (i << 8) | buffer.next_pending_slot();
+
+				if (!_write_queue.submit_write(buffer.fd(), read_ptr, available, buffer.next_file_offset(), tag)) {
+					break;
+				}
+
+				buffer.add_pending_write((uint8_t *)read_ptr, available);
+			}
+
+			/* Stop only when all data written (or on error), and all requests completed */
+			if (!buffer._should_run && !buffer.has_pending()
+			    && ((buffer.count() == 0 && buffer.encoder().pending() == 0 && buffer._encoded_frame_size == 0)
+				|| buffer._had_write_error.load())) {
+				pthread_mutex_unlock(&_mtx);
+				buffer.close_file();
+				pthread_mutex_lock(&_mtx);
+				buffer.reset();
+			}
+		}
+
+		if (_buffers[0].fd() < 0 && _buffers[1].fd() < 0) {
+			// stop when both files are closed
+#if defined(PX4_CRYPTO)
+			/* close the crypto session */
+
+			_crypto.close();
+#endif
+
+			break;
+		}
+
+		/* Wait for a call to notify() or for a write to complete (see run() for more details). */
+		if (_buffers[0]._should_run || _buffers[1]._should_run || _buffers[0].has_pending() || _buffers[1].has_pending()) {
+			pthread_cond_wait(&_cv, &_mtx);
+		}
+	}
+}
+
+void LogWriterFile::compress_async(int buffer_index, bool call_fsync)
+{
+	LogFileBuffer &buffer = _buffers[buffer_index];
+
+	while (!buffer._had_write_error.load()) {
+		// submit an encoded frame
+		if (buffer._encoded_frame_size > 0) {
+			const uint32_t tag = (buffer_index << 8) | buffer.next_pending_slot();
+
+			if (!_write_queue.submit_write(buffer.fd(), buffer.next_frame(), buffer._encoded_frame_size,
+						       buffer.next_file_offset(), tag)) {
+				break;
+			}
+
+			buffer.add_pending_write(buffer.next_frame(), buffer._encoded_frame_size, false);
+			buffer._encoded_frame_size = 0;
+			continue;
+		}
+
+		// move data from the log buffer into the encoder, which releases the buffer space immediately
+		void *read_ptr;
+		bool is_part;
+		const size_t available = buffer.get_read_ptr(&read_ptr, &is_part);
+
+		if (available > 0 && !buffer.encoder().full()) {
+			/* only this thread uses the encoder, and the logger only appends at the head of the buffer */
+			pthread_mutex_unlock(&_mtx);
+			const size_t consumed = buffer.encoder().append(read_ptr, available);
+			pthread_mutex_lock(&_mtx);
+			buffer.mark_read(consumed);
+			continue;
+		}
+
+		// encode a frame when the block is full, or to flush the data on fsync and when stopping
+		const bool flush = available == 0 && (call_fsync || !buffer._should_run);
+
+		if (!buffer.can_submit() || !(buffer.encoder().full() || (flush && buffer.encoder().pending() > 0))) {
+			break;
+		}
+
+		pthread_mutex_unlock(&_mtx);
+		const size_t frame_size = buffer.encoder().encodeFrame(buffer.next_frame());
+		pthread_mutex_lock(&_mtx);
+		buffer._encoded_frame_size = frame_size;
+	}
+}
+
+void LogWriterFile::write_completed(void *context, uint32_t tag, ssize_t result, hrt_abstime latency)
+{
+	LogWriterFile *writer = static_cast<LogWriterFile *>(context);
+	LogFileBuffer &buffer = writer->_buffers[tag >> 8];
+	const uint32_t slot = tag & 0xff;
+
+	pthread_mutex_lock(&writer->_mtx);
+
+	if (slot == FSYNC_TAG) {
+		buffer.fsync_completed(latency);
+
+	} else {
+		buffer.write_completed(slot, result, latency);
+	}
+
+	pthread_cond_broadcast(&writer->_cv);
+	pthread_mutex_unlock(&writer->_mtx);
+}
+
+void LogWriterFile::handle_completed_writes(int buffer_index)
+{
+	LogFileBuffer &buffer = _buffers[buffer_index];
+	LogFileBuffer::PendingWrite *write;
+
+	while ((write = buffer.completed_write()) != nullptr) {
+		bool success = write->result == (ssize_t)write->size;
+
+		if (!success && !buffer._had_write_error.load()) {
+			// retry once
+			PX4_ERR("write failed (%i), retrying", (int)write->result);
+			pthread_mutex_unlock(&_mtx);
+			px4_usleep(10000); // 10 milliseconds
+			success = ::pwrite(buffer.fd(), write->ptr, write->size, write->offset) == (ssize_t)write->size;
+			pthread_mutex_lock(&_mtx);
+
+			if (!success) {
+				PX4_ERR("write failed (%i)", errno);
+				buffer._had_write_error.store(true);
+				buffer._should_run = false;
+			}
+		}
+
+		buffer.pop_pending_write(success && !buffer._had_write_error.load());
+	}
+}
+#endif /* LOGGER_ASYNC_FILE_IO */
+
 int LogWriterFile::write_message(LogType type, void *ptr, size_t size, uint64_t dropout_start)
 {
 	if (_need_reliable_transfer) {
@@ -603,6 +867,7 @@ LogWriterFile::LogFileBuffer::~LogFileBuffer()
 	}
 
 	free(_buffer);
+	free(_frames);
 
 	perf_free(_perf_write);
 	perf_free(_perf_fsync);
@@ -649,7 +914,7 @@ size_t LogWriterFile::LogFileBuffer::get_read_ptr(void **ptr, bool *is_part)
 	}
 }
 
-bool LogWriterFile::LogFileBuffer::start_log(const char *filename)
+bool LogWriterFile::LogFileBuffer::start_log(const char *filename, int32_t compression)
 {
 	_fd = ::open(filename, O_CREAT | O_WRONLY, PX4_O_MODE_666);
 	_had_write_error.store(false);
@@ -670,10 +935,28 @@ bool LogWriterFile::LogFileBuffer::start_log(const char *filename)
 		}
 	}
 
+	if (compression > 0) {
+		if (_frames == nullptr) {
+			_frames = (uint8_t *)malloc(NUM_FRAMES * log_compression::MAX_FRAME_SIZE);
+		}
+
+		if (_frames == nullptr || !_encoder.allocate(compression)) {
+			PX4_ERR("Can't create compression buffers");
+			::close(_fd);
+			_fd = -1;
+			return false;
+		}
+
+	} else {
+		_encoder.deallocate();
+	}
+
 	// Clear buffer and counters
 	_head = 0;
 	_count = 0;
 	_total_written = 0;
+	_compressed_written = 0;
+	memset(_write_latency_hist, 0, sizeof(_write_latency_hist));
 
 	_should_run = true;
 
@@ -700,8 +983,64 @@ ssize_t LogWriterFile::LogFileBuffer::write_to_file(const void *buffer, size_t s
 	return ret;
 }
 
+ssize_t LogWriterFile::LogFileBuffer::compress_to_file(const void *buffer, size_t size, bool call_fsync)
+{
+	const uint8_t *data = static_cast<const uint8_t *>(buffer);
+	size_t consumed = 0;
+
+	while (consumed < size) {
+		consumed += _encoder.append(data + consumed, size - consumed);
+
+		if (_encoder.full() && !write_frame()) {
+			return -1;
+		}
+	}
+
+	if (call_fsync) {
+		if (_encoder.pending() > 0 && !write_frame()) {
+			return -1;
+		}
+
+		fsync();
+	}
+
+	return size;
+}
+
+bool LogWriterFile::LogFileBuffer::write_frame()
+{
+	const size_t frame_size = _encoder.encodeFrame(_frames);
+
+	if (frame_size == 0) {
+		return true;
+	}
+
+	ssize_t written = write_to_file(_frames, frame_size, false);
+
+	if (written != (ssize_t)frame_size) {
+		// retry once
+		PX4_ERR("write failed errno:%i (%s), retrying", errno, strerror(errno));
+		px4_usleep(10000); // 10 milliseconds
+		written = write_to_file(_frames, frame_size, false);
+	}
+
+	if (written != (ssize_t)frame_size) {
+		return false;
+	}
+
+	_compressed_written += frame_size;
+	return true;
+}
+
 void LogWriterFile::LogFileBuffer::close_file()
 {
+	// write the last (partial) frame
+	if (_fd >= 0 && compressing() && _encoder.pending() > 0 && !_had_write_error.load()) {
+		if (!write_frame()) {
+			PX4_ERR("writing the last frame failed (%i)", errno);
+		}
+	}
+
 	if (_fd >= 0) {
 		int res = close(_fd);
 
@@ -719,7 +1058,122 @@ void LogWriterFile::LogFileBuffer::reset()
 	_head = 0;
 	_count = 0;
 	_fd = -1;
+
+#if defined(LOGGER_ASYNC_FILE_IO)
+	_pending_head = 0;
+	_num_pending = 0;
+	_submitted = 0;
+	_file_offset = 0;
+	_fsync_in_flight = false;
+	_encoded_frame_size = 0;
+#endif /* LOGGER_ASYNC_FILE_IO */
+}
+
+void LogWriterFile::LogFileBuffer::record_write_latency(hrt_abstime latency)
+{
+	static constexpr hrt_abstime bucket_limits[WRITE_LATENCY_BUCKETS - 1] = {1_ms, 4_ms, 16_ms, 64_ms, 256_ms};
+	int bucket = 0;
+
+	while (bucket < WRITE_LATENCY_BUCKETS - 1 && latency >= bucket_limits[bucket]) {
+		++bucket;
+	}
+
+	if (_write_latency_hist[bucket] < UINT16_MAX) {
+		++_write_latency_hist[bucket];
+	}
+}
+
+void LogWriterFile::LogFileBuffer::take_write_latency_histogram(uint16_t histogram[WRITE_LATENCY_BUCKETS])
+{
+	memcpy(histogram, _write_latency_hist, sizeof(_write_latency_hist));
+	memset(_write_latency_hist, 0, sizeof(_write_latency_hist));
+}
+
+#if defined(LOGGER_ASYNC_FILE_IO)
+size_t LogWriterFile::LogFileBuffer::get_unsubmitted_read_ptr(void **ptr, bool *is_part)
+{
+	size_t read_ptr = (_head + _buffer_size - _count + _submitted) % _buffer_size;
+	const size_t available = _count - _submitted;
+	*ptr = &_buffer[read_ptr];
+
+	if (read_ptr + available > _buffer_size) {
+		*is_part = true;
+		return _buffer_size - read_ptr;
+	}
+
+	*is_part = false;
+	return available;
+}
+
+size_t LogWriterFile::LogFileBuffer::max_write_size() const
+{
+	const size_t size = (_buffer_size / MAX_PENDING_WRITES / _min_write_chunk) * _min_write_chunk;
+	return math::max(size, _min_write_chunk);
+}
+
+void LogWriterFile::LogFileBuffer::add_pending_write(uint8_t *ptr, size_t size, bool from_buffer)
+{
+	PendingWrite &write = _pending[next_pending_slot()];
+	write.ptr = ptr;
+	write.size = size;
+	write.offset = _file_offset;
+	write.result = 0;
+	write.done = false;
+	write.from_buffer = from_buffer;
+
+	++_num_pending;
+	_file_offset += size;
+
+	if (from_buffer) {
+		_submitted += size;
+	}
+}
+
+LogWriterFile::LogFileBuffer::PendingWrite *LogWriterFile::LogFileBuffer::completed_write()
+{
+	if (_num_pending > 0 && _pending[_pending_head].done) {
+		return &_pending[_pending_head];
+	}
+
+	return nullptr;
+}
+
+void LogWriterFile::LogFileBuffer::pop_pending_write(bool success)
+{
+	const PendingWrite &write = _pending[_pending_head];
+
+	if (!write.from_buffer) {
+		if (success) {
+			_compressed_written += write.size;
+		}
+
+	} else {
+		_submitted -= write.size;
+
+		if (success) {
+			mark_read(write.size);
+		}
+	}
+
+	_pending_head = (_pending_head + 1) % MAX_PENDING_WRITES;
+	--_num_pending;
+}
+
+void LogWriterFile::LogFileBuffer::write_completed(unsigned slot, ssize_t result, hrt_abstime latency)
+{
+	_pending[slot].result = result;
+	_pending[slot].done = true;
+
+	perf_set_elapsed(_perf_write, latency);
+	record_write_latency(latency);
+}
+
+void LogWriterFile::LogFileBuffer::fsync_completed(hrt_abstime latency)
+{
+	_fsync_in_flight = false;
+	perf_set_elapsed(_perf_fsync, latency);
 }
+#endif /* LOGGER_ASYNC_FILE_IO */
 
 }
 }
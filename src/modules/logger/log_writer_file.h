@@ -40,6 +40,9 @@
 #include <drivers/drv_hrt.h>
 #include <perf/perf_counter.h>
 #include <px4_platform_common/crypto.h>
+#include <lib/log_compression/LogCompression.hpp>
+
+#include "file_write_queue.h"
 
 namespace px4
 {
@@ -71,6 +74,15 @@ public:
 
 	bool init();
 
+	/**
+	 * Select asynchronous file I/O (SDLOG_ASYNC_IO). Must be called before init().
+	 * Only has an effect on Linux, other platforms always write synchronously.
+	 */
+	void set_async_io_mode(int32_t mode) { _async_io_mode = mode; }
+
+	/** @return name of the I/O backend used for file writes */
+	const char *io_backend_str() const;
+
 	/**
 	 * start the thread
 	 * @return 0 on success, error number otherwise (@see pthread_create)
@@ -79,7 +91,12 @@ public:
 
 	void thread_stop();
 
-	bool start_log(LogType type, const char *filename);
+	/**
+	 * Open a log file and start logging
+	 * @param compression 0 to write the data as is, otherwise compress the file with LZ4 and use the value
+	 *                    as acceleration factor (higher is faster, but compresses less)
+	 */
+	bool start_log(LogType type, const char *filename, int32_t compression = 0);
 
 	void stop_log(LogType type);
 
@@ -108,6 +125,12 @@ public:
 		return _buffers[(int)type].total_written();
 	}
 
+	/** @return number of bytes written to the file (less than get_total_written() if compressed) */
+	size_t get_file_size(LogType type) const
+	{
+		return _buffers[(int)type].file_size();
+	}
+
 	size_t get_buffer_size(LogType type) const
 	{
 		return _buffers[(int)type].buffer_size();
@@ -118,6 +141,17 @@ public:
 		return _buffers[(int)type].count();
 	}
 
+	static constexpr int WRITE_LATENCY_BUCKETS = 6;
+
+	/**
+	 * Get the number of file writes per latency bucket (<1ms, <4ms, <16ms, <64ms, <256ms, >=256ms)
+	 * since the last call, and reset the counts. Requires lock() to be held.
+	 */
+	void get_write_latency_histogram(LogType type, uint16_t histogram[WRITE_LATENCY_BUCKETS])
+	{
+		_buffers[(int)type].take_write_latency_histogram(histogram);
+	}
+
 	void set_need_reliable_transfer(bool need_reliable)
 	{
 		if (!need_reliable && _need_reliable_transfer) {
@@ -150,6 +184,31 @@ private:
 
 	void run();
 
+#if defined(LOGGER_ASYNC_FILE_IO)
+	/**
+	 * Writer loop using asynchronous I/O: writes are queued to _write_queue without waiting for them to
+	 * complete, so that slow writes or fsync calls do not stall the draining of the buffers.
+	 * Called and returns with _mtx locked, once both files are closed.
+	 */
+	void run_async();
+
+	/**
+	 * Compress the data of a buffer into frames and queue them for writing.
+	 * Called with _mtx locked (temporarily unlocks it while copying and compressing).
+	 */
+	void compress_async(int buffer_index, bool call_fsync);
+
+	static void write_completed(void *context, uint32_t tag, ssize_t result, hrt_abstime latency);
+
+	/**
+	 * Release the buffer space of completed writes, in file order. Failed writes are retried once.
+	 * Called with _mtx locked (temporarily unlocks it for a retry).
+	 */
+	void handle_completed_writes(int buffer_index);
+
+	static constexpr uint32_t FSYNC_TAG = 0xff;
+#endif /* LOGGER_ASYNC_FILE_IO */
+
 	/**
 	 * permanently store the ulog file name for the hardfault crash handler, so that it can
 	 * append crash logs to the last ulog file.
@@ -173,7 +232,7 @@ private:
 
 		~LogFileBuffer();
 
-		bool start_log(const char *filename);
+		bool start_log(const char *filename, int32_t compression);
 
 		void close_file();
 
@@ -196,7 +255,77 @@ private:
 
 		void mark_read(size_t n) { _count -= n; _total_written += n; }
 
+		bool compressing() const { return _encoder.allocated(); }
+
+		log_compression::FrameEncoder &encoder() { return _encoder; }
+
+		/**
+		 * Compress data and write each completed frame to the file (synchronous writer)
+		 * @param call_fsync also write the current partial frame and call fsync
+		 * @return size on success, -1 if writing a frame failed
+		 */
+		ssize_t compress_to_file(const void *buffer, size_t size, bool call_fsync);
+
+		/**
+		 * Encode and write the current (partial) frame, retry once on failure
+		 * @return true on success
+		 */
+		bool write_frame();
+
+		void record_write_latency(hrt_abstime latency);
+
+		void take_write_latency_histogram(uint16_t histogram[WRITE_LATENCY_BUCKETS]);
+
+#if defined(LOGGER_ASYNC_FILE_IO)
+		static constexpr unsigned MAX_PENDING_WRITES = 3; ///< number of writes in flight per buffer
+
+		struct PendingWrite {
+			uint8_t *ptr;
+			size_t size;
+			off_t offset;
+			ssize_t result;
+			bool done;
+			bool from_buffer; ///< false for compressed frames, the input data is already released
+		};
+
+		/**
+		 * Like get_read_ptr(), but skip the data that is already submitted for writing
+		 */
+		size_t get_unsubmitted_read_ptr(void **ptr, bool *is_part);
+
+		/** maximum size of a single write, so that MAX_PENDING_WRITES can be in flight */
+		size_t max_write_size() const;
+
+		bool can_submit() const { return _num_pending < MAX_PENDING_WRITES; }
+
+		/** @return tag slot that the next submitted write will use */
+		unsigned next_pending_slot() const { return (_pending_head + _num_pending) % MAX_PENDING_WRITES; }
+
+		off_t next_file_offset() const { return _file_offset; }
+
+		void add_pending_write(uint8_t *ptr, size_t size, bool from_buffer = true);
+
+		/** @return frame buffer of the next pending slot */
+		uint8_t *next_frame() { return _frames + next_pending_slot() * log_compression::MAX_FRAME_SIZE; }
+
+		size_t _encoded_frame_size = 0; ///< size of an encoded frame in next_frame() that is not submitted yet
+
+		PendingWrite *completed_write();
+
+		/** remove the oldest pending write (returned by completed_write()) and release its buffer space on success */
+		void pop_pending_write(bool success);
+
+		void write_completed(unsigned slot, ssize_t result, hrt_abstime latency);
+
+		void fsync_completed(hrt_abstime latency);
+
+		bool has_pending() const { return _num_pending > 0 || _fsync_in_flight; }
+
+		bool _fsync_in_flight = false;
+#endif /* LOGGER_ASYNC_FILE_IO */
+
 		size_t total_written() const { return _total_written; }
+		size_t file_size() const { return compressing() ? _compressed_written : _total_written; }
 		size_t buffer_size() const { return _buffer_size; }
 		size_t count() const { return _count; }
 
@@ -211,6 +340,24 @@ private:
 		size_t _total_written = 0;
 		perf_counter_t _perf_write;
 		perf_counter_t _perf_fsync;
+		uint16_t _write_latency_hist[WRITE_LATENCY_BUCKETS] {};
+
+#if defined(LOGGER_ASYNC_FILE_IO)
+		static constexpr unsigned NUM_FRAMES = MAX_PENDING_WRITES;
+#else
+		static constexpr unsigned NUM_FRAMES = 1;
+#endif
+		log_compression::FrameEncoder _encoder;
+		uint8_t *_frames = nullptr; ///< output buffer for one compressed frame per write in flight
+		size_t _compressed_written = 0;
+
+#if defined(LOGGER_ASYNC_FILE_IO)
+		PendingWrite _pending[MAX_PENDING_WRITES] {};
+		unsigned _pending_head = 0;
+		unsigned _num_pending = 0;
+		size_t _submitted = 0; ///< number of bytes after the read pointer that are submitted for writing
+		off_t _file_offset = 0; ///< file offset of the next write
+#endif /* LOGGER_ASYNC_FILE_IO */
 	};
 
 	LogFileBuffer _buffers[(int)LogType::Count];
@@ -221,6 +368,10 @@ private:
 	pthread_mutex_t		_mtx;
 	pthread_cond_t		_cv;
 	pthread_t _thread = 0;
+	int32_t _async_io_mode{0};
+#if defined(LOGGER_ASYNC_FILE_IO)
+	FileWriteQueue _write_queue{&LogWriterFile::write_completed, this};
+#endif
 #if defined(PX4_CRYPTO)
 	bool init_logfile_encryption(const char *filename);
 	PX4Crypto _crypto;
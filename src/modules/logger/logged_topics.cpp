@@ -137,6 +137,7 @@ void LoggedTopics::add_default_topics()
 	add_topic("vehicle_status");
 	add_optional_topic("vtol_vehicle_status", 200);
 	add_topic("wind", 1000);
+	add_optional_topic("work_item_stats");
 
 	// multi topics
 	add_optional_topic_multi("actuator_outputs", 100, 3);
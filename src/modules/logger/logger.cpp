@@ -194,6 +194,20 @@ int Logger::print_status()
 	PX4_INFO("Number of subscriptions: %i (%i bytes)", _num_subscriptions,
 		 (int)(_num_subscriptions * sizeof(LoggerSubscription)));
 
+	if (_loop_count > 0) {
+		PX4_INFO("Topic updates: %s, since last status: avg %.1f topics checked per cycle",
+			 _event_driven ? "event driven" : "polling", (double)_topics_serviced / _loop_count);
+		_topics_serviced = 0;
+		_loop_count = 0;
+	}
+
+	perf_print_counter(_loop_perf);
+	perf_print_counter(_loop_interval_perf);
+
+	if (_writer.backend() & LogWriter::BackendFile) {
+		PX4_INFO("File writes: %s", _writer.io_backend_str_file());
+	}
+
 	bool is_logging = false;
 
 	if (_writer.is_started(LogType::Full, LogWriter::BackendFile)) {
@@ -242,6 +256,13 @@ void Logger::print_statistics(LogType type)
 		PX4_INFO("Wrote %4.2f MiB (avg %5.2f KiB/s)", (double)mebibytes, (double)(kibibytes / seconds));
 	}
 
+	const size_t file_size = _writer.get_file_size_file(type);
+
+	if (file_size > 0 && file_size != _writer.get_total_written_file(type)) {
+		PX4_INFO("Compressed to %4.2f KiB (ratio %.2f)", (double)(file_size / 1024.0f),
+			 (double)(_writer.get_total_written_file(type) / (float)file_size));
+	}
+
 	PX4_INFO("Since last status: dropouts: %zu (max len: %.3f s), max used buffer: %zu / %zu B",
 		 stats.write_dropouts, (double)stats.max_dropout_duration, stats.high_water, _writer.get_buffer_size_file(type));
 	stats.high_water = 0;
@@ -416,6 +437,9 @@ Logger::~Logger()
 
 	delete[](_msg_buffer);
 	delete[](_subscriptions);
+
+	perf_free(_loop_perf);
+	perf_free(_loop_interval_perf);
 }
 
 void Logger::update_params()
@@ -478,6 +502,57 @@ bool Logger::copy_if_updated(int sub_idx, void *buffer, bool try_to_subscribe)
 	return updated;
 }
 
+bool Logger::write_subscription(int sub_idx, bool try_to_subscribe, hrt_abstime loop_time, uint32_t &total_bytes)
+{
+	LoggerSubscription &sub = _subscriptions[sub_idx];
+
+	/* if this topic has been updated, copy the new data into the message buffer
+	 * and write a message to the log
+	 */
+	if (!copy_if_updated(sub_idx, _msg_buffer + sizeof(ulog_message_data_s), try_to_subscribe)) {
+		return false;
+	}
+
+	// each message consists of a header followed by an orb data object
+	const size_t msg_size = sizeof(ulog_message_data_s) + sub.get_topic()->o_size_no_padding;
+	const uint16_t write_msg_size = static_cast<uint16_t>(msg_size - ULOG_MSG_HEADER_LEN);
+	const uint16_t write_msg_id = sub.msg_id;
+
+	//write one byte after another (necessary because of alignment)
+	_msg_buffer[0] = (uint8_t)write_msg_size;
+	_msg_buffer[1] = (uint8_t)(write_msg_size >> 8);
+	_msg_buffer[2] = static_cast<uint8_t>(ULogMessageType::DATA);
+	_msg_buffer[3] = (uint8_t)write_msg_id;
+	_msg_buffer[4] = (uint8_t)(write_msg_id >> 8);
+
+	// PX4_INFO("topic: %s, size = %zu, out_size = %zu", sub.get_topic()->o_name, sub.get_topic()->o_size, msg_size);
+
+	// full log
+	if (write_message(LogType::Full, _msg_buffer, msg_size)) {
+
+#ifdef DBGPRINT
+		total_bytes += msg_size;
+#endif /* DBGPRINT */
+	}
+
+	// mission log
+	if (sub_idx < _num_mission_subs) {
+		if (_writer.is_started(LogType::Mission)) {
+			if (_mission_subscriptions[sub_idx].next_write_time < (loop_time / 100000)) {
+				unsigned delta_time = _mission_subscriptions[sub_idx].min_delta_ms;
+
+				if (delta_time > 0) {
+					_mission_subscriptions[sub_idx].next_write_time = (loop_time / 100000) + delta_time / 100;
+				}
+
+				write_message(LogType::Mission, _msg_buffer, msg_size);
+			}
+		}
+	}
+
+	return true;
+}
+
 const char *Logger::configured_backend_mode() const
 {
 	switch (_writer.backend()) {
@@ -558,9 +633,16 @@ bool Logger::initialize_topics()
 			return false;
 		}
 
+		_event_driven = _param_sdlog_evt_loop.get();
+
 		for (int i = 0; i < logged_topics.subscriptions().count; ++i) {
 			const LoggedTopics::RequestedSubscription &sub = logged_topics.subscriptions().sub[i];
 			_subscriptions[i] = LoggerSubscription(sub.id, sub.interval_ms, sub.instance);
+
+			if (_event_driven) {
+				_subscriptions[i].set_ready_topics(&_ready_topics, i);
+			}
+
 			_subscriptions[i].subscribe();
 		}
 	}
@@ -638,6 +720,8 @@ void Logger::run()
 	}
 
 
+	_writer.set_async_io_mode_file(_param_sdlog_async_io.get());
+
 	if (!_writer.init()) {
 		PX4_ERR("writer init failed");
 		return;
@@ -696,6 +780,9 @@ void Logger::run()
 	bool was_started = false;
 
 	while (!should_exit()) {
+		perf_count(_loop_interval_perf);
+		perf_begin(_loop_perf);
+
 		// Start/stop logging (depending on logging mode, by default when arming/disarming)
 		const bool logging_started = start_stop_logging();
 
@@ -721,6 +808,9 @@ void Logger::run()
 
 			if (!was_started) {
 				adjust_subscription_updates();
+
+				// check all topics once when logging starts
+				_ready_topics.set_all();
 			}
 
 			/* check if we need to output the process load */
@@ -749,53 +839,44 @@ void Logger::run()
 			/* wait for lock on log buffer */
 			_writer.lock();
 
-			for (int sub_idx = 0; sub_idx < _num_subscriptions; ++sub_idx) {
-				LoggerSubscription &sub = _subscriptions[sub_idx];
-				/* if this topic has been updated, copy the new data into the message buffer
-				 * and write a message to the log
-				 */
-				const bool try_to_subscribe = (sub_idx == next_subscribe_topic_index);
-
-				if (copy_if_updated(sub_idx, _msg_buffer + sizeof(ulog_message_data_s), try_to_subscribe)) {
-					// each message consists of a header followed by an orb data object
-					const size_t msg_size = sizeof(ulog_message_data_s) + sub.get_topic()->o_size_no_padding;
-					const uint16_t write_msg_size = static_cast<uint16_t>(msg_size - ULOG_MSG_HEADER_LEN);
-					const uint16_t write_msg_id = sub.msg_id;
+			if (_event_driven) {
+				// only service the subscriptions that were published since the last iteration
+				for (int word = 0; word < ReadyTopics::NUM_WORDS; ++word) {
+					uint32_t ready = _ready_topics.take(word);
 
-					//write one byte after another (necessary because of alignment)
-					_msg_buffer[0] = (uint8_t)write_msg_size;
-					_msg_buffer[1] = (uint8_t)(write_msg_size >> 8);
-					_msg_buffer[2] = static_cast<uint8_t>(ULogMessageType::DATA);
-					_msg_buffer[3] = (uint8_t)write_msg_id;
-					_msg_buffer[4] = (uint8_t)(write_msg_id >> 8);
-
-					// PX4_INFO("topic: %s, size = %zu, out_size = %zu", sub.get_topic()->o_name, sub.get_topic()->o_size, msg_size);
-
-					// full log
-					if (write_message(LogType::Full, _msg_buffer, msg_size)) {
-
-#ifdef DBGPRINT
-						total_bytes += msg_size;
-#endif /* DBGPRINT */
+					// the topic we try to subscribe to is checked regardless
+					if ((next_subscribe_topic_index >= 0) && (next_subscribe_topic_index / 32 == word)) {
+						ready |= 1u << (next_subscribe_topic_index % 32);
 					}
 
-					// mission log
-					if (sub_idx < _num_mission_subs) {
-						if (_writer.is_started(LogType::Mission)) {
-							if (_mission_subscriptions[sub_idx].next_write_time < (loop_time / 100000)) {
-								unsigned delta_time = _mission_subscriptions[sub_idx].min_delta_ms;
+					while (ready != 0) {
+						const int sub_idx = word * 32 + __builtin_ctz(ready);
+						ready &= ready - 1;
+
+						if (sub_idx >= _num_subscriptions) {
+							break;
+						}
 
-								if (delta_time > 0) {
-									_mission_subscriptions[sub_idx].next_write_time = (loop_time / 100000) + delta_time / 100;
-								}
+						++_topics_serviced;
 
-								write_message(LogType::Mission, _msg_buffer, msg_size);
-							}
+						if (!write_subscription(sub_idx, sub_idx == next_subscribe_topic_index, loop_time, total_bytes)
+						    && _subscriptions[sub_idx].valid() && _subscriptions[sub_idx].pending()) {
+							// held back by the interval limit, check again on the next iteration
+							_ready_topics.set(sub_idx);
 						}
 					}
 				}
+
+			} else {
+				for (int sub_idx = 0; sub_idx < _num_subscriptions; ++sub_idx) {
+					write_subscription(sub_idx, sub_idx == next_subscribe_topic_index, loop_time, total_bytes);
+				}
+
+				_topics_serviced += _num_subscriptions;
 			}
 
+			++_loop_count;
+
 			// check for new events
 			handle_event_updates(total_bytes);
 
@@ -897,6 +978,8 @@ void Logger::run()
 
 		update_params();
 
+		perf_end(_loop_perf);
+
 		// wait for next loop iteration...
 		if (polling_topic_sub >= 0) {
 			px4_lockstep_progress(_lockstep_component);
@@ -1055,6 +1138,9 @@ void Logger::publish_logger_status()
 				status.message_gaps = _message_gaps;
 				status.buffer_used_bytes = buffer_fill_count_file;
 				status.buffer_size_bytes = _writer.get_buffer_size_file(log_type);
+				static_assert(sizeof(status.write_latency_hist) / sizeof(status.write_latency_hist[0])
+					      == LogWriterFile::WRITE_LATENCY_BUCKETS, "latency histogram size mismatch");
+				_writer.get_write_latency_histogram_file(log_type, status.write_latency_hist);
 				status.num_messages = _num_subscriptions;
 				status.timestamp = hrt_absolute_time();
 				_logger_status_pub[i].publish(status);
@@ -1309,6 +1395,8 @@ int Logger::get_log_file_name(LogType type, char *file_name, size_t file_name_si
 
 #endif
 
+	const char *compression_suffix = compression_level(type) > 0 ? ".lz4" : "";
+
 	char *log_file_name = _file_name[(int)type].log_file_name;
 
 	if (time_ok) {
@@ -1320,8 +1408,8 @@ int Logger::get_log_file_name(LogType type, char *file_name, size_t file_name_si
 
 		char log_file_name_time[16] = "";
 		strftime(log_file_name_time, sizeof(log_file_name_time), "%H_%M_%S", &tt);
-		snprintf(log_file_name, sizeof(LogFileName::log_file_name), "%s%s.ulg%s", log_file_name_time, replay_suffix,
-			 crypto_suffix);
+		snprintf(log_file_name, sizeof(LogFileName::log_file_name), "%s%s.ulg%s%s", log_file_name_time, replay_suffix,
+			 crypto_suffix, compression_suffix);
 		snprintf(file_name + n, file_name_size - n, "/%s", log_file_name);
 
 		if (notify) {
@@ -1351,8 +1439,8 @@ int Logger::get_log_file_name(LogType type, char *file_name, size_t file_name_si
 		/* look for the next file that does not exist */
 		while (file_number <= MAX_NO_LOGFILE) {
 			/* format log file path: e.g. /fs/microsd/log/sess001/log001.ulg */
-			snprintf(log_file_name, sizeof(LogFileName::log_file_name), "log%03" PRIu16 "%s.ulg%s", file_number, replay_suffix,
-				 crypto_suffix);
+			snprintf(log_file_name, sizeof(LogFileName::log_file_name), "log%03" PRIu16 "%s.ulg%s%s", file_number,
+				 replay_suffix, crypto_suffix, compression_suffix);
 			snprintf(file_name + n, file_name_size - n, "/%s", log_file_name);
 
 			if (!util::file_exist(file_name)) {
@@ -1390,6 +1478,20 @@ void Logger::setReplayFile(const char *file_name)
 	_replay_file_name = strdup(file_name);
 }
 
+int32_t Logger::compression_level(LogType type) const
+{
+	// the mission log is small, and encrypted logs do not compress
+#if defined(PX4_CRYPTO)
+
+	if (_param_sdlog_crypto_algorithm.get() != 0) {
+		return 0;
+	}
+
+#endif
+
+	return type == LogType::Full ? _param_sdlog_compress.get() : 0;
+}
+
 void Logger::start_log_file(LogType type)
 {
 	if (_writer.is_started(type, LogWriter::BackendFile) || (_writer.backend() & LogWriter::BackendFile) == 0) {
@@ -1418,7 +1520,7 @@ void Logger::start_log_file(LogType type)
 		_param_sdlog_crypto_exchange_key.get());
 #endif
 
-	if (_writer.start_log_file(type, file_name)) {
+	if (_writer.start_log_file(type, file_name, compression_level(type))) {
 		_writer.select_write_backend(LogWriter::BackendFile);
 		_writer.set_need_reliable_transfer(true);
 
@@ -39,16 +39,19 @@
 #include "watchdog.h"
 #include <containers/Array.hpp>
 #include "util.h"
+#include <px4_platform_common/atomic.h>
 #include <px4_platform_common/defines.h>
 #include <drivers/drv_hrt.h>
 #include <version/version.h>
 #include <parameters/param.h>
+#include <perf/perf_counter.h>
 #include <px4_platform_common/printload.h>
 #include <px4_platform_common/module.h>
 #include <px4_platform_common/module_params.h>
 
 #include <uORB/PublicationMulti.hpp>
 #include <uORB/Subscription.hpp>
+#include <uORB/SubscriptionCallback.hpp>
 #include <uORB/SubscriptionInterval.hpp>
 #include <uORB/topics/logger_status.h>
 #include <uORB/topics/log_message.h>
@@ -71,14 +74,78 @@ namespace logger
 
 static constexpr uint8_t MSG_ID_INVALID = UINT8_MAX;
 
-struct LoggerSubscription : public uORB::SubscriptionInterval {
-	LoggerSubscription() = default;
+/**
+ * Set of logged topics with pending updates (one bit per subscription index).
+ * Bits are set from the publisher's context via uORB callbacks and drained by the logger thread.
+ */
+class ReadyTopics
+{
+public:
+	static constexpr int NUM_WORDS = (LoggedTopics::MAX_TOPICS_NUM + 31) / 32;
+
+	void set(int index) { _words[index / 32].fetch_or(1u << (index % 32)); }
+
+	void set_all()
+	{
+		for (int i = 0; i < NUM_WORDS; ++i) {
+			_words[i].store(UINT32_MAX);
+		}
+	}
+
+	/** get and clear one word of the set */
+	uint32_t take(int word) { return _words[word].fetch_and(0); }
+
+private:
+	px4::atomic<uint32_t> _words[NUM_WORDS] {};
+};
+
+struct LoggerSubscription : public uORB::SubscriptionCallback {
+	LoggerSubscription() : uORB::SubscriptionCallback(nullptr) {}
 
 	LoggerSubscription(ORB_ID id, uint32_t interval_ms = 0, uint8_t instance = 0) :
-		uORB::SubscriptionInterval(id, interval_ms * 1000, instance)
+		uORB::SubscriptionCallback(get_orb_meta(id), interval_ms * 1000, instance)
 	{}
 
+	/**
+	 * Report updates of this subscription to ready_topics (event driven logging).
+	 * Takes effect on the next successful subscribe().
+	 */
+	void set_ready_topics(ReadyTopics *ready_topics, uint8_t index)
+	{
+		_ready_topics = ready_topics;
+		_index = index;
+	}
+
+	bool subscribe()
+	{
+		if (!uORB::SubscriptionCallback::subscribe()) {
+			return false;
+		}
+
+		if (_ready_topics) {
+			registerCallback();
+			// the topic might already hold data
+			_ready_topics->set(_index);
+		}
+
+		return true;
+	}
+
+	/** true if there is unread data, regardless of the interval limit */
+	bool pending() { return _subscription.updated(); }
+
+	void call() override
+	{
+		if (_ready_topics) {
+			_ready_topics->set(_index);
+		}
+	}
+
 	uint8_t msg_id{MSG_ID_INVALID};
+
+private:
+	ReadyTopics *_ready_topics{nullptr};
+	uint8_t _index{0};
 };
 
 class Logger : public ModuleBase<Logger>, public ModuleParams
@@ -213,6 +280,11 @@ private:
 	 */
 	int get_log_file_name(LogType type, char *file_name, size_t file_name_size, bool notify);
 
+	/**
+	 * @return LZ4 acceleration to compress the log file with (SDLOG_COMPRESS), 0 for no compression
+	 */
+	int32_t compression_level(LogType type) const;
+
 	void start_log_file(LogType type);
 
 	void stop_log_file(LogType type);
@@ -280,6 +352,13 @@ private:
 
 	inline bool copy_if_updated(int sub_idx, void *buffer, bool try_to_subscribe);
 
+	/**
+	 * Copy the subscription if updated and write it to the full (and mission) log.
+	 * Must be called with _writer.lock() held.
+	 * @return true if a message was written
+	 */
+	inline bool write_subscription(int sub_idx, bool try_to_subscribe, hrt_abstime loop_time, uint32_t &total_bytes);
+
 	/**
 	 * Write exactly one ulog message to the logger and handle dropouts.
 	 * Must be called with _writer.lock() held.
@@ -357,6 +436,10 @@ private:
 	MissionSubscription 				_mission_subscriptions[MAX_MISSION_TOPICS_NUM] {}; ///< additional data for mission subscriptions
 	int						_num_mission_subs{0};
 	LoggerSubscription				_event_subscription; ///< Subscription for the event topic (handled separately)
+	ReadyTopics					_ready_topics{}; ///< subscriptions with pending updates (event driven mode)
+	bool						_event_driven{false}; ///< only service subscriptions in _ready_topics instead of checking all
+	uint32_t					_loop_count{0};
+	uint32_t					_topics_serviced{0}; ///< number of subscriptions checked, for the average per loop
 	uint16_t 					_event_sequence_offset{0}; ///< event sequence offset to account for skipped (not logged) messages
 	uint16_t 					_event_sequence_offset_mission{0};
 
@@ -385,6 +468,9 @@ private:
 
 	timer_callback_data_s				_timer_callback_data{};
 
+	perf_counter_t					_loop_perf{perf_alloc(PC_ELAPSED, MODULE_NAME": cycle")};
+	perf_counter_t					_loop_interval_perf{perf_alloc(PC_INTERVAL, MODULE_NAME": cycle interval")};
+
 	uORB::Subscription				_manual_control_setpoint_sub{ORB_ID(manual_control_setpoint)};
 	uORB::Subscription				_vehicle_command_sub{ORB_ID(vehicle_command)};
 	uORB::Subscription				_vehicle_status_sub{ORB_ID(vehicle_status)};
@@ -397,7 +483,10 @@ private:
 		(ParamInt<px4::params::SDLOG_PROFILE>) _param_sdlog_profile,
 		(ParamInt<px4::params::SDLOG_MISSION>) _param_sdlog_mission,
 		(ParamBool<px4::params::SDLOG_BOOT_BAT>) _param_sdlog_boot_bat,
-		(ParamBool<px4::params::SDLOG_UUID>) _param_sdlog_uuid
+		(ParamBool<px4::params::SDLOG_UUID>) _param_sdlog_uuid,
+		(ParamBool<px4::params::SDLOG_EVT_LOOP>) _param_sdlog_evt_loop,
+		(ParamInt<px4::params::SDLOG_ASYNC_IO>) _param_sdlog_async_io,
+		(ParamInt<px4::params::SDLOG_COMPRESS>) _param_sdlog_compress
 #if defined(PX4_CRYPTO)
 		, (ParamInt<px4::params::SDLOG_ALGORITHM>) _param_sdlog_crypto_algorithm,
 		(ParamInt<px4::params::SDLOG_KEY>) _param_sdlog_crypto_key,
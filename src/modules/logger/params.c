@@ -177,6 +177,66 @@ PARAM_DEFINE_INT32(SDLOG_DIRS_MAX, 0);
  */
 PARAM_DEFINE_INT32(SDLOG_UUID, 1);
 
+/**
+ * Event driven topic updates
+ *
+ * If enabled, the logger is notified on publication of a logged topic and
+ * only checks the topics that were updated, instead of checking every logged
+ * topic on each cycle. This reduces the logger CPU load with large logging
+ * profiles. The per-topic logging rate limits apply in both modes.
+ *
+ * The logger cycle time and interval are available as perf counters
+ * ('logger status') for comparison.
+ *
+ * @boolean
+ * @reboot_required true
+ * @group SD Logging
+ */
+PARAM_DEFINE_INT32(SDLOG_EVT_LOOP, 1);
+
+/**
+ * Asynchronous log file writes
+ *
+ * Queue the log file writes and fsync calls asynchronously, so that a slow
+ * write or fsync does not prevent the writer from draining the log buffer.
+ * Up to 3 writes per log file are in flight at the same time.
+ *
+ * Only supported on Linux, ignored on other platforms. If io_uring is not
+ * available (kernel < 5.1), worker threads are used instead.
+ *
+ * The write latency distribution is published in logger_status.
+ *
+ * @value 0 Disabled (synchronous writes)
+ * @value 1 io_uring, or worker threads as fallback
+ * @value 2 Worker threads
+ * @reboot_required true
+ * @group SD Logging
+ */
+PARAM_DEFINE_INT32(SDLOG_ASYNC_IO, 1);
+
+/**
+ * Log file compression
+ *
+ * If enabled, the full log is compressed with LZ4 while logging, and written as
+ * .ulg.lz4 file. The file consists of independently compressed blocks of 64KB
+ * (16KB on NuttX), so that it can be accessed randomly. It can be decompressed with
+ * the standard lz4 tools, and replay reads it directly.
+ *
+ * The value is the LZ4 acceleration factor: 1 gives the best compression, higher
+ * values use less CPU time but compress less. Use 'microbench microbench_compress'
+ * with a recorded log to compare the levels on a vehicle.
+ *
+ * Not supported for encrypted logs.
+ *
+ * @min 0
+ * @max 32
+ * @value 0 Disabled
+ * @value 1 Best compression
+ * @value 8 Fast
+ * @group SD Logging
+ */
+PARAM_DEFINE_INT32(SDLOG_COMPRESS, 0);
+
 /**
  * Logfile Encryption algorithm
  *
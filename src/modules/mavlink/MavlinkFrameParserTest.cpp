@@ -0,0 +1,388 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file MavlinkFrameParserTest.cpp
+ * Checks the bulk frame parser against mavlink_parse_char() on random byte
+ * streams, and compares the throughput of both on a telemetry capture.
+ *
+ * A recorded raw byte stream can be used for the throughput test by setting
+ * MAVLINK_RX_CAPTURE to its path.
+ */
+
+#include "mavlink_frame_parser.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+static constexpr mavlink_channel_t PARSER_CHANNEL = MAVLINK_COMM_0;
+static constexpr mavlink_channel_t REFERENCE_CHANNEL = MAVLINK_COMM_1;
+static constexpr mavlink_channel_t TX_CHANNEL = MAVLINK_COMM_2;
+
+static mavlink_status_t channel_status[MAVLINK_COMM_NUM_BUFFERS] {};
+static mavlink_message_t channel_buffer[MAVLINK_COMM_NUM_BUFFERS] {};
+
+mavlink_status_t *mavlink_get_channel_status(uint8_t chan) { return &channel_status[chan]; }
+mavlink_message_t *mavlink_get_channel_buffer(uint8_t chan) { return &channel_buffer[chan]; }
+
+static constexpr uint32_t capture_msg_ids[] {
+	MAVLINK_MSG_ID_HEARTBEAT,
+	MAVLINK_MSG_ID_PING,
+	MAVLINK_MSG_ID_SCALED_PRESSURE,
+	MAVLINK_MSG_ID_COMMAND_LONG,
+	MAVLINK_MSG_ID_VISION_POSITION_ESTIMATE,
+	MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL,
+	MAVLINK_MSG_ID_TIMESYNC,
+	MAVLINK_MSG_ID_STATUSTEXT,
+	MAVLINK_MSG_ID_ODOMETRY,
+};
+
+struct Received {
+	mavlink_message_t msg;
+	mavlink_status_t status;
+};
+
+class MavlinkFrameParserTest : public ::testing::Test
+{
+public:
+	void SetUp() override
+	{
+		memset(channel_status, 0, sizeof(channel_status));
+		memset(channel_buffer, 0, sizeof(channel_buffer));
+	}
+
+	// random payload with a random number of trailing zeros, packed into buf
+	static size_t pack(std::mt19937 &rng, uint32_t msgid, bool mavlink1, uint8_t *buf)
+	{
+		const mavlink_msg_entry_t *entry = mavlink_get_msg_entry(msgid);
+		mavlink_message_t msg{};
+		uint8_t *payload = reinterpret_cast<uint8_t *>(_MAV_PAYLOAD_NON_CONST(&msg));
+		const size_t nonzero = rng() % (entry->max_msg_len + 1);
+
+		for (size_t i = 0; i < nonzero; i++) {
+			payload[i] = rng();
+		}
+
+		mavlink_status_t *tx_status = mavlink_get_channel_status(TX_CHANNEL);
+
+		if (mavlink1) {
+			tx_status->flags |= MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+
+		} else {
+			tx_status->flags &= ~MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+		}
+
+		msg.msgid = msgid;
+		mavlink_finalize_message_chan(&msg, 1 + rng() % 3, 1 + rng() % 200, TX_CHANNEL, entry->min_msg_len,
+					      entry->max_msg_len, entry->crc_extra);
+		return mavlink_msg_to_send_buffer(buf, &msg);
+	}
+
+	// set flags or message id of a mavlink 2 frame and fix up the CRC
+	static void modify(uint8_t *buf, size_t len, uint8_t incompat_flags, uint32_t msgid)
+	{
+		buf[2] = incompat_flags;
+		buf[7] = msgid & 0xFF;
+		buf[8] = (msgid >> 8) & 0xFF;
+		buf[9] = (msgid >> 16) & 0xFF;
+
+		const mavlink_msg_entry_t *entry = mavlink_get_msg_entry(msgid);
+		const uint8_t crc_extra = entry ? entry->crc_extra : 0;
+		uint16_t crc = MavlinkFrameParser::crc_calculate(&buf[1], len - 3);
+		crc = MavlinkFrameParser::crc_calculate(&crc_extra, 1, crc);
+		buf[len - 2] = crc & 0xFF;
+		buf[len - 1] = crc >> 8;
+	}
+
+	// random frames mixed with garbage, corrupted bytes, signed frames and unknown messages
+	static std::vector<uint8_t> random_stream(std::mt19937 &rng, size_t frames)
+	{
+		std::vector<uint8_t> stream;
+		uint8_t frame[MAVLINK_MAX_PACKET_LEN];
+
+		for (size_t n = 0; n < frames; n++) {
+			const uint32_t msgid = capture_msg_ids[rng() % (sizeof(capture_msg_ids) / sizeof(capture_msg_ids[0]))];
+			const bool mavlink1 = (msgid < 256) && (rng() % 4 == 0);
+			size_t len = pack(rng, msgid, mavlink1, frame);
+
+			switch (rng() % 16) {
+			case 0: // flipped byte
+				frame[rng() % len] ^= 1 << (rng() % 8);
+				break;
+
+			case 1: // truncated
+				len = rng() % len;
+				break;
+
+			case 2: // start marker within the frame
+				frame[rng() % len] = (rng() % 2) ? MAVLINK_STX : MAVLINK_STX_MAVLINK1;
+				break;
+
+			case 3: // signed
+				if (!mavlink1) {
+					modify(frame, len, MAVLINK_IFLAG_SIGNED, msgid);
+
+					for (int i = 0; i < MAVLINK_SIGNATURE_BLOCK_LEN; i++) {
+						frame[len++] = rng();
+					}
+				}
+
+				break;
+
+			case 4: // unknown flags or message id
+				if (!mavlink1) {
+					if (rng() % 2) {
+						modify(frame, len, 0x80, msgid);
+
+					} else {
+						modify(frame, len, 0, 0xFFFF00);
+					}
+				}
+
+				break;
+
+			case 5: { // garbage
+					const size_t garbage = rng() % 64;
+
+					for (size_t i = 0; i < garbage; i++) {
+						stream.push_back((rng() % 8 == 0) ? MAVLINK_STX : rng());
+					}
+				}
+				break;
+			}
+
+			stream.insert(stream.end(), frame, frame + len);
+		}
+
+		return stream;
+	}
+
+	static std::vector<Received> parse_bytewise(const std::vector<uint8_t> &stream)
+	{
+		std::vector<Received> received;
+		mavlink_message_t msg{};
+		mavlink_status_t status{};
+
+		for (uint8_t c : stream) {
+			if (mavlink_parse_char(REFERENCE_CHANNEL, c, &msg, &status)) {
+				received.push_back({msg, status});
+			}
+		}
+
+		if (!received.empty()) {
+			received.back().status = status;
+		}
+
+		return received;
+	}
+
+	static std::vector<Received> parse_bulk(MavlinkFrameParser &parser, const std::vector<uint8_t> &stream,
+						std::mt19937 &rng, size_t max_chunk)
+	{
+		std::vector<Received> received;
+		mavlink_message_t msg{};
+		mavlink_status_t status{};
+		size_t offset = 0;
+
+		while (offset < stream.size()) {
+			const size_t chunk = std::min(stream.size() - offset, 1 + rng() % max_chunk);
+			parser.parse(PARSER_CHANNEL, &stream[offset], chunk, msg, status, [&](mavlink_message_t &message) {
+				received.push_back({message, status});
+			});
+			offset += chunk;
+		}
+
+		if (!received.empty()) {
+			received.back().status = status;
+		}
+
+		return received;
+	}
+
+	static void expect_equal(const Received &a, const Received &b)
+	{
+		EXPECT_EQ(a.msg.magic, b.msg.magic);
+		EXPECT_EQ(a.msg.len, b.msg.len);
+		EXPECT_EQ(a.msg.incompat_flags, b.msg.incompat_flags);
+		EXPECT_EQ(a.msg.compat_flags, b.msg.compat_flags);
+		EXPECT_EQ(a.msg.seq, b.msg.seq);
+		EXPECT_EQ(a.msg.sysid, b.msg.sysid);
+		EXPECT_EQ(a.msg.compid, b.msg.compid);
+		EXPECT_EQ(a.msg.msgid, b.msg.msgid);
+		EXPECT_EQ(a.msg.checksum, b.msg.checksum);
+		EXPECT_EQ(a.msg.ck[0], b.msg.ck[0]);
+		EXPECT_EQ(a.msg.ck[1], b.msg.ck[1]);
+
+		// payload including the zero-filled part of truncated messages
+		const mavlink_msg_entry_t *entry = mavlink_get_msg_entry(a.msg.msgid);
+		const size_t len = std::max<size_t>(a.msg.len, entry ? entry->max_msg_len : 0);
+		EXPECT_EQ(0, memcmp(_MAV_PAYLOAD(&a.msg), _MAV_PAYLOAD(&b.msg), len));
+
+		EXPECT_EQ(a.status.parse_state, b.status.parse_state);
+		EXPECT_EQ(a.status.packet_idx, b.status.packet_idx);
+		EXPECT_EQ(a.status.current_rx_seq, b.status.current_rx_seq);
+		EXPECT_EQ(a.status.packet_rx_success_count, b.status.packet_rx_success_count);
+		EXPECT_EQ(a.status.packet_rx_drop_count, b.status.packet_rx_drop_count);
+		EXPECT_EQ(a.status.flags, b.status.flags);
+	}
+};
+
+TEST_F(MavlinkFrameParserTest, Crc)
+{
+	// CRC-16/MCRF4XX check value
+	const uint8_t check[] {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+	EXPECT_EQ(MavlinkFrameParser::crc_calculate(check, sizeof(check)), 0x6F91);
+
+	std::mt19937 rng{1};
+	uint8_t buf[300];
+
+	for (int n = 0; n < 100; n++) {
+		const uint16_t len = rng() % sizeof(buf);
+
+		for (size_t i = 0; i < len; i++) {
+			buf[i] = rng();
+		}
+
+		EXPECT_EQ(MavlinkFrameParser::crc_calculate(buf, len), crc_calculate(buf, len));
+	}
+}
+
+TEST_F(MavlinkFrameParserTest, Fuzz)
+{
+	std::mt19937 rng{2};
+
+	for (int run = 0; run < 200; run++) {
+		SetUp();
+		MavlinkFrameParser parser;
+
+		const std::vector<uint8_t> stream = random_stream(rng, 200);
+		const std::vector<Received> reference = parse_bytewise(stream);
+		const std::vector<Received> received = parse_bulk(parser, stream, rng, (run % 2) ? 64 : 2048);
+
+		ASSERT_EQ(received.size(), reference.size()) << "run " << run;
+
+		for (size_t i = 0; i < reference.size(); i++) {
+			SCOPED_TRACE(i);
+			expect_equal(received[i], reference[i]);
+		}
+
+		// parser state is carried over to the next buffer
+		const mavlink_status_t &a = channel_status[PARSER_CHANNEL];
+		const mavlink_status_t &b = channel_status[REFERENCE_CHANNEL];
+		EXPECT_EQ(a.parse_state, b.parse_state);
+		EXPECT_EQ(a.parse_error, b.parse_error);
+		EXPECT_EQ(a.current_rx_seq, b.current_rx_seq);
+		EXPECT_EQ(a.packet_rx_success_count, b.packet_rx_success_count);
+		EXPECT_EQ(a.flags, b.flags);
+	}
+}
+
+TEST_F(MavlinkFrameParserTest, Throughput)
+{
+	std::vector<uint8_t> capture;
+
+	const char *capture_file = getenv("MAVLINK_RX_CAPTURE");
+
+	if (capture_file) {
+		FILE *f = fopen(capture_file, "rb");
+		ASSERT_NE(f, nullptr) << capture_file;
+		uint8_t buf[4096];
+		size_t nread;
+
+		while ((nread = fread(buf, 1, sizeof(buf), f)) > 0) {
+			capture.insert(capture.end(), buf, buf + nread);
+		}
+
+		fclose(f);
+
+	} else {
+		// clean companion computer link: odometry, vision, timesync and ftp traffic
+		static constexpr uint32_t link_msg_ids[] {
+			MAVLINK_MSG_ID_ODOMETRY,
+			MAVLINK_MSG_ID_VISION_POSITION_ESTIMATE,
+			MAVLINK_MSG_ID_TIMESYNC,
+			MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL,
+			MAVLINK_MSG_ID_HEARTBEAT,
+		};
+
+		std::mt19937 rng{3};
+		uint8_t frame[MAVLINK_MAX_PACKET_LEN];
+
+		while (capture.size() < 4 * 1024 * 1024) {
+			const size_t len = pack(rng, link_msg_ids[rng() % (sizeof(link_msg_ids) / sizeof(link_msg_ids[0]))], false, frame);
+			capture.insert(capture.end(), frame, frame + len);
+		}
+	}
+
+	// receive buffer size of the posix receiver
+	static constexpr size_t chunk = 1600 * 5;
+
+	mavlink_message_t msg{};
+	mavlink_status_t status{};
+	size_t bytewise_messages = 0;
+	size_t bulk_messages = 0;
+
+	const auto bytewise_start = std::chrono::steady_clock::now();
+
+	for (uint8_t c : capture) {
+		if (mavlink_parse_char(REFERENCE_CHANNEL, c, &msg, &status)) {
+			bytewise_messages++;
+		}
+	}
+
+	const auto bytewise_end = std::chrono::steady_clock::now();
+
+	MavlinkFrameParser parser;
+
+	for (size_t offset = 0; offset < capture.size(); offset += chunk) {
+		parser.parse(PARSER_CHANNEL, &capture[offset], std::min(chunk, capture.size() - offset), msg, status,
+		[&](mavlink_message_t &) { bulk_messages++; });
+	}
+
+	const auto bulk_end = std::chrono::steady_clock::now();
+
+	EXPECT_EQ(bulk_messages, bytewise_messages);
+
+	const double bytewise_s = std::chrono::duration<double>(bytewise_end - bytewise_start).count();
+	const double bulk_s = std::chrono::duration<double>(bulk_end - bytewise_end).count();
+
+	printf("%zu bytes, %zu messages: byte-wise %.1f MB/s, bulk %.1f MB/s\n", capture.size(), bulk_messages,
+	       capture.size() / bytewise_s * 1e-6, capture.size() / bulk_s * 1e-6);
+	parser.print_status();
+}
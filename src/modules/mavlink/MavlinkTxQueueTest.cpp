@@ -0,0 +1,272 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file MavlinkTxQueueTest.cpp
+ * Tests the transmit frame queue: ordering, frames of several threads in
+ * flight at the same time, full queue, and a stress test with concurrent
+ * producers that take turns sending like Mavlink::send_queued_frames().
+ */
+
+#include "mavlink_tx_queue.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+// frame: producer id, 32 bit counter, then filler bytes depending on both
+static unsigned build_frame(uint8_t *buf, uint8_t producer, uint32_t counter)
+{
+	const unsigned len = 5 + (producer * 31 + counter) % (MAVLINK_MAX_PACKET_LEN - 5);
+	buf[0] = producer;
+	memcpy(&buf[1], &counter, sizeof(counter));
+
+	for (unsigned i = 5; i < len; i++) {
+		buf[i] = (uint8_t)(i + producer + counter);
+	}
+
+	return len;
+}
+
+static bool check_frame(const uint8_t *buf, unsigned len, uint8_t &producer, uint32_t &counter)
+{
+	if (len < 5) {
+		return false;
+	}
+
+	producer = buf[0];
+	memcpy(&counter, &buf[1], sizeof(counter));
+
+	uint8_t expected[MAVLINK_MAX_PACKET_LEN];
+	return build_frame(expected, producer, counter) == len && memcmp(buf, expected, len) == 0;
+}
+
+// queue a frame the way the MAVLink library does: header, payload and checksum separately
+static bool send_frame(MavlinkTxQueue &queue, uint8_t producer, uint32_t counter)
+{
+	uint8_t buf[MAVLINK_MAX_PACKET_LEN];
+	const unsigned len = build_frame(buf, producer, counter);
+
+	if (!queue.begin(len)) {
+		return false;
+	}
+
+	EXPECT_TRUE(queue.append(buf, 3));
+	EXPECT_TRUE(queue.append(&buf[3], len - 5));
+	EXPECT_TRUE(queue.append(&buf[len - 2], 2));
+	EXPECT_TRUE(queue.commit());
+	return true;
+}
+
+TEST(MavlinkTxQueueTest, Order)
+{
+	MavlinkTxQueue queue;
+	EXPECT_FALSE(queue.ready());
+
+	for (uint32_t i = 0; i < 3 * MavlinkTxQueue::CAPACITY; i++) {
+		ASSERT_TRUE(send_frame(queue, 1, i));
+
+		if (i % 3 == 2) {
+			uint32_t expected = i - 2;
+			const unsigned frames = queue.consume([&](const uint8_t *buf, unsigned len) {
+				uint8_t producer;
+				uint32_t counter;
+				EXPECT_TRUE(check_frame(buf, len, producer, counter));
+				EXPECT_EQ(counter, expected++);
+			});
+			EXPECT_EQ(frames, 3u);
+			EXPECT_EQ(queue.queued_bytes(), 0u);
+		}
+	}
+
+	// nothing open, nothing to append to
+	EXPECT_TRUE(queue.append((const uint8_t *)"x", 1));
+	EXPECT_FALSE(queue.commit());
+	EXPECT_FALSE(queue.ready());
+}
+
+TEST(MavlinkTxQueueTest, Full)
+{
+	MavlinkTxQueue queue;
+	unsigned queued_bytes = 0;
+
+	for (uint32_t i = 0; i < MavlinkTxQueue::CAPACITY; i++) {
+		EXPECT_FALSE(queue.full());
+		uint8_t buf[MAVLINK_MAX_PACKET_LEN];
+		queued_bytes += build_frame(buf, 0, i);
+		ASSERT_TRUE(send_frame(queue, 0, i));
+	}
+
+	EXPECT_EQ(queue.queued_bytes(), queued_bytes);
+	EXPECT_TRUE(queue.full());
+	EXPECT_FALSE(queue.begin(10));
+	EXPECT_FALSE(queue.begin(MAVLINK_MAX_PACKET_LEN + 1));
+
+	// a dropped frame leaves nothing to fill
+	EXPECT_TRUE(queue.append((const uint8_t *)"x", 1));
+	EXPECT_FALSE(queue.commit());
+
+	EXPECT_EQ(queue.consume([](const uint8_t *, unsigned) {}), MavlinkTxQueue::CAPACITY);
+	EXPECT_FALSE(queue.full());
+	EXPECT_TRUE(send_frame(queue, 0, 0));
+
+	// too long
+	uint8_t buf[MAVLINK_MAX_PACKET_LEN + 1] {};
+	EXPECT_TRUE(queue.begin(10));
+	EXPECT_FALSE(queue.append(buf, sizeof(buf)));
+	EXPECT_TRUE(queue.commit());
+}
+
+TEST(MavlinkTxQueueTest, OpenFrameOfOtherThread)
+{
+	MavlinkTxQueue queue;
+	std::atomic<int> step{0};
+
+	// the other thread claims the first slot and commits only when told to
+	std::thread other([&]() {
+		uint8_t buf[MAVLINK_MAX_PACKET_LEN];
+		const unsigned len = build_frame(buf, 2, 0);
+		EXPECT_TRUE(queue.begin(len));
+		EXPECT_TRUE(queue.append(buf, len));
+		step = 1;
+
+		while (step != 2) {
+			std::this_thread::yield();
+		}
+
+		EXPECT_TRUE(queue.commit());
+	});
+
+	while (step != 1) {
+		std::this_thread::yield();
+	}
+
+	// our frame is queued behind the open one and the open one is not ours
+	ASSERT_TRUE(send_frame(queue, 1, 0));
+	EXPECT_FALSE(queue.ready());
+	EXPECT_EQ(queue.consume([](const uint8_t *, unsigned) {}), 0u);
+
+	step = 2;
+	other.join();
+
+	std::vector<uint8_t> producers;
+	EXPECT_EQ(queue.consume([&](const uint8_t *buf, unsigned len) {
+		uint8_t producer;
+		uint32_t counter;
+		EXPECT_TRUE(check_frame(buf, len, producer, counter));
+		producers.push_back(producer);
+	}), 2u);
+
+	ASSERT_EQ(producers.size(), 2u);
+	EXPECT_EQ(producers[0], 2);
+	EXPECT_EQ(producers[1], 1);
+}
+
+TEST(MavlinkTxQueueTest, ConcurrentProducers)
+{
+	static constexpr unsigned PRODUCERS = 4;
+	static constexpr uint32_t FRAMES = 20000;
+
+	MavlinkTxQueue queue;
+	std::atomic<uint32_t> full{0};
+	std::atomic<uint32_t> errors{0};
+
+	// only accessed by the consumer
+	uint32_t received[PRODUCERS] {};
+	int64_t last_counter[PRODUCERS];
+
+	for (unsigned i = 0; i < PRODUCERS; i++) {
+		last_counter[i] = -1;
+	}
+
+	auto consume = [&](const uint8_t *buf, unsigned len) {
+		uint8_t producer;
+		uint32_t counter;
+
+		if (!check_frame(buf, len, producer, counter) || producer >= PRODUCERS
+		    || (int64_t)counter <= last_counter[producer]) {
+			errors++;
+			return;
+		}
+
+		last_counter[producer] = counter;
+		received[producer]++;
+	};
+
+	auto send_queued_frames = [&]() {
+		while (queue.try_lock_consumer()) {
+			queue.consume(consume);
+			queue.unlock_consumer();
+
+			if (!queue.ready()) {
+				break;
+			}
+		}
+	};
+
+	std::vector<std::thread> producers;
+
+	for (unsigned p = 0; p < PRODUCERS; p++) {
+		producers.emplace_back([&, p]() {
+			for (uint32_t i = 0; i < FRAMES; i++) {
+				// the queue is full while a preempted producer holds the oldest frame, let it finish
+				while (!send_frame(queue, p, i)) {
+					full++;
+					std::this_thread::yield();
+				}
+
+				send_queued_frames();
+			}
+		});
+	}
+
+	for (auto &producer : producers) {
+		producer.join();
+	}
+
+	// every frame has been sent once, in order, by one of the producers
+	EXPECT_FALSE(queue.ready());
+	EXPECT_EQ(queue.queued_bytes(), 0u);
+	EXPECT_EQ(errors, 0u);
+
+	for (unsigned p = 0; p < PRODUCERS; p++) {
+		EXPECT_EQ(received[p], FRAMES);
+	}
+
+	printf("queue full %u times\n", full.load());
+
+	queue.print_status();
+}
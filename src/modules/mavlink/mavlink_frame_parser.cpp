@@ -0,0 +1,223 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file mavlink_frame_parser.cpp
+ * Bulk MAVLink frame parser.
+ */
+
+#include "mavlink_frame_parser.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace
+{
+
+// CRC-16/MCRF4XX lookup table (reflected polynomial 0x8408)
+struct CrcTable {
+	uint16_t entry[256];
+
+	constexpr CrcTable() : entry()
+	{
+		for (unsigned i = 0; i < 256; i++) {
+			uint16_t crc = i;
+
+			for (int bit = 0; bit < 8; bit++) {
+				crc = (crc & 1) ? (crc >> 1) ^ 0x8408 : (crc >> 1);
+			}
+
+			entry[i] = crc;
+		}
+	}
+};
+
+constexpr CrcTable crc_table{};
+
+inline bool is_stx(uint8_t c)
+{
+	return (c == MAVLINK_STX) || (c == MAVLINK_STX_MAVLINK1);
+}
+
+} // namespace
+
+uint16_t
+MavlinkFrameParser::crc_calculate(const uint8_t *buf, size_t len, uint16_t crc)
+{
+	for (size_t i = 0; i < len; i++) {
+		crc = (crc >> 8) ^ crc_table.entry[(crc ^ buf[i]) & 0xFF];
+	}
+
+	return crc;
+}
+
+size_t
+MavlinkFrameParser::skip(const uint8_t *buf, size_t len, mavlink_status_t &status, mavlink_status_t &r_status)
+{
+	size_t skipped = 0;
+
+	while ((skipped < len) && !is_stx(buf[skipped])) {
+		skipped++;
+	}
+
+	if (skipped > 0) {
+		// mavlink_parse_char() ignores these bytes, but still reports and clears a pending parse error
+		r_status.parse_state = status.parse_state;
+		r_status.packet_idx = status.packet_idx;
+		r_status.current_rx_seq = status.current_rx_seq + 1;
+		r_status.packet_rx_success_count = status.packet_rx_success_count;
+		r_status.packet_rx_drop_count = (skipped == 1) ? status.parse_error : 0;
+		r_status.flags = status.flags;
+		status.parse_error = 0;
+	}
+
+	return skipped;
+}
+
+size_t
+MavlinkFrameParser::parse_frame(const uint8_t *buf, size_t len, mavlink_message_t &msg, mavlink_status_t &status,
+				mavlink_status_t &r_status)
+{
+	const bool mavlink1 = (buf[0] == MAVLINK_STX_MAVLINK1);
+	const size_t header_len = mavlink1 ? MAVLINK_CORE_HEADER_MAVLINK1_LEN : MAVLINK_CORE_HEADER_LEN;
+
+	// STX and header
+	if (len < 1 + header_len) {
+		return 0;
+	}
+
+	const uint8_t payload_len = buf[1];
+	const size_t frame_len = 1 + header_len + payload_len + MAVLINK_NUM_CHECKSUM_BYTES;
+
+	if (frame_len > len) {
+		return 0;
+	}
+
+	uint8_t incompat_flags = 0;
+	uint8_t compat_flags = 0;
+	uint8_t seq;
+	uint8_t sysid;
+	uint8_t compid;
+	uint32_t msgid;
+
+	if (mavlink1) {
+		seq = buf[2];
+		sysid = buf[3];
+		compid = buf[4];
+		msgid = buf[5];
+
+	} else {
+		incompat_flags = buf[2];
+		compat_flags = buf[3];
+		seq = buf[4];
+		sysid = buf[5];
+		compid = buf[6];
+		msgid = buf[7] | (buf[8] << 8) | (buf[9] << 16);
+
+		// signed frames need the signature check of mavlink_parse_char()
+		if (incompat_flags != 0) {
+			return 0;
+		}
+	}
+
+	// unknown messages are checked with crc_extra 0 by mavlink_parse_char()
+	const mavlink_msg_entry_t *entry = mavlink_get_msg_entry(msgid);
+
+	if (entry == nullptr) {
+		return 0;
+	}
+
+	const uint8_t *payload = &buf[1 + header_len];
+	uint16_t crc = crc_calculate(&buf[1], header_len + payload_len);
+	crc = crc_calculate(&entry->crc_extra, 1, crc);
+
+	if ((payload[payload_len] != (crc & 0xFF)) || (payload[payload_len + 1] != (crc >> 8))) {
+		return 0;
+	}
+
+	msg.magic = buf[0];
+	msg.len = payload_len;
+	msg.incompat_flags = incompat_flags;
+	msg.compat_flags = compat_flags;
+	msg.seq = seq;
+	msg.sysid = sysid;
+	msg.compid = compid;
+	msg.msgid = msgid;
+	msg.checksum = crc;
+	msg.ck[0] = payload[payload_len];
+	msg.ck[1] = payload[payload_len + 1];
+
+	uint8_t *msg_payload = reinterpret_cast<uint8_t *>(_MAV_PAYLOAD_NON_CONST(&msg));
+	memcpy(msg_payload, payload, payload_len);
+
+	// zero-fill truncated payloads
+	if (payload_len < entry->max_msg_len) {
+		memset(&msg_payload[payload_len], 0, entry->max_msg_len - payload_len);
+	}
+
+	// leave the channel and receiver status as mavlink_parse_char() does after the last byte of the frame
+	if (mavlink1) {
+		status.flags |= MAVLINK_STATUS_FLAG_IN_MAVLINK1;
+
+	} else {
+		status.flags &= ~MAVLINK_STATUS_FLAG_IN_MAVLINK1;
+	}
+
+	status.msg_received = MAVLINK_FRAMING_OK;
+	status.parse_state = MAVLINK_PARSE_STATE_IDLE;
+	status.packet_idx = payload_len;
+	status.current_rx_seq = seq;
+
+	if (status.packet_rx_success_count == 0) {
+		status.packet_rx_drop_count = 0;
+	}
+
+	status.packet_rx_success_count++;
+	status.parse_error = 0;
+
+	r_status.parse_state = status.parse_state;
+	r_status.packet_idx = status.packet_idx;
+	r_status.current_rx_seq = status.current_rx_seq + 1;
+	r_status.packet_rx_success_count = status.packet_rx_success_count;
+	r_status.packet_rx_drop_count = 0;
+	r_status.flags = status.flags;
+
+	return frame_len;
+}
+
+void
+MavlinkFrameParser::print_status() const
+{
+	printf("\tRX frames: %" PRIu32 " bulk parsed, %" PRIu32 " bytes parsed byte-wise\n", _bulk_frames, _bytewise_bytes);
+}
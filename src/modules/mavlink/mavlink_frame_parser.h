@@ -0,0 +1,135 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file mavlink_frame_parser.h
+ * Bulk MAVLink frame parser for received buffers.
+ *
+ * Complete, unsigned frames are located and checked as a whole (length,
+ * known message id, CRC-16/MCRF4XX with a lookup table). Everything else
+ * (partial frames at the end of a buffer, corrupt data, signed frames) is
+ * handed to mavlink_parse_char() byte by byte, so the result is the same as
+ * feeding every byte to mavlink_parse_char().
+ */
+
+#ifndef MAVLINK_FRAME_PARSER_H_
+#define MAVLINK_FRAME_PARSER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "mavlink_bridge_header.h"
+
+class MavlinkFrameParser
+{
+public:
+	MavlinkFrameParser() = default;
+	~MavlinkFrameParser() = default;
+
+	// no copy, assignment, move, move assignment
+	MavlinkFrameParser(const MavlinkFrameParser &) = delete;
+	MavlinkFrameParser &operator=(const MavlinkFrameParser &) = delete;
+	MavlinkFrameParser(MavlinkFrameParser &&) = delete;
+	MavlinkFrameParser &operator=(MavlinkFrameParser &&) = delete;
+
+	/**
+	 * Parse a buffer of received bytes.
+	 *
+	 * @param channel channel of the parser state
+	 * @param msg message buffer, valid when on_message is called
+	 * @param r_status receiver status, updated like mavlink_parse_char() does
+	 * @param on_message called with msg for every message received
+	 */
+	template<typename F>
+	void parse(mavlink_channel_t channel, const uint8_t *buf, size_t len, mavlink_message_t &msg,
+		   mavlink_status_t &r_status, F &&on_message)
+	{
+		mavlink_status_t *status = mavlink_get_channel_status(channel);
+		size_t i = 0;
+
+		while (i < len) {
+			if ((status->parse_state <= MAVLINK_PARSE_STATE_IDLE) && (status->signing == nullptr)) {
+				// between frames: skip to the next start marker and try to take the whole frame
+				const size_t skipped = skip(&buf[i], len - i, *status, r_status);
+				i += skipped;
+
+				if (i == len) {
+					break;
+				}
+
+				const size_t frame_len = parse_frame(&buf[i], len - i, msg, *status, r_status);
+
+				if (frame_len > 0) {
+					i += frame_len;
+					_bulk_frames++;
+					on_message(msg);
+					continue;
+				}
+			}
+
+			// within a frame that cannot be taken as a whole
+			_bytewise_bytes++;
+
+			if (mavlink_parse_char(channel, buf[i++], &msg, &r_status)) {
+				on_message(msg);
+			}
+		}
+	}
+
+	void print_status() const;
+
+	/**
+	 * CRC-16/MCRF4XX (X.25) as used by MAVLink, table driven
+	 */
+	static uint16_t crc_calculate(const uint8_t *buf, size_t len, uint16_t crc = 0xFFFF);
+
+private:
+
+	/**
+	 * Skip to the next start marker, the parser state has to be idle.
+	 * @return number of bytes skipped
+	 */
+	size_t skip(const uint8_t *buf, size_t len, mavlink_status_t &status, mavlink_status_t &r_status);
+
+	/**
+	 * Parse a complete frame at the start of buf, the parser state has to be idle.
+	 * @return frame length, 0 if it has to go through mavlink_parse_char()
+	 */
+	size_t parse_frame(const uint8_t *buf, size_t len, mavlink_message_t &msg, mavlink_status_t &status,
+			   mavlink_status_t &r_status);
+
+	uint32_t _bulk_frames{0};
+	uint32_t _bytewise_bytes{0};
+};
+
+#endif /* MAVLINK_FRAME_PARSER_H_ */
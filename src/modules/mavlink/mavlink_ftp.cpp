@@ -35,6 +35,7 @@
 ///	@author px4dev, Don Gagne <don@thegagnes.com>
 
 #include <crc32.h>
+#include <lib/mathlib/mathlib.h>
 #include <unistd.h>
 #include <stdio.h>
 #include <fcntl.h>
@@ -66,12 +67,13 @@ MavlinkFTP::~MavlinkFTP()
 {
 	delete[] _work_buffer1;
 	delete[] _work_buffer2;
+	delete[] _read_cache;
 }
 
 unsigned
 MavlinkFTP::get_size()
 {
-	if (_session_info.stream_download) {
+	if (_session_info.stream_download || _session_info.window_download) {
 		return MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL_LEN + MAVLINK_NUM_NON_PAYLOAD_BYTES;
 
 	} else {
@@ -227,6 +229,15 @@ MavlinkFTP::_process_request(
 		stream_send = true;
 		break;
 
+	case kCmdWindowReadFile:
+		errorCode = _workWindowRead(payload, target_system_id, target_comp_id);
+		break;
+
+	case kCmdWindowAck:
+		errorCode = _workWindowAck(payload);
+		stream_send = true;
+		break;
+
 	case kCmdWriteFile:
 		errorCode = _workWrite(payload);
 		break;
@@ -299,6 +310,12 @@ out:
 		ftp_req->target_component = target_comp_id;
 		_reply(ftp_req);
 	}
+
+	// windowed download packets are sent right away when the client makes room in the window
+	if (_session_info.window_download && errorCode == kErrNone
+	    && (payload->req_opcode == kCmdWindowReadFile || payload->req_opcode == kCmdWindowAck)) {
+		_send_window();
+	}
 }
 
 bool MavlinkFTP::_ensure_buffers_exist()
@@ -543,6 +560,8 @@ MavlinkFTP::_workOpen(PayloadHeader *payload, int oflag)
 	_session_info.fd = fd;
 	_session_info.file_size = fileSize;
 	_session_info.stream_download = false;
+	_session_info.window_download = false;
+	_read_cache_fill = 0;
 
 	payload->session = 0;
 	payload->size = sizeof(uint32_t);
@@ -567,15 +586,7 @@ MavlinkFTP::_workRead(PayloadHeader *payload)
 		return kErrEOF;
 	}
 
-	PX4_DEBUG("lseek with offset: %ld", payload->offset);
-
-	if (lseek(_session_info.fd, payload->offset, SEEK_SET) < 0) {
-		_our_errno = errno;
-		PX4_ERR("seek fail: %s", strerror(_our_errno));
-		return kErrFailErrno;
-	}
-
-	int bytes_read = ::read(_session_info.fd, &payload->data[0], payload->size);
+	int bytes_read = _read_cached(payload->offset, &payload->data[0], payload->size);
 
 	if (bytes_read < 0) {
 		// Negative return indicates error other than eof
@@ -610,6 +621,86 @@ MavlinkFTP::_workBurst(PayloadHeader *payload, uint8_t target_system_id, uint8_t
 	return kErrNone;
 }
 
+/// @brief Responds to a WindowReadFile command
+MavlinkFTP::ErrorCode
+MavlinkFTP::_workWindowRead(PayloadHeader *payload, uint8_t target_system_id, uint8_t target_component_id)
+{
+	if (payload->session != 0 || _session_info.fd < 0) {
+		PX4_DEBUG("_workWindowRead: no session or no fd");
+		return kErrInvalidSession;
+	}
+
+	if (payload->size != sizeof(uint16_t)) {
+		return kErrInvalidDataSize;
+	}
+
+	uint16_t window_size;
+	std::memcpy(&window_size, payload->data, sizeof(window_size));
+
+	if (window_size < 1) {
+		window_size = 1;
+
+	} else if (window_size > kMaxWindowSize) {
+		window_size = kMaxWindowSize;
+	}
+
+	PX4_DEBUG("FTP: window read offset:%" PRIu32 " window:%" PRIu16, payload->offset, window_size);
+
+	_session_info.stream_download = false;
+	_session_info.window_download = true;
+	_session_info.window_eof_sent = false;
+	_session_info.window_size = window_size;
+	_session_info.window_acked_offset = payload->offset;
+	_session_info.window_resend_count = 0;
+	_session_info.stream_offset = payload->offset;
+	_session_info.stream_seq_number = payload->seq_number + 2; // data follows the ack of this request
+	_session_info.stream_target_system_id = target_system_id;
+	_session_info.stream_target_component_id = target_component_id;
+
+	// the ack returns the window size in use
+	payload->size = sizeof(uint16_t);
+	std::memcpy(payload->data, &window_size, sizeof(window_size));
+
+	return kErrNone;
+}
+
+/// @brief Responds to a WindowAck command
+MavlinkFTP::ErrorCode
+MavlinkFTP::_workWindowAck(PayloadHeader *payload)
+{
+	if (payload->session != 0 || _session_info.fd < 0 || !_session_info.window_download) {
+		return kErrInvalidSession;
+	}
+
+	if (payload->size % sizeof(uint32_t) != 0) {
+		return kErrInvalidDataSize;
+	}
+
+	if (payload->offset > _session_info.window_acked_offset) {
+		_session_info.window_acked_offset = math::min(payload->offset, _session_info.stream_offset);
+	}
+
+	// every ack carries the complete list of missing packets, it replaces the previous one
+	_session_info.window_resend_count = 0;
+
+	for (unsigned i = 0; i < payload->size / sizeof(uint32_t); i++) {
+		uint32_t offset;
+		std::memcpy(&offset, &payload->data[i * sizeof(uint32_t)], sizeof(offset));
+
+		if (offset >= _session_info.window_acked_offset && offset < _session_info.stream_offset
+		    && _session_info.window_resend_count < kMaxWindowResend) {
+			_session_info.window_resend[_session_info.window_resend_count++] = offset;
+		}
+	}
+
+	// the client is still waiting, so tell it again if there's nothing left
+	_session_info.window_eof_sent = false;
+
+	payload->size = 0;
+
+	return kErrNone;
+}
+
 /// @brief Responds to a Write command
 MavlinkFTP::ErrorCode
 MavlinkFTP::_workWrite(PayloadHeader *payload)
@@ -623,6 +714,8 @@ MavlinkFTP::_workWrite(PayloadHeader *payload)
 		return kErrFailFileProtected;
 	}
 
+	_read_cache_fill = 0;
+
 	if (lseek(_session_info.fd, payload->offset, SEEK_SET) < 0) {
 		// Unable to see to the specified location
 		PX4_ERR("seek fail");
@@ -685,6 +778,9 @@ MavlinkFTP::_workTruncateFile(PayloadHeader *payload)
 		return kErrFailFileProtected;
 	}
 
+	// the truncated file might be the one that is open
+	_read_cache_fill = 0;
+
 #ifdef __PX4_NUTTX
 
 	// emulate truncate(_work_buffer1, payload->offset) by
@@ -803,6 +899,8 @@ MavlinkFTP::_workTerminate(PayloadHeader *payload)
 	::close(_session_info.fd);
 	_session_info.fd = -1;
 	_session_info.stream_download = false;
+	_session_info.window_download = false;
+	_read_cache_fill = 0;
 
 	payload->size = 0;
 
@@ -819,6 +917,8 @@ MavlinkFTP::_workReset(PayloadHeader *payload)
 		::close(_session_info.fd);
 		_session_info.fd = -1;
 		_session_info.stream_download = false;
+		_session_info.window_download = false;
+		_read_cache_fill = 0;
 	}
 
 	payload->size = 0;
@@ -1032,7 +1132,7 @@ MavlinkFTP::_copy_file(const char *src_path, const char *dst_path, size_t length
 void MavlinkFTP::send()
 {
 
-	if (_work_buffer1 || _work_buffer2) {
+	if (_work_buffer1 || _work_buffer2 || _read_cache) {
 		// free the work buffers if they are not used for a while
 		if (hrt_elapsed_time(&_last_work_buffer_access) > 2_s) {
 			if (_work_buffer1) {
@@ -1044,6 +1144,12 @@ void MavlinkFTP::send()
 				delete[] _work_buffer2;
 				_work_buffer2 = nullptr;
 			}
+
+			if (_read_cache) {
+				delete[] _read_cache;
+				_read_cache = nullptr;
+				_read_cache_fill = 0;
+			}
 		}
 
 	} else if (_session_info.fd != -1) {
@@ -1052,11 +1158,17 @@ void MavlinkFTP::send()
 			::close(_session_info.fd);
 			_session_info.fd = -1;
 			_session_info.stream_download = false;
+			_session_info.window_download = false;
 			_last_reply_valid = false;
 			PX4_WARN("Session was closed without activity");
 		}
 	}
 
+	if (_session_info.window_download) {
+		_send_window();
+		return;
+	}
+
 	// Anything to stream?
 	if (!_session_info.stream_download) {
 		return;
@@ -1101,14 +1213,7 @@ void MavlinkFTP::send()
 		}
 
 		if (error_code == kErrNone) {
-			if (lseek(_session_info.fd, payload->offset, SEEK_SET) < 0) {
-				error_code = kErrFailErrno;
-				PX4_WARN("stream download: seek fail");
-			}
-		}
-
-		if (error_code == kErrNone) {
-			int bytes_read = ::read(_session_info.fd, &payload->data[0], kMaxDataLength);
+			int bytes_read = _read_cached(payload->offset, &payload->data[0], kMaxDataLength);
 
 			if (bytes_read < 0) {
 				// Negative return indicates error other than eof
@@ -1166,6 +1271,162 @@ void MavlinkFTP::send()
 	} while (more_data);
 }
 
+int MavlinkFTP::_read_cached(uint32_t offset, uint8_t *data, uint8_t size)
+{
+	// a stream download keeps the cache alive without further requests
+	_last_work_buffer_access = hrt_absolute_time();
+
+	if (_read_cache == nullptr) {
+		_read_cache = new uint8_t[_read_cache_len];
+		_read_cache_fill = 0;
+	}
+
+	if (offset < _read_cache_offset || offset + size > _read_cache_offset + _read_cache_fill) {
+		if (lseek(_session_info.fd, offset, SEEK_SET) < 0) {
+			_our_errno = errno;
+			PX4_ERR("seek fail: %s", strerror(_our_errno));
+			return -1;
+		}
+
+		if (_read_cache == nullptr) {
+			// no memory for the cache, read directly
+			int bytes_read = ::read(_session_info.fd, data, size);
+
+			if (bytes_read < 0) {
+				_our_errno = errno;
+			}
+
+			return bytes_read;
+		}
+
+		// read ahead from the requested offset
+		int bytes_read = ::read(_session_info.fd, _read_cache, _read_cache_len);
+
+		if (bytes_read < 0) {
+			_our_errno = errno;
+			_read_cache_fill = 0;
+			return -1;
+		}
+
+		_read_cache_offset = offset;
+		_read_cache_fill = bytes_read;
+	}
+
+	if (offset >= _read_cache_offset + _read_cache_fill) {
+		return 0;
+	}
+
+	const uint32_t bytes_read = math::min((uint32_t)size, _read_cache_offset + _read_cache_fill - offset);
+	std::memcpy(data, &_read_cache[offset - _read_cache_offset], bytes_read);
+
+	return bytes_read;
+}
+
+void MavlinkFTP::_send_window()
+{
+#ifndef MAVLINK_FTP_UNIT_TEST
+	// Skip send if not enough room
+	unsigned max_bytes_to_send = _mavlink->get_free_tx_buf();
+#endif
+
+	while (_session_info.window_download) {
+#ifndef MAVLINK_FTP_UNIT_TEST
+
+		if (max_bytes_to_send < get_size()) {
+			break;
+		}
+
+#endif
+
+		mavlink_file_transfer_protocol_t ftp_msg;
+		PayloadHeader *payload = reinterpret_cast<PayloadHeader *>(&ftp_msg.payload[0]);
+		ErrorCode error_code = kErrNone;
+
+		if (_session_info.window_resend_count > 0) {
+			// resends first, they hold back the window
+			payload->offset = _session_info.window_resend[0];
+			_session_info.window_resend_count--;
+			memmove(&_session_info.window_resend[0], &_session_info.window_resend[1],
+				_session_info.window_resend_count * sizeof(_session_info.window_resend[0]));
+
+		} else if (_session_info.stream_offset < _session_info.file_size) {
+			const uint32_t in_flight = _session_info.stream_offset - _session_info.window_acked_offset;
+
+			if (in_flight >= _session_info.window_size * kMaxDataLength) {
+				// window is full, wait for the next ack
+				break;
+			}
+
+			payload->offset = _session_info.stream_offset;
+
+		} else if (!_session_info.window_eof_sent) {
+			payload->offset = _session_info.file_size;
+			error_code = kErrEOF;
+			_session_info.window_eof_sent = true;
+
+		} else {
+			break;
+		}
+
+		payload->seq_number = _session_info.stream_seq_number++;
+		payload->session = 0;
+		payload->opcode = kRspAck;
+		payload->req_opcode = kCmdWindowData; // tells the data apart from the reply to kCmdWindowReadFile
+		payload->burst_complete = 0;
+		payload->padding = 0;
+
+		if (error_code == kErrNone) {
+			int bytes_read = _read_cached(payload->offset, &payload->data[0], kMaxDataLength);
+
+			if (bytes_read < 0) {
+				error_code = kErrFailErrno;
+				PX4_WARN("window download: read fail");
+
+			} else if (bytes_read == 0) {
+				// file got shorter
+				error_code = kErrEOF;
+				_session_info.window_eof_sent = true;
+
+				if (payload->offset == _session_info.stream_offset) {
+					_session_info.file_size = _session_info.stream_offset;
+				}
+
+			} else {
+				payload->size = bytes_read;
+
+				if (payload->offset == _session_info.stream_offset) {
+					_session_info.stream_offset += bytes_read;
+				}
+			}
+		}
+
+		if (error_code != kErrNone) {
+			payload->opcode = kRspNak;
+			payload->size = 1;
+			uint8_t *pData = &payload->data[0];
+			*pData = error_code; // Straight reference to data[0] is causing bogus gcc array subscript error
+
+			if (error_code == kErrFailErrno) {
+				payload->size = 2;
+				payload->data[1] = _our_errno;
+				_session_info.window_download = false;
+			}
+		}
+
+		ftp_msg.target_system = _session_info.stream_target_system_id;
+		ftp_msg.target_network = 0;
+		ftp_msg.target_component = _session_info.stream_target_component_id;
+		_reply(&ftp_msg);
+
+		// these are not responses to a request, a repeated request must not get them again
+		_last_reply_valid = false;
+
+#ifndef MAVLINK_FTP_UNIT_TEST
+		max_bytes_to_send -= get_size();
+#endif
+	}
+}
+
 bool MavlinkFTP::_validatePathIsWritable(const char *path)
 {
 #ifdef __PX4_NUTTX
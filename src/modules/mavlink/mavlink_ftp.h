@@ -109,6 +109,13 @@ public:
 		kCmdCalcFileCRC32,	///< Calculate CRC32 for file at <path>
 		kCmdBurstReadFile,	///< Burst download session file
 
+		// Windowed download: PX4 extension, not part of the MAVLink FTP specification.
+		// Clients must only use it if the server acks kCmdWindowReadFile, older servers nak it with
+		// kErrUnknownCommand.
+		kCmdWindowReadFile,	///< Windowed download of session file from <offset>, data: window size in packets
+		kCmdWindowAck,		///< Windowed download received up to <offset>, data: offsets to resend
+		kCmdWindowData,		///< req_opcode of the data and EOF packets of a windowed download, not a command
+
 		kRspAck = 128,		///< Ack response
 		kRspNak			///< Nak response
 	};
@@ -141,6 +148,8 @@ private:
 	ErrorCode	_workOpen(PayloadHeader *payload, int oflag);
 	ErrorCode	_workRead(PayloadHeader *payload);
 	ErrorCode	_workBurst(PayloadHeader *payload, uint8_t target_system_id, uint8_t target_component_id);
+	ErrorCode	_workWindowRead(PayloadHeader *payload, uint8_t target_system_id, uint8_t target_component_id);
+	ErrorCode	_workWindowAck(PayloadHeader *payload);
 	ErrorCode	_workWrite(PayloadHeader *payload);
 	ErrorCode	_workTerminate(PayloadHeader *payload);
 	ErrorCode	_workReset(PayloadHeader *payload);
@@ -157,6 +166,18 @@ private:
 
 	bool _validatePathIsWritable(const char *path);
 
+	/**
+	 * Read from the session file through the read-ahead cache.
+	 * @return number of bytes read, -1 on error (_our_errno is set)
+	 */
+	int _read_cached(uint32_t offset, uint8_t *data, uint8_t size);
+
+	/**
+	 * Send the packets of a windowed download: requested resends first, then new data
+	 * as long as the window allows it.
+	 */
+	void _send_window();
+
 	/**
 	 * make sure that the working buffers _work_buffer* are allocated
 	 * @return true if buffers exist, false if allocation failed
@@ -170,6 +191,17 @@ private:
 	/// @brief Maximum data size in RequestHeader::data
 	static const uint8_t	kMaxDataLength = MAVLINK_MSG_FILE_TRANSFER_PROTOCOL_FIELD_PAYLOAD_LEN - sizeof(PayloadHeader);
 
+	/// @brief Maximum number of offsets to resend that are kept from a kCmdWindowAck
+	static const uint8_t	kMaxWindowResend = 16;
+
+	/// @brief Read-ahead cache size in packets, the download window is limited to half of it
+#if defined(__PX4_POSIX)
+	static const uint16_t	kReadCachePackets = 256;
+#else
+	static const uint16_t	kReadCachePackets = 16;
+#endif
+	static const uint16_t	kMaxWindowSize = kReadCachePackets / 2;
+
 	struct SessionInfo {
 		int		fd;
 		uint32_t	file_size;
@@ -179,6 +211,12 @@ private:
 		uint8_t		stream_target_system_id;
 		uint8_t         stream_target_component_id;
 		unsigned	stream_chunk_transmitted;
+		bool		window_download;
+		bool		window_eof_sent;
+		uint16_t	window_size;		///< maximum number of packets in flight
+		uint32_t	window_acked_offset;	///< the client has received everything below this offset
+		uint32_t	window_resend[kMaxWindowResend];
+		uint8_t		window_resend_count;
 	};
 	struct SessionInfo _session_info {};	///< Session info, fd=-1 for no active session
 
@@ -198,6 +236,12 @@ private:
 	static constexpr int _work_buffer2_len = 256;
 	hrt_abstime _last_work_buffer_access{0}; ///< timestamp when the buffers were last accessed
 
+	/* read-ahead cache of the session file, allocated on the first read and freed with the work buffers */
+	uint8_t *_read_cache{nullptr};
+	static constexpr uint32_t _read_cache_len = kReadCachePackets * kMaxDataLength;
+	uint32_t _read_cache_offset{0};	///< file offset of _read_cache[0]
+	uint32_t _read_cache_fill{0};	///< number of valid bytes in the cache
+
 	// prepend a root directory to each file/dir access to avoid enumerating the full FS tree (e.g. on Linux).
 	// Note that requests can still fall outside of the root dir by using ../..
 #ifdef MAVLINK_FTP_UNIT_TEST
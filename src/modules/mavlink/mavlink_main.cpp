@@ -701,9 +701,9 @@ Mavlink::get_free_tx_buf()
 	// if we are using network sockets, return max length of one packet
 	if (get_protocol() == Protocol::UDP) {
 # if defined(__PX4_POSIX)
-		return  1500 * 10; // Speed up FTP transfers
+		buf_free = 1500 * 10; // Speed up FTP transfers
 # else
-		return  1500;
+		buf_free = 1500;
 # endif /* defined(__PX4_POSIX) */
 
 	} else
@@ -732,52 +732,101 @@ Mavlink::get_free_tx_buf()
 		}
 	}
 
-	return buf_free;
+	// frames in the transmit queue are not written yet
+	const int queued = _tx_queue.queued_bytes();
+
+	return (buf_free > queued) ? buf_free - queued : 0;
 }
 
 void Mavlink::send_start(int length)
 {
-	pthread_mutex_lock(&_send_mutex);
-	_last_write_try_time = hrt_absolute_time();
+	// Frames of other threads wait for the main loop. If they filled up the queue (e.g. the receiver
+	// answering a burst of requests), send them now or wait for the sending thread instead of dropping.
+	for (int i = 0; _tx_queue.full() && (i < TX_QUEUE_FULL_WAIT_ATTEMPTS); i++) {
+		send_queued_frames();
+
+		if (_tx_queue.full()) {
+			px4_usleep(TX_QUEUE_FULL_WAIT_US);
+		}
+	}
 
 	// check if there is space in the buffer
-	if (length > (int)get_free_tx_buf()) {
+	if (length > (int)get_free_tx_buf() || !_tx_queue.begin(length)) {
 		// not enough space in buffer to send
-		count_txerrbytes(length);
-
-		_tstatus.tx_buffer_overruns++;
+		_tx_overrun_bytes.fetch_add(length);
+		_tx_buffer_overruns.fetch_add(1);
+	}
+}
 
-		// prevent writes
-		_tx_buffer_low = true;
+void Mavlink::send_finish()
+{
+	// Only the main thread writes to the link. Frames of other threads (e.g. the receiver) wait for
+	// the next main loop iteration, so they never block on a full link or send the main thread's frames.
+	if (_tx_queue.commit() && pthread_equal(pthread_self(), _main_thread)) {
+		send_queued_frames();
+	}
+}
 
-	} else {
-		_tx_buffer_low = false;
+void Mavlink::send_bytes(const uint8_t *buf, unsigned packet_len)
+{
+	if (!_tx_queue.append(buf, packet_len)) {
+		perf_count(_send_byte_error_perf);
 	}
 }
 
-void Mavlink::send_finish()
+void Mavlink::send_queued_frames(bool flush_batch)
 {
-	if (_tx_buffer_low || (_buf_fill == 0)) {
-		pthread_mutex_unlock(&_send_mutex);
-		return;
+	// Frames committed by other threads while sending are picked up before returning.
+	while (_tx_queue.try_lock_consumer()) {
+		if (_tx_queue.ready()) {
+			_last_write_try_time = hrt_absolute_time();
+			_tx_queue.consume([this](const uint8_t *buf, unsigned len) { send_packet(buf, len); });
+		}
+
+#if defined(MAVLINK_UDP_BATCH)
+
+		if (flush_batch && _udp_batch) {
+			flush_udp_batch();
+		}
+
+#endif // MAVLINK_UDP_BATCH
+
+		_tx_queue.unlock_consumer();
+
+		if (!_tx_queue.ready()) {
+			break;
+		}
 	}
+}
 
+void Mavlink::send_packet(const uint8_t *buf, unsigned len)
+{
 	int ret = -1;
 
 	// send message to UART
 	if (get_protocol() == Protocol::SERIAL) {
-		ret = ::write(_uart_fd, _buf, _buf_fill);
+		ret = ::write(_uart_fd, buf, len);
 	}
 
 #if defined(MAVLINK_UDP)
 
 	else if (get_protocol() == Protocol::UDP) {
 
+# if defined(MAVLINK_UDP_BATCH)
+
+		if (_udp_batch) {
+			// sent and accounted for with the next flush of the batch
+			queue_udp_packet(buf, len);
+			return;
+		}
+
+# endif // MAVLINK_UDP_BATCH
+
 # if defined(CONFIG_NET)
 
 		if (_src_addr_initialized) {
 # endif // CONFIG_NET
-			ret = sendto(_socket_fd, _buf, _buf_fill, 0, (struct sockaddr *)&_src_addr, sizeof(_src_addr));
+			ret = sendto(_socket_fd, buf, len, 0, (struct sockaddr *)&_src_addr, sizeof(_src_addr));
 # if defined(CONFIG_NET)
 		}
 
@@ -790,9 +839,9 @@ void Mavlink::send_finish()
 				find_broadcast_address();
 			}
 
-			if (_broadcast_address_found && _buf_fill > 0) {
+			if (_broadcast_address_found && len > 0) {
 
-				int bret = sendto(_socket_fd, _buf, _buf_fill, 0, (struct sockaddr *)&_bcast_addr, sizeof(_bcast_addr));
+				int bret = sendto(_socket_fd, buf, len, 0, (struct sockaddr *)&_bcast_addr, sizeof(_bcast_addr));
 
 				if (bret <= 0) {
 					if (!_broadcast_failed_warned) {
@@ -809,32 +858,65 @@ void Mavlink::send_finish()
 
 #endif // MAVLINK_UDP
 
-	if (ret == (int)_buf_fill) {
+	if (ret == (int)len) {
 		_tstatus.tx_message_count++;
-		count_txbytes(_buf_fill);
+		count_txbytes(len);
 		_last_write_success_time = _last_write_try_time;
 
 	} else {
-		count_txerrbytes(_buf_fill);
+		count_txerrbytes(len);
 	}
+}
 
-	_buf_fill = 0;
+#if defined(MAVLINK_UDP_BATCH)
+void Mavlink::queue_udp_packet(const uint8_t *buf, unsigned len)
+{
+	if (_udp_batch->full()) {
+		flush_udp_batch();
+	}
 
-	pthread_mutex_unlock(&_send_mutex);
+	_udp_batch->add(buf, len, _src_addr);
+
+	if ((_mode != MAVLINK_MODE_ONBOARD) && broadcast_enabled() &&
+	    (!get_client_source_initialized() || !is_gcs_connected())) {
+
+		if (!_broadcast_address_found) {
+			find_broadcast_address();
+		}
+
+		if (_broadcast_address_found) {
+			if (_udp_batch->full()) {
+				flush_udp_batch();
+			}
+
+			// broadcast copies are not accounted for, like in send_packet()
+			_udp_batch->add(buf, len, _bcast_addr, false);
+		}
+	}
 }
 
-void Mavlink::send_bytes(const uint8_t *buf, unsigned packet_len)
+void Mavlink::flush_udp_batch()
 {
-	if (!_tx_buffer_low) {
-		if (_buf_fill + packet_len < sizeof(_buf)) {
-			memcpy(&_buf[_buf_fill], buf, packet_len);
-			_buf_fill += packet_len;
+	if (_udp_batch->empty()) {
+		return;
+	}
 
-		} else {
-			perf_count(_send_byte_error_perf);
-		}
+	unsigned sent_packets = 0;
+	unsigned sent_bytes = 0;
+	unsigned failed_bytes = 0;
+	_udp_batch->flush(sent_packets, sent_bytes, failed_bytes);
+
+	if (sent_packets > 0) {
+		_tstatus.tx_message_count += sent_packets;
+		count_txbytes(sent_bytes);
+		_last_write_success_time = _last_write_try_time;
+	}
+
+	if (failed_bytes > 0) {
+		count_txerrbytes(failed_bytes);
 	}
 }
+#endif // MAVLINK_UDP_BATCH
 
 #ifdef MAVLINK_UDP
 void Mavlink::find_broadcast_address()
@@ -1171,10 +1253,10 @@ Mavlink::configure_stream(const char *stream_name, const float rate)
 			} else {
 				/* delete stream */
 				_streams.deleteNode(stream);
-				return OK; // must finish with loop after node is deleted
 			}
 
-			return OK;
+			_stream_scheduler.reschedule();
+			return OK; // must finish with loop after node is deleted
 		}
 	}
 
@@ -1185,6 +1267,7 @@ Mavlink::configure_stream(const char *stream_name, const float rate)
 	if (stream != nullptr) {
 		stream->set_interval(interval);
 		_streams.add(stream);
+		_stream_scheduler.reschedule();
 
 		return OK;
 	}
@@ -1797,6 +1880,8 @@ Mavlink::configure_streams_to_default(const char *configure_single_stream)
 int
 Mavlink::task_main(int argc, char *argv[])
 {
+	_main_thread = pthread_self();
+
 	// If stdin, stdout and/or stderr file descriptors (0, 1, 2)
 	// are not open when mavlink module starts (as might be the case for USB auto-start),
 	// use default /dev/null so that these numbers are not used by other other files.
@@ -1849,7 +1934,7 @@ Mavlink::task_main(int argc, char *argv[])
 	int temp_int_arg;
 #endif
 
-	while ((ch = px4_getopt(argc, argv, "b:r:d:n:u:o:m:t:c:fswxzZp", &myoptind, &myoptarg)) != EOF) {
+	while ((ch = px4_getopt(argc, argv, "b:r:d:n:u:o:m:t:c:fswxzZpB", &myoptind, &myoptarg)) != EOF) {
 		switch (ch) {
 		case 'b':
 			if (px4_get_parameter_value(myoptarg, _baudrate) != 0) {
@@ -2061,6 +2146,14 @@ Mavlink::task_main(int argc, char *argv[])
 			_flow_control = FLOW_CONTROL_OFF;
 			break;
 
+		case 'B':
+#if defined(MAVLINK_UDP_BATCH)
+			_udp_batch_on = true;
+#else
+			PX4_WARN("UDP batching not supported");
+#endif // MAVLINK_UDP_BATCH
+			break;
+
 		default:
 			err_flag = true;
 			break;
@@ -2151,7 +2244,6 @@ Mavlink::task_main(int argc, char *argv[])
 	}
 
 	pthread_mutex_init(&_message_buffer_mutex, nullptr);
-	pthread_mutex_init(&_send_mutex, nullptr);
 	pthread_mutex_init(&_radio_status_mutex, nullptr);
 
 	/* if we are passing on mavlink messages, we need to prepare a buffer for this instance */
@@ -2222,6 +2314,18 @@ Mavlink::task_main(int argc, char *argv[])
 	/* init socket if necessary */
 	if (get_protocol() == Protocol::UDP) {
 		init_udp();
+
+# if defined(MAVLINK_UDP_BATCH)
+
+		if (_udp_batch_on && (_socket_fd >= 0)) {
+			_udp_batch = new MavlinkUdpBatch();
+
+			if (_udp_batch) {
+				_udp_batch->init(_socket_fd);
+			}
+		}
+
+# endif // MAVLINK_UDP_BATCH
 	}
 
 #endif // MAVLINK_UDP
@@ -2245,6 +2349,9 @@ Mavlink::task_main(int argc, char *argv[])
 		/* main loop */
 		px4_usleep(_main_loop_delay);
 
+		// frames queued from other threads (e.g. the receiver) while the main loop was sleeping
+		send_queued_frames(true);
+
 		if (!should_transmit()) {
 			check_requested_subscriptions();
 			continue;
@@ -2438,20 +2545,16 @@ Mavlink::task_main(int argc, char *argv[])
 
 		check_requested_subscriptions();
 
-		/* update streams */
-		for (const auto &stream : _streams) {
-			stream->update(t);
+		/* update streams which are due */
+		_stream_scheduler.update(_streams, t);
 
-			if (!_first_heartbeat_sent) {
-				if (_mode == MAVLINK_MODE_IRIDIUM) {
-					if (stream->get_id() == MAVLINK_MSG_ID_HIGH_LATENCY2) {
-						_first_heartbeat_sent = stream->first_message_sent();
-					}
+		if (!_first_heartbeat_sent) {
+			const uint16_t heartbeat_id = (_mode == MAVLINK_MODE_IRIDIUM) ? MAVLINK_MSG_ID_HIGH_LATENCY2 :
+						      MAVLINK_MSG_ID_HEARTBEAT;
 
-				} else {
-					if (stream->get_id() == MAVLINK_MSG_ID_HEARTBEAT) {
-						_first_heartbeat_sent = stream->first_message_sent();
-					}
+			for (const auto &stream : _streams) {
+				if (stream->get_id() == heartbeat_id) {
+					_first_heartbeat_sent = stream->first_message_sent();
 				}
 			}
 		}
@@ -2532,13 +2635,18 @@ Mavlink::task_main(int argc, char *argv[])
 			if (_bytes_timestamp != 0) {
 				const float dt = (t - _bytes_timestamp) * 1e-6f;
 
+				_bytes_txerr += _tx_overrun_bytes.fetch_and(0);
+
 				_tstatus.tx_rate_avg = _bytes_tx / dt;
 				_tstatus.tx_error_rate_avg = _bytes_txerr / dt;
 				_tstatus.rx_rate_avg = _bytes_rx / dt;
 
+				_loop_load_avg = _loop_elapsed * 1e-6f / dt;
+
 				_bytes_tx = 0;
 				_bytes_txerr = 0;
 				_bytes_rx = 0;
+				_loop_elapsed = 0;
 			}
 
 			_bytes_timestamp = t;
@@ -2549,6 +2657,9 @@ Mavlink::task_main(int argc, char *argv[])
 			publish_telemetry_status();
 		}
 
+		send_queued_frames(true);
+
+		_loop_elapsed += hrt_elapsed_time(&t);
 		perf_end(_loop_perf);
 	}
 
@@ -2567,6 +2678,11 @@ Mavlink::task_main(int argc, char *argv[])
 		::close(_uart_fd);
 	}
 
+#if defined(MAVLINK_UDP_BATCH)
+	delete _udp_batch;
+	_udp_batch = nullptr;
+#endif // MAVLINK_UDP_BATCH
+
 	if (_socket_fd >= 0) {
 		close(_socket_fd);
 		_socket_fd = -1;
@@ -2577,7 +2693,6 @@ Mavlink::task_main(int argc, char *argv[])
 		_mavlink_ulog = nullptr;
 	}
 
-	pthread_mutex_destroy(&_send_mutex);
 	pthread_mutex_destroy(&_radio_status_mutex);
 	pthread_mutex_destroy(&_message_buffer_mutex);
 
@@ -2673,6 +2788,7 @@ void Mavlink::publish_telemetry_status()
 	_tstatus.mavlink_v2 = (_protocol_version == 2);
 
 	_tstatus.streams = _streams.size();
+	_tstatus.tx_buffer_overruns = _tx_buffer_overruns.load();
 
 	// telemetry_status is also updated from the receiver thread, but never the same fields
 	_tstatus.timestamp = hrt_absolute_time();
@@ -2874,6 +2990,7 @@ Mavlink::display_status()
 	printf("\t  tx rate max: %i B/s\n", _datarate);
 	printf("\t  rx: %.1f B/s\n", (double)_tstatus.rx_rate_avg);
 	printf("\t  rx loss: %.1f%%\n", (double)_tstatus.rx_message_lost_rate);
+	_tx_queue.print_status();
 
 #if !defined(CONSTRAINED_FLASH)
 	_receiver.print_detailed_rx_stats();
@@ -2900,6 +3017,13 @@ Mavlink::display_status()
 		printf("UDP (%hu, remote port: %hu)\n", _network_port, _remote_port);
 		printf("\tBroadcast enabled: %s\n",
 		       broadcast_enabled() ? "YES" : "NO");
+#if defined(MAVLINK_UDP_BATCH)
+
+		if (_udp_batch) {
+			_udp_batch->print_status();
+		}
+
+#endif // MAVLINK_UDP_BATCH
 #if defined(CONFIG_NET_IGMP) && defined(CONFIG_NET_ROUTE)
 		printf("\tMulticast enabled: %s\n",
 		       multicast_enabled() ? "YES" : "NO");
@@ -2932,6 +3056,9 @@ Mavlink::display_status()
 void
 Mavlink::display_status_streams()
 {
+	printf("\tmain loop CPU: %.2f%%\n", (double)(_loop_load_avg * 100.f));
+	_stream_scheduler.print_status();
+
 	printf("\t%-20s%-16s %s\n", "Name", "Rate Config (current) [Hz]", "Message Size (if active) [B]");
 
 	const float rate_mult = _rate_mult;
@@ -3273,6 +3400,7 @@ $ mavlink stream -u 14556 -s HIGHRES_IMU -r 50
 	PRINT_MODULE_USAGE_PARAM_FLAG('x', "Enable FTP", true);
 	PRINT_MODULE_USAGE_PARAM_FLAG('z', "Force hardware flow control always on", true);
 	PRINT_MODULE_USAGE_PARAM_FLAG('Z', "Force hardware flow control always off", true);
+	PRINT_MODULE_USAGE_PARAM_FLAG('B', "Batch UDP packets of a loop iteration into one sendmmsg() (Linux only)", true);
 
 	PRINT_MODULE_USAGE_COMMAND_DESCR("stop-all", "Stop all instances");
 
@@ -84,6 +84,9 @@
 #include "mavlink_messages.h"
 #include "mavlink_receiver.h"
 #include "mavlink_shell.h"
+#include "mavlink_stream_scheduler.h"
+#include "mavlink_tx_queue.h"
+#include "mavlink_udp_batch.h"
 #include "mavlink_ulog.h"
 
 #define DEFAULT_BAUD_RATE       57600
@@ -329,17 +332,18 @@ public:
 	void 			set_protocol(Protocol p) { _protocol = p; }
 
 	/**
-	 * This is the beginning of a MAVLINK_START_UART_SEND/MAVLINK_END_UART_SEND transaction
+	 * This is the beginning of a MAVLINK_START_UART_SEND/MAVLINK_END_UART_SEND transaction,
+	 * it claims a frame in the transmit queue for the calling thread.
 	 */
 	void 			send_start(int length);
 
 	/**
-	 * Buffer bytes to send out on the link.
+	 * Buffer bytes of the frame of the calling thread.
 	 */
 	void			send_bytes(const uint8_t *buf, unsigned packet_len);
 
 	/**
-	 * Flush the transmit buffer and send one MAVLink packet
+	 * Queue the frame of the calling thread and send the queue, unless another thread is sending it already
 	 */
 	void             	send_finish();
 
@@ -551,6 +555,9 @@ private:
 	static constexpr int	MAVLINK_MAX_INTERVAL{10000};
 	static constexpr float	MAVLINK_MIN_MULTIPLIER{0.0005f};
 
+	static constexpr int	TX_QUEUE_FULL_WAIT_ATTEMPTS{10};
+	static constexpr int	TX_QUEUE_FULL_WAIT_US{1000};
+
 	mavlink_message_t	_mavlink_buffer {};
 	mavlink_status_t	_mavlink_status {};
 
@@ -565,6 +572,7 @@ private:
 	unsigned		_main_loop_delay{1000};	/**< mainloop delay, depends on data rate */
 
 	List<MavlinkStream *>		_streams;
+	MavlinkStreamScheduler		_stream_scheduler{this};
 
 	MavlinkShell		*_mavlink_shell{nullptr};
 	MavlinkULog		*_mavlink_ulog{nullptr};
@@ -615,6 +623,9 @@ private:
 	unsigned		_bytes_rx{0};
 	hrt_abstime		_bytes_timestamp{0};
 
+	hrt_abstime		_loop_elapsed{0};	///< time spent in the main loop since _bytes_timestamp
+	float			_loop_load_avg{0.f};
+
 #if defined(MAVLINK_UDP)
 	BROADCAST_MODE		_mav_broadcast {BROADCAST_MODE_OFF};
 
@@ -629,12 +640,17 @@ private:
 
 	unsigned short		_network_port{14556};
 	unsigned short		_remote_port{DEFAULT_REMOTE_PORT_UDP};
-#endif // MAVLINK_UDP
 
-	uint8_t			_buf[MAVLINK_MAX_PACKET_LEN] {};
-	unsigned		_buf_fill{0};
+# if defined(MAVLINK_UDP_BATCH)
+	bool			_udp_batch_on{false};
+	MavlinkUdpBatch		*_udp_batch{nullptr};
+# endif // MAVLINK_UDP_BATCH
+#endif // MAVLINK_UDP
 
-	bool			_tx_buffer_low{false};
+	MavlinkTxQueue		_tx_queue{};
+	pthread_t		_main_thread{};		///< sends the queued frames, other threads only if the queue is full
+	px4::atomic<uint32_t>	_tx_buffer_overruns{0};
+	px4::atomic<uint32_t>	_tx_overrun_bytes{0};	///< added to _bytes_txerr by the main loop
 
 	const char 		*_interface_name{nullptr};
 
@@ -650,7 +666,6 @@ private:
 	pthread_mutex_t		_message_buffer_mutex{};
 	VariableLengthRingbuffer _message_buffer{};
 
-	pthread_mutex_t		_send_mutex {};
 	pthread_mutex_t         _radio_status_mutex {};
 
 	DEFINE_PARAMETERS(
@@ -724,8 +739,32 @@ private:
 	void find_broadcast_address();
 
 	void init_udp();
+
+# if defined(MAVLINK_UDP_BATCH)
+	/**
+	 * Queue the packet for the destinations send_packet() would send it to
+	 */
+	void queue_udp_packet(const uint8_t *buf, unsigned len);
+
+	/**
+	 * Send the queued UDP packets, the transmit queue consumer must be locked
+	 */
+	void flush_udp_batch();
+# endif // MAVLINK_UDP_BATCH
 #endif // MAVLINK_UDP
 
+	/**
+	 * Send the frames in the transmit queue, called from the main thread or when the queue is full.
+	 *
+	 * @param flush_batch send the queued UDP packets too
+	 */
+	void send_queued_frames(bool flush_batch = false);
+
+	/**
+	 * Write a frame to the link, the transmit queue consumer must be locked
+	 */
+	void send_packet(const uint8_t *buf, unsigned len);
+
 
 	bool set_channel();
 
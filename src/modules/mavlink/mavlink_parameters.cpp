@@ -129,6 +129,21 @@ MavlinkParametersManager::handle_message(const mavlink_message_t *msg)
 					     (param_type(param) == PARAM_TYPE_FLOAT && set.param_type == MAV_PARAM_TYPE_REAL32))) {
 					PX4_ERR("param types mismatch param: %s", name);
 
+				} else if (_param_set_batching) {
+					// PARAM_SETs received together (e.g. a GCS uploading a parameter file) are notified at once
+					// in end_param_set_batch(), which also sends the acknowledgements after the notification.
+					if (_param_set_acks_count == PARAM_SET_BATCH_MAX) {
+						end_param_set_batch();
+						begin_param_set_batch();
+					}
+
+					if (_param_set_acks_count == 0) {
+						param_notify_batch_begin();
+					}
+
+					param_set(param, &(set.param_value));
+					_param_set_acks[_param_set_acks_count++] = param;
+
 				} else {
 					// According to the mavlink spec we should always acknowledge a write operation.
 					param_set(param, &(set.param_value));
@@ -284,6 +299,29 @@ MavlinkParametersManager::handle_message(const mavlink_message_t *msg)
 	}
 }
 
+void
+MavlinkParametersManager::begin_param_set_batch()
+{
+	_param_set_batching = true;
+}
+
+void
+MavlinkParametersManager::end_param_set_batch()
+{
+	_param_set_batching = false;
+
+	if (_param_set_acks_count > 0) {
+		param_notify_batch_end();
+
+		// According to the mavlink spec we should always acknowledge a write operation.
+		for (unsigned i = 0; i < _param_set_acks_count; i++) {
+			send_param(_param_set_acks[i]);
+		}
+
+		_param_set_acks_count = 0;
+	}
+}
+
 void
 MavlinkParametersManager::send()
 {
@@ -77,6 +77,17 @@ public:
 
 	void handle_message(const mavlink_message_t *msg);
 
+	/**
+	 * Collect the PARAM_SET messages handled until end_param_set_batch() into a single
+	 * parameter_update notification, e.g. all messages of one read from the link.
+	 */
+	void begin_param_set_batch();
+
+	/**
+	 * Publish the parameter_update notification of the batch, then acknowledge its PARAM_SETs.
+	 */
+	void end_param_set_batch();
+
 private:
 	int		_send_all_index{-1};
 
@@ -159,6 +170,12 @@ protected:
 	hrt_abstime _param_update_time{0};
 	int _param_update_index{0};
 
+	// PARAM_SETs of the current batch, acknowledged once the batch is notified
+	static constexpr unsigned PARAM_SET_BATCH_MAX{16};
+	param_t _param_set_acks[PARAM_SET_BATCH_MAX] {};
+	unsigned _param_set_acks_count{0};
+	bool _param_set_batching{false};
+
 	Mavlink *_mavlink;
 
 	bool _first_send{false};
@@ -3114,6 +3114,54 @@ MavlinkReceiver::handle_message_gimbal_device_attitude_status(mavlink_message_t
 	_gimbal_device_attitude_status_pub.publish(gimbal_attitude_status);
 }
 
+void
+MavlinkReceiver::handle_received_message(mavlink_message_t *msg)
+{
+	/* check if we received version 2 and request a switch. */
+	if (!(_mavlink->get_status()->flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1)) {
+		/* this will only switch to proto version 2 if allowed in settings */
+		_mavlink->set_proto_version(2);
+	}
+
+	/* handle generic messages and commands */
+	handle_message(msg);
+
+	/* handle packet with mission manager */
+	_mission_manager.handle_message(msg);
+
+	/* handle packet with parameter component */
+	if (_mavlink->boot_complete()) {
+		// make sure mavlink app has booted before we start processing parameter sync
+		_parameters_manager.handle_message(msg);
+
+	} else {
+		if (hrt_elapsed_time(&_mavlink->get_first_start_time()) > 20_s) {
+			PX4_ERR("system boot did not complete in 20 seconds");
+			_mavlink->set_boot_complete();
+		}
+	}
+
+	if (_mavlink->ftp_enabled()) {
+		/* handle packet with ftp component */
+		_mavlink_ftp.handle_message(msg);
+	}
+
+	/* handle packet with log component */
+	_mavlink_log_handler.handle_message(msg);
+
+	/* handle packet with timesync component */
+	_mavlink_timesync.handle_message(msg);
+
+	/* handle packet with parent object */
+	_mavlink->handle_message(msg);
+
+	update_rx_stats(*msg);
+
+	if (_message_statistics_enabled) {
+		update_message_statistics(*msg);
+	}
+}
+
 void
 MavlinkReceiver::run()
 {
@@ -3219,54 +3267,16 @@ MavlinkReceiver::run()
 			if (_mavlink->get_protocol() != Protocol::UDP || _mavlink->get_client_source_initialized()) {
 #endif // MAVLINK_UDP
 
-				/* if read failed, this loop won't execute */
-				for (ssize_t i = 0; i < nread; i++) {
-					if (mavlink_parse_char(_mavlink->get_channel(), buf[i], &msg, &_status)) {
-
-						/* check if we received version 2 and request a switch. */
-						if (!(_mavlink->get_status()->flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1)) {
-							/* this will only switch to proto version 2 if allowed in settings */
-							_mavlink->set_proto_version(2);
-						}
-
-						/* handle generic messages and commands */
-						handle_message(&msg);
-
-						/* handle packet with mission manager */
-						_mission_manager.handle_message(&msg);
-
-						/* handle packet with parameter component */
-						if (_mavlink->boot_complete()) {
-							// make sure mavlink app has booted before we start processing parameter sync
-							_parameters_manager.handle_message(&msg);
-
-						} else {
-							if (hrt_elapsed_time(&_mavlink->get_first_start_time()) > 20_s) {
-								PX4_ERR("system boot did not complete in 20 seconds");
-								_mavlink->set_boot_complete();
-							}
-						}
-
-						if (_mavlink->ftp_enabled()) {
-							/* handle packet with ftp component */
-							_mavlink_ftp.handle_message(&msg);
-						}
-
-						/* handle packet with log component */
-						_mavlink_log_handler.handle_message(&msg);
-
-						/* handle packet with timesync component */
-						_mavlink_timesync.handle_message(&msg);
-
-						/* handle packet with parent object */
-						_mavlink->handle_message(&msg);
+				/* parse received bytes, complete frames are taken as a whole */
+				if (nread > 0) {
+					// parameters set by the messages of one read (e.g. a GCS uploading a parameter file) are notified once
+					_parameters_manager.begin_param_set_batch();
 
-						update_rx_stats(msg);
+					_frame_parser.parse(_mavlink->get_channel(), buf, nread, msg, _status, [this](mavlink_message_t &message) {
+						handle_received_message(&message);
+					});
 
-						if (_message_statistics_enabled) {
-							update_message_statistics(msg);
-						}
-					}
+					_parameters_manager.end_param_set_batch();
 				}
 
 				/* count received bytes (nread will be -1 on read error) */
@@ -3508,6 +3518,8 @@ void MavlinkReceiver::print_detailed_rx_stats() const
 			}
 		}
 	}
+
+	_frame_parser.print_status();
 }
 
 void MavlinkReceiver::start()
@@ -43,6 +43,7 @@
 
 #pragma once
 
+#include "mavlink_frame_parser.h"
 #include "mavlink_ftp.h"
 #include "mavlink_log_handler.h"
 #include "mavlink_mission.h"
@@ -156,6 +157,11 @@ private:
 
 	void handle_message(mavlink_message_t *msg);
 
+	/**
+	 * Pass a received message to all handlers
+	 */
+	void handle_received_message(mavlink_message_t *msg);
+
 	void handle_message_adsb_vehicle(mavlink_message_t *msg);
 	void handle_message_att_pos_mocap(mavlink_message_t *msg);
 	void handle_message_battery_status(mavlink_message_t *msg);
@@ -255,6 +261,7 @@ private:
 	MavlinkTimesync			_mavlink_timesync;
 	MavlinkStatustextHandler	_mavlink_statustext_handler;
 
+	MavlinkFrameParser		_frame_parser;
 	mavlink_status_t		_status{}; ///< receiver status, used for mavlink_parse_char()
 
 	orb_advert_t _mavlink_log_pub{nullptr};
@@ -50,6 +50,40 @@ MavlinkStream::MavlinkStream(Mavlink *mavlink) :
 	_last_sent = hrt_absolute_time();
 }
 
+int
+MavlinkStream::current_interval()
+{
+	int interval = _interval;
+
+	if (!const_rate()) {
+		interval /= _mavlink->get_rate_mult();
+	}
+
+	return interval;
+}
+
+hrt_abstime
+MavlinkStream::next_update()
+{
+	if (_last_sent == 0) {
+		return 0;
+	}
+
+	const int interval = current_interval();
+
+	if (interval == 0) {
+		return UINT64_MAX;
+
+	} else if (interval < 0) {
+		return 0;
+	}
+
+	// first time at which update() sees dt > interval - 30% of the main loop delay
+	const int64_t threshold = interval - (_mavlink->get_main_loop_delay() / 10) * 3;
+
+	return _last_sent + ((threshold >= 0) ? threshold + 1 : 0);
+}
+
 /**
  * Update subscriptions and send message if necessary
  */
@@ -82,11 +116,7 @@ MavlinkStream::update(const hrt_abstime &t)
 	}
 
 	int64_t dt = t - _last_sent;
-	int interval = _interval;
-
-	if (!const_rate()) {
-		interval /= _mavlink->get_rate_mult();
-	}
+	const int interval = current_interval();
 
 	// We don't need to send anything if the inverval is 0. send() will be called manually.
 	if (interval == 0) {
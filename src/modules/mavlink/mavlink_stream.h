@@ -122,6 +122,20 @@ public:
 	 */
 	void reset_last_sent() { _last_sent = 0; }
 
+	/**
+	 * Earliest time at which update() can send the next message.
+	 *
+	 * @return 0 if update() needs to be called on the next iteration,
+	 *         UINT64_MAX if the stream is only sent on request
+	 */
+	hrt_abstime next_update();
+
+	/**
+	 * @return true if update() needs to be called at every iteration of the
+	 * mavlink module (stream collects data in update_data())
+	 */
+	virtual bool always_update() const { return false; }
+
 protected:
 	Mavlink      *const _mavlink;
 	int _interval{1000000};		///< if set to negative value = unlimited rate
@@ -137,6 +151,11 @@ protected:
 	virtual void update_data() { }
 
 private:
+	/**
+	 * @return the interval scaled by the rate multiplier, 0 if disabled, negative if unlimited
+	 */
+	int current_interval();
+
 	hrt_abstime _last_sent{0};
 	bool _first_message_sent{false};
 };
@@ -0,0 +1,209 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file mavlink_stream_scheduler.cpp
+ * Deadline ordered scheduling of the mavlink streams of an instance.
+ */
+
+#include "mavlink_stream_scheduler.h"
+#include "mavlink_main.h"
+#include "mavlink_stream.h"
+
+void
+MavlinkStreamScheduler::rebuild(List<MavlinkStream *> &streams)
+{
+	const size_t count = streams.size();
+
+	if (count > _capacity) {
+		delete[] _entries;
+		_entries = new Entry[count];
+		_capacity = (_entries != nullptr) ? count : 0;
+
+		if (_entries == nullptr) {
+			PX4_ERR("stream scheduler alloc failed");
+		}
+	}
+
+	// all streams are due now, update() then schedules them on their own deadline
+	_size = 0;
+
+	for (const auto &stream : streams) {
+		if (_size < _capacity) {
+			_entries[_size++] = Entry{0, stream};
+		}
+	}
+
+	_rebuild = false;
+}
+
+void
+MavlinkStreamScheduler::sift_up(size_t index)
+{
+	const Entry entry = _entries[index];
+
+	while (index > 0) {
+		const size_t parent = (index - 1) / 2;
+
+		if (_entries[parent].due <= entry.due) {
+			break;
+		}
+
+		_entries[index] = _entries[parent];
+		index = parent;
+	}
+
+	_entries[index] = entry;
+}
+
+void
+MavlinkStreamScheduler::sift_down(size_t index, size_t size)
+{
+	const Entry entry = _entries[index];
+
+	for (;;) {
+		size_t child = 2 * index + 1;
+
+		if (child >= size) {
+			break;
+		}
+
+		if ((child + 1 < size) && (_entries[child + 1].due < _entries[child].due)) {
+			child++;
+		}
+
+		if (entry.due <= _entries[child].due) {
+			break;
+		}
+
+		_entries[index] = _entries[child];
+		index = child;
+	}
+
+	_entries[index] = entry;
+}
+
+void
+MavlinkStreamScheduler::update(List<MavlinkStream *> &streams, const hrt_abstime &t)
+{
+	const hrt_abstime start = hrt_absolute_time();
+
+	// a higher rate multiplier shortens the intervals the streams were scheduled with
+	const float rate_mult = _mavlink->get_rate_mult();
+
+	if (rate_mult > _rate_mult * 1.05f) {
+		_rate_mult = rate_mult;
+		_rebuild = true;
+
+	} else {
+		_rate_mult = fminf(_rate_mult, rate_mult);
+	}
+
+	if (_rebuild) {
+		rebuild(streams);
+	}
+
+	// pop the streams which are due, they are collected at the end of the array
+	// with the earliest deadline last
+	size_t heap_size = _size;
+
+	while ((heap_size > 0) && (_entries[0].due <= t)) {
+		heap_size--;
+		const Entry entry = _entries[0];
+		_entries[0] = _entries[heap_size];
+		_entries[heap_size] = entry;
+		sift_down(0, heap_size);
+	}
+
+	unsigned free_tx_buf = (heap_size < _size) ? _mavlink->get_free_tx_buf() : 0;
+
+	for (size_t i = _size; i > heap_size; i--) {
+		Entry &entry = _entries[i - 1];
+		MavlinkStream *stream = entry.stream;
+		const bool always_update = stream->always_update();
+		const unsigned size = stream->get_size();
+
+		if (!always_update && (size > free_tx_buf)) {
+			// the estimate is outdated once data has been written out
+			free_tx_buf = _mavlink->get_free_tx_buf();
+		}
+
+		if (!always_update && (size > free_tx_buf)) {
+			// link is congested, keep the deadline so this stream goes first once there is space again
+			_deferred++;
+			continue;
+		}
+
+		_updates++;
+
+		if (stream->update(t) == 0) {
+			_sent++;
+			free_tx_buf = (size < free_tx_buf) ? free_tx_buf - size : 0;
+		}
+
+		entry.due = always_update ? 0 : stream->next_update();
+	}
+
+	// reinsert the updated streams
+	while (heap_size < _size) {
+		sift_up(heap_size++);
+	}
+
+	_elapsed += hrt_elapsed_time(&start);
+
+	if (t > _stats_timestamp + 1_s) {
+		if (_stats_timestamp != 0) {
+			const float dt = (t - _stats_timestamp) * 1e-6f;
+
+			_updates_rate_avg = _updates / dt;
+			_sent_rate_avg = _sent / dt;
+			_deferred_rate_avg = _deferred / dt;
+			_load_avg = _elapsed * 1e-6f / dt;
+
+			_updates = 0;
+			_sent = 0;
+			_deferred = 0;
+			_elapsed = 0;
+		}
+
+		_stats_timestamp = t;
+	}
+}
+
+void
+MavlinkStreamScheduler::print_status() const
+{
+	printf("\tstreams scheduled: %zu, updates: %.1f/s, sent: %.1f/s, deferred: %.1f/s, CPU: %.2f%%\n",
+	       _size, (double)_updates_rate_avg, (double)_sent_rate_avg, (double)_deferred_rate_avg,
+	       (double)(_load_avg * 100.f));
+}
@@ -0,0 +1,110 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file mavlink_stream_scheduler.h
+ * Deadline ordered scheduling of the mavlink streams of an instance.
+ *
+ * The streams are kept in a min-heap on the time their next message is due,
+ * so that each iteration only the streams which can send are updated.
+ */
+
+#ifndef MAVLINK_STREAM_SCHEDULER_H_
+#define MAVLINK_STREAM_SCHEDULER_H_
+
+#include <drivers/drv_hrt.h>
+#include <containers/List.hpp>
+
+class Mavlink;
+class MavlinkStream;
+
+class MavlinkStreamScheduler
+{
+public:
+	explicit MavlinkStreamScheduler(Mavlink *mavlink) : _mavlink(mavlink) {}
+	~MavlinkStreamScheduler() { delete[] _entries; }
+
+	// no copy, assignment, move, move assignment
+	MavlinkStreamScheduler(const MavlinkStreamScheduler &) = delete;
+	MavlinkStreamScheduler &operator=(const MavlinkStreamScheduler &) = delete;
+	MavlinkStreamScheduler(MavlinkStreamScheduler &&) = delete;
+	MavlinkStreamScheduler &operator=(MavlinkStreamScheduler &&) = delete;
+
+	/**
+	 * Check all streams again on the next update. Needs to be called whenever
+	 * streams are added, removed or their interval is changed.
+	 */
+	void reschedule() { _rebuild = true; }
+
+	/**
+	 * Update the streams which are due, earliest deadline first. Streams which
+	 * don't fit into the free transmit buffer are deferred to the next iteration.
+	 */
+	void update(List<MavlinkStream *> &streams, const hrt_abstime &t);
+
+	void print_status() const;
+
+private:
+	struct Entry {
+		hrt_abstime due;
+		MavlinkStream *stream;
+	};
+
+	void rebuild(List<MavlinkStream *> &streams);
+
+	void sift_up(size_t index);
+	void sift_down(size_t index, size_t size);
+
+	Mavlink *const _mavlink;
+
+	Entry *_entries{nullptr};	///< heap of the scheduled streams, earliest due time first
+	size_t _capacity{0};
+	size_t _size{0};
+
+	bool _rebuild{true};
+	float _rate_mult{1.f};		///< lowest rate multiplier since the last rebuild
+
+	// statistics
+	hrt_abstime _stats_timestamp{0};
+	hrt_abstime _elapsed{0};
+	uint32_t _updates{0};
+	uint32_t _sent{0};
+	uint32_t _deferred{0};
+
+	float _updates_rate_avg{0.f};
+	float _sent_rate_avg{0.f};
+	float _deferred_rate_avg{0.f};
+	float _load_avg{0.f};
+};
+
+#endif /* MAVLINK_STREAM_SCHEDULER_H_ */
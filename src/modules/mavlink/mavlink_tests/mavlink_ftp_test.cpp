@@ -36,6 +36,7 @@
 
 #include <sys/stat.h>
 #include <crc32.h>
+#include <lib/mathlib/mathlib.h>
 #include <stdio.h>
 #include <fcntl.h>
 
@@ -63,6 +64,98 @@ const MavlinkFtpTest::DownloadTestCase MavlinkFtpTest::_rgDownloadTestCases[] =
 	{ _test_files[2], MAX_DATA_LEN + 1, false, false },	// Read take two packets
 };
 
+static const char _window_test_file[] = PX4_MAVLINK_TEST_DATA_DIR "/test_window.data";
+static const char _upload_test_file[] = PX4_MAVLINK_TEST_DATA_DIR "/test_upload.data";
+
+/// Loopback link for the windowed transfer tests: fixed latency, limited bandwidth and random packet loss.
+class LoopbackLink
+{
+public:
+	LoopbackLink(unsigned capacity, unsigned latency, unsigned bandwidth, unsigned loss_percent, uint32_t seed) :
+		_capacity(capacity), _latency(latency), _bandwidth(bandwidth), _loss_percent(loss_percent), _seed(seed)
+	{}
+	~LoopbackLink() { delete[] _packets; }
+
+	bool init()
+	{
+		_packets = new Packet[_capacity];
+		return _packets != nullptr;
+	}
+
+	void send(const mavlink_message_t &msg)
+	{
+		_sent++;
+
+		if (_random() % 100 < _loss_percent || _count == _capacity) {
+			_dropped++;
+			return;
+		}
+
+		Packet &packet = _packets[(_head + _count) % _capacity];
+		packet.due = _now + _latency;
+		packet.msg = msg;
+		_count++;
+	}
+
+	bool receive(mavlink_message_t &msg)
+	{
+		if (_count == 0 || _packets[_head].due > _now || _delivered >= _bandwidth) {
+			return false;
+		}
+
+		msg = _packets[_head].msg;
+		_head = (_head + 1) % _capacity;
+		_count--;
+		_delivered++;
+		return true;
+	}
+
+	void tick()
+	{
+		_now++;
+		_delivered = 0;
+	}
+
+	unsigned now() const { return _now; }
+	unsigned sent() const { return _sent; }
+	unsigned dropped() const { return _dropped; }
+
+	/// Unit test worker for the server, queues its messages on the link
+	static void server_send(const mavlink_file_transfer_protocol_t *ftp_msg, void *worker_data)
+	{
+		mavlink_message_t msg;
+		mavlink_msg_file_transfer_protocol_encode(MavlinkFtpTest::serverSystemId, MavlinkFtpTest::serverComponentId,
+				&msg, ftp_msg);
+		static_cast<LoopbackLink *>(worker_data)->send(msg);
+	}
+
+private:
+	struct Packet {
+		unsigned		due;
+		mavlink_message_t	msg;
+	};
+
+	uint32_t _random()
+	{
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 16) & 0x7fff;
+	}
+
+	Packet *_packets{nullptr};
+	const unsigned _capacity;
+	const unsigned _latency;
+	const unsigned _bandwidth;
+	const unsigned _loss_percent;
+	uint32_t _seed;
+
+	unsigned _head{0};
+	unsigned _count{0};
+	unsigned _now{0};
+	unsigned _delivered{0};
+	unsigned _sent{0};
+	unsigned _dropped{0};
+};
+
 const char MavlinkFtpTest::_unittest_microsd_dir[] = PX4_STORAGEDIR "/ftp_unit_test_dir";
 const char MavlinkFtpTest::_unittest_microsd_file[] = PX4_STORAGEDIR "/ftp_unit_test_dir/file";
 
@@ -137,6 +230,9 @@ bool MavlinkFtpTest::_remove_test_files()
 		::unlink(_test_files[i]);
 	}
 
+	::unlink(_window_test_file);
+	::unlink(_upload_test_file);
+
 	::rmdir(PX4_MAVLINK_TEST_DATA_DIR "/empty_dir");
 	::rmdir(PX4_MAVLINK_TEST_DATA_DIR);
 
@@ -644,6 +740,366 @@ bool MavlinkFtpTest::_burst_test()
 	return true;
 }
 
+/// @brief Tests a windowed download over a link with latency, limited bandwidth and packet loss.
+bool MavlinkFtpTest::_window_test()
+{
+	MavlinkFTP::PayloadHeader		payload {};
+	const MavlinkFTP::PayloadHeader		*reply;
+
+	// Several windows worth of data, the last packet is a partial one
+	const uint32_t file_size = 3 * MavlinkFTP::kMaxWindowSize * MAX_DATA_LEN + 17;
+	const uint32_t packet_count = (file_size + MAX_DATA_LEN - 1) / MAX_DATA_LEN;
+
+	uint8_t *bytes = new uint8_t[file_size];
+	uint8_t *bytes_received = new uint8_t[file_size];
+	bool *received = new bool[packet_count] {};
+	unsigned *resend_requested = new unsigned[packet_count] {};
+	LoopbackLink uplink(16, _loopback_latency, _loopback_bandwidth, _loopback_loss_percent, 1);
+	LoopbackLink downlink(2 * (MavlinkFTP::kMaxWindowSize + MavlinkFTP::kMaxWindowResend) + 16, _loopback_latency,
+			      _loopback_bandwidth, _loopback_loss_percent, 2);
+	bool success = uplink.init() && downlink.init();
+
+	for (uint32_t i = 0; i < file_size; i++) {
+		bytes[i] = (uint8_t)(i + (i >> 8));
+	}
+
+	int fd = ::open(_window_test_file, O_CREAT | O_TRUNC | O_WRONLY, S_IRWXU | S_IRWXG | S_IRWXO);
+
+	if (fd < 0 || ::write(fd, bytes, file_size) != (ssize_t)file_size) {
+		success = false;
+	}
+
+	if (fd >= 0) {
+		::close(fd);
+	}
+
+	if (success) {
+		payload.opcode = MavlinkFTP::kCmdOpenFileRO;
+		payload.offset = 0;
+		payload.size = strlen(_window_test_file) + 1;
+
+		success = _send_receive_msg(&payload, (const uint8_t *)_window_test_file, payload.size, &reply)
+			  && reply->opcode == MavlinkFTP::kRspAck;
+	}
+
+	if (!success) {
+		delete[] bytes;
+		delete[] bytes_received;
+		delete[] received;
+		delete[] resend_requested;
+		ut_assert("window test setup failed", false);
+	}
+
+	_ftp_server->set_unittest_worker(LoopbackLink::server_send, &downlink);
+
+	// The time a resent packet needs to arrive: round trip plus a full window queued on the link
+	const unsigned round_trip = 2 * _loopback_latency;
+	const unsigned resend_timeout = round_trip + MavlinkFTP::kMaxWindowSize / _loopback_bandwidth;
+	const unsigned max_ticks = 100 * (packet_count / _loopback_bandwidth + resend_timeout);
+
+	bool started = false;
+	bool window_ok = true;
+	uint16_t window_size = 0;
+	uint32_t received_count = 0;
+	uint32_t first_missing = 0;	// index of the first packet not received
+	uint32_t end = 0;		// index after the highest packet received
+	unsigned last_request = 0;
+	unsigned last_data = 0;
+	bool new_data = false;
+
+	while (received_count < packet_count && downlink.now() < max_ticks) {
+		mavlink_message_t msg;
+
+		// server side
+		while (uplink.receive(msg)) {
+			_ftp_server->handle_message(&msg);
+		}
+
+		_ftp_server->send();
+
+		// client side
+		while (downlink.receive(msg)) {
+			mavlink_file_transfer_protocol_t ftp_msg;
+			mavlink_msg_file_transfer_protocol_decode(&msg, &ftp_msg);
+			const MavlinkFTP::PayloadHeader *data = reinterpret_cast<const MavlinkFTP::PayloadHeader *>
+								(ftp_msg.payload);
+
+			if (data->req_opcode == MavlinkFTP::kCmdWindowReadFile) {
+				// Ack of the start request
+				window_ok = window_ok && data->opcode == MavlinkFTP::kRspAck && data->size == sizeof(uint16_t);
+				memcpy(&window_size, data->data, sizeof(window_size));
+				window_ok = window_ok && window_size == MavlinkFTP::kMaxWindowSize;
+				started = true;
+
+			} else if (data->req_opcode != MavlinkFTP::kCmdWindowData) {
+				window_ok = false;
+
+			} else if (data->opcode == MavlinkFTP::kRspNak) {
+				// EOF, everything up to the end of the file has been sent
+				window_ok = window_ok && data->data[0] == MavlinkFTP::kErrEOF
+					    && data->offset == file_size;
+				end = packet_count;
+
+			} else {
+				const uint32_t index = data->offset / MAX_DATA_LEN;
+				const uint32_t size = math::min(MAX_DATA_LEN, file_size - data->offset);
+
+				if (data->offset % MAX_DATA_LEN != 0 || index >= packet_count || data->size != size) {
+					window_ok = false;
+					continue;
+				}
+
+				started = true;
+
+				if (!received[index]) {
+					memcpy(&bytes_received[data->offset], data->data, data->size);
+					received[index] = true;
+					received_count++;
+					new_data = true;
+					last_data = downlink.now();
+				}
+
+				end = math::max(end, index + 1);
+			}
+		}
+
+		while (first_missing < packet_count && received[first_missing]) {
+			first_missing++;
+		}
+
+		const unsigned now = downlink.now();
+
+		if (!started) {
+			if (now == 0 || now - last_request > resend_timeout) {
+				payload.opcode = MavlinkFTP::kCmdWindowReadFile;
+				payload.session = 0;
+				payload.offset = 0;
+				payload.size = sizeof(uint16_t);
+				const uint16_t requested_window = MavlinkFTP::kMaxWindowSize;
+				_setup_ftp_msg(&payload, (const uint8_t *)&requested_window, sizeof(requested_window),
+					       &msg);
+				uplink.send(msg);
+				last_request = now;
+			}
+
+		} else if (received_count < packet_count && (new_data || now - last_request > round_trip)) {
+			// Cumulative ack, plus the missing packets that are not already on their way. Losses at
+			// the end of the window only show when nothing arrives anymore, then everything the
+			// window allows is missing.
+			uint32_t missing[MavlinkFTP::kMaxWindowResend];
+			uint8_t missing_count = 0;
+			const uint32_t window_end = math::min(first_missing + MavlinkFTP::kMaxWindowSize, packet_count);
+			const uint32_t horizon = now - last_data > resend_timeout ? window_end : end;
+
+			for (uint32_t i = first_missing; i < horizon; i++) {
+				if (missing_count == MavlinkFTP::kMaxWindowResend) {
+					break;
+				}
+
+				if (!received[i] && (resend_requested[i] == 0 || now - resend_requested[i] > resend_timeout)) {
+					missing[missing_count++] = i * MAX_DATA_LEN;
+					resend_requested[i] = now;
+				}
+			}
+
+			payload.opcode = MavlinkFTP::kCmdWindowAck;
+			payload.session = 0;
+			payload.offset = math::min(first_missing * MAX_DATA_LEN, file_size);
+			payload.size = missing_count * sizeof(uint32_t);
+			_setup_ftp_msg(&payload, (const uint8_t *)missing, payload.size, &msg);
+			uplink.send(msg);
+			last_request = now;
+			new_data = false;
+		}
+
+		uplink.tick();
+		downlink.tick();
+	}
+
+	const unsigned ticks = downlink.now();
+	const bool complete = received_count == packet_count;
+	const bool content_ok = complete && memcmp(bytes, bytes_received, file_size) == 0;
+
+	delete[] bytes;
+	delete[] bytes_received;
+	delete[] received;
+	delete[] resend_requested;
+
+	// Put back generic message handler
+	_ftp_server->set_unittest_worker(MavlinkFtpTest::receive_message_handler_generic, this);
+
+	ut_assert("Download did not complete", complete);
+	ut_assert("Unexpected download message", window_ok);
+	ut_assert("File contents differ", content_ok);
+
+	// One request per packet takes a round trip each
+	const float stop_and_wait = (float)MAX_DATA_LEN / round_trip;
+	const float windowed = (float)file_size / ticks;
+	printf("window download: %" PRIu32 " bytes in %u ticks, %.1f bytes/tick (stop-and-wait %.1f, link %" PRIu32
+	       "), %u/%u packets lost\n",
+	       file_size, ticks, (double)windowed, (double)stop_and_wait, _loopback_bandwidth * MAX_DATA_LEN,
+	       uplink.dropped() + downlink.dropped(), uplink.sent() + downlink.sent());
+	ut_assert("Windowed download not faster than stop-and-wait", windowed > 8.f * stop_and_wait);
+
+	// Terminate session
+	payload.opcode = MavlinkFTP::kCmdTerminateSession;
+	payload.session = 0;
+	payload.size = 0;
+
+	success = _send_receive_msg(&payload, nullptr, 0, &reply);
+
+	if (!success) {
+		return false;
+	}
+
+	ut_compare("Didn't get Ack back", reply->opcode, MavlinkFTP::kRspAck);
+
+	return true;
+}
+
+/// @brief Tests an upload with several writes in flight over a link with latency and packet loss.
+bool MavlinkFtpTest::_pipelined_write_test()
+{
+	MavlinkFTP::PayloadHeader		payload {};
+	const MavlinkFTP::PayloadHeader		*reply;
+
+	static const unsigned kWritesInFlight = 16;
+
+	const uint32_t file_size = 64 * MAX_DATA_LEN + 100;
+	const uint32_t packet_count = (file_size + MAX_DATA_LEN - 1) / MAX_DATA_LEN;
+
+	payload.opcode = MavlinkFTP::kCmdCreateFile;
+	payload.offset = 0;
+	payload.size = strlen(_upload_test_file) + 1;
+
+	bool success = _send_receive_msg(&payload, (const uint8_t *)_upload_test_file, payload.size, &reply);
+
+	if (!success) {
+		return false;
+	}
+
+	ut_compare("Didn't get Ack back", reply->opcode, MavlinkFTP::kRspAck);
+
+	uint8_t *bytes = new uint8_t[file_size];
+	bool *acked = new bool[packet_count] {};
+	unsigned *sent = new unsigned[packet_count] {};	// tick of the last send, 0 for not sent
+	LoopbackLink uplink(2 * kWritesInFlight, _loopback_latency, _loopback_bandwidth, _loopback_loss_percent, 3);
+	LoopbackLink downlink(2 * kWritesInFlight, _loopback_latency, _loopback_bandwidth, _loopback_loss_percent, 4);
+	success = uplink.init() && downlink.init();
+
+	for (uint32_t i = 0; i < file_size; i++) {
+		bytes[i] = (uint8_t)(i * 3 + (i >> 8));
+	}
+
+	_ftp_server->set_unittest_worker(LoopbackLink::server_send, &downlink);
+
+	// Writes are positioned, so a write can be resent whenever its ack does not arrive in time
+	const unsigned resend_timeout = 2 * _loopback_latency + kWritesInFlight / _loopback_bandwidth + 1;
+	const unsigned max_ticks = 100 * (packet_count / _loopback_bandwidth + resend_timeout);
+
+	uint32_t acked_count = 0;
+	bool write_ok = true;
+
+	while (success && acked_count < packet_count && uplink.now() < max_ticks) {
+		mavlink_message_t msg;
+
+		while (uplink.receive(msg)) {
+			_ftp_server->handle_message(&msg);
+		}
+
+		while (downlink.receive(msg)) {
+			mavlink_file_transfer_protocol_t ftp_msg;
+			mavlink_msg_file_transfer_protocol_decode(&msg, &ftp_msg);
+			const MavlinkFTP::PayloadHeader *ack = reinterpret_cast<const MavlinkFTP::PayloadHeader *>
+							       (ftp_msg.payload);
+			const uint32_t index = ack->offset / MAX_DATA_LEN;
+
+			if (ack->opcode != MavlinkFTP::kRspAck || ack->req_opcode != MavlinkFTP::kCmdWriteFile
+			    || index >= packet_count) {
+				write_ok = false;
+
+			} else if (!acked[index]) {
+				acked[index] = true;
+				acked_count++;
+			}
+		}
+
+		// Keep the pipeline full: resends of timed out writes, then the next new ones
+		const unsigned now = uplink.now() + 1;
+		unsigned in_flight = 0;
+
+		for (uint32_t i = 0; i < packet_count && in_flight < kWritesInFlight; i++) {
+			if (acked[i]) {
+				continue;
+			}
+
+			if (sent[i] == 0 || now - sent[i] > resend_timeout) {
+				payload.opcode = MavlinkFTP::kCmdWriteFile;
+				payload.session = 0;
+				payload.offset = i * MAX_DATA_LEN;
+				payload.size = math::min(MAX_DATA_LEN, file_size - payload.offset);
+				_setup_ftp_msg(&payload, &bytes[payload.offset], payload.size, &msg);
+				uplink.send(msg);
+				sent[i] = now;
+			}
+
+			in_flight++;
+		}
+
+		uplink.tick();
+		downlink.tick();
+	}
+
+	const unsigned ticks = uplink.now();
+
+	delete[] acked;
+	delete[] sent;
+
+	// Put back generic message handler
+	_ftp_server->set_unittest_worker(MavlinkFtpTest::receive_message_handler_generic, this);
+
+	if (!success || !write_ok || acked_count != packet_count) {
+		delete[] bytes;
+		ut_assert("Upload did not complete", success && acked_count == packet_count);
+		ut_assert("Unexpected upload message", write_ok);
+	}
+
+	printf("pipelined upload: %" PRIu32 " bytes in %u ticks, %.1f bytes/tick (stop-and-wait %.1f)\n",
+	       file_size, ticks, (double)((float)file_size / ticks),
+	       (double)((float)MAX_DATA_LEN / (2 * _loopback_latency)));
+
+	payload.opcode = MavlinkFTP::kCmdTerminateSession;
+	payload.session = 0;
+	payload.size = 0;
+
+	success = _send_receive_msg(&payload, nullptr, 0, &reply);
+
+	if (!success) {
+		delete[] bytes;
+		return false;
+	}
+
+	ut_compare("Didn't get Ack back", reply->opcode, MavlinkFTP::kRspAck);
+
+	// Read back what was written
+	uint8_t *bytes_written = new uint8_t[file_size + 1];
+	int fd = ::open(_upload_test_file, O_RDONLY);
+	const ssize_t bytes_read = fd >= 0 ? ::read(fd, bytes_written, file_size + 1) : -1;
+
+	if (fd >= 0) {
+		::close(fd);
+	}
+
+	const bool content_ok = bytes_read == (ssize_t)file_size && memcmp(bytes, bytes_written, file_size) == 0;
+
+	delete[] bytes;
+	delete[] bytes_written;
+
+	ut_assert("Uploaded file differs", content_ok);
+
+	return true;
+}
+
 /// @brief Tests for correct reponse to a Read command on an invalid session.
 bool MavlinkFtpTest::_read_badsession_test()
 {
@@ -1017,6 +1473,8 @@ bool MavlinkFtpTest::run_tests()
 	ut_run_test(_read_test);
 	ut_run_test(_read_badsession_test);
 	ut_run_test(_burst_test);
+	ut_run_test(_window_test);
+	ut_run_test(_pipelined_write_test);
 	ut_run_test(_removedirectory_test);
 	ut_run_test(_createdirectory_test);
 	ut_run_test(_removefile_test);
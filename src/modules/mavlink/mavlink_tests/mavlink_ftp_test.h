@@ -93,6 +93,8 @@ private:
 	bool _read_test(void);
 	bool _read_badsession_test(void);
 	bool _burst_test(void);
+	bool _window_test(void);
+	bool _pipelined_write_test(void);
 	bool _removedirectory_test(void);
 	bool _createdirectory_test(void);
 	bool _removefile_test(void);
@@ -136,6 +138,11 @@ private:
 
 	static const char _unittest_microsd_dir[];
 	static const char _unittest_microsd_file[];
+
+	/// Link settings of the windowed transfer tests, time is in ticks
+	static const unsigned _loopback_latency = 10;		///< one way latency
+	static const unsigned _loopback_bandwidth = 4;		///< packets per tick
+	static const unsigned _loopback_loss_percent = 5;	///< random packet loss in both directions
 };
 
 bool mavlink_ftp_test(void);
@@ -0,0 +1,172 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file mavlink_tx_queue.cpp
+ * Lock-free multi-producer, single-consumer queue of outgoing MAVLink frames.
+ */
+
+#include "mavlink_tx_queue.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+constexpr uint32_t MavlinkTxQueue::CAPACITY;
+
+MavlinkTxQueue::MavlinkTxQueue()
+{
+	for (uint32_t i = 0; i < CAPACITY; i++) {
+		_frames[i].sequence.store(i);
+	}
+}
+
+bool
+MavlinkTxQueue::begin(unsigned length)
+{
+	if (length > MAVLINK_MAX_PACKET_LEN) {
+		_dropped_frames.fetch_add(1);
+		return false;
+	}
+
+	uint32_t position = _head.load();
+	Frame *frame = nullptr;
+
+	for (;;) {
+		frame = &_frames[position & (CAPACITY - 1)];
+		const int32_t diff = (int32_t)(frame->sequence.load() - position);
+
+		if (diff == 0) {
+			// the slot is free, try to claim it (position is updated on failure)
+			if (_head.compare_exchange(&position, position + 1)) {
+				break;
+			}
+
+			_claim_retries.fetch_add(1);
+
+		} else if (diff < 0) {
+			// the frame claimed a full turn before has not been sent yet
+			_dropped_frames.fetch_add(1);
+			return false;
+
+		} else {
+			// another thread claimed the slot
+			position = _head.load();
+		}
+	}
+
+	frame->position = position;
+	frame->fill = 0;
+	frame->writer.store(pthread_self());
+	frame->open.store(true);
+
+	uint32_t max_depth = _max_depth.load();
+	const uint32_t depth = position + 1 - _tail.load();
+
+	while (depth > max_depth && !_max_depth.compare_exchange(&max_depth, depth)) {}
+
+	return true;
+}
+
+MavlinkTxQueue::Frame *
+MavlinkTxQueue::own_frame()
+{
+	const pthread_t self = pthread_self();
+	const uint32_t head = _head.load();
+
+	// a thread has at most one open frame, usually the one claimed last
+	for (uint32_t i = 1; i <= CAPACITY; i++) {
+		Frame *frame = &_frames[(head - i) & (CAPACITY - 1)];
+
+		if (frame->open.load() && pthread_equal(frame->writer.load(), self)) {
+			return frame;
+		}
+	}
+
+	return nullptr;
+}
+
+bool
+MavlinkTxQueue::append(const uint8_t *buf, unsigned len)
+{
+	Frame *frame = own_frame();
+
+	if (frame == nullptr) {
+		return true;
+	}
+
+	if (frame->fill + len > sizeof(frame->data)) {
+		return false;
+	}
+
+	memcpy(&frame->data[frame->fill], buf, len);
+	frame->fill += len;
+	return true;
+}
+
+bool
+MavlinkTxQueue::commit()
+{
+	Frame *frame = own_frame();
+
+	if (frame == nullptr) {
+		return false;
+	}
+
+	frame->open.store(false);
+	_queued_bytes.fetch_add(frame->fill);
+	frame->sequence.store(frame->position + 1);
+	return true;
+}
+
+bool
+MavlinkTxQueue::try_lock_consumer()
+{
+	bool unlocked = false;
+
+	if (_consumer_locked.compare_exchange(&unlocked, true)) {
+		return true;
+	}
+
+	_consumer_busy.fetch_add(1);
+	return false;
+}
+
+void
+MavlinkTxQueue::print_status() const
+{
+	printf("\tTX queue: %" PRIu32 " frames sent, max depth %" PRIu32 "/%" PRIu32 ", dropped (full): %" PRIu32 "\n",
+	       _sent_frames, _max_depth.load(), CAPACITY, _dropped_frames.load());
+	printf("\t  contention: %" PRIu32 " slot claim retries, %" PRIu32 " sends left to the sending thread\n",
+	       _claim_retries.load(), _consumer_busy.load());
+}
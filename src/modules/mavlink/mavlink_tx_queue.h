@@ -0,0 +1,186 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file mavlink_tx_queue.h
+ * Lock-free multi-producer, single-consumer queue of outgoing MAVLink frames.
+ *
+ * Every thread sending on an instance (main loop, receiver, ULog streaming)
+ * claims a frame slot, fills and commits it without taking a lock. Frames
+ * are sent in the order the slots were claimed by a single consumer: the
+ * first thread that finds no other thread sending takes the consumer role
+ * and sends all committed frames, the others return right away.
+ *
+ * The slots are a bounded ring with a sequence number per slot, so claiming
+ * a slot is a single compare-and-swap.
+ */
+
+#ifndef MAVLINK_TX_QUEUE_H_
+#define MAVLINK_TX_QUEUE_H_
+
+#include <pthread.h>
+#include <stdint.h>
+
+#include <px4_platform_common/atomic.h>
+#include <mavlink_types.h>
+
+class MavlinkTxQueue
+{
+public:
+#if defined(__PX4_POSIX)
+	static constexpr uint32_t CAPACITY = 64;
+#elif defined(CONSTRAINED_MEMORY)
+	static constexpr uint32_t CAPACITY = 4;
+#else
+	static constexpr uint32_t CAPACITY = 8;
+#endif
+	static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of 2");
+
+	MavlinkTxQueue();
+	~MavlinkTxQueue() = default;
+
+	// no copy, assignment, move, move assignment
+	MavlinkTxQueue(const MavlinkTxQueue &) = delete;
+	MavlinkTxQueue &operator=(const MavlinkTxQueue &) = delete;
+	MavlinkTxQueue(MavlinkTxQueue &&) = delete;
+	MavlinkTxQueue &operator=(MavlinkTxQueue &&) = delete;
+
+	/**
+	 * Start a frame of the calling thread
+	 *
+	 * @param length frame length
+	 * @return false if the queue is full, the frame is dropped then
+	 */
+	bool begin(unsigned length);
+
+	/**
+	 * Append bytes to the frame of the calling thread, nothing happens if there is none
+	 *
+	 * @return false if the frame got longer than MAVLINK_MAX_PACKET_LEN
+	 */
+	bool append(const uint8_t *buf, unsigned len);
+
+	/**
+	 * Hand the frame of the calling thread over to the consumer
+	 *
+	 * @return false if the calling thread has no frame
+	 */
+	bool commit();
+
+	/**
+	 * Take the consumer role, fails if another thread has it
+	 */
+	bool try_lock_consumer();
+
+	void unlock_consumer() { _consumer_locked.store(false); }
+
+	/**
+	 * Whether all slots are claimed, begin() fails until the consumer sent a frame
+	 */
+	bool full() const
+	{
+		const uint32_t position = _head.load();
+		return (int32_t)(_frames[position & (CAPACITY - 1)].sequence.load() - position) < 0;
+	}
+
+	/**
+	 * Whether the next frame is committed
+	 */
+	bool ready() const
+	{
+		const uint32_t position = _tail.load();
+		return _frames[position & (CAPACITY - 1)].sequence.load() == position + 1;
+	}
+
+	/**
+	 * Pass the committed frames in order to send(const uint8_t *buf, unsigned len), consumer only
+	 *
+	 * @return number of frames sent
+	 */
+	template<typename F>
+	unsigned consume(F &&send)
+	{
+		unsigned frames = 0;
+
+		while (ready()) {
+			const uint32_t position = _tail.load();
+			Frame &frame = _frames[position & (CAPACITY - 1)];
+
+			send(frame.data, frame.fill);
+
+			_queued_bytes.fetch_sub(frame.fill);
+			frame.sequence.store(position + CAPACITY);
+			_tail.store(position + 1);
+			frames++;
+		}
+
+		_sent_frames += frames;
+		return frames;
+	}
+
+	/**
+	 * Number of bytes committed and not sent yet
+	 */
+	unsigned queued_bytes() const { return _queued_bytes.load(); }
+
+	void print_status() const;
+
+private:
+	struct Frame {
+		px4::atomic<uint32_t> sequence{0};	///< position + 1 if committed, position + CAPACITY once sent
+		px4::atomic_bool open{false};		///< claimed and not committed yet
+		px4::atomic<pthread_t> writer{};
+		uint32_t position{0};
+		uint16_t fill{0};
+		uint8_t data[MAVLINK_MAX_PACKET_LEN] {};
+	};
+
+	// the open frame of the calling thread
+	Frame *own_frame();
+
+	Frame _frames[CAPACITY] {};
+
+	px4::atomic<uint32_t> _head{0};		///< next position to claim
+	px4::atomic<uint32_t> _tail{0};		///< next position to send
+	px4::atomic<uint32_t> _queued_bytes{0};
+	px4::atomic_bool _consumer_locked{false};
+
+	// statistics
+	uint32_t _sent_frames{0};
+	px4::atomic<uint32_t> _dropped_frames{0};	///< queue full
+	px4::atomic<uint32_t> _max_depth{0};
+	px4::atomic<uint32_t> _claim_retries{0};	///< lost compare-and-swap claiming a slot
+	px4::atomic<uint32_t> _consumer_busy{0};	///< frames left to the thread already sending
+};
+
+#endif /* MAVLINK_TX_QUEUE_H_ */
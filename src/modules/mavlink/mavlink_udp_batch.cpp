@@ -0,0 +1,211 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file mavlink_udp_batch.cpp
+ * Batched UDP transmit with sendmmsg() and UDP GSO.
+ */
+
+#include "mavlink_udp_batch.h"
+
+#if defined(MAVLINK_UDP_BATCH)
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <netinet/udp.h>
+
+#include <px4_platform_common/log.h>
+
+#if !defined(UDP_SEGMENT)
+# define UDP_SEGMENT 103
+#endif
+
+void
+MavlinkUdpBatch::init(int socket_fd)
+{
+	_socket_fd = socket_fd;
+
+	// UDP_SEGMENT can be read back if the kernel supports GSO (Linux >= 4.18)
+	int gso_size = 0;
+	socklen_t len = sizeof(gso_size);
+	_gso = (getsockopt(_socket_fd, IPPROTO_UDP, UDP_SEGMENT, &gso_size, &len) == 0);
+}
+
+bool
+MavlinkUdpBatch::add(const uint8_t *buf, size_t len, const sockaddr_in &addr, bool counted)
+{
+	if (full() || (len > MAVLINK_MAX_PACKET_LEN)) {
+		return false;
+	}
+
+	// destinations are few (partner and broadcast address), look them up linearly
+	size_t destination = 0;
+
+	while ((destination < _num_destinations)
+	       && ((_destinations[destination].sin_addr.s_addr != addr.sin_addr.s_addr)
+		   || (_destinations[destination].sin_port != addr.sin_port))) {
+		destination++;
+	}
+
+	if (destination == _num_destinations) {
+		_destinations[_num_destinations++] = addr;
+	}
+
+	memcpy(&_data[_fill], buf, len);
+	_packets[_num_packets++] = Packet{(uint16_t)_fill, (uint16_t)len, (uint8_t)destination, counted};
+	_fill += len;
+
+	return true;
+}
+
+size_t
+MavlinkUdpBatch::build_messages(size_t first)
+{
+	size_t num_msgs = 0;
+
+	for (size_t i = first; i < _num_packets; i++) {
+		const Packet &packet = _packets[i];
+
+		if (_gso && (num_msgs > 0)) {
+			// coalesce packets of the same size and destination into one GSO message
+			const Packet &previous = _packets[i - 1];
+			iovec &iov = _iov[num_msgs - 1];
+
+			if ((packet.len == previous.len) && (packet.destination == previous.destination)
+			    && (packet.counted == previous.counted) && (iov.iov_len % packet.len == 0)
+			    && ((uint8_t *)iov.iov_base + iov.iov_len == &_data[packet.offset])) {
+
+				iov.iov_len += packet.len;
+				_msg_packets[num_msgs - 1]++;
+				continue;
+			}
+		}
+
+		_iov[num_msgs].iov_base = &_data[packet.offset];
+		_iov[num_msgs].iov_len = packet.len;
+		_msg_packets[num_msgs] = 1;
+
+		msghdr &hdr = _msgs[num_msgs].msg_hdr;
+		memset(&hdr, 0, sizeof(hdr));
+		hdr.msg_name = &_destinations[packet.destination];
+		hdr.msg_namelen = sizeof(sockaddr_in);
+		hdr.msg_iov = &_iov[num_msgs];
+		hdr.msg_iovlen = 1;
+		num_msgs++;
+	}
+
+	// segment size for the coalesced messages
+	for (size_t m = 0; m < num_msgs; m++) {
+		msghdr &hdr = _msgs[m].msg_hdr;
+
+		if (_msg_packets[m] > 1) {
+			hdr.msg_control = _control[m];
+			hdr.msg_controllen = sizeof(_control[m]);
+
+			cmsghdr *cmsg = CMSG_FIRSTHDR(&hdr);
+			cmsg->cmsg_level = IPPROTO_UDP;
+			cmsg->cmsg_type = UDP_SEGMENT;
+			cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+			const uint16_t gso_size = _iov[m].iov_len / _msg_packets[m];
+			memcpy(CMSG_DATA(cmsg), &gso_size, sizeof(gso_size));
+		}
+	}
+
+	return num_msgs;
+}
+
+void
+MavlinkUdpBatch::flush(unsigned &sent_packets, unsigned &sent_bytes, unsigned &failed_bytes)
+{
+	sent_packets = 0;
+	sent_bytes = 0;
+	failed_bytes = 0;
+
+	size_t first = 0;
+
+	while (first < _num_packets) {
+		const size_t num_msgs = build_messages(first);
+		const int ret = sendmmsg(_socket_fd, _msgs, num_msgs, 0);
+		_total_syscalls++;
+
+		if (ret <= 0) {
+			if (_gso && (errno == EIO || errno == EINVAL || errno == ENOPROTOOPT)) {
+				// no GSO on this route (e.g. no checksum offload), send the packets individually
+				PX4_WARN("UDP GSO send failed (%s), disabled", strerror(errno));
+				_gso = false;
+				continue;
+			}
+
+			break;
+		}
+
+		for (int m = 0; m < ret; m++) {
+			for (size_t p = 0; p < _msg_packets[m]; p++) {
+				const Packet &packet = _packets[first++];
+
+				if (packet.counted) {
+					sent_packets++;
+					sent_bytes += packet.len;
+				}
+			}
+
+			if (_msg_packets[m] > 1) {
+				_total_gso_messages++;
+			}
+		}
+	}
+
+	for (size_t i = first; i < _num_packets; i++) {
+		if (_packets[i].counted) {
+			failed_bytes += _packets[i].len;
+		}
+	}
+
+	_total_packets += first;
+	_total_failed += _num_packets - first;
+
+	_num_packets = 0;
+	_num_destinations = 0;
+	_fill = 0;
+}
+
+void
+MavlinkUdpBatch::print_status() const
+{
+	printf("\tUDP batching: %.1f packets/syscall, GSO: %s (%llu messages), failed: %llu\n",
+	       (_total_syscalls > 0) ? (double)_total_packets / (double)_total_syscalls : 0.,
+	       _gso ? "on" : "off", (unsigned long long)_total_gso_messages, (unsigned long long)_total_failed);
+}
+
+#endif // MAVLINK_UDP_BATCH
@@ -0,0 +1,132 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file mavlink_udp_batch.h
+ * Batched UDP transmit: the packets of a main loop iteration are queued and
+ * sent with a single sendmmsg(). Consecutive packets of the same size to the
+ * same destination are coalesced into one UDP GSO send if the kernel supports it.
+ */
+
+#ifndef MAVLINK_UDP_BATCH_H_
+#define MAVLINK_UDP_BATCH_H_
+
+#if defined(__PX4_LINUX)
+
+#define MAVLINK_UDP_BATCH
+
+#include <stddef.h>
+#include <stdint.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <mavlink_types.h>
+
+class MavlinkUdpBatch
+{
+public:
+	static constexpr size_t MAX_PACKETS = 64;	///< also the GSO segment limit of the kernel
+
+	MavlinkUdpBatch() = default;
+	~MavlinkUdpBatch() = default;
+
+	// no copy, assignment, move, move assignment
+	MavlinkUdpBatch(const MavlinkUdpBatch &) = delete;
+	MavlinkUdpBatch &operator=(const MavlinkUdpBatch &) = delete;
+	MavlinkUdpBatch(MavlinkUdpBatch &&) = delete;
+	MavlinkUdpBatch &operator=(MavlinkUdpBatch &&) = delete;
+
+	/**
+	 * Set the socket and check for UDP GSO support
+	 */
+	void init(int socket_fd);
+
+	bool full() const { return _num_packets >= MAX_PACKETS; }
+	bool empty() const { return _num_packets == 0; }
+
+	/**
+	 * Queue a packet for the next flush.
+	 *
+	 * @param counted whether the packet is accounted for in the flush results (false for broadcast copies)
+	 * @return false if the batch is full
+	 */
+	bool add(const uint8_t *buf, size_t len, const sockaddr_in &addr, bool counted = true);
+
+	/**
+	 * Send all queued packets
+	 *
+	 * @param sent_packets number of counted packets sent
+	 * @param sent_bytes number of counted bytes sent
+	 * @param failed_bytes number of counted bytes which could not be sent
+	 */
+	void flush(unsigned &sent_packets, unsigned &sent_bytes, unsigned &failed_bytes);
+
+	void print_status() const;
+
+private:
+	struct Packet {
+		uint16_t offset;
+		uint16_t len;
+		uint8_t destination;
+		bool counted;
+	};
+
+	// builds the messages for the packets starting at first, returns the number of messages
+	size_t build_messages(size_t first);
+
+	int _socket_fd{-1};
+	bool _gso{false};
+
+	uint8_t _data[MAX_PACKETS * MAVLINK_MAX_PACKET_LEN] {};
+	size_t _fill{0};
+
+	Packet _packets[MAX_PACKETS] {};
+	size_t _num_packets{0};
+
+	sockaddr_in _destinations[MAX_PACKETS] {};
+	size_t _num_destinations{0};
+
+	mmsghdr _msgs[MAX_PACKETS] {};
+	iovec _iov[MAX_PACKETS] {};
+	size_t _msg_packets[MAX_PACKETS] {};	///< number of packets in each message
+	alignas(cmsghdr) uint8_t _control[MAX_PACKETS][CMSG_SPACE(sizeof(uint16_t))] {};
+
+	// statistics
+	uint64_t _total_packets{0};
+	uint64_t _total_syscalls{0};
+	uint64_t _total_gso_messages{0};
+	uint64_t _total_failed{0};
+};
+
+#endif // __PX4_LINUX
+
+#endif /* MAVLINK_UDP_BATCH_H_ */
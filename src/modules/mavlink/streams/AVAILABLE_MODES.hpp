@@ -57,6 +57,8 @@ public:
 		return _had_dynamic_update ? MAVLINK_MSG_ID_AVAILABLE_MODES_MONITOR_LEN + MAVLINK_NUM_NON_PAYLOAD_BYTES : 0;
 	}
 
+	bool always_update() const override { return true; }
+
 private:
 	static constexpr int MAX_NUM_EXTERNAL_MODES = vehicle_status_s::NAVIGATION_STATE_EXTERNAL8 -
 			vehicle_status_s::NAVIGATION_STATE_EXTERNAL1 + 1;
@@ -77,6 +77,8 @@ public:
 
 	bool const_rate() override { return true; }
 
+	bool always_update() const override { return true; }
+
 private:
 	explicit MavlinkStreamHighLatency2(Mavlink *mavlink) :
 		MavlinkStream(mavlink),
@@ -78,13 +78,20 @@ void MulticopterPositionControl::parameters_update(bool force)
 	// check for parameter updates
 	if (_parameter_update_sub.updated() || force) {
 		// clear update
-		parameter_update_s pupdate;
+		parameter_update_s pupdate{};
 		_parameter_update_sub.copy(&pupdate);
 
-		// update parameters from storage
-		ModuleParams::updateParams();
+		// block parameters are not covered by the changed parameter bitset
 		SuperBlock::updateParams();
 
+		// update parameters from storage, skip the rest if none of ours changed
+		if (force) {
+			ModuleParams::updateParams();
+
+		} else if (!ModuleParams::updateParamsIfChanged(pupdate)) {
+			return;
+		}
+
 		int num_changed = 0;
 
 		if (_param_sys_vehicle_resp.get() >= 0.f) {
@@ -36,13 +36,26 @@
 
 const bool mUORB::Aggregator::debugFlag = false;
 
-bool mUORB::Aggregator::NewRecordOverflows(const char *messageName, int32_t length)
+void mUORB::Aggregator::Configure(const Config &new_config)
 {
-	if (! messageName) { return false; }
+	config = new_config;
 
-	uint32_t messageNameLength = strlen(messageName);
-	uint32_t newMessageRecordTotalLength = headerSize + messageNameLength + length;
-	return ((bufferWriteIndex + newMessageRecordTotalLength) > bufferSize);
+	// a buffer has to hold at least the sync flag and one small record
+	if (config.bufferSize < 64) { config.bufferSize = 64; }
+
+	if ((config.flushThreshold == 0) || (config.flushThreshold > config.bufferSize)) {
+		config.flushThreshold = config.bufferSize;
+	}
+
+	delete[] buffer;
+	buffer = new uint8_t[numBuffers * config.bufferSize];
+
+	bufferId = 0;
+	bufferWriteIndex = 0;
+	oldestRecordTime = 0;
+
+	txTopics.clear();
+	deltaScratch.clear();
 }
 
 void mUORB::Aggregator::MoveToNextBuffer()
@@ -52,21 +65,106 @@ void mUORB::Aggregator::MoveToNextBuffer()
 	bufferId %= numBuffers;
 }
 
-void mUORB::Aggregator::AddRecordToBuffer(const char *messageName, int32_t length, const uint8_t *data)
+int mUORB::Aggregator::FindTxTopic(const char *name)
+{
+	const int num_topics = txTopics.size();
+
+	for (int i = 0; i < num_topics; i++) {
+		if (txTopics[i].namePtr == name) {
+			return i;
+		}
+	}
+
+	for (int i = 0; i < num_topics; i++) {
+		if (strcmp(txTopics[i].name.c_str(), name) == 0) {
+			txTopics[i].namePtr = name;
+			return i;
+		}
+	}
+
+	if (num_topics > UINT16_MAX) {
+		return -1;
+	}
+
+	TxTopic topic;
+	topic.name = name;
+	topic.namePtr = name;
+	txTopics.push_back(topic);
+
+	return num_topics;
+}
+
+void mUORB::Aggregator::AppendRecord(RecordType type, uint16_t topic_id, const uint8_t *payload,
+				     uint32_t payload_length)
+{
+	uint8_t *dst = &CurrentBuffer()[bufferWriteIndex];
+	const uint16_t length = payload_length;
+
+	dst[0] = type;
+	memcpy(&dst[1], &topic_id, sizeof(topic_id));
+	memcpy(&dst[3], &length, sizeof(length));
+	memcpy(&dst[recordHeaderSize], payload, payload_length);
+
+	bufferWriteIndex += recordHeaderSize + payload_length;
+}
+
+uint32_t mUORB::Aggregator::EncodeDelta(const uint8_t *previous, const uint8_t *data, uint32_t length, uint8_t *out,
+					uint32_t out_size)
+{
+	uint32_t i = 0;
+	uint32_t o = 0;
+
+	while (i < length) {
+		uint32_t unchanged = 0;
+
+		while ((i < length) && (unchanged < UINT8_MAX) && (previous[i] == data[i])) {
+			unchanged++;
+			i++;
+		}
+
+		const uint32_t changed_start = i;
+		uint32_t changed = 0;
+
+		while ((i < length) && (changed < UINT8_MAX) && (previous[i] != data[i])) {
+			changed++;
+			i++;
+		}
+
+		if (o + 2 + changed > out_size) {
+			// not worth it, send the full message
+			return 0;
+		}
+
+		out[o++] = unchanged;
+		out[o++] = changed;
+		memcpy(&out[o], &data[changed_start], changed);
+		o += changed;
+	}
+
+	return o;
+}
+
+bool mUORB::Aggregator::DecodeDelta(const uint8_t *encoded, uint32_t encoded_length, std::vector<uint8_t> &message)
 {
-	if (! messageName) { return; }
-
-	uint32_t messageNameLength = strlen(messageName);
-	memcpy(&buffer[bufferId][bufferWriteIndex], (uint8_t *) &syncFlag, syncFlagSize);
-	bufferWriteIndex += syncFlagSize;
-	memcpy(&buffer[bufferId][bufferWriteIndex], (uint8_t *) &messageNameLength, topicNameLengthSize);
-	bufferWriteIndex += topicNameLengthSize;
-	memcpy(&buffer[bufferId][bufferWriteIndex], (uint8_t *) &length, dataLengthSize);
-	bufferWriteIndex += dataLengthSize;
-	memcpy(&buffer[bufferId][bufferWriteIndex], (uint8_t *) messageName, messageNameLength);
-	bufferWriteIndex += messageNameLength;
-	memcpy(&buffer[bufferId][bufferWriteIndex], data, length);
-	bufferWriteIndex += length;
+	const uint32_t length = message.size();
+	uint32_t i = 0;
+	uint32_t pos = 0;
+
+	while (i + 2 <= encoded_length) {
+		pos += encoded[i];
+		const uint32_t changed = encoded[i + 1];
+		i += 2;
+
+		if ((pos + changed > length) || (i + changed > encoded_length)) {
+			return false;
+		}
+
+		memcpy(&message[pos], &encoded[i], changed);
+		pos += changed;
+		i += changed;
+	}
+
+	return (i == encoded_length) && (pos == length);
 }
 
 int16_t mUORB::Aggregator::SendData()
@@ -76,7 +174,20 @@ int16_t mUORB::Aggregator::SendData()
 	if (sendFunc) {
 		if (aggregationEnabled) {
 			if (bufferWriteIndex) {
-				rc = sendFunc(topicName.c_str(), buffer[bufferId], bufferWriteIndex);
+				rc = sendFunc(topicNameV2, CurrentBuffer(), bufferWriteIndex);
+				stats.wireBytes += bufferWriteIndex;
+
+				if (rc != 0) {
+					// The receiver may have missed topic definitions and delta
+					// references, start over for all topics
+					stats.sendErrors++;
+
+					for (auto &topic : txTopics) {
+						topic.defined = false;
+						topic.last.clear();
+					}
+				}
+
 				MoveToNextBuffer();
 			}
 		}
@@ -85,19 +196,108 @@ int16_t mUORB::Aggregator::SendData()
 	return rc;
 }
 
-int16_t mUORB::Aggregator::ProcessTransmitTopic(const char *topic, const uint8_t *data, uint32_t length_in_bytes)
+int16_t mUORB::Aggregator::SendDataIfDue(uint64_t now_us)
+{
+	if (bufferWriteIndex && (now_us - oldestRecordTime >= config.maxLatencyUs)) {
+		stats.flushesLatency++;
+		return SendData();
+	}
+
+	return 0;
+}
+
+int16_t mUORB::Aggregator::ProcessTransmitTopic(const char *topic, const uint8_t *data, uint32_t length_in_bytes,
+		uint64_t now_us)
 {
 	int16_t rc = 0;
 
-	if (sendFunc) {
+	if (sendFunc && topic) {
 		if (aggregationEnabled) {
-			if (NewRecordOverflows(topic, length_in_bytes)) {
+			const int topic_id = FindTxTopic(topic);
+			const uint32_t name_length = strlen(topic);
+
+			// worst case: topic definition plus full message
+			const uint32_t worst_case_length = (2 * recordHeaderSize) + name_length + length_in_bytes;
+
+			if ((topic_id < 0) || (length_in_bytes > maxRecordPayload) || (name_length > maxRecordPayload)
+			    || (syncFlagSize + worst_case_length > config.bufferSize)) {
+
+				// does not fit into an aggregation buffer at all, send the pending
+				// records first so the direct message does not overtake them
+				if (bufferWriteIndex) {
+					rc = SendData();
+				}
+
+				stats.directSends++;
+				stats.payloadBytes += length_in_bytes;
+				stats.wireBytes += length_in_bytes;
+
+				const int16_t direct_rc = sendFunc(topic, data, length_in_bytes);
+				return (direct_rc != 0) ? direct_rc : rc;
+			}
+
+			if (bufferWriteIndex && (bufferWriteIndex + worst_case_length > config.bufferSize)) {
+				stats.flushesSize++;
 				rc = SendData();
 			}
 
-			AddRecordToBuffer(topic, length_in_bytes, data);
+			if (bufferWriteIndex == 0) {
+				memcpy(CurrentBuffer(), &syncFlagV2, syncFlagSize);
+				bufferWriteIndex = syncFlagSize;
+				oldestRecordTime = now_us;
+			}
+
+			TxTopic &tx_topic = txTopics[topic_id];
 
-		} else if (topic) {
+			// a keyframe repeats the definition and sends the full message, so
+			// that a receiver that restarted or lost a buffer recovers the topic
+			const bool keyframe = tx_topic.defined && (tx_topic.records >= config.keyframeInterval);
+
+			if (!tx_topic.defined || keyframe) {
+				AppendRecord(RECORD_DEFINE, topic_id, (const uint8_t *) topic, name_length);
+				tx_topic.defined = true;
+				tx_topic.records = 0;
+
+				if (keyframe) {
+					stats.keyframes++;
+				}
+			}
+
+			uint32_t encoded_length = 0;
+
+			if (config.deltaEncoding && !keyframe && (tx_topic.last.size() == length_in_bytes)) {
+				if (deltaScratch.size() < length_in_bytes) {
+					deltaScratch.resize(length_in_bytes);
+				}
+
+				// only use the delta if it is smaller than the message itself
+				encoded_length = EncodeDelta(tx_topic.last.data(), data, length_in_bytes, deltaScratch.data(),
+							     length_in_bytes - 1);
+			}
+
+			if (encoded_length > 0) {
+				AppendRecord(RECORD_DELTA, topic_id, deltaScratch.data(), encoded_length);
+				stats.deltaRecords++;
+
+			} else {
+				AppendRecord(RECORD_DATA, topic_id, data, length_in_bytes);
+			}
+
+			tx_topic.last.assign(data, data + length_in_bytes);
+			tx_topic.records++;
+
+			stats.records++;
+			stats.payloadBytes += length_in_bytes;
+
+			if (bufferWriteIndex >= config.flushThreshold) {
+				stats.flushesSize++;
+				rc = SendData();
+
+			} else {
+				rc = SendDataIfDue(now_us);
+			}
+
+		} else {
 			rc = sendFunc(topic, data, length_in_bytes);
 		}
 	}
@@ -105,59 +305,148 @@ int16_t mUORB::Aggregator::ProcessTransmitTopic(const char *topic, const uint8_t
 	return rc;
 }
 
-void mUORB::Aggregator::ProcessReceivedTopic(const char *topic, const uint8_t *data, uint32_t length_in_bytes)
+void mUORB::Aggregator::ProcessReceivedV1(const uint8_t *data, uint32_t length_in_bytes)
 {
-	if (isAggregate(topic)) {
-		if (debugFlag) { PX4_INFO("Parsing aggregate buffer of length %u", length_in_bytes); }
+	uint32_t current_index = 0;
+	const uint32_t name_buffer_length = 80;
+	char name_buffer[name_buffer_length];
+
+	while ((current_index + headerSize) < length_in_bytes) {
+		uint32_t sync_flag = *((uint32_t *) &data[current_index]);
 
-		uint32_t current_index = 0;
-		const uint32_t name_buffer_length = 80;
-		char name_buffer[name_buffer_length];
+		if (sync_flag != syncFlag) {
+			PX4_ERR("Expected sync flag but got 0x%X", sync_flag);
+			break;
+		}
 
-		while ((current_index + headerSize) < length_in_bytes) {
-			uint32_t sync_flag = *((uint32_t *) &data[current_index]);
+		current_index += syncFlagSize;
 
-			if (sync_flag != syncFlag) {
-				PX4_ERR("Expected sync flag but got 0x%X", sync_flag);
-				break;
-			}
+		uint32_t name_length = *((uint32_t *) &data[current_index]);
 
-			current_index += syncFlagSize;
+		// Make sure name plus a terminating null can fit into our buffer
+		if (name_length > (name_buffer_length - 1)) {
+			PX4_ERR("Name length too long %u", name_length);
+			break;
+		}
 
-			uint32_t name_length = *((uint32_t *) &data[current_index]);
+		current_index += topicNameLengthSize;
 
-			// Make sure name plus a terminating null can fit into our buffer
-			if (name_length > (name_buffer_length - 1)) {
-				PX4_ERR("Name length too long %u", name_length);
-				break;
-			}
+		uint32_t data_length = *((uint32_t *) &data[current_index]);
+		current_index += dataLengthSize;
+
+		int32_t payload_size = name_length + data_length;
+		int32_t remaining_bytes = length_in_bytes - current_index;
+
+		if (payload_size > remaining_bytes) {
+			PX4_ERR("Payload too big %u. Remaining bytes %d", payload_size, remaining_bytes);
+			break;
+		}
+
+		memcpy(name_buffer, &data[current_index], name_length);
+		name_buffer[name_length] = 0;
+
+		current_index += name_length;
+
+		if (debugFlag) { PX4_INFO("Parsed topic: %s, name length %u, data length: %u", name_buffer, name_length, data_length); }
+
+		_RxHandler->process_received_message(name_buffer,
+						     data_length,
+						     const_cast<uint8_t *>(&data[current_index]));
+		current_index += data_length;
+	}
+}
+
+void mUORB::Aggregator::ProcessReceivedV2(const uint8_t *data, uint32_t length_in_bytes)
+{
+	uint32_t sync_flag = 0;
+
+	if (length_in_bytes >= syncFlagSize) {
+		memcpy(&sync_flag, data, syncFlagSize);
+	}
+
+	if (sync_flag != syncFlagV2) {
+		PX4_ERR("Expected sync flag but got 0x%X", sync_flag);
+		return;
+	}
 
-			current_index += topicNameLengthSize;
+	uint32_t current_index = syncFlagSize;
 
-			uint32_t data_length = *((uint32_t *) &data[current_index]);
-			current_index += dataLengthSize;
+	while ((current_index + recordHeaderSize) <= length_in_bytes) {
+		const uint8_t type = data[current_index];
+		uint16_t topic_id;
+		uint16_t payload_length;
+		memcpy(&topic_id, &data[current_index + 1], sizeof(topic_id));
+		memcpy(&payload_length, &data[current_index + 3], sizeof(payload_length));
+		current_index += recordHeaderSize;
 
-			int32_t payload_size = name_length + data_length;
-			int32_t remaining_bytes = length_in_bytes - current_index;
+		if (payload_length > (length_in_bytes - current_index)) {
+			PX4_ERR("Payload too big %u. Remaining bytes %u", payload_length, length_in_bytes - current_index);
+			return;
+		}
+
+		const uint8_t *payload = &data[current_index];
+		current_index += payload_length;
 
-			if (payload_size > remaining_bytes) {
-				PX4_ERR("Payload too big %u. Remaining bytes %d", payload_size, remaining_bytes);
-				break;
+		if (type == RECORD_DEFINE) {
+			if (topic_id >= rxTopics.size()) {
+				rxTopics.resize(topic_id + 1);
 			}
 
-			memcpy(name_buffer, &data[current_index], name_length);
-			name_buffer[name_length] = 0;
+			rxTopics[topic_id].name.assign((const char *) payload, payload_length);
+			rxTopics[topic_id].last.clear();
 
-			current_index += name_length;
+			if (debugFlag) { PX4_INFO("Topic %s has id %u", rxTopics[topic_id].name.c_str(), topic_id); }
+
+			continue;
+		}
 
-			if (debugFlag) { PX4_INFO("Parsed topic: %s, name length %u, data length: %u", name_buffer, name_length, data_length); }
+		if ((topic_id >= rxTopics.size()) || rxTopics[topic_id].name.empty()) {
+			// definition not received yet (e.g. receiver restart), wait for the next keyframe
+			if (debugFlag) { PX4_INFO("Unknown topic id %u", topic_id); }
 
-			_RxHandler->process_received_message(name_buffer,
-							     data_length,
-							     const_cast<uint8_t *>(&data[current_index]));
-			current_index += data_length;
+			continue;
 		}
 
+		RxTopic &rx_topic = rxTopics[topic_id];
+
+		if (type == RECORD_DATA) {
+			rx_topic.last.assign(payload, payload + payload_length);
+
+		} else if (type == RECORD_DELTA) {
+			if (rx_topic.last.empty()) {
+				// the reference was lost (e.g. receiver restart), wait for the next keyframe
+				continue;
+			}
+
+			if (!DecodeDelta(payload, payload_length, rx_topic.last)) {
+				PX4_ERR("Invalid delta record for %s", rx_topic.name.c_str());
+				rx_topic.last.clear();
+				continue;
+			}
+
+		} else {
+			PX4_ERR("Unknown record type %u", type);
+			return;
+		}
+
+		if (debugFlag) { PX4_INFO("Parsed topic: %s, data length: %u", rx_topic.name.c_str(), (unsigned) rx_topic.last.size()); }
+
+		_RxHandler->process_received_message(rx_topic.name.c_str(), rx_topic.last.size(), rx_topic.last.data());
+	}
+}
+
+void mUORB::Aggregator::ProcessReceivedTopic(const char *topic, const uint8_t *data, uint32_t length_in_bytes)
+{
+	if (isAggregateV2(topic)) {
+		if (debugFlag) { PX4_INFO("Parsing aggregate buffer of length %u", length_in_bytes); }
+
+		ProcessReceivedV2(data, length_in_bytes);
+
+	} else if (isAggregate(topic)) {
+		if (debugFlag) { PX4_INFO("Parsing version 1 aggregate buffer of length %u", length_in_bytes); }
+
+		ProcessReceivedV1(data, length_in_bytes);
+
 	} else {
 		if (debugFlag) { PX4_INFO("Got non-aggregate buffer for topic %s", topic); }
 
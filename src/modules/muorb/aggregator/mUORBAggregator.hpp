@@ -34,58 +34,172 @@
 #pragma once
 
 #include <string>
+#include <vector>
+#include <stdint.h>
 #include <string.h>
 #include "uORB/uORBCommunicator.hpp"
 
 namespace mUORB
 {
 
+/**
+ * Batches the topic data sent to the remote processor into larger buffers.
+ *
+ * Version 2 of the wire format (topic "aggregation2") starts every buffer
+ * with a sync word, followed by records with a 5 byte header:
+ *   uint8 type, uint16 topic id, uint16 payload length
+ * Topic ids are interned by the sender: a DEFINE record carrying the topic
+ * name is sent before the first data record of a topic. DATA records carry
+ * the raw message, DELTA records only the bytes that changed relative to the
+ * previous message of the same topic, run-length encoded as
+ * (unchanged count, changed count, changed bytes) tuples.
+ *
+ * Every keyframeInterval records a topic is sent as a keyframe: its DEFINE
+ * record again followed by a full DATA record. This way a receiver that
+ * restarted or missed a buffer learns the topic ids and delta references
+ * again, without needing a back channel.
+ *
+ * Buffers are sent once they reach the flush threshold or the oldest record
+ * exceeds the latency deadline. Version 1 buffers ("aggregation") are still
+ * accepted on the receive side.
+ */
 class Aggregator
 {
 public:
 	typedef int (*sendFuncPtr)(const char *, const uint8_t *, int);
 
+	struct Config {
+		uint32_t bufferSize{4096};     ///< capacity of each buffer [bytes]
+		uint32_t flushThreshold{2048}; ///< send when this many bytes are buffered [bytes]
+		uint32_t maxLatencyUs{1000};   ///< send when the oldest buffered record is this old [us]
+		bool deltaEncoding{true};      ///< delta encode repeated messages of a topic
+		uint32_t keyframeInterval{32}; ///< re-send definition and full message after this many records of a topic
+	};
+
+	struct Stats {
+		uint32_t records{0};        ///< data records added to a buffer
+		uint32_t deltaRecords{0};   ///< of which were delta encoded
+		uint32_t keyframes{0};      ///< of which were periodic keyframes
+		uint32_t directSends{0};    ///< messages too large to aggregate, sent directly
+		uint32_t flushesSize{0};    ///< buffers sent because of the flush threshold
+		uint32_t flushesLatency{0}; ///< buffers sent because of the latency deadline
+		uint32_t sendErrors{0};
+		uint64_t payloadBytes{0};   ///< raw message bytes handed to the aggregator
+		uint64_t wireBytes{0};      ///< bytes passed to the send function
+	};
+
+	Aggregator() { Configure(Config{}); }
+	~Aggregator() { delete[] buffer; }
+
+	// no copy, assignment, move, move assignment
+	Aggregator(const Aggregator &) = delete;
+	Aggregator &operator=(const Aggregator &) = delete;
+	Aggregator(Aggregator &&) = delete;
+	Aggregator &operator=(Aggregator &&) = delete;
+
+	/**
+	 * Apply a new configuration, drops all buffered data and interned topics.
+	 */
+	void Configure(const Config &config);
+
 	void RegisterSendHandler(sendFuncPtr func) { sendFunc = func; }
 
 	void RegisterHandler(uORBCommunicator::IChannelRxHandler *handler) { _RxHandler = handler; }
 
-	int16_t ProcessTransmitTopic(const char *topic, const uint8_t *data, uint32_t length_in_bytes);
+	int16_t ProcessTransmitTopic(const char *topic, const uint8_t *data, uint32_t length_in_bytes, uint64_t now_us);
 
 	void ProcessReceivedTopic(const char *topic, const uint8_t *data, uint32_t length_in_bytes);
 
+	/**
+	 * Send the current buffer regardless of its age or size.
+	 */
 	int16_t SendData();
 
+	/**
+	 * Send the current buffer if the oldest record reached the latency deadline.
+	 */
+	int16_t SendDataIfDue(uint64_t now_us);
+
+	const Stats &GetStats() const { return stats; }
+
 private:
 	static const bool debugFlag;
 
-	const std::string topicName = "aggregation";
+	const char *const topicName = "aggregation";
+	const char *const topicNameV2 = "aggregation2";
 
 	// Master flag to enable aggregation
 	const bool aggregationEnabled = true;
 
+	// version 1 format
 	const uint32_t syncFlag = 0x5A01FF00;
 	const uint32_t syncFlagSize = 4;
 	const uint32_t topicNameLengthSize = 4;
 	const uint32_t dataLengthSize = 4;
 	const uint32_t headerSize = syncFlagSize + topicNameLengthSize + dataLengthSize;
+
+	// version 2 format
+	const uint32_t syncFlagV2 = 0x5A02FF00;
+	const uint32_t recordHeaderSize = 5;
+	const uint32_t maxRecordPayload = UINT16_MAX;
+
+	enum RecordType : uint8_t {
+		RECORD_DEFINE = 1,
+		RECORD_DATA = 2,
+		RECORD_DELTA = 3,
+	};
+
+	struct TxTopic {
+		std::string name;
+		const char *namePtr{nullptr}; ///< last pointer the name was passed with, fast path for lookups
+		std::vector<uint8_t> last;    ///< last message sent, reference for delta encoding
+		uint32_t records{0};          ///< records since the last keyframe
+		bool defined{false};          ///< DEFINE record was sent
+	};
+
+	struct RxTopic {
+		std::string name;
+		std::vector<uint8_t> last;    ///< last message received, reference for delta decoding
+	};
+
 	static const uint32_t numBuffers = 2;
-	static const uint32_t bufferSize = 2048;
 
-	uint32_t bufferId;
-	uint32_t bufferWriteIndex;
-	uint8_t  buffer[numBuffers][bufferSize];
+	Config config{};
 
-	uORBCommunicator::IChannelRxHandler *_RxHandler;
+	uint32_t bufferId{0};
+	uint32_t bufferWriteIndex{0};
+	uint8_t *buffer{nullptr}; ///< numBuffers * config.bufferSize
+	uint64_t oldestRecordTime{0};
 
-	sendFuncPtr sendFunc;
+	std::vector<TxTopic> txTopics;
+	std::vector<RxTopic> rxTopics;
+	std::vector<uint8_t> deltaScratch;
 
-	bool isAggregate(const char *name) { return (strcmp(name, topicName.c_str()) == 0); }
+	Stats stats{};
 
-	bool NewRecordOverflows(const char *messageName, int32_t length);
+	uORBCommunicator::IChannelRxHandler *_RxHandler{nullptr};
+
+	sendFuncPtr sendFunc{nullptr};
+
+	uint8_t *CurrentBuffer() { return &buffer[bufferId * config.bufferSize]; }
+
+	bool isAggregate(const char *name) { return (strcmp(name, topicName) == 0); }
+	bool isAggregateV2(const char *name) { return (strcmp(name, topicNameV2) == 0); }
 
 	void MoveToNextBuffer();
 
-	void AddRecordToBuffer(const char *messageName, int32_t length, const uint8_t *data);
+	int FindTxTopic(const char *name);
+
+	void AppendRecord(RecordType type, uint16_t topic_id, const uint8_t *payload, uint32_t payload_length);
+
+	uint32_t EncodeDelta(const uint8_t *previous, const uint8_t *data, uint32_t length, uint8_t *out,
+			     uint32_t out_size);
+
+	bool DecodeDelta(const uint8_t *encoded, uint32_t encoded_length, std::vector<uint8_t> &message);
+
+	void ProcessReceivedV1(const uint8_t *data, uint32_t length_in_bytes);
+
+	void ProcessReceivedV2(const uint8_t *data, uint32_t length_in_bytes);
 };
 
 }
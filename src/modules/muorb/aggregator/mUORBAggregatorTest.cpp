@@ -0,0 +1,375 @@
+/****************************************************************************
+ *
+ * Copyright (C) 2024 ModalAI, Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * Host side loopback test of the muorb aggregator: the fastRPC send function
+ * is replaced by a function feeding the buffers straight into a receiving
+ * aggregator, so that the wire format, throughput and latency can be checked
+ * on plain Linux.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "mUORBAggregator.hpp"
+
+namespace
+{
+
+struct ReceivedMessage {
+	std::string topic;
+	std::vector<uint8_t> data;
+};
+
+class LoopbackRxHandler : public uORBCommunicator::IChannelRxHandler
+{
+public:
+	int16_t process_remote_topic(const char *topic_name) override { return 0; }
+	int16_t process_add_subscription(const char *messageName) override { return 0; }
+	int16_t process_remove_subscription(const char *messageName) override { return 0; }
+
+	int16_t process_received_message(const char *messageName, int32_t length, uint8_t *data) override
+	{
+		received.push_back(ReceivedMessage{messageName, std::vector<uint8_t>(data, data + length)});
+		return 0;
+	}
+
+	std::vector<ReceivedMessage> received;
+};
+
+// the send function is a plain function pointer, route it through globals
+mUORB::Aggregator *loopback_receiver = nullptr;
+int loopback_sends = 0;
+bool loopback_fail_next = false;
+
+int loopbackSend(const char *topic, const uint8_t *data, int length)
+{
+	loopback_sends++;
+
+	if (loopback_fail_next) {
+		// simulate a lost buffer
+		loopback_fail_next = false;
+		return -1;
+	}
+
+	loopback_receiver->ProcessReceivedTopic(topic, data, length);
+	return 0;
+}
+
+// Something that looks like a sensor message: timestamp and samples change, the rest is constant
+struct TestSample {
+	uint64_t timestamp;
+	uint64_t timestamp_sample;
+	uint32_t device_id;
+	float x;
+	float y;
+	float z;
+	float temperature;
+	uint32_t error_count;
+	uint8_t samples;
+	uint8_t padding[7];
+};
+
+TestSample makeSample(int i)
+{
+	TestSample sample{};
+	sample.timestamp = 1000000 + i * 125;
+	sample.timestamp_sample = sample.timestamp - 50;
+	sample.device_id = 2490378;
+	sample.x = 0.001f * (i % 7);
+	sample.y = -0.002f;
+	sample.z = 9.81f;
+	sample.temperature = 42.f;
+	sample.samples = 1;
+	return sample;
+}
+
+class MuorbAggregatorTest : public ::testing::Test
+{
+public:
+	void SetUp() override
+	{
+		loopback_receiver = &_receiver;
+		loopback_sends = 0;
+		loopback_fail_next = false;
+
+		_sender.RegisterSendHandler(&loopbackSend);
+		_receiver.RegisterHandler(&_rx_handler);
+	}
+
+	void transmit(const char *topic, const TestSample &sample, uint64_t now)
+	{
+		_sender.ProcessTransmitTopic(topic, (const uint8_t *) &sample, sizeof(sample), now);
+	}
+
+	mUORB::Aggregator _sender;
+	mUORB::Aggregator _receiver;
+	LoopbackRxHandler _rx_handler;
+};
+
+} // namespace
+
+TEST_F(MuorbAggregatorTest, RoundTrip)
+{
+	const char *topics[] = {"sensor_gyro", "sensor_accel", "sensor_baro", "esc_status"};
+	std::vector<ReceivedMessage> sent;
+
+	for (int i = 0; i < 500; i++) {
+		const char *topic = topics[i % 4];
+		TestSample sample = makeSample(i);
+		transmit(topic, sample, i * 10);
+		sent.push_back(ReceivedMessage{topic, std::vector<uint8_t>((uint8_t *) &sample, (uint8_t *) &sample + sizeof(sample))});
+	}
+
+	_sender.SendData();
+
+	ASSERT_EQ(_rx_handler.received.size(), sent.size());
+
+	for (size_t i = 0; i < sent.size(); i++) {
+		EXPECT_EQ(_rx_handler.received[i].topic, sent[i].topic);
+		EXPECT_EQ(_rx_handler.received[i].data, sent[i].data);
+	}
+
+	// repeated sensor structs are mostly delta encoded and cheaper than the raw data
+	const mUORB::Aggregator::Stats &stats = _sender.GetStats();
+	EXPECT_GT(stats.deltaRecords, stats.records / 2);
+	EXPECT_LT(stats.wireBytes, stats.payloadBytes);
+}
+
+TEST_F(MuorbAggregatorTest, NoDeltaEncoding)
+{
+	mUORB::Aggregator::Config config{};
+	config.deltaEncoding = false;
+	_sender.Configure(config);
+
+	for (int i = 0; i < 100; i++) {
+		transmit("sensor_gyro", makeSample(i), 0);
+	}
+
+	_sender.SendData();
+
+	ASSERT_EQ(_rx_handler.received.size(), 100u);
+	EXPECT_EQ(_sender.GetStats().deltaRecords, 0u);
+
+	TestSample last = makeSample(99);
+	EXPECT_EQ(memcmp(_rx_handler.received.back().data.data(), &last, sizeof(last)), 0);
+}
+
+TEST_F(MuorbAggregatorTest, LatencyDeadline)
+{
+	mUORB::Aggregator::Config config{};
+	config.maxLatencyUs = 1000;
+	_sender.Configure(config);
+
+	transmit("sensor_baro", makeSample(0), 10000);
+
+	// below the byte threshold and deadline: nothing is sent
+	EXPECT_EQ(_sender.SendDataIfDue(10500), 0);
+	EXPECT_EQ(loopback_sends, 0);
+
+	EXPECT_EQ(_sender.SendDataIfDue(11000), 0);
+	EXPECT_EQ(loopback_sends, 1);
+	EXPECT_EQ(_rx_handler.received.size(), 1u);
+
+	// a new record past the deadline of the oldest one flushes immediately
+	transmit("sensor_baro", makeSample(1), 20000);
+	transmit("sensor_baro", makeSample(2), 21000);
+	EXPECT_EQ(loopback_sends, 2);
+	EXPECT_EQ(_rx_handler.received.size(), 3u);
+}
+
+TEST_F(MuorbAggregatorTest, FlushThreshold)
+{
+	mUORB::Aggregator::Config config{};
+	config.bufferSize = 1024;
+	config.flushThreshold = 256;
+	config.deltaEncoding = false;
+	_sender.Configure(config);
+
+	int sends_expected = 0;
+
+	for (int i = 0; i < 100; i++) {
+		transmit("sensor_gyro", makeSample(i), 0);
+	}
+
+	// define record, then full records of 5 + 64 bytes
+	sends_expected = (100 * (5 + sizeof(TestSample))) / 256;
+	EXPECT_NEAR(loopback_sends, sends_expected, 1);
+}
+
+TEST_F(MuorbAggregatorTest, LargeMessageSentDirectly)
+{
+	mUORB::Aggregator::Config config{};
+	config.bufferSize = 256;
+	_sender.Configure(config);
+
+	std::vector<uint8_t> large(1000, 0xAB);
+	_sender.ProcessTransmitTopic("obstacle_distance", large.data(), large.size(), 0);
+
+	ASSERT_EQ(_rx_handler.received.size(), 1u);
+	EXPECT_EQ(_rx_handler.received[0].topic, "obstacle_distance");
+	EXPECT_EQ(_rx_handler.received[0].data, large);
+	EXPECT_EQ(_sender.GetStats().directSends, 1u);
+}
+
+TEST_F(MuorbAggregatorTest, LargeMessageKeepsOrder)
+{
+	mUORB::Aggregator::Config config{};
+	config.bufferSize = 256;
+	_sender.Configure(config);
+
+	transmit("sensor_gyro", makeSample(0), 0);
+	transmit("sensor_accel", makeSample(1), 0);
+	EXPECT_EQ(loopback_sends, 0);
+
+	// the buffered records have to arrive before the directly sent message
+	std::vector<uint8_t> large(1000, 0xAB);
+	_sender.ProcessTransmitTopic("obstacle_distance", large.data(), large.size(), 0);
+
+	ASSERT_EQ(_rx_handler.received.size(), 3u);
+	EXPECT_EQ(_rx_handler.received[0].topic, "sensor_gyro");
+	EXPECT_EQ(_rx_handler.received[1].topic, "sensor_accel");
+	EXPECT_EQ(_rx_handler.received[2].topic, "obstacle_distance");
+	EXPECT_EQ(_rx_handler.received[2].data, large);
+}
+
+TEST_F(MuorbAggregatorTest, ResyncAfterSendFailure)
+{
+	for (int i = 0; i < 10; i++) {
+		transmit("sensor_gyro", makeSample(i), 0);
+	}
+
+	// the buffer with the topic definition gets lost
+	loopback_fail_next = true;
+	_sender.SendData();
+	EXPECT_EQ(_rx_handler.received.size(), 0u);
+
+	for (int i = 10; i < 20; i++) {
+		transmit("sensor_gyro", makeSample(i), 0);
+	}
+
+	_sender.SendData();
+
+	ASSERT_EQ(_rx_handler.received.size(), 10u);
+	TestSample last = makeSample(19);
+	EXPECT_EQ(memcmp(_rx_handler.received.back().data.data(), &last, sizeof(last)), 0);
+}
+
+TEST_F(MuorbAggregatorTest, ReceiverRestart)
+{
+	mUORB::Aggregator::Config config{};
+	config.keyframeInterval = 8;
+	_sender.Configure(config);
+
+	for (int i = 0; i < 10; i++) {
+		transmit("sensor_gyro", makeSample(i), 0);
+		transmit("sensor_accel", makeSample(i), 0);
+	}
+
+	_sender.SendData();
+	ASSERT_EQ(_rx_handler.received.size(), 20u);
+
+	// the receiver comes up again without the topic definitions and delta references
+	mUORB::Aggregator restarted_receiver;
+	LoopbackRxHandler restarted_rx_handler;
+	restarted_receiver.RegisterHandler(&restarted_rx_handler);
+	loopback_receiver = &restarted_receiver;
+
+	for (int i = 10; i < 30; i++) {
+		transmit("sensor_gyro", makeSample(i), 0);
+		transmit("sensor_accel", makeSample(i), 0);
+		_sender.SendData();
+	}
+
+	// records before the next keyframe are dropped, everything after it arrives
+	ASSERT_GE(restarted_rx_handler.received.size(), 2u * (30 - 10 - config.keyframeInterval));
+	EXPECT_GT(_sender.GetStats().keyframes, 0u);
+
+	TestSample last = makeSample(29);
+	const ReceivedMessage &received_last = restarted_rx_handler.received.back();
+	EXPECT_EQ(received_last.topic, "sensor_accel");
+	EXPECT_EQ(memcmp(received_last.data.data(), &last, sizeof(last)), 0);
+
+	for (size_t i = 0; i < restarted_rx_handler.received.size(); i += 2) {
+		EXPECT_EQ(restarted_rx_handler.received[i].topic, "sensor_gyro");
+	}
+}
+
+TEST_F(MuorbAggregatorTest, Version1Buffer)
+{
+	// syncFlag, name length, data length, name, data
+	const uint32_t header[3] = {0x5A01FF00, 4, 2};
+	std::vector<uint8_t> buffer((uint8_t *) header, (uint8_t *) header + sizeof(header));
+	const char name[] = "test";
+	buffer.insert(buffer.end(), name, name + 4);
+	buffer.push_back(1);
+	buffer.push_back(2);
+
+	_receiver.ProcessReceivedTopic("aggregation", buffer.data(), buffer.size());
+
+	ASSERT_EQ(_rx_handler.received.size(), 1u);
+	EXPECT_EQ(_rx_handler.received[0].topic, "test");
+	EXPECT_EQ(_rx_handler.received[0].data, std::vector<uint8_t>({1, 2}));
+}
+
+TEST_F(MuorbAggregatorTest, Throughput)
+{
+	// 8 kHz IMU plus some slower topics, timed on a 125 us grid
+	const int num_messages = 200000;
+	const char *topics[] = {"sensor_gyro", "sensor_accel", "sensor_gyro", "sensor_accel", "sensor_baro", "esc_status"};
+
+	const auto start = std::chrono::steady_clock::now();
+
+	for (int i = 0; i < num_messages; i++) {
+		transmit(topics[i % 6], makeSample(i), (uint64_t) i * 125 / 6);
+	}
+
+	_sender.SendData();
+
+	const auto end = std::chrono::steady_clock::now();
+	const double elapsed_s = std::chrono::duration<double>(end - start).count();
+
+	ASSERT_EQ(_rx_handler.received.size(), (size_t) num_messages);
+
+	const mUORB::Aggregator::Stats &stats = _sender.GetStats();
+	printf("%d messages in %.3f s (%.0f msg/s), %d buffers, %.1f%% of payload on the wire, "
+	       "flushes: %u size, %u latency\n",
+	       num_messages, elapsed_s, num_messages / elapsed_s, loopback_sends,
+	       100.0 * stats.wireBytes / stats.payloadBytes, stats.flushesSize, stats.flushesLatency);
+
+	EXPECT_LT(stats.wireBytes, stats.payloadBytes);
+}
@@ -42,9 +42,8 @@ bool uORB::AppsProtobufChannel::test_flag = false;
 uORB::AppsProtobufChannel *uORB::AppsProtobufChannel::_InstancePtr = nullptr;
 uORBCommunicator::IChannelRxHandler *uORB::AppsProtobufChannel::_RxHandler = nullptr;
 mUORB::Aggregator uORB::AppsProtobufChannel::_Aggregator;
-std::map<std::string, int> uORB::AppsProtobufChannel::_SlpiSubscriberCache;
+px4::atomic<int32_t> uORB::AppsProtobufChannel::_SlpiSubscriberCache[ORB_TOPICS_COUNT];
 pthread_mutex_t uORB::AppsProtobufChannel::_tx_mutex = PTHREAD_MUTEX_INITIALIZER;
-pthread_mutex_t uORB::AppsProtobufChannel::_rx_mutex = PTHREAD_MUTEX_INITIALIZER;
 bool uORB::AppsProtobufChannel::_Debug = false;
 
 
@@ -55,7 +54,12 @@ void uORB::AppsProtobufChannel::ReceiveCallback(const char *topic,
 
 	if (_Debug) { PX4_INFO("Got Receive callback for topic %s", topic); }
 
-	if (strcmp(topic, "slpi_debug") == 0) {
+	// Regular topics resolve through the generated topic hash, only the
+	// special channel names need the string compares below.
+	if ((get_orb_id(topic) != ORB_ID::INVALID) && _RxHandler) {
+		_Aggregator.ProcessReceivedTopic(topic, data, length_in_bytes);
+
+	} else if (strcmp(topic, "slpi_debug") == 0) {
 		PX4_INFO("SLPI: %s", (const char *) data);
 
 	} else if (strcmp(topic, "slpi_error") == 0) {
@@ -119,9 +123,11 @@ void uORB::AppsProtobufChannel::SubscribeCallback(const char *topic)
 		// SLPI image that doesn't support the CPULOAD request. If the
 		// SLPI image does support it then we wouldn't get this.
 	} else if (_RxHandler) {
-		pthread_mutex_lock(&_rx_mutex);
-		_SlpiSubscriberCache[topic]++;
-		pthread_mutex_unlock(&_rx_mutex);
+		const ORB_ID orb_id = get_orb_id(topic);
+
+		if (orb_id != ORB_ID::INVALID) {
+			_SlpiSubscriberCache[static_cast<size_t>(orb_id)].fetch_add(1);
+		}
 
 		_RxHandler->process_add_subscription(topic);
 
@@ -139,11 +145,14 @@ void uORB::AppsProtobufChannel::UnsubscribeCallback(const char *topic)
 		return;
 
 	} else if (_RxHandler) {
-		pthread_mutex_lock(&_rx_mutex);
+		const ORB_ID orb_id = get_orb_id(topic);
 
-		if (_SlpiSubscriberCache[topic]) { _SlpiSubscriberCache[topic]--; }
+		if (orb_id != ORB_ID::INVALID) {
+			px4::atomic<int32_t> &count = _SlpiSubscriberCache[static_cast<size_t>(orb_id)];
+			int32_t current = count.load();
 
-		pthread_mutex_unlock(&_rx_mutex);
+			while ((current > 0) && !count.compare_exchange(&current, current - 1)) {}
+		}
 
 		_RxHandler->process_remove_subscription(topic);
 
@@ -301,9 +310,12 @@ int16_t uORB::AppsProtobufChannel::send_message(const char *messageName, int len
 	}
 
 	if (_Initialized) {
-		pthread_mutex_lock(&_rx_mutex);
-		int has_subscribers = _SlpiSubscriberCache[messageName];
-		pthread_mutex_unlock(&_rx_mutex);
+		const ORB_ID orb_id = get_orb_id(messageName);
+		int has_subscribers = 0;
+
+		if (orb_id != ORB_ID::INVALID) {
+			has_subscribers = _SlpiSubscriberCache[static_cast<size_t>(orb_id)].load();
+		}
 
 		if (has_subscribers) {
 			if (_Debug && enable_debug) {
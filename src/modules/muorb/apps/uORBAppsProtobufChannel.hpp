@@ -35,10 +35,10 @@
 #define _uORBAppsProtobufChannel_hpp_
 
 #include <stdint.h>
-#include <string>
-#include <map>
 
+#include <px4_platform_common/atomic.h>
 #include <px4_platform_common/log.h>
+#include <uORB/topics/uORBTopics.hpp>
 
 #include "MUORBTest.hpp"
 #include "uORB/uORBCommunicator.hpp"
@@ -163,9 +163,8 @@ private:
 	static uORB::AppsProtobufChannel           *_InstancePtr;
 	static uORBCommunicator::IChannelRxHandler *_RxHandler;
 	static mUORB::Aggregator					_Aggregator;
-	static std::map<std::string, int>           _SlpiSubscriberCache;
+	static px4::atomic<int32_t>                 _SlpiSubscriberCache[ORB_TOPICS_COUNT];
 	static pthread_mutex_t                      _tx_mutex;
-	static pthread_mutex_t                      _rx_mutex;
 	static bool                                 _Debug;
 
 	bool                                        _Initialized;
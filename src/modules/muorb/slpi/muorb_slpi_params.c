@@ -0,0 +1,83 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * muorb aggregation flush threshold
+ *
+ * Topic data sent from the DSP to the apps processor is batched and the
+ * batch is sent once it reaches this size in bytes.
+ *
+ * @min 64
+ * @max 4096
+ * @reboot_required false
+ * @group muORB
+ */
+PARAM_DEFINE_INT32(MUORB_AGG_FLUSH, 2048);
+
+/**
+ * muorb aggregation latency limit
+ *
+ * A batch is sent at the latest once its oldest message reached this age.
+ *
+ * @unit us
+ * @min 0
+ * @max 100000
+ * @reboot_required false
+ * @group muORB
+ */
+PARAM_DEFINE_INT32(MUORB_AGG_LAT, 1000);
+
+/**
+ * muorb aggregation delta encoding
+ *
+ * Only send the bytes that changed relative to the previous message of a topic.
+ *
+ * @boolean
+ * @reboot_required false
+ * @group muORB
+ */
+PARAM_DEFINE_INT32(MUORB_AGG_DELTA, 1);
+
+/**
+ * muorb aggregation keyframe interval
+ *
+ * After this many messages of a topic, its definition and the full message
+ * are sent again (keyframe). Keyframes reset the delta encoding and let a
+ * receiver that restarted or lost a buffer recover the topic.
+ *
+ * @min 1
+ * @max 1000
+ * @reboot_required false
+ * @group muORB
+ */
+PARAM_DEFINE_INT32(MUORB_AGG_KEYFR, 32);
@@ -44,11 +44,15 @@
 #include <px4_platform_common/tasks.h>
 #include <px4_platform_common/log.h>
 #include <lib/parameters/param.h>
+#include <uORB/SubscriptionInterval.hpp>
+#include <uORB/topics/parameter_update.h>
 #include <px4_platform_common/px4_work_queue/WorkQueueManager.hpp>
 #include <qurt.h>
 
 #include "hrt_work.h"
 
+using namespace time_literals;
+
 // Definition of test to run when in muorb test mode
 static MUORBTestType test_to_run;
 
@@ -58,8 +62,7 @@ fc_func_ptrs muorb_func_ptrs;
 uORB::ProtobufChannel uORB::ProtobufChannel::_Instance;
 uORBCommunicator::IChannelRxHandler *uORB::ProtobufChannel::_RxHandler;
 mUORB::Aggregator uORB::ProtobufChannel::_Aggregator;
-std::map<std::string, int> uORB::ProtobufChannel::_AppsSubscriberCache;
-pthread_mutex_t uORB::ProtobufChannel::_rx_mutex = PTHREAD_MUTEX_INITIALIZER;
+px4::atomic<int32_t> uORB::ProtobufChannel::_AppsSubscriberCache[ORB_TOPICS_COUNT];
 pthread_mutex_t uORB::ProtobufChannel::_tx_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 bool uORB::ProtobufChannel::_debug = false;
@@ -74,17 +77,56 @@ const uint32_t aggregator_thread_priority = 240;
 const uint32_t aggregator_stack_size = 8096;
 char aggregator_stack[aggregator_stack_size];
 
+static bool aggregator_config_update(mUORB::Aggregator::Config &config)
+{
+	mUORB::Aggregator::Config new_config{config};
+	int32_t value = 0;
+
+	if (param_get(param_find("MUORB_AGG_FLUSH"), &value) == PX4_OK) { new_config.flushThreshold = value; }
+
+	if (param_get(param_find("MUORB_AGG_LAT"), &value) == PX4_OK) { new_config.maxLatencyUs = value; }
+
+	if (param_get(param_find("MUORB_AGG_DELTA"), &value) == PX4_OK) { new_config.deltaEncoding = (value != 0); }
+
+	if (param_get(param_find("MUORB_AGG_KEYFR"), &value) == PX4_OK) { new_config.keyframeInterval = value; }
+
+	const bool changed = (new_config.flushThreshold != config.flushThreshold)
+			     || (new_config.maxLatencyUs != config.maxLatencyUs)
+			     || (new_config.deltaEncoding != config.deltaEncoding)
+			     || (new_config.keyframeInterval != config.keyframeInterval);
+
+	config = new_config;
+	return changed;
+}
+
 static void aggregator_thread_func(void *ptr)
 {
 	PX4_INFO("muorb aggregator thread running");
 
 	uORB::ProtobufChannel *muorb = uORB::ProtobufChannel::GetInstance();
 
+	// the parameters arrive from the apps processor after startup, follow their updates
+	uORB::SubscriptionInterval parameter_update_sub{ORB_ID(parameter_update), 1_s};
+	mUORB::Aggregator::Config aggregator_config{};
+
+	if (aggregator_config_update(aggregator_config)) {
+		muorb->ConfigureAggregator(aggregator_config);
+	}
+
 	while (true) {
-		// Check for timeout. Send buffer if timeout happened.
+		if (parameter_update_sub.updated()) {
+			parameter_update_s param_update;
+			parameter_update_sub.copy(&param_update);
+
+			if (aggregator_config_update(aggregator_config)) {
+				muorb->ConfigureAggregator(aggregator_config);
+			}
+		}
+
+		// Check for timeout. Send buffer if the oldest record reached the latency deadline.
 		muorb->SendAggregateData();
 
-		qurt_timer_sleep(2000);
+		qurt_timer_sleep(1000);
 	}
 
 	qurt_thread_exit(QURT_EOK);
@@ -148,9 +190,11 @@ int16_t uORB::ProtobufChannel::send_message(const char *messageName, int32_t len
 	// This function can be called from the PX4 log function so we have to make
 	// sure that we do not call PX4_INFO, PX4_ERR, etc. That would cause an
 	// infinite loop!
+	const ORB_ID orb_id = get_orb_id(messageName);
 	bool is_not_slpi_log = true;
 
-	if ((strcmp(messageName, "slpi_debug") == 0) || (strcmp(messageName, "slpi_error") == 0)) {
+	if ((orb_id == ORB_ID::INVALID) &&
+	    ((strcmp(messageName, "slpi_debug") == 0) || (strcmp(messageName, "slpi_error") == 0))) {
 		is_not_slpi_log = false;
 	}
 
@@ -159,11 +203,11 @@ int16_t uORB::ProtobufChannel::send_message(const char *messageName, int32_t len
 			PX4_INFO("Got message for topic %s", messageName);
 		}
 
-		std::string temp(messageName);
 		int has_subscribers = 0;
-		pthread_mutex_lock(&_rx_mutex);
-		has_subscribers = _AppsSubscriberCache[temp];
-		pthread_mutex_unlock(&_rx_mutex);
+
+		if (orb_id != ORB_ID::INVALID) {
+			has_subscribers = _AppsSubscriberCache[static_cast<size_t>(orb_id)].load();
+		}
 
 		if ((has_subscribers) || (is_not_slpi_log == false)) {
 			if ((_debug) && (is_not_slpi_log)) {
@@ -174,7 +218,7 @@ int16_t uORB::ProtobufChannel::send_message(const char *messageName, int32_t len
 			pthread_mutex_lock(&_tx_mutex);
 
 			if (is_not_slpi_log) {
-				rc = _Aggregator.ProcessTransmitTopic(messageName, data, length);
+				rc = _Aggregator.ProcessTransmitTopic(messageName, data, length, hrt_absolute_time());
 
 			} else {
 				// SLPI logs don't go through the aggregator
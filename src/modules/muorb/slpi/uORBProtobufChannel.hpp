@@ -35,11 +35,13 @@
 
 #include <stdint.h>
 #include <stdio.h>
-#include <string>
-#include <map>
 #include <pthread.h>
 #include <termios.h>
 
+#include <drivers/drv_hrt.h>
+#include <px4_platform_common/atomic.h>
+#include <uORB/topics/uORBTopics.hpp>
+
 #include "uORB/uORBCommunicator.hpp"
 #include "mUORBAggregator.hpp"
 
@@ -132,32 +134,53 @@ public:
 		_Aggregator.RegisterSendHandler(func);
 	}
 
-	int AddRemoteSubscriber(const std::string &messageName)
+	/**
+	 * Count a subscriber on the apps side.
+	 * @return number of remote subscribers before this one was added
+	 */
+	int AddRemoteSubscriber(const char *messageName)
 	{
-		int currentRemoteSubscribers;
-		pthread_mutex_lock(&_rx_mutex);
-		currentRemoteSubscribers = _AppsSubscriberCache[messageName]++;
-		pthread_mutex_unlock(&_rx_mutex);
-		return currentRemoteSubscribers;
+		const ORB_ID orb_id = get_orb_id(messageName);
+
+		if (orb_id == ORB_ID::INVALID) {
+			return 0;
+		}
+
+		return _AppsSubscriberCache[static_cast<size_t>(orb_id)].fetch_add(1);
 	}
 
-	void RemoveRemoteSubscriber(const std::string &messageName)
+	void RemoveRemoteSubscriber(const char *messageName)
 	{
-		pthread_mutex_lock(&_rx_mutex);
+		const ORB_ID orb_id = get_orb_id(messageName);
 
-		if (_AppsSubscriberCache[messageName]) {
-			_AppsSubscriberCache[messageName]--;
+		if (orb_id == ORB_ID::INVALID) {
+			return;
 		}
 
-		pthread_mutex_unlock(&_rx_mutex);
+		px4::atomic<int32_t> &count = _AppsSubscriberCache[static_cast<size_t>(orb_id)];
+		int32_t current = count.load();
+
+		while ((current > 0) && !count.compare_exchange(&current, current - 1)) {}
 	}
 
 	bool DebugEnabled()	{ return _debug; }
 
 	void SendAggregateData()
+	{
+		pthread_mutex_lock(&_tx_mutex);
+		_Aggregator.SendDataIfDue(hrt_absolute_time());
+		pthread_mutex_unlock(&_tx_mutex);
+	}
+
+	/**
+	 * Apply a new aggregator configuration. Pending data is sent first,
+	 * topics are defined again on the next transmit.
+	 */
+	void ConfigureAggregator(const mUORB::Aggregator::Config &config)
 	{
 		pthread_mutex_lock(&_tx_mutex);
 		_Aggregator.SendData();
+		_Aggregator.Configure(config);
 		pthread_mutex_unlock(&_tx_mutex);
 	}
 
@@ -168,9 +191,8 @@ private:
 	static uORB::ProtobufChannel                _Instance;
 	static uORBCommunicator::IChannelRxHandler *_RxHandler;
 	static mUORB::Aggregator					_Aggregator;
-	static std::map<std::string, int>           _AppsSubscriberCache;
+	static px4::atomic<int32_t>                 _AppsSubscriberCache[ORB_TOPICS_COUNT];
 	static pthread_mutex_t                      _tx_mutex;
-	static pthread_mutex_t                      _rx_mutex;
 	static bool                                 _debug;
 
 	/**
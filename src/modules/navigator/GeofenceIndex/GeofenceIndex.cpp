@@ -0,0 +1,479 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "GeofenceIndex.hpp"
+
+#include <float.h>
+#include <math.h>
+
+#include <lib/geo/geo.h>
+#include <lib/mathlib/mathlib.h>
+
+bool GeofenceIndex::begin(int max_shapes, int max_vertices)
+{
+	reset();
+
+	if (max_shapes <= 0 || max_shapes > UINT16_MAX || max_vertices < 0) {
+		return false;
+	}
+
+	_shapes = new Shape[max_shapes];
+	_vertices = new Vertex[max_vertices > 0 ? max_vertices : 1];
+
+	if (!_shapes || !_vertices) {
+		reset();
+		return false;
+	}
+
+	_max_shapes = max_shapes;
+	_max_vertices = max_vertices;
+	return true;
+}
+
+bool GeofenceIndex::addPolygon(bool inclusion)
+{
+	if (_built || _num_shapes >= _max_shapes) {
+		return false;
+	}
+
+	Shape &shape = _shapes[_num_shapes++];
+	shape = {};
+	shape.box = {DBL_MAX, -DBL_MAX, DBL_MAX, -DBL_MAX};
+	shape.first_vertex = _num_vertices;
+	shape.type = inclusion ? ShapeType::PolygonInclusion : ShapeType::PolygonExclusion;
+	return true;
+}
+
+bool GeofenceIndex::addVertex(double lat, double lon)
+{
+	if (_built || _num_shapes == 0 || _num_vertices >= _max_vertices) {
+		return false;
+	}
+
+	Shape &shape = _shapes[_num_shapes - 1];
+
+	if ((shape.type != ShapeType::PolygonInclusion && shape.type != ShapeType::PolygonExclusion)
+	    || shape.vertex_count >= UINT16_MAX) {
+		return false;
+	}
+
+	_vertices[_num_vertices++] = {lat, lon};
+	++shape.vertex_count;
+
+	Box &box = shape.box;
+	box.min_lat = math::min(box.min_lat, lat);
+	box.max_lat = math::max(box.max_lat, lat);
+	box.min_lon = math::min(box.min_lon, lon);
+	box.max_lon = math::max(box.max_lon, lon);
+	return true;
+}
+
+bool GeofenceIndex::addCircle(bool inclusion, double lat, double lon, float radius)
+{
+	if (_built || _num_shapes >= _max_shapes || _num_vertices >= _max_vertices) {
+		return false;
+	}
+
+	Shape &shape = _shapes[_num_shapes++];
+	shape = {};
+	shape.first_vertex = _num_vertices;
+	shape.vertex_count = 1;
+	shape.type = inclusion ? ShapeType::CircleInclusion : ShapeType::CircleExclusion;
+	shape.radius = radius;
+
+	_vertices[_num_vertices++] = {lat, lon};
+
+	// angular radius, with some margin for rounding
+	const double angle = math::max((double)radius, 0.0) / CONSTANTS_RADIUS_OF_EARTH * 1.01 + 1e-9;
+	const double sin_lon = sin(angle) / cos(math::radians(lat));
+	const double delta_lat = math::degrees(angle);
+	const double delta_lon = (sin_lon >= 0.0 && sin_lon < 1.0) ? math::degrees(asin(sin_lon)) : 360.0;
+
+	shape.box = {lat - delta_lat, lat + delta_lat, lon - delta_lon, lon + delta_lon};
+	return true;
+}
+
+bool GeofenceIndex::build()
+{
+	if (_built || !_shapes) {
+		return false;
+	}
+
+	_inclusion_shapes = new uint16_t[_num_shapes > 0 ? _num_shapes : 1];
+
+	if (!_inclusion_shapes) {
+		reset();
+		return false;
+	}
+
+	_num_inclusion_shapes = 0;
+
+	for (int i = 0; i < _num_shapes; ++i) {
+		if (!isExclusion(_shapes[i])) {
+			_inclusion_shapes[_num_inclusion_shapes++] = i;
+		}
+	}
+
+	if (!buildSlabs() || !buildGrid()) {
+		reset();
+		return false;
+	}
+
+	_built = true;
+	return true;
+}
+
+bool GeofenceIndex::buildSlabs()
+{
+	// first pass: assign the slabs and count the edge entries
+	_num_slab_offsets = 0;
+	_num_slab_edges = 0;
+
+	for (int i = 0; i < _num_shapes; ++i) {
+		Shape &shape = _shapes[i];
+		const double lon_range = shape.box.max_lon - shape.box.min_lon;
+
+		if (shape.type == ShapeType::CircleInclusion || shape.type == ShapeType::CircleExclusion
+		    || shape.vertex_count < MIN_SLAB_VERTICES || !(lon_range > 0.0)) {
+			continue;
+		}
+
+		shape.num_slabs = math::min(static_cast<int>(shape.vertex_count) / VERTICES_PER_SLAB, MAX_SLABS);
+		shape.slab_scale = shape.num_slabs / lon_range;
+		shape.first_slab = _num_slab_offsets;
+		_num_slab_offsets += shape.num_slabs + 1;
+
+		const Vertex *vertices = &_vertices[shape.first_vertex];
+
+		for (uint32_t k = 0, j = shape.vertex_count - 1; k < shape.vertex_count; j = k++) {
+			const int first = slabIndex(shape, math::min(vertices[k].lon, vertices[j].lon));
+			const int last = slabIndex(shape, math::max(vertices[k].lon, vertices[j].lon));
+			_num_slab_edges += last - first + 1;
+		}
+	}
+
+	if (_num_slab_offsets == 0) {
+		return true;
+	}
+
+	_slab_offsets = new uint32_t[_num_slab_offsets];
+	_slab_edges = new uint16_t[_num_slab_edges];
+
+	if (!_slab_offsets || !_slab_edges) {
+		return false;
+	}
+
+	// second pass: bucket the edges. Each edge goes into every slab its longitude range overlaps.
+	uint32_t edge_start = 0;
+
+	for (int i = 0; i < _num_shapes; ++i) {
+		const Shape &shape = _shapes[i];
+
+		if (shape.num_slabs == 0) {
+			continue;
+		}
+
+		uint32_t *offsets = &_slab_offsets[shape.first_slab];
+		const Vertex *vertices = &_vertices[shape.first_vertex];
+
+		for (int s = 0; s <= shape.num_slabs; ++s) {
+			offsets[s] = 0;
+		}
+
+		for (uint32_t k = 0, j = shape.vertex_count - 1; k < shape.vertex_count; j = k++) {
+			const int first = slabIndex(shape, math::min(vertices[k].lon, vertices[j].lon));
+			const int last = slabIndex(shape, math::max(vertices[k].lon, vertices[j].lon));
+
+			for (int s = first; s <= last; ++s) {
+				++offsets[s + 1];
+			}
+		}
+
+		offsets[0] = edge_start;
+
+		for (int s = 1; s <= shape.num_slabs; ++s) {
+			offsets[s] += offsets[s - 1];
+		}
+
+		// offsets[s] is used as the write cursor of slab s, which leaves it at the start of slab s + 1
+		for (uint32_t k = 0, j = shape.vertex_count - 1; k < shape.vertex_count; j = k++) {
+			const int first = slabIndex(shape, math::min(vertices[k].lon, vertices[j].lon));
+			const int last = slabIndex(shape, math::max(vertices[k].lon, vertices[j].lon));
+
+			for (int s = first; s <= last; ++s) {
+				_slab_edges[offsets[s]++] = k;
+			}
+		}
+
+		for (int s = shape.num_slabs; s > 0; --s) {
+			offsets[s] = offsets[s - 1];
+		}
+
+		offsets[0] = edge_start;
+		edge_start = offsets[shape.num_slabs];
+	}
+
+	return true;
+}
+
+bool GeofenceIndex::buildGrid()
+{
+	_grid_size = 0;
+	_num_cell_shapes = 0;
+
+	int num_exclusion_shapes = 0;
+	Box box{DBL_MAX, -DBL_MAX, DBL_MAX, -DBL_MAX};
+
+	for (int i = 0; i < _num_shapes; ++i) {
+		const Shape &shape = _shapes[i];
+
+		if (isExclusion(shape) && shape.vertex_count > 0) {
+			++num_exclusion_shapes;
+			box.min_lat = math::min(box.min_lat, shape.box.min_lat);
+			box.max_lat = math::max(box.max_lat, shape.box.max_lat);
+			box.min_lon = math::min(box.min_lon, shape.box.min_lon);
+			box.max_lon = math::max(box.max_lon, shape.box.max_lon);
+		}
+	}
+
+	if (num_exclusion_shapes == 0) {
+		return true;
+	}
+
+	const int grid_size = math::constrain(static_cast<int>(ceilf(sqrtf(num_exclusion_shapes))), 1, MAX_GRID_SIZE);
+	const int num_cells = grid_size * grid_size;
+
+	_grid_box = box;
+	_grid_size = grid_size;
+	_grid_scale_lat = (box.max_lat > box.min_lat) ? grid_size / (box.max_lat - box.min_lat) : 0.0;
+	_grid_scale_lon = (box.max_lon > box.min_lon) ? grid_size / (box.max_lon - box.min_lon) : 0.0;
+
+	_cell_offsets = new uint32_t[num_cells + 1];
+
+	if (!_cell_offsets) {
+		return false;
+	}
+
+	for (int c = 0; c <= num_cells; ++c) {
+		_cell_offsets[c] = 0;
+	}
+
+	// count the shapes per cell, then convert to offsets and fill (same scheme as the slabs)
+	for (int i = 0; i < _num_shapes; ++i) {
+		const Shape &shape = _shapes[i];
+
+		if (!isExclusion(shape) || shape.vertex_count == 0) {
+			continue;
+		}
+
+		const int row_first = gridIndex(shape.box.min_lat, _grid_box.min_lat, _grid_scale_lat);
+		const int row_last = gridIndex(shape.box.max_lat, _grid_box.min_lat, _grid_scale_lat);
+		const int col_first = gridIndex(shape.box.min_lon, _grid_box.min_lon, _grid_scale_lon);
+		const int col_last = gridIndex(shape.box.max_lon, _grid_box.min_lon, _grid_scale_lon);
+
+		for (int row = row_first; row <= row_last; ++row) {
+			for (int col = col_first; col <= col_last; ++col) {
+				++_cell_offsets[row * grid_size + col + 1];
+			}
+		}
+	}
+
+	for (int c = 1; c <= num_cells; ++c) {
+		_cell_offsets[c] += _cell_offsets[c - 1];
+	}
+
+	_num_cell_shapes = _cell_offsets[num_cells];
+	_cell_shapes = new uint16_t[_num_cell_shapes];
+
+	if (!_cell_shapes) {
+		return false;
+	}
+
+	for (int i = 0; i < _num_shapes; ++i) {
+		const Shape &shape = _shapes[i];
+
+		if (!isExclusion(shape) || shape.vertex_count == 0) {
+			continue;
+		}
+
+		const int row_first = gridIndex(shape.box.min_lat, _grid_box.min_lat, _grid_scale_lat);
+		const int row_last = gridIndex(shape.box.max_lat, _grid_box.min_lat, _grid_scale_lat);
+		const int col_first = gridIndex(shape.box.min_lon, _grid_box.min_lon, _grid_scale_lon);
+		const int col_last = gridIndex(shape.box.max_lon, _grid_box.min_lon, _grid_scale_lon);
+
+		for (int row = row_first; row <= row_last; ++row) {
+			for (int col = col_first; col <= col_last; ++col) {
+				_cell_shapes[_cell_offsets[row * grid_size + col]++] = i;
+			}
+		}
+	}
+
+	for (int c = num_cells; c > 0; --c) {
+		_cell_offsets[c] = _cell_offsets[c - 1];
+	}
+
+	_cell_offsets[0] = 0;
+	return true;
+}
+
+void GeofenceIndex::reset()
+{
+	delete[] _shapes;
+	delete[] _vertices;
+	delete[] _slab_offsets;
+	delete[] _slab_edges;
+	delete[] _inclusion_shapes;
+	delete[] _cell_offsets;
+	delete[] _cell_shapes;
+
+	_shapes = nullptr;
+	_vertices = nullptr;
+	_slab_offsets = nullptr;
+	_slab_edges = nullptr;
+	_inclusion_shapes = nullptr;
+	_cell_offsets = nullptr;
+	_cell_shapes = nullptr;
+
+	_max_shapes = 0;
+	_max_vertices = 0;
+	_num_shapes = 0;
+	_num_vertices = 0;
+	_num_slab_offsets = 0;
+	_num_slab_edges = 0;
+	_num_inclusion_shapes = 0;
+	_grid_size = 0;
+	_num_cell_shapes = 0;
+	_built = false;
+}
+
+size_t GeofenceIndex::memoryUsage() const
+{
+	return _max_shapes * sizeof(Shape) + _max_vertices * sizeof(Vertex)
+	       + _num_slab_offsets * sizeof(uint32_t) + _num_slab_edges * sizeof(uint16_t)
+	       + (_inclusion_shapes ? _num_shapes * sizeof(uint16_t) : 0)
+	       + (_cell_offsets ? (_grid_size * _grid_size + 1) * sizeof(uint32_t) : 0)
+	       + _num_cell_shapes * sizeof(uint16_t);
+}
+
+bool GeofenceIndex::isInside(double lat, double lon) const
+{
+	if (!_built) {
+		return true;
+	}
+
+	for (int i = 0; i < _num_inclusion_shapes; ++i) {
+		if (!isInsideShape(_shapes[_inclusion_shapes[i]], lat, lon)) {
+			return false;
+		}
+	}
+
+	if (_grid_size > 0 && _grid_box.contains(lat, lon)) {
+		const int row = gridIndex(lat, _grid_box.min_lat, _grid_scale_lat);
+		const int col = gridIndex(lon, _grid_box.min_lon, _grid_scale_lon);
+		const int cell = row * _grid_size + col;
+
+		for (uint32_t k = _cell_offsets[cell]; k < _cell_offsets[cell + 1]; ++k) {
+			if (isInsideShape(_shapes[_cell_shapes[k]], lat, lon)) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool GeofenceIndex::isInsideShape(const Shape &shape, double lat, double lon) const
+{
+	if (!shape.box.contains(lat, lon)) {
+		return false;
+	}
+
+	if (shape.type == ShapeType::CircleInclusion || shape.type == ShapeType::CircleExclusion) {
+		return isInsideCircle(shape, lat, lon);
+	}
+
+	return isInsidePolygon(shape, lat, lon);
+}
+
+bool GeofenceIndex::isInsidePolygon(const Shape &shape, double lat, double lon) const
+{
+	// Same crossing test as Geofence::insidePolygon() (PNPOLY, W. Randolph Franklin). Only the edges in the
+	// query's longitude slab can cross it, and the parity does not depend on the order the edges are visited in.
+	const Vertex *vertices = &_vertices[shape.first_vertex];
+	bool c = false;
+
+	if (shape.num_slabs > 0) {
+		const uint32_t *offsets = &_slab_offsets[shape.first_slab];
+		const int slab = slabIndex(shape, lon);
+
+		for (uint32_t k = offsets[slab]; k < offsets[slab + 1]; ++k) {
+			const uint32_t i = _slab_edges[k];
+			const uint32_t j = (i == 0) ? shape.vertex_count - 1 : i - 1;
+
+			if ((vertices[i].lon >= lon) != (vertices[j].lon >= lon) &&
+			    (lat <= (vertices[j].lat - vertices[i].lat) * (lon - vertices[i].lon) /
+			     (vertices[j].lon - vertices[i].lon) + vertices[i].lat)) {
+				c = !c;
+			}
+		}
+
+	} else {
+		for (uint32_t i = 0, j = shape.vertex_count - 1; i < shape.vertex_count; j = i++) {
+			if ((vertices[i].lon >= lon) != (vertices[j].lon >= lon) &&
+			    (lat <= (vertices[j].lat - vertices[i].lat) * (lon - vertices[i].lon) /
+			     (vertices[j].lon - vertices[i].lon) + vertices[i].lat)) {
+				c = !c;
+			}
+		}
+	}
+
+	return c;
+}
+
+bool GeofenceIndex::isInsideCircle(const Shape &shape, double lat, double lon) const
+{
+	const Vertex &center = _vertices[shape.first_vertex];
+	return get_distance_to_next_waypoint(lat, lon, center.lat, center.lon) < shape.radius;
+}
+
+int GeofenceIndex::slabIndex(const Shape &shape, double lon) const
+{
+	const int slab = static_cast<int>((lon - shape.box.min_lon) * shape.slab_scale);
+	return math::constrain(slab, 0, shape.num_slabs - 1);
+}
+
+int GeofenceIndex::gridIndex(double value, double min, double scale) const
+{
+	const int index = static_cast<int>((value - min) * scale);
+	return math::constrain(index, 0, _grid_size - 1);
+}
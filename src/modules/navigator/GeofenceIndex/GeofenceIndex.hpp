@@ -0,0 +1,196 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file GeofenceIndex.hpp
+ *
+ * Spatial index over the geofence polygons and circles, built once when a fence is loaded.
+ *
+ * Every shape gets a bounding box. Polygons with many vertices additionally bucket their edges
+ * into longitude slabs, so the point-in-polygon test only visits the edges that can cross the
+ * query longitude. Exclusion shapes are bucketed into a uniform grid, so a query only tests the
+ * exclusion shapes whose bounding box overlaps its cell.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+class GeofenceIndex
+{
+public:
+	enum class ShapeType : uint8_t {
+		PolygonInclusion,
+		PolygonExclusion,
+		CircleInclusion,
+		CircleExclusion
+	};
+
+	GeofenceIndex() = default;
+	GeofenceIndex(const GeofenceIndex &) = delete;
+	GeofenceIndex &operator=(const GeofenceIndex &) = delete;
+	~GeofenceIndex() { reset(); }
+
+	/**
+	 * Drop the current index and allocate storage for a new one.
+	 * Add the shapes with addPolygon()/addVertex() and addCircle(), then call build().
+	 * @param max_shapes number of polygons and circles
+	 * @param max_vertices number of polygon vertices plus one per circle
+	 * @return false if the allocation failed
+	 */
+	bool begin(int max_shapes, int max_vertices);
+
+	/**
+	 * Start a new polygon, its vertices follow with addVertex().
+	 */
+	bool addPolygon(bool inclusion);
+
+	/**
+	 * Add a vertex to the polygon started last.
+	 * @param lat in degrees
+	 * @param lon in degrees
+	 */
+	bool addVertex(double lat, double lon);
+
+	/**
+	 * Add a circle.
+	 * @param lat center in degrees
+	 * @param lon center in degrees
+	 * @param radius in meters
+	 */
+	bool addCircle(bool inclusion, double lat, double lon, float radius);
+
+	/**
+	 * Build the edge slabs and the exclusion grid after all shapes were added.
+	 * @return false if the allocation failed, the index is empty in that case
+	 */
+	bool build();
+
+	/**
+	 * Free all memory, isBuilt() is false afterwards.
+	 */
+	void reset();
+
+	bool isBuilt() const { return _built; }
+
+	/**
+	 * Check a point against all shapes: it must be inside all inclusion shapes and outside all exclusion shapes.
+	 * @param lat in degrees
+	 * @param lon in degrees
+	 * @return true if the point passes
+	 */
+	bool isInside(double lat, double lon) const;
+
+	int numShapes() const { return _num_shapes; }
+	int numVertices() const { return _num_vertices; }
+
+	/**
+	 * @return heap memory used by the index in bytes
+	 */
+	size_t memoryUsage() const;
+
+private:
+	struct Vertex {
+		double lat;
+		double lon;
+	};
+
+	struct Box {
+		double min_lat;
+		double max_lat;
+		double min_lon;
+		double max_lon;
+
+		bool contains(double lat, double lon) const
+		{
+			return lat >= min_lat && lat <= max_lat && lon >= min_lon && lon <= max_lon;
+		}
+	};
+
+	struct Shape {
+		Box box;
+		uint32_t first_vertex;
+		uint32_t vertex_count;
+		uint32_t first_slab;        ///< index into _slab_offsets
+		uint16_t num_slabs;         ///< 0: the edges are not bucketed
+		ShapeType type;
+		float radius;               ///< circles only [m], the center is the first vertex
+		double slab_scale;          ///< slabs per degree longitude
+	};
+
+	static constexpr int MIN_SLAB_VERTICES = 16; ///< polygons with fewer vertices are tested edge by edge
+	static constexpr int VERTICES_PER_SLAB = 4;
+	static constexpr int MAX_SLABS = 1024;
+	static constexpr int MAX_GRID_SIZE = 64; ///< cells along each axis of the exclusion grid
+
+	bool isInsideShape(const Shape &shape, double lat, double lon) const;
+	bool isInsidePolygon(const Shape &shape, double lat, double lon) const;
+	bool isInsideCircle(const Shape &shape, double lat, double lon) const;
+
+	bool buildSlabs();
+	bool buildGrid();
+
+	int slabIndex(const Shape &shape, double lon) const;
+	int gridIndex(double value, double min, double scale) const;
+
+	bool isExclusion(const Shape &shape) const
+	{
+		return shape.type == ShapeType::PolygonExclusion || shape.type == ShapeType::CircleExclusion;
+	}
+
+	Shape *_shapes{nullptr};
+	Vertex *_vertices{nullptr};
+	int _max_shapes{0};
+	int _max_vertices{0};
+	int _num_shapes{0};
+	int _num_vertices{0};
+
+	uint32_t *_slab_offsets{nullptr};   ///< per slab: first entry in _slab_edges, one extra entry per polygon
+	uint16_t *_slab_edges{nullptr};     ///< edge i connects vertex i and i - 1 of the polygon
+	uint32_t _num_slab_offsets{0};
+	uint32_t _num_slab_edges{0};
+
+	uint16_t *_inclusion_shapes{nullptr};
+	int _num_inclusion_shapes{0};
+
+	Box _grid_box{};
+	double _grid_scale_lat{0.0};        ///< cells per degree
+	double _grid_scale_lon{0.0};
+	int _grid_size{0};
+	uint32_t *_cell_offsets{nullptr};   ///< per cell: first entry in _cell_shapes, plus one
+	uint16_t *_cell_shapes{nullptr};
+	uint32_t _num_cell_shapes{0};
+
+	bool _built{false};
+};
@@ -0,0 +1,351 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include <gtest/gtest.h>
+#include "GeofenceIndex.hpp"
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include <lib/geo/geo.h>
+
+// to run: make tests TESTFILTER=GeofenceIndex
+namespace
+{
+
+struct TestShape {
+	bool inclusion;
+	bool circle;
+	float radius;
+	std::vector<std::pair<double, double>> vertices; ///< lat, lon
+};
+
+// reference implementation: the linear scan over all shapes and vertices done by Geofence without the index
+bool insidePolygonReference(const TestShape &shape, double lat, double lon)
+{
+	bool c = false;
+	const auto &v = shape.vertices;
+
+	for (size_t i = 0, j = v.size() - 1; i < v.size(); j = i++) {
+		if ((v[i].second >= lon) != (v[j].second >= lon) &&
+		    (lat <= (v[j].first - v[i].first) * (lon - v[i].second) / (v[j].second - v[i].second) + v[i].first)) {
+			c = !c;
+		}
+	}
+
+	return c;
+}
+
+bool isInsideReference(const std::vector<TestShape> &shapes, double lat, double lon)
+{
+	bool pass = true;
+
+	for (const TestShape &shape : shapes) {
+		bool inside;
+
+		if (shape.circle) {
+			inside = get_distance_to_next_waypoint(lat, lon, shape.vertices[0].first, shape.vertices[0].second) < shape.radius;
+
+		} else {
+			inside = insidePolygonReference(shape, lat, lon);
+		}
+
+		pass &= (shape.inclusion == inside);
+	}
+
+	return pass;
+}
+
+bool buildIndex(GeofenceIndex &index, const std::vector<TestShape> &shapes)
+{
+	int num_vertices = 0;
+
+	for (const TestShape &shape : shapes) {
+		num_vertices += shape.vertices.size();
+	}
+
+	if (!index.begin(shapes.size(), num_vertices)) {
+		return false;
+	}
+
+	for (const TestShape &shape : shapes) {
+		if (shape.circle) {
+			if (!index.addCircle(shape.inclusion, shape.vertices[0].first, shape.vertices[0].second, shape.radius)) {
+				return false;
+			}
+
+		} else {
+			if (!index.addPolygon(shape.inclusion)) {
+				return false;
+			}
+
+			for (const auto &vertex : shape.vertices) {
+				if (!index.addVertex(vertex.first, vertex.second)) {
+					return false;
+				}
+			}
+		}
+	}
+
+	return index.build();
+}
+
+// irregular star shaped polygon (not self intersecting) around a center
+TestShape randomPolygon(std::mt19937 &gen, bool inclusion, double lat, double lon, float radius, int vertex_count)
+{
+	std::uniform_real_distribution<float> scale(0.3f, 1.f);
+	TestShape shape{inclusion, false, 0.f, {}};
+
+	for (int i = 0; i < vertex_count; ++i) {
+		double vertex_lat;
+		double vertex_lon;
+		waypoint_from_heading_and_distance(lat, lon, 2.f * M_PI_F * i / vertex_count, radius * scale(gen), &vertex_lat, &vertex_lon);
+		shape.vertices.emplace_back(vertex_lat, vertex_lon);
+	}
+
+	return shape;
+}
+
+// survey style fence: one detailed inclusion polygon with many exclusion polygons and circles inside
+std::vector<TestShape> largeFence(std::mt19937 &gen, int num_exclusion_polygons, int num_exclusion_circles)
+{
+	static constexpr double lat = 47.397742;
+	static constexpr double lon = 8.545594;
+	static constexpr float fence_radius = 5000.f;
+
+	std::vector<TestShape> shapes;
+	shapes.push_back(randomPolygon(gen, true, lat, lon, fence_radius, 2000));
+
+	std::uniform_real_distribution<float> bearing(0.f, 2.f * M_PI_F);
+	std::uniform_real_distribution<float> distance(0.f, fence_radius);
+	std::uniform_int_distribution<int> vertex_count(3, 40);
+	std::uniform_real_distribution<float> radius(20.f, 150.f);
+
+	for (int i = 0; i < num_exclusion_polygons + num_exclusion_circles; ++i) {
+		double center_lat;
+		double center_lon;
+		waypoint_from_heading_and_distance(lat, lon, bearing(gen), distance(gen), &center_lat, &center_lon);
+
+		if (i < num_exclusion_polygons) {
+			shapes.push_back(randomPolygon(gen, false, center_lat, center_lon, radius(gen), vertex_count(gen)));
+
+		} else {
+			shapes.push_back(TestShape{false, true, radius(gen), {{center_lat, center_lon}}});
+		}
+	}
+
+	return shapes;
+}
+
+std::vector<std::pair<double, double>> randomPoints(std::mt19937 &gen, const std::vector<TestShape> &shapes, int count)
+{
+	double min_lat = 90., max_lat = -90., min_lon = 180., max_lon = -180.;
+
+	for (const TestShape &shape : shapes) {
+		for (const auto &vertex : shape.vertices) {
+			min_lat = std::min(min_lat, vertex.first);
+			max_lat = std::max(max_lat, vertex.first);
+			min_lon = std::min(min_lon, vertex.second);
+			max_lon = std::max(max_lon, vertex.second);
+		}
+	}
+
+	// cover some area outside of the fence as well
+	const double margin_lat = (max_lat - min_lat) * 0.1;
+	const double margin_lon = (max_lon - min_lon) * 0.1;
+	std::uniform_real_distribution<double> lat(min_lat - margin_lat, max_lat + margin_lat);
+	std::uniform_real_distribution<double> lon(min_lon - margin_lon, max_lon + margin_lon);
+
+	std::vector<std::pair<double, double>> points;
+
+	for (int i = 0; i < count; ++i) {
+		points.emplace_back(lat(gen), lon(gen));
+	}
+
+	return points;
+}
+
+} // namespace
+
+TEST(GeofenceIndexTest, EmptyIndexAcceptsAll)
+{
+	GeofenceIndex index;
+	EXPECT_FALSE(index.isBuilt());
+	EXPECT_TRUE(index.isInside(47.4, 8.5));
+
+	ASSERT_TRUE(index.begin(1, 0));
+	ASSERT_TRUE(index.build());
+	EXPECT_TRUE(index.isInside(47.4, 8.5));
+}
+
+TEST(GeofenceIndexTest, InclusionAndExclusion)
+{
+	// exclusion square inside an inclusion square
+	const std::vector<TestShape> shapes{
+		{true, false, 0.f, {{47.0, 8.0}, {47.0, 9.0}, {48.0, 9.0}, {48.0, 8.0}}},
+		{false, false, 0.f, {{47.4, 8.4}, {47.4, 8.6}, {47.6, 8.6}, {47.6, 8.4}}},
+	};
+
+	GeofenceIndex index;
+	ASSERT_TRUE(buildIndex(index, shapes));
+	EXPECT_EQ(index.numShapes(), 2);
+	EXPECT_EQ(index.numVertices(), 8);
+
+	EXPECT_TRUE(index.isInside(47.2, 8.2));
+	EXPECT_FALSE(index.isInside(47.5, 8.5)); // inside the exclusion
+	EXPECT_FALSE(index.isInside(46.5, 8.5)); // outside the inclusion
+	EXPECT_FALSE(index.isInside(47.5, 9.5));
+}
+
+TEST(GeofenceIndexTest, Circles)
+{
+	static constexpr double lat = 47.397742;
+	static constexpr double lon = 8.545594;
+
+	GeofenceIndex index;
+	ASSERT_TRUE(index.begin(2, 2));
+	ASSERT_TRUE(index.addCircle(true, lat, lon, 500.f));
+	ASSERT_TRUE(index.addCircle(false, lat, lon, 100.f));
+	EXPECT_FALSE(index.addVertex(lat, lon)); // circles have no vertices
+	ASSERT_TRUE(index.build());
+
+	for (float bearing = 0.f; bearing < 2.f * M_PI_F; bearing += 0.1f) {
+		double point_lat;
+		double point_lon;
+
+		waypoint_from_heading_and_distance(lat, lon, bearing, 99.f, &point_lat, &point_lon);
+		EXPECT_FALSE(index.isInside(point_lat, point_lon));
+
+		waypoint_from_heading_and_distance(lat, lon, bearing, 101.f, &point_lat, &point_lon);
+		EXPECT_TRUE(index.isInside(point_lat, point_lon));
+
+		waypoint_from_heading_and_distance(lat, lon, bearing, 499.f, &point_lat, &point_lon);
+		EXPECT_TRUE(index.isInside(point_lat, point_lon));
+
+		waypoint_from_heading_and_distance(lat, lon, bearing, 501.f, &point_lat, &point_lon);
+		EXPECT_FALSE(index.isInside(point_lat, point_lon));
+	}
+}
+
+TEST(GeofenceIndexTest, CapacityExceeded)
+{
+	GeofenceIndex index;
+	ASSERT_TRUE(index.begin(1, 3));
+	ASSERT_TRUE(index.addPolygon(true));
+	EXPECT_TRUE(index.addVertex(47.0, 8.0));
+	EXPECT_TRUE(index.addVertex(47.0, 9.0));
+	EXPECT_TRUE(index.addVertex(48.0, 9.0));
+	EXPECT_FALSE(index.addVertex(48.0, 8.0));
+	EXPECT_FALSE(index.addPolygon(false));
+	EXPECT_FALSE(index.addCircle(false, 47.5, 8.5, 10.f));
+}
+
+TEST(GeofenceIndexTest, LargePolygonMatchesReference)
+{
+	std::mt19937 gen(1);
+	const std::vector<TestShape> shapes{randomPolygon(gen, true, 47.397742, 8.545594, 2000.f, 5000)};
+
+	GeofenceIndex index;
+	ASSERT_TRUE(buildIndex(index, shapes));
+
+	for (const auto &point : randomPoints(gen, shapes, 20000)) {
+		ASSERT_EQ(index.isInside(point.first, point.second), isInsideReference(shapes, point.first, point.second))
+				<< "lat " << point.first << " lon " << point.second;
+	}
+}
+
+TEST(GeofenceIndexTest, LargeFenceMatchesReference)
+{
+	std::mt19937 gen(2);
+	const std::vector<TestShape> shapes = largeFence(gen, 400, 50);
+
+	GeofenceIndex index;
+	ASSERT_TRUE(buildIndex(index, shapes));
+
+	int num_inside = 0;
+
+	for (const auto &point : randomPoints(gen, shapes, 20000)) {
+		const bool inside = index.isInside(point.first, point.second);
+		ASSERT_EQ(inside, isInsideReference(shapes, point.first, point.second))
+				<< "lat " << point.first << " lon " << point.second;
+		num_inside += inside;
+	}
+
+	// make sure both outcomes are covered
+	EXPECT_GT(num_inside, 1000);
+	EXPECT_LT(num_inside, 19000);
+}
+
+TEST(GeofenceIndexTest, Benchmark)
+{
+	static constexpr int NUM_POINTS = 2000;
+
+	for (int num_exclusion_polygons : {50, 200, 800}) {
+		std::mt19937 gen(3);
+		const std::vector<TestShape> shapes = largeFence(gen, num_exclusion_polygons, num_exclusion_polygons / 10);
+		const std::vector<std::pair<double, double>> points = randomPoints(gen, shapes, NUM_POINTS);
+
+		const auto build_start = std::chrono::steady_clock::now();
+		GeofenceIndex index;
+		ASSERT_TRUE(buildIndex(index, shapes));
+		const auto build_end = std::chrono::steady_clock::now();
+
+		int reference_inside = 0;
+		const auto reference_start = std::chrono::steady_clock::now();
+
+		for (const auto &point : points) {
+			reference_inside += isInsideReference(shapes, point.first, point.second);
+		}
+
+		const auto reference_end = std::chrono::steady_clock::now();
+
+		int index_inside = 0;
+
+		for (const auto &point : points) {
+			index_inside += index.isInside(point.first, point.second);
+		}
+
+		const auto index_end = std::chrono::steady_clock::now();
+
+		EXPECT_EQ(index_inside, reference_inside);
+
+		const double build_ms = std::chrono::duration<double, std::milli>(build_end - build_start).count();
+		const double reference_us = std::chrono::duration<double, std::micro>(reference_end - reference_start).count() /
+					    NUM_POINTS;
+		const double index_us = std::chrono::duration<double, std::micro>(index_end - reference_end).count() / NUM_POINTS;
+
+		printf("%4zu shapes, %5i vertices: build %.2f ms (%zu bytes), linear scan %.2f us, index %.3f us per check\n",
+		       shapes.size(), index.numVertices(), build_ms, index.memoryUsage(), reference_us, index_us);
+	}
+}
@@ -212,6 +212,7 @@ void Geofence::_updateFence()
 
 	// iterate over all polygons and store their starting vertices
 	_num_polygons = 0;
+	_index.reset();
 	int current_seq = 0;
 
 	while (current_seq < _dataman_cache.size()) {
@@ -298,6 +299,58 @@ void Geofence::_updateFence()
 			break;
 		}
 	}
+
+	buildIndex();
+}
+
+void Geofence::buildIndex()
+{
+	int num_vertices = 0;
+
+	for (int i = 0; i < _num_polygons; ++i) {
+		const bool is_circle = _polygons[i].fence_type == NAV_CMD_FENCE_CIRCLE_INCLUSION
+				       || _polygons[i].fence_type == NAV_CMD_FENCE_CIRCLE_EXCLUSION;
+		num_vertices += is_circle ? 1 : _polygons[i].vertex_count;
+	}
+
+	if (_num_polygons == 0 || !_index.begin(_num_polygons, num_vertices)) {
+		return;
+	}
+
+	const dm_item_t fence_dataman_id{static_cast<dm_item_t>(_stats.dataman_id)};
+	bool success = true;
+
+	for (int i = 0; i < _num_polygons && success; ++i) {
+		const PolygonInfo &polygon = _polygons[i];
+		const bool is_circle = polygon.fence_type == NAV_CMD_FENCE_CIRCLE_INCLUSION
+				       || polygon.fence_type == NAV_CMD_FENCE_CIRCLE_EXCLUSION;
+		const bool inclusion = polygon.fence_type == NAV_CMD_FENCE_CIRCLE_INCLUSION
+				       || polygon.fence_type == NAV_CMD_FENCE_POLYGON_VERTEX_INCLUSION;
+		const int vertex_count = is_circle ? 1 : polygon.vertex_count;
+
+		success = is_circle || _index.addPolygon(inclusion);
+
+		for (int k = 0; k < vertex_count && success; ++k) {
+			mission_fence_point_s vertex{};
+			success = _dataman_cache.loadWait(fence_dataman_id, polygon.dataman_index + k,
+							  reinterpret_cast<uint8_t *>(&vertex), sizeof(mission_fence_point_s));
+
+			// other frames are left to the linear scan, which reports them
+			success = success && (vertex.frame == NAV_FRAME_GLOBAL || vertex.frame == NAV_FRAME_GLOBAL_INT
+					      || vertex.frame == NAV_FRAME_GLOBAL_RELATIVE_ALT
+					      || vertex.frame == NAV_FRAME_GLOBAL_RELATIVE_ALT_INT);
+
+			if (success) {
+				success = is_circle ? _index.addCircle(inclusion, vertex.lat, vertex.lon, vertex.circle_radius)
+					  : _index.addVertex(vertex.lat, vertex.lon);
+			}
+		}
+	}
+
+	if (!success || !_index.build()) {
+		PX4_WARN("Geofence index not built, using linear scan");
+		_index.reset();
+	}
 }
 
 bool Geofence::checkHomeRequirementsForGeofence(const PolygonInfo &polygon)
@@ -392,7 +445,11 @@ bool Geofence::isInsidePolygonOrCircle(double lat, double lon, float altitude)
 		}
 	}
 
-	/* Horizontal check: iterate all polygons & circles */
+	/* Horizontal check: use the index if available, otherwise iterate all polygons & circles */
+	if (_index.isBuilt()) {
+		return _index.isInside(lat, lon);
+	}
+
 	bool checksPass = true;
 
 	for (int polygon_index = 0; polygon_index < _num_polygons; ++polygon_index) {
@@ -695,4 +752,9 @@ void Geofence::printStatus()
 	PX4_INFO("Geofence: %i inclusion, %i exclusion polygons, %i inclusion circles, %i exclusion circles, %i total vertices",
 		 num_inclusion_polygons, num_exclusion_polygons, num_inclusion_circles, num_exclusion_circles,
 		 total_num_vertices);
+
+	if (_index.isBuilt()) {
+		PX4_INFO("Geofence index: %i shapes, %i vertices, %zu bytes", _index.numShapes(), _index.numVertices(),
+			 _index.memoryUsage());
+	}
 }
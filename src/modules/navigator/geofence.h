@@ -54,6 +54,8 @@
 #include <uORB/topics/vehicle_global_position.h>
 #include <uORB/topics/sensor_gps.h>
 
+#include "GeofenceIndex/GeofenceIndex.hpp"
+
 #define GEOFENCE_FILENAME PX4_STORAGEDIR"/etc/geofence.txt"
 
 class Navigator;
@@ -182,6 +184,8 @@ private:
 
 	MapProjection _projection_reference{}; ///< class to convert (lon, lat) to local [m]
 
+	GeofenceIndex _index{}; ///< spatial index over _polygons, falls back to the linear scan if not built
+
 	uint32_t _opaque_id{0}; ///< dataman geofence id: if it does not match, the polygon data was updated
 	bool _fence_updated{true};  ///< flag indicating if fence are updated to dataman cache
 	bool _initiate_fence_updated{true}; ///< flag indicating if fence updated is needed
@@ -193,6 +197,11 @@ private:
 	 */
 	void _updateFence();
 
+	/**
+	 * Build the spatial index from the polygons and circles loaded by _updateFence()
+	 */
+	void buildIndex();
+
 
 	/**
 	 * Check if a single point is within a polygon
@@ -52,8 +52,10 @@
 #include <cstring>
 #include <float.h>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <math.h>
+#include <queue>
 #include <time.h>
 #include <sstream>
 #include <stdio.h>
@@ -237,13 +239,12 @@ Replay::readDynamicParams(const char *filename)
 }
 
 bool
-Replay::readFileHeader(std::ifstream &file)
+Replay::readFileHeader(ReplayFile &file)
 {
-	file.seekg(0);
+	file.seek(0);
 	ulog_file_header_s msg_header;
-	file.read((char *)&msg_header, sizeof(msg_header));
 
-	if (!file) {
+	if (!file.read(&msg_header, sizeof(msg_header))) {
 		return false;
 	}
 
@@ -261,17 +262,15 @@ Replay::readFileHeader(std::ifstream &file)
 }
 
 bool
-Replay::readFileDefinitions(std::ifstream &file)
+Replay::readFileDefinitions(ReplayFile &file)
 {
 	PX4_INFO("Applying params from ULog file...");
 
 	ulog_message_header_s message_header;
-	file.seekg(sizeof(ulog_file_header_s));
+	file.seek(sizeof(ulog_file_header_s));
 
 	while (true) {
-		file.read((char *)&message_header, ULOG_MSG_HEADER_LEN);
-
-		if (!file) {
+		if (!file.read(&message_header, ULOG_MSG_HEADER_LEN)) {
 			return false;
 		}
 
@@ -298,19 +297,19 @@ Replay::readFileDefinitions(std::ifstream &file)
 			break;
 
 		case (int)ULogMessageType::ADD_LOGGED_MSG:
-			_data_section_start = file.tellg() - (streamoff)ULOG_MSG_HEADER_LEN;
+			_data_section_start = file.tell() - ULOG_MSG_HEADER_LEN;
 			return true;
 
 		case (int)ULogMessageType::INFO: //skip
 		case (int)ULogMessageType::INFO_MULTIPLE: //skip
 		case (int)ULogMessageType::PARAMETER_DEFAULT:
-			file.seekg(message_header.msg_size, ios::cur);
+			file.skip(message_header.msg_size);
 			break;
 
 		default:
 			PX4_ERR("unknown log definition type %i, size %i (offset %i)",
-				(int)message_header.msg_type, (int)message_header.msg_size, (int)file.tellg());
-			file.seekg(message_header.msg_size, ios::cur);
+				(int)message_header.msg_type, (int)message_header.msg_size, (int)file.tell());
+			file.skip(message_header.msg_size);
 			break;
 		}
 	}
@@ -319,7 +318,7 @@ Replay::readFileDefinitions(std::ifstream &file)
 }
 
 bool
-Replay::readFlagBits(std::ifstream &file, uint16_t msg_size)
+Replay::readFlagBits(ReplayFile &file, uint16_t msg_size)
 {
 	if (msg_size != 40) {
 		PX4_ERR("unsupported message length for FLAG_BITS message (%i)", msg_size);
@@ -328,7 +327,11 @@ Replay::readFlagBits(std::ifstream &file, uint16_t msg_size)
 
 	_read_buffer.reserve(msg_size);
 	uint8_t *message = (uint8_t *)_read_buffer.data();
-	file.read((char *)message, msg_size);
+
+	if (!file.read(message, msg_size)) {
+		return false;
+	}
+
 	//uint8_t *compat_flags = message;
 	uint8_t *incompat_flags = message + 8;
 
@@ -366,17 +369,17 @@ Replay::readFlagBits(std::ifstream &file, uint16_t msg_size)
 }
 
 bool
-Replay::readFormat(std::ifstream &file, uint16_t msg_size)
+Replay::readFormat(ReplayFile &file, uint16_t msg_size)
 {
 	_read_buffer.reserve(msg_size + 1);
 	char *format = (char *)_read_buffer.data();
-	file.read(format, msg_size);
-	format[msg_size] = 0;
 
-	if (!file) {
+	if (!file.read(format, msg_size)) {
 		return false;
 	}
 
+	format[msg_size] = 0;
+
 	string str_format(format);
 	size_t pos = str_format.find(':');
 
@@ -419,23 +422,17 @@ string Replay::getOrbFields(const orb_metadata *meta)
 }
 
 bool
-Replay::readAndAddSubscription(std::ifstream &file, uint16_t msg_size)
+Replay::readAndAddSubscription(ReplayFile &file, uint16_t msg_size)
 {
 	_read_buffer.reserve(msg_size + 1);
 	uint8_t *message = _read_buffer.data();
-	streampos this_message_pos = file.tellg() - (streamoff)ULOG_MSG_HEADER_LEN;
-	file.read((char *)message, msg_size);
-	message[msg_size] = 0;
+	const uint64_t this_message_pos = file.tell() - ULOG_MSG_HEADER_LEN;
 
-	if (!file) {
+	if (!file.read(message, msg_size)) {
 		return false;
 	}
 
-	if (file.tellg() <= _subscription_file_pos) { //already read this subscription
-		return true;
-	}
-
-	_subscription_file_pos = file.tellg();
+	message[msg_size] = 0;
 
 	uint8_t multi_id = *(uint8_t *)message;
 	uint16_t msg_id = ((uint16_t)message[1]) | (((uint16_t)message[2]) << 8);
@@ -544,17 +541,17 @@ Replay::readAndAddSubscription(std::ifstream &file, uint16_t msg_size)
 		return true;
 	}
 
-	//find first data message (and the timestamp)
-	streampos cur_pos = file.tellg();
-	subscription->next_read_pos = this_message_pos; //this will be skipped
+	//find first data message after the subscription (and the timestamp)
+	const std::vector<uint64_t> &data_messages = file.dataMessages(msg_id);
+	subscription->next_read_pos = this_message_pos;
+	subscription->next_message = std::lower_bound(data_messages.begin(), data_messages.end(), this_message_pos)
+				     - data_messages.begin();
 
 	if (!nextDataMessage(file, *subscription, msg_id)) {
 		delete subscription;
 		return false;
 	}
 
-	file.seekg(cur_pos);
-
 	if (!subscription->orb_meta) {
 		//no message found. This is not a fatal error
 		delete subscription;
@@ -607,14 +604,17 @@ Replay::findFieldOffset(const string &format, const string &field_name, int &off
 }
 
 bool
-Replay::readAndHandleAdditionalMessages(std::ifstream &file, std::streampos end_position)
+Replay::readAndHandleAdditionalMessages(ReplayFile &file, uint64_t end_position)
 {
 	ulog_message_header_s message_header;
+	const std::vector<uint64_t> &additional_messages = file.additionalMessages();
 
-	while (file.tellg() < end_position) {
-		file.read((char *)&message_header, ULOG_MSG_HEADER_LEN);
+	while (_next_additional_message < additional_messages.size()
+	       && additional_messages[_next_additional_message] < end_position) {
 
-		if (!file) {
+		file.seek(additional_messages[_next_additional_message++]);
+
+		if (!file.read(&message_header, ULOG_MSG_HEADER_LEN)) {
 			return false;
 		}
 
@@ -630,8 +630,7 @@ Replay::readAndHandleAdditionalMessages(std::ifstream &file, std::streampos end_
 			readDropout(file, message_header.msg_size);
 			break;
 
-		default: //skip all others
-			file.seekg(message_header.msg_size, ios::cur);
+		default: //the index only contains the types above
 			break;
 		}
 	}
@@ -640,13 +639,12 @@ Replay::readAndHandleAdditionalMessages(std::ifstream &file, std::streampos end_
 }
 
 bool
-Replay::readAndApplyParameter(std::ifstream &file, uint16_t msg_size)
+Replay::readAndApplyParameter(ReplayFile &file, uint16_t msg_size)
 {
 	_read_buffer.reserve(msg_size);
 	uint8_t *message = (uint8_t *)_read_buffer.data();
-	file.read((char *)message, msg_size);
 
-	if (!file) {
+	if (!file.read(message, msg_size)) {
 		return false;
 	}
 
@@ -683,99 +681,56 @@ Replay::readAndApplyParameter(std::ifstream &file, uint16_t msg_size)
 }
 
 bool
-Replay::readDropout(std::ifstream &file, uint16_t msg_size)
+Replay::readDropout(ReplayFile &file, uint16_t msg_size)
 {
 	uint16_t duration;
-	file.read((char *)&duration, sizeof(duration));
+
+	if (!file.read(&duration, sizeof(duration))) {
+		return false;
+	}
 
 	PX4_ERR("Dropout in replayed log, %i ms", (int)duration);
-	return file.good();
+	return true;
 }
 
 bool
-Replay::nextDataMessage(std::ifstream &file, Subscription &subscription, int msg_id)
+Replay::nextDataMessage(ReplayFile &file, Subscription &subscription, int msg_id)
 {
-	ulog_message_header_s message_header;
-	file.seekg(subscription.next_read_pos);
-	//ignore the first message (it's data we already read)
-	file.read((char *)&message_header, ULOG_MSG_HEADER_LEN);
-
-	if (file) {
-		file.seekg(message_header.msg_size, ios::cur);
-	}
-
-	uint16_t file_msg_id;
-	bool done = false;
+	const std::vector<uint64_t> &data_messages = file.dataMessages(msg_id);
+	const uint16_t expected_size = subscription.orb_meta->o_size_no_padding + 2;
 
-	while (file && !done) {
-		streampos cur_pos = file.tellg();
-		file.read((char *)&message_header, ULOG_MSG_HEADER_LEN);
+	while (subscription.next_message < data_messages.size()) {
+		const uint64_t cur_pos = data_messages[subscription.next_message++];
+		const uint8_t *message = file.at(cur_pos, ULOG_MSG_HEADER_LEN);
 
-		if (!file) {
-			break;
-		}
-
-		if (((streamoff)cur_pos) + ULOG_MSG_HEADER_LEN + message_header.msg_size > _read_until_file_position) {
-			file.setstate(std::ios::eofbit);
-			break;
+		if (!message) {
+			return false;
 		}
 
-		switch (message_header.msg_type) {
-		case (int)ULogMessageType::ADD_LOGGED_MSG:
-			readAndAddSubscription(file, message_header.msg_size);
-			break;
+		uint16_t msg_size;
+		memcpy(&msg_size, message, sizeof(msg_size));
 
-		case (int)ULogMessageType::DATA:
-			file.read((char *)&file_msg_id, sizeof(file_msg_id));
-
-			if (file) {
-				if (msg_id == file_msg_id) {
-					if (message_header.msg_size == subscription.orb_meta->o_size_no_padding + 2) {
-						subscription.next_read_pos = cur_pos;
-						file.seekg(subscription.timestamp_offset, ios::cur);
-						file.read((char *)&subscription.next_timestamp, sizeof(subscription.next_timestamp));
-						done = true;
-
-					} else { //sanity check failed!
-						PX4_ERR("data message %s has wrong size %i (expected %i). Skipping",
-							subscription.orb_meta->o_name, message_header.msg_size,
-							subscription.orb_meta->o_size_no_padding + 2);
-						file.seekg(message_header.msg_size - sizeof(file_msg_id), ios::cur);
-					}
+		if (msg_size == expected_size) {
+			const uint8_t *timestamp = file.at(cur_pos + ULOG_MSG_HEADER_LEN + 2 + subscription.timestamp_offset,
+							   sizeof(subscription.next_timestamp));
 
-				} else { //not the one we are looking for
-					file.seekg(message_header.msg_size - sizeof(file_msg_id), ios::cur);
-				}
+			if (!timestamp) {
+				return false;
 			}
 
-			break;
-
-		case (int)ULogMessageType::REMOVE_LOGGED_MSG: //skip these
-		case (int)ULogMessageType::PARAMETER:
-		case (int)ULogMessageType::DROPOUT:
-		case (int)ULogMessageType::INFO:
-		case (int)ULogMessageType::INFO_MULTIPLE:
-		case (int)ULogMessageType::SYNC:
-		case (int)ULogMessageType::LOGGING:
-		case (int)ULogMessageType::PARAMETER_DEFAULT:
-			file.seekg(message_header.msg_size, ios::cur);
-			break;
+			subscription.next_read_pos = cur_pos;
+			memcpy(&subscription.next_timestamp, timestamp, sizeof(subscription.next_timestamp));
+			return true;
 
-		default:
-			//this really should not happen
-			PX4_ERR("unknown log message type %i, size %i (offset %i)",
-				(int)message_header.msg_type, (int)message_header.msg_size, (int)file.tellg());
-			file.seekg(message_header.msg_size, ios::cur);
-			break;
+		} else { //sanity check failed!
+			PX4_ERR("data message %s has wrong size %i (expected %i). Skipping",
+				subscription.orb_meta->o_name, msg_size, expected_size);
 		}
 	}
 
-	if (file.eof()) { //no more data messages for this subscription
-		subscription.orb_meta = nullptr;
-		file.clear();
-	}
-
-	return file.good();
+	//no more data messages for this subscription
+	subscription.orb_meta = nullptr;
+	return true;
 }
 
 const orb_metadata *
@@ -851,7 +806,7 @@ Replay::sizeOfFullType(const std::string &type_name_full)
 }
 
 bool
-Replay::readDefinitionsAndApplyParams(std::ifstream &file)
+Replay::readDefinitionsAndApplyParams(ReplayFile &file)
 {
 	// log reader currently assumes little endian
 	int num = 1;
@@ -861,7 +816,7 @@ Replay::readDefinitionsAndApplyParams(std::ifstream &file)
 		return false;
 	}
 
-	if (!file.is_open()) {
+	if (!file.isOpen()) {
 		PX4_ERR("Failed to open replay file");
 		return false;
 	}
@@ -885,7 +840,8 @@ Replay::readDefinitionsAndApplyParams(std::ifstream &file)
 void
 Replay::run()
 {
-	ifstream replay_file(_replay_file, ios::in | ios::binary);
+	ReplayFile replay_file;
+	replay_file.open(_replay_file);
 
 	if (!readDefinitionsAndApplyParams(replay_file)) {
 		return;
@@ -898,68 +854,76 @@ Replay::run()
 		_speed_factor = atof(speedup);
 	}
 
-	onEnterMainLoop();
+	const char *index_cache = getenv(replay::ENV_INDEX_CACHE);
 
-	_replay_start_time = hrt_absolute_time();
-
-	PX4_INFO("Replay in progress...");
+	if (!replay_file.buildIndex(_data_section_start, _read_until_file_position, index_cache && atoi(index_cache) != 0)) {
+		PX4_ERR("Failed to index replay file");
+		return;
+	}
 
+	// add all subscriptions upfront, the index already knows where their data is
 	ulog_message_header_s message_header;
-	replay_file.seekg(_data_section_start);
 
-	//we know the next message must be an ADD_LOGGED_MSG
-	replay_file.read((char *)&message_header, ULOG_MSG_HEADER_LEN);
+	for (const uint64_t subscription_pos : replay_file.subscriptionMessages()) {
+		replay_file.seek(subscription_pos);
 
-	if (!readAndAddSubscription(replay_file, message_header.msg_size)) {
-		PX4_ERR("Failed to read subscription");
-		return;
+		if (!replay_file.read(&message_header, ULOG_MSG_HEADER_LEN)
+		    || !readAndAddSubscription(replay_file, message_header.msg_size)) {
+			PX4_ERR("Failed to read subscription");
+			return;
+		}
 	}
 
-	const uint64_t timestamp_offset = getTimestampOffset();
-	uint32_t nr_published_messages = 0;
-	streampos last_additional_message_pos = _data_section_start;
+	onEnterMainLoop();
 
-	while (!should_exit() && replay_file) {
+	_replay_start_time = hrt_absolute_time();
 
-		//Find the next message to publish. Messages from different subscriptions don't need
-		//to be in chronological order, so we need to check all subscriptions
-		uint64_t next_file_time = 0;
-		int next_msg_id = -1;
-		bool first_time = true;
+	PX4_INFO("Replay in progress...");
 
-		for (size_t i = 0; i < _subscriptions.size(); ++i) {
-			const Subscription *subscription = _subscriptions[i];
+	const uint64_t timestamp_offset = getTimestampOffset();
+	uint32_t nr_published_messages = 0;
 
-			if (!subscription) {
-				continue;
-			}
+	// Messages from different subscriptions don't need to be in chronological order, so the next
+	// message of each subscription is kept in a heap. Subscriptions that are advanced outside of
+	// the main loop leave stale entries behind, which are dropped when they reach the top.
+	std::priority_queue<PendingPublication, std::vector<PendingPublication>, std::greater<PendingPublication>>
+			publication_queue;
 
-			if (subscription->orb_meta && !subscription->ignored) {
-				if (first_time || subscription->next_timestamp < next_file_time) {
-					first_time = false;
-					next_msg_id = (int)i;
-					next_file_time = subscription->next_timestamp;
-				}
-			}
+	auto queue_subscription = [&publication_queue](const Subscription & sub, int msg_id) {
+		if (sub.orb_meta && !sub.ignored) {
+			publication_queue.push(PendingPublication{sub.next_timestamp, (uint16_t)msg_id, sub.next_message});
 		}
+	};
 
-		if (next_msg_id == -1) {
-			break; //no active subscription anymore. We're done.
+	for (size_t i = 0; i < _subscriptions.size(); ++i) {
+		if (_subscriptions[i]) {
+			queue_subscription(*_subscriptions[i], i);
 		}
+	}
+
+	while (!should_exit() && !publication_queue.empty()) {
 
+		//Find the next message to publish
+		const PendingPublication next = publication_queue.top();
+		publication_queue.pop();
+
+		const uint64_t next_file_time = next.timestamp;
+		const int next_msg_id = next.msg_id;
 		Subscription &sub = *_subscriptions[next_msg_id];
 
+		if (!sub.orb_meta || sub.ignored || sub.next_message != next.next_message) {
+			continue; // stale entry
+		}
+
 		if (next_file_time == 0 || next_file_time < _file_start_time) {
 			//someone didn't set the timestamp properly. Consider the message invalid
 			nextDataMessage(replay_file, sub, next_msg_id);
+			queue_subscription(sub, next_msg_id);
 			continue;
 		}
 
 		//handle additional messages between last and next published data
-		replay_file.seekg(last_additional_message_pos);
-		streampos next_additional_message_pos = sub.next_read_pos;
-		readAndHandleAdditionalMessages(replay_file, next_additional_message_pos);
-		last_additional_message_pos = next_additional_message_pos;
+		readAndHandleAdditionalMessages(replay_file, sub.next_read_pos);
 
 		// Perform scheduled parameter changes
 		while (_next_param_change < _dynamic_parameter_schedule.size() &&
@@ -983,6 +947,7 @@ Replay::run()
 		}
 
 		nextDataMessage(replay_file, sub, next_msg_id);
+		queue_subscription(sub, next_msg_id);
 
 		// TODO: output status (eg. every sec), including total duration...
 	}
@@ -1026,17 +991,17 @@ Replay::run()
 }
 
 void
-Replay::readTopicDataToBuffer(const Subscription &sub, std::ifstream &replay_file)
+Replay::readTopicDataToBuffer(const Subscription &sub, ReplayFile &replay_file)
 {
 	const size_t msg_read_size = sub.orb_meta->o_size_no_padding;
 	const size_t msg_write_size = sub.orb_meta->o_size;
 	_read_buffer.reserve(msg_write_size);
-	replay_file.seekg(sub.next_read_pos + (streamoff)(ULOG_MSG_HEADER_LEN + 2)); //skip header & msg id
-	replay_file.read((char *)_read_buffer.data(), msg_read_size);
+	replay_file.seek(sub.next_read_pos + ULOG_MSG_HEADER_LEN + 2); //skip header & msg id
+	replay_file.read(_read_buffer.data(), msg_read_size);
 }
 
 bool
-Replay::handleTopicUpdate(Subscription &sub, void *data, std::ifstream &replay_file)
+Replay::handleTopicUpdate(Subscription &sub, void *data, ReplayFile &replay_file)
 {
 	return publishTopic(sub, data);
 }
@@ -1182,7 +1147,8 @@ Replay::applyParams(bool quiet)
 		return -ENOMEM;
 	}
 
-	ifstream replay_file(_replay_file, ios::in | ios::binary);
+	ReplayFile replay_file;
+	replay_file.open(_replay_file);
 
 	if (!r->readDefinitionsAndApplyParams(replay_file)) {
 		ret = -1;
@@ -1231,6 +1197,10 @@ the log file to be replayed. The second is the mode, specified via `replay_mode`
 - Generic otherwise: this can be used to replay any module(s), but the replay will be done with the same speed as the
   log was recorded.
 
+Set `PX4_SIM_SPEED_FACTOR=0` to replay as fast as possible, without any sleeps (always the case in ekf2 mode).
+The log file is memory mapped and indexed in a single pass before the replay starts. With `replay_index_cache=1`
+the index is stored next to the log (`<log>.index`) and reused as long as the log file is unchanged.
+
 The module is typically used together with uORB publisher rules, to specify which messages should be replayed.
 The replay module will just publish all messages that are found in the log. It also applies the parameters from
 the log.
@@ -34,13 +34,13 @@
 #pragma once
 
 #include <algorithm>
-#include <fstream>
 #include <map>
 #include <vector>
 #include <set>
 #include <string>
 
 #include "definitions.hpp"
+#include "ReplayFile.hpp"
 
 #include <px4_platform_common/module.h>
 #include <uORB/topics/uORBTopics.hpp>
@@ -52,9 +52,10 @@ namespace px4
 /**
  * @class Replay
  * Parses an ULog file and replays it in 'real-time'. The timestamp of each replayed message is offset
- * to match the starting time of replay. It keeps a stream for each subscription to find the next message
- * to replay. This is necessary because data messages from different subscriptions don't need to be in
- * monotonic increasing order.
+ * to match the starting time of replay. The file is memory mapped and indexed once, and each subscription
+ * keeps a position in the index of its data messages. The next message to replay is taken from a heap
+ * ordered by timestamp. This is necessary because data messages from different subscriptions don't need
+ * to be in monotonic increasing order.
  */
 class Replay : public ModuleBase<Replay>
 {
@@ -135,8 +136,9 @@ protected:
 
 		bool ignored = false; ///< if true, it will not be considered for publication in the main loop
 
-		std::streampos next_read_pos;
+		uint64_t next_read_pos{0}; ///< file offset of the next message to publish
 		uint64_t next_timestamp; ///< timestamp of the file
+		size_t next_message{0}; ///< position in ReplayFile::dataMessages() after next_read_pos
 
 		CompatBase *compat = nullptr;
 
@@ -190,22 +192,20 @@ protected:
 	 * handle the publication of a topic update
 	 * @return true if published, false otherwise
 	 */
-	virtual bool handleTopicUpdate(Subscription &sub, void *data, std::ifstream &replay_file);
+	virtual bool handleTopicUpdate(Subscription &sub, void *data, ReplayFile &replay_file);
 
 	/**
 	 * read a topic from the file (offset given by the subscription) into _read_buffer
 	 */
-	void readTopicDataToBuffer(const Subscription &sub, std::ifstream &replay_file);
+	void readTopicDataToBuffer(const Subscription &sub, ReplayFile &replay_file);
 
 	/**
-	 * Find next data message for this subscription, starting with the stored file offset.
-	 * Skip the first message, and if found, read the timestamp and store the new file offset.
-	 * This also takes care of new subscriptions and parameter updates. When reaching EOF,
+	 * Find next data message for this subscription in the index, starting after the stored file offset.
+	 * If found, read the timestamp and store the new file offset. When reaching the end of the index,
 	 * the subscription is set to invalid.
-	 * File seek position is arbitrary after this call.
 	 * @return false on file error
 	 */
-	bool nextDataMessage(std::ifstream &file, Subscription &subscription, int msg_id);
+	bool nextDataMessage(ReplayFile &file, Subscription &subscription, int msg_id);
 
 	virtual uint64_t getTimestampOffset()
 	{
@@ -242,45 +242,59 @@ private:
 
 	uint64_t _file_start_time;
 	uint64_t _replay_start_time;
-	std::streampos _data_section_start; ///< first ADD_LOGGED_MSG message
-
-	/** keep track of file position to avoid adding a subscription multiple times. */
-	std::streampos _subscription_file_pos = 0;
+	uint64_t _data_section_start; ///< first ADD_LOGGED_MSG message
 
 	int64_t _read_until_file_position = 1ULL << 60; ///< read limit if log contains appended data
 
+	size_t _next_additional_message{0}; ///< position in ReplayFile::additionalMessages()
+
 	float _accumulated_delay{0.f};
 
-	bool readFileHeader(std::ifstream &file);
+	/**
+	 * entry of the publication heap, ordered by timestamp (and msg_id for equal timestamps)
+	 */
+	struct PendingPublication {
+		uint64_t timestamp;
+		uint16_t msg_id;
+		size_t next_message; ///< to detect stale entries: Subscription::next_message when pushed
+
+		bool operator>(const PendingPublication &other) const
+		{
+			return timestamp > other.timestamp || (timestamp == other.timestamp && msg_id > other.msg_id);
+		}
+	};
+
+	bool readFileHeader(ReplayFile &file);
 
 	/**
 	 * Read definitions section: check formats, apply parameters and store
 	 * the start of the data section.
 	 * @return true on success
 	 */
-	bool readFileDefinitions(std::ifstream &file);
+	bool readFileDefinitions(ReplayFile &file);
 
 	///file parsing methods. They return false, when further parsing should be aborted.
-	bool readFormat(std::ifstream &file, uint16_t msg_size);
-	bool readAndAddSubscription(std::ifstream &file, uint16_t msg_size);
-	bool readFlagBits(std::ifstream &file, uint16_t msg_size);
+	bool readFormat(ReplayFile &file, uint16_t msg_size);
+	bool readAndAddSubscription(ReplayFile &file, uint16_t msg_size);
+	bool readFlagBits(ReplayFile &file, uint16_t msg_size);
 
 	/**
 	 * Read the file header and definitions sections. Apply the parameters from this section
 	 * and apply user-defined overridden parameters.
 	 * @return true on success
 	 */
-	bool readDefinitionsAndApplyParams(std::ifstream &file);
+	bool readDefinitionsAndApplyParams(ReplayFile &file);
 
 	/**
-	 * Read and handle additional messages starting at current file position, while position < end_position.
+	 * Read and handle the additional messages from the index that were not handled yet and
+	 * are located before end_position.
 	 * This handles dropout and parameter update messages.
 	 * We need to handle these separately, because they have no timestamp. We look at the file position instead.
 	 * @return false on file error
 	 */
-	bool readAndHandleAdditionalMessages(std::ifstream &file, std::streampos end_position);
-	bool readDropout(std::ifstream &file, uint16_t msg_size);
-	bool readAndApplyParameter(std::ifstream &file, uint16_t msg_size);
+	bool readAndHandleAdditionalMessages(ReplayFile &file, uint64_t end_position);
+	bool readDropout(ReplayFile &file, uint16_t msg_size);
+	bool readAndApplyParameter(ReplayFile &file, uint16_t msg_size);
 
 	static const orb_metadata *findTopic(const std::string &name);
 
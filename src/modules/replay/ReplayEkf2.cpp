@@ -59,7 +59,7 @@ namespace px4
 {
 
 bool
-ReplayEkf2::handleTopicUpdate(Subscription &sub, void *data, std::ifstream &replay_file)
+ReplayEkf2::handleTopicUpdate(Subscription &sub, void *data, ReplayFile &replay_file)
 {
 	if (sub.orb_meta == ORB_ID(ekf2_timestamps)) {
 		ekf2_timestamps_s ekf2_timestamps;
@@ -118,7 +118,7 @@ ReplayEkf2::onSubscriptionAdded(Subscription &sub, uint16_t msg_id)
 }
 
 bool
-ReplayEkf2::publishEkf2Topics(const ekf2_timestamps_s &ekf2_timestamps, std::ifstream &replay_file)
+ReplayEkf2::publishEkf2Topics(const ekf2_timestamps_s &ekf2_timestamps, ReplayFile &replay_file)
 {
 	auto handle_sensor_publication = [&](int16_t timestamp_relative, uint16_t msg_id) {
 		if (timestamp_relative != ekf2_timestamps_s::RELATIVE_TIMESTAMP_INVALID) {
@@ -156,7 +156,7 @@ ReplayEkf2::publishEkf2Topics(const ekf2_timestamps_s &ekf2_timestamps, std::ifs
 }
 
 bool
-ReplayEkf2::findTimestampAndPublish(uint64_t timestamp, uint16_t msg_id, std::ifstream &replay_file)
+ReplayEkf2::findTimestampAndPublish(uint64_t timestamp, uint16_t msg_id, ReplayFile &replay_file)
 {
 	if (msg_id == msg_id_invalid) {
 		// could happen if a topic is not logged
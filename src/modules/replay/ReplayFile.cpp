@@ -0,0 +1,478 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "ReplayFile.hpp"
+
+#include <px4_platform_common/log.h>
+
+#include <algorithm>
+#include <fcntl.h>
+#include <fstream>
+#include <inttypes.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <logger/messages.h>
+#include <lib/log_compression/LogCompression.hpp>
+
+namespace px4
+{
+
+constexpr char ReplayFile::INDEX_FILE_MAGIC[8];
+
+static constexpr uint64_t FNV1A_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+
+bool
+ReplayFile::open(const char *file_name)
+{
+	close();
+
+	_fd = ::open(file_name, O_RDONLY);
+
+	if (_fd < 0) {
+		return false;
+	}
+
+	struct stat file_stat;
+
+	if (fstat(_fd, &file_stat) != 0 || file_stat.st_size <= 0) {
+		close();
+		return false;
+	}
+
+	void *data = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, _fd, 0);
+
+	if (data == MAP_FAILED) {
+		close();
+		return false;
+	}
+
+	_file_data = (const uint8_t *)data;
+	_file_size = file_stat.st_size;
+
+	// the data section is mostly read front to back
+	madvise(data, _file_size, MADV_SEQUENTIAL);
+
+	if (log_compression::isCompressed(_file_data, _file_size)) {
+		// compressed log (SDLOG_COMPRESS): frames are decompressed on demand
+		_compressed = true;
+
+		if (!indexFrames()) {
+			PX4_ERR("failed to decompress %s", file_name);
+			close();
+			return false;
+		}
+
+	} else {
+		_size = _file_size;
+	}
+
+	_position = 0;
+	_modification_time = file_stat.st_mtime;
+	_file_name = file_name;
+	return true;
+}
+
+void
+ReplayFile::close()
+{
+	if (_file_data) {
+		munmap((void *)_file_data, _file_size);
+		_file_data = nullptr;
+	}
+
+	if (_fd >= 0) {
+		::close(_fd);
+		_fd = -1;
+	}
+
+	_file_size = 0;
+	_size = 0;
+	_position = 0;
+	_compressed = false;
+	_frames.clear();
+
+	for (CachedFrame &cached : _frame_cache) {
+		cached.frame = SIZE_MAX;
+		cached.data.clear();
+		cached.data.shrink_to_fit();
+	}
+
+	_span_buffer.clear();
+	_data_messages.clear();
+	_subscription_messages.clear();
+	_additional_messages.clear();
+}
+
+bool
+ReplayFile::indexFrames()
+{
+	std::vector<uint8_t> scratch;
+	uint64_t file_offset = 0;
+	uint64_t offset = 0;
+	log_compression::FrameInfo info;
+
+	// a truncated last frame is ignored (e.g. after a power loss)
+	while (file_offset < _file_size
+	       && log_compression::parseFrame(_file_data + file_offset, _file_size - file_offset, info)) {
+
+		uint64_t size = info.content_size;
+
+		if (!info.skippable && !info.content_size_exact && size > 0) {
+			// only an upper bound is known: decompress to get the exact size
+			scratch.resize(size);
+			const int64_t ret = log_compression::decompress(_file_data + file_offset, info.frame_size,
+					    scratch.data(), scratch.size());
+
+			if (ret < 0) {
+				return false;
+			}
+
+			size = ret;
+		}
+
+		if (!info.skippable && size > 0) {
+			_frames.push_back(Frame{file_offset, info.frame_size, offset, size});
+			offset += size;
+		}
+
+		file_offset += info.frame_size;
+	}
+
+	_size = offset;
+	return !_frames.empty();
+}
+
+const uint8_t *
+ReplayFile::frameData(size_t frame)
+{
+	CachedFrame *oldest = &_frame_cache[0];
+
+	for (CachedFrame &cached : _frame_cache) {
+		if (cached.frame == frame) {
+			cached.last_use = ++_frame_cache_uses;
+			return cached.data.data();
+		}
+
+		if (cached.last_use < oldest->last_use) {
+			oldest = &cached;
+		}
+	}
+
+	const Frame &f = _frames[frame];
+	oldest->frame = SIZE_MAX;
+	oldest->data.resize(f.size);
+
+	if (log_compression::decompress(_file_data + f.file_offset, f.frame_size, oldest->data.data(),
+					oldest->data.size()) != (int64_t)f.size) {
+		PX4_ERR("failed to decompress frame at offset %" PRIu64, f.file_offset);
+		return nullptr;
+	}
+
+	oldest->frame = frame;
+	oldest->last_use = ++_frame_cache_uses;
+	return oldest->data.data();
+}
+
+const uint8_t *
+ReplayFile::decompressedAt(uint64_t position, size_t length)
+{
+	// find the last frame starting at or before position
+	size_t frame = std::upper_bound(_frames.begin(), _frames.end(), position, [](uint64_t pos, const Frame & f) {
+		return pos < f.offset;
+	}) - _frames.begin() - 1;
+
+	const uint8_t *data = frameData(frame);
+
+	if (!data) {
+		return nullptr;
+	}
+
+	uint64_t frame_position = position - _frames[frame].offset;
+
+	if (frame_position + length <= _frames[frame].size) {
+		return data + frame_position;
+	}
+
+	// the data crosses frame boundaries: copy it into the span buffer
+	_span_buffer.resize(length);
+	size_t copied = 0;
+
+	while (copied < length) {
+		const size_t chunk = std::min<uint64_t>(length - copied, _frames[frame].size - frame_position);
+		memcpy(_span_buffer.data() + copied, data + frame_position, chunk);
+		copied += chunk;
+		frame_position = 0;
+
+		if (copied < length) {
+			data = frameData(++frame);
+
+			if (!data) {
+				return nullptr;
+			}
+		}
+	}
+
+	return _span_buffer.data();
+}
+
+bool
+ReplayFile::read(void *buffer, size_t length)
+{
+	const uint8_t *src = at(_position, length);
+
+	if (!src) {
+		return false;
+	}
+
+	memcpy(buffer, src, length);
+	_position += length;
+	return true;
+}
+
+bool
+ReplayFile::buildIndex(uint64_t data_section_start, uint64_t end_position, bool use_cache)
+{
+	if (!isOpen()) {
+		return false;
+	}
+
+	if (end_position > _size) {
+		end_position = _size;
+	}
+
+	const std::string index_file_name = _file_name + ".index";
+
+	if (use_cache && loadIndex(index_file_name, data_section_start, end_position)) {
+		PX4_INFO("Using index %s", index_file_name.c_str());
+		return true;
+	}
+
+	_data_messages.clear();
+	_subscription_messages.clear();
+	_additional_messages.clear();
+
+	uint64_t position = data_section_start;
+	ulog_message_header_s message_header;
+
+	while (position + ULOG_MSG_HEADER_LEN <= end_position) {
+		const uint8_t *header = at(position, ULOG_MSG_HEADER_LEN);
+
+		if (!header) {
+			break;
+		}
+
+		memcpy(&message_header, header, ULOG_MSG_HEADER_LEN);
+
+		// a truncated message at the end of the file is ignored
+		if (position + ULOG_MSG_HEADER_LEN + message_header.msg_size > end_position) {
+			break;
+		}
+
+		switch (message_header.msg_type) {
+		case (int)ULogMessageType::DATA:
+			if (message_header.msg_size >= sizeof(uint16_t)) {
+				const uint8_t *msg_id_data = at(position + ULOG_MSG_HEADER_LEN, sizeof(uint16_t));
+
+				if (!msg_id_data) {
+					break;
+				}
+
+				uint16_t msg_id;
+				memcpy(&msg_id, msg_id_data, sizeof(msg_id));
+
+				if (_data_messages.size() <= msg_id) {
+					_data_messages.resize(msg_id + 1);
+				}
+
+				_data_messages[msg_id].push_back(position);
+			}
+
+			break;
+
+		case (int)ULogMessageType::ADD_LOGGED_MSG:
+			_subscription_messages.push_back(position);
+			break;
+
+		case (int)ULogMessageType::PARAMETER:
+		case (int)ULogMessageType::DROPOUT:
+			_additional_messages.push_back(position);
+			break;
+
+		case (int)ULogMessageType::REMOVE_LOGGED_MSG: //skip these
+		case (int)ULogMessageType::INFO:
+		case (int)ULogMessageType::INFO_MULTIPLE:
+		case (int)ULogMessageType::SYNC:
+		case (int)ULogMessageType::LOGGING:
+		case (int)ULogMessageType::LOGGING_TAGGED:
+		case (int)ULogMessageType::PARAMETER_DEFAULT:
+			break;
+
+		default:
+			//this really should not happen
+			PX4_ERR("unknown log message type %i, size %i (offset %" PRIu64 ")",
+				(int)message_header.msg_type, (int)message_header.msg_size, position);
+			break;
+		}
+
+		position += ULOG_MSG_HEADER_LEN + message_header.msg_size;
+	}
+
+	if (use_cache) {
+		saveIndex(index_file_name, data_section_start, end_position);
+	}
+
+	return true;
+}
+
+uint64_t
+ReplayFile::checksum(const std::vector<uint64_t> &list, uint64_t hash)
+{
+	auto add = [&hash](uint64_t value) {
+		for (int i = 0; i < 8; ++i) {
+			hash = (hash ^ ((value >> (8 * i)) & 0xff)) * 0x100000001b3ULL;
+		}
+	};
+
+	add(list.size());
+
+	for (const uint64_t value : list) {
+		add(value);
+	}
+
+	return hash;
+}
+
+bool
+ReplayFile::loadIndex(const std::string &index_file_name, uint64_t data_section_start, uint64_t end_position)
+{
+	std::ifstream file(index_file_name, std::ios::in | std::ios::binary);
+
+	if (!file.is_open()) {
+		return false;
+	}
+
+	IndexFileHeader header{};
+	file.read((char *)&header, sizeof(header));
+
+	if (!file || memcmp(header.magic, INDEX_FILE_MAGIC, sizeof(header.magic)) != 0
+	    || header.log_size != _size || header.log_modification_time != _modification_time
+	    || header.data_section_start != data_section_start || header.end_position != end_position) {
+		return false;
+	}
+
+	auto read_list = [&file, this](std::vector<uint64_t> &list) {
+		uint64_t count = 0;
+		file.read((char *)&count, sizeof(count));
+
+		// every message takes at least a header, so a larger count is corrupt
+		if (!file || count > _size / ULOG_MSG_HEADER_LEN) {
+			return false;
+		}
+
+		list.resize(count);
+		file.read((char *)list.data(), count * sizeof(uint64_t));
+		return !file.fail();
+	};
+
+	_data_messages.resize(header.num_msg_ids);
+	bool success = read_list(_subscription_messages) && read_list(_additional_messages);
+	uint64_t hash = checksum(_additional_messages, checksum(_subscription_messages, FNV1A_OFFSET_BASIS));
+
+	for (size_t i = 0; i < _data_messages.size() && success; ++i) {
+		success = read_list(_data_messages[i]);
+		hash = checksum(_data_messages[i], hash);
+	}
+
+	success = success && hash == header.checksum;
+
+	if (!success) {
+		_data_messages.clear();
+		_subscription_messages.clear();
+		_additional_messages.clear();
+	}
+
+	return success;
+}
+
+void
+ReplayFile::saveIndex(const std::string &index_file_name, uint64_t data_section_start, uint64_t end_position) const
+{
+	// write to a temporary file first, so that an interrupted write never leaves a truncated index behind
+	const std::string tmp_file_name = index_file_name + ".tmp";
+	std::ofstream file(tmp_file_name, std::ios::out | std::ios::binary | std::ios::trunc);
+
+	if (!file.is_open()) {
+		PX4_WARN("Cannot write index %s", index_file_name.c_str());
+		return;
+	}
+
+	IndexFileHeader header{};
+	memcpy(header.magic, INDEX_FILE_MAGIC, sizeof(header.magic));
+	header.log_size = _size;
+	header.log_modification_time = _modification_time;
+	header.data_section_start = data_section_start;
+	header.end_position = end_position;
+	header.num_msg_ids = _data_messages.size();
+	header.checksum = checksum(_additional_messages, checksum(_subscription_messages, FNV1A_OFFSET_BASIS));
+
+	for (const auto &list : _data_messages) {
+		header.checksum = checksum(list, header.checksum);
+	}
+
+	file.write((const char *)&header, sizeof(header));
+
+	auto write_list = [&file](const std::vector<uint64_t> &list) {
+		const uint64_t count = list.size();
+		file.write((const char *)&count, sizeof(count));
+		file.write((const char *)list.data(), count * sizeof(uint64_t));
+	};
+
+	write_list(_subscription_messages);
+	write_list(_additional_messages);
+
+	for (const auto &list : _data_messages) {
+		write_list(list);
+	}
+
+	file.close();
+
+	if (file.fail() || rename(tmp_file_name.c_str(), index_file_name.c_str()) != 0) {
+		PX4_WARN("Cannot write index %s", index_file_name.c_str());
+		unlink(tmp_file_name.c_str());
+	}
+}
+
+} // namespace px4
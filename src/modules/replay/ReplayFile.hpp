@@ -0,0 +1,178 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace px4
+{
+
+/**
+ * @class ReplayFile
+ * Read-only, memory mapped ULog file. It provides sequential reads for the header and definitions
+ * sections, and an index of the data section built in a single pass: the offsets of the data messages
+ * of each msg_id, of all subscriptions and of the messages without timestamp (parameter changes and
+ * dropouts). Replay can then move every subscription to its next message in constant time instead of
+ * scanning the file.
+ * The index can be cached next to the log file, so it is only built once per log.
+ * Compressed logs (LZ4 frames, see SDLOG_COMPRESS) are indexed by frame when opened, and frames are
+ * decompressed on demand into a small cache. Positions always refer to the decompressed log.
+ */
+class ReplayFile
+{
+public:
+	ReplayFile() = default;
+	ReplayFile(const ReplayFile &) = delete;
+	ReplayFile &operator=(const ReplayFile &) = delete;
+
+	~ReplayFile() { close(); }
+
+	/**
+	 * Open and map a file
+	 * @return true on success
+	 */
+	bool open(const char *file_name);
+
+	void close();
+
+	bool isOpen() const { return _file_data != nullptr; }
+
+	uint64_t size() const { return _size; }
+
+	/**
+	 * Copy length bytes at the current position and advance it
+	 * @return false if the end of the file is reached (the position is not changed in that case)
+	 */
+	bool read(void *buffer, size_t length);
+
+	void seek(uint64_t position) { _position = position; }
+	void skip(uint64_t length) { _position += length; }
+	uint64_t tell() const { return _position; }
+
+	/**
+	 * @return pointer to the data at position, nullptr if [position, position + length) is out of the file.
+	 * For compressed logs the pointer is only valid until the next call of at() or read().
+	 */
+	const uint8_t *at(uint64_t position, size_t length)
+	{
+		if (position > _size || length > _size - position) {
+			return nullptr;
+		}
+
+		return _compressed ? decompressedAt(position, length) : _file_data + position;
+	}
+
+	/**
+	 * Index the messages in [data_section_start, end_position)
+	 * @param use_cache load the index from <file_name>.index if it matches the log, or create it
+	 * @return false if the file is not open
+	 */
+	bool buildIndex(uint64_t data_section_start, uint64_t end_position, bool use_cache);
+
+	/**
+	 * @return file offsets of all DATA messages with the given msg_id, in file order
+	 */
+	const std::vector<uint64_t> &dataMessages(uint16_t msg_id) const
+	{
+		return msg_id < _data_messages.size() ? _data_messages[msg_id] : _empty;
+	}
+
+	/** @return file offsets of all ADD_LOGGED_MSG messages, in file order */
+	const std::vector<uint64_t> &subscriptionMessages() const { return _subscription_messages; }
+
+	/** @return file offsets of all PARAMETER and DROPOUT messages, in file order */
+	const std::vector<uint64_t> &additionalMessages() const { return _additional_messages; }
+
+private:
+	/** LZ4 frame of a compressed log */
+	struct Frame {
+		uint64_t file_offset;  ///< offset of the frame in the file
+		uint64_t frame_size;   ///< compressed size including the frame header
+		uint64_t offset;       ///< offset of the frame content in the decompressed log
+		uint64_t size;         ///< decompressed size
+	};
+
+	struct CachedFrame {
+		size_t frame{SIZE_MAX};
+		uint64_t last_use{0};
+		std::vector<uint8_t> data;
+	};
+
+	bool indexFrames();
+	const uint8_t *frameData(size_t frame);
+	const uint8_t *decompressedAt(uint64_t position, size_t length);
+
+	bool loadIndex(const std::string &index_file_name, uint64_t data_section_start, uint64_t end_position);
+	void saveIndex(const std::string &index_file_name, uint64_t data_section_start, uint64_t end_position) const;
+
+	struct IndexFileHeader {
+		char magic[8];
+		uint64_t log_size;
+		int64_t log_modification_time; ///< [s]
+		uint64_t data_section_start;
+		uint64_t end_position;
+		uint32_t num_msg_ids;
+		uint32_t reserved;
+		uint64_t checksum; ///< FNV-1a over the stored lists
+	};
+
+	static uint64_t checksum(const std::vector<uint64_t> &list, uint64_t hash);
+
+	static constexpr char INDEX_FILE_MAGIC[8] = {'U', 'L', 'o', 'g', 'I', 'd', 'x', 1};
+
+	int _fd{-1};
+	const uint8_t *_file_data{nullptr};
+	uint64_t _file_size{0};
+	uint64_t _size{0}; ///< size of the (decompressed) log
+	uint64_t _position{0};
+	int64_t _modification_time{0}; ///< [s]
+	std::string _file_name;
+
+	bool _compressed{false};
+	std::vector<Frame> _frames;
+	static constexpr int FRAME_CACHE_SIZE = 8; ///< the subscriptions read close to the current replay time
+	CachedFrame _frame_cache[FRAME_CACHE_SIZE];
+	uint64_t _frame_cache_uses{0};
+	std::vector<uint8_t> _span_buffer; ///< data crossing frame boundaries
+
+	std::vector<std::vector<uint64_t>> _data_messages;
+	std::vector<uint64_t> _subscription_messages;
+	std::vector<uint64_t> _additional_messages;
+	const std::vector<uint64_t> _empty;
+};
+
+} // namespace px4
@@ -40,6 +40,7 @@ namespace replay
 
 static const char __attribute__((unused)) *ENV_FILENAME = "replay"; ///< name for getenv()
 static const char __attribute__((unused)) *ENV_MODE = "replay_mode";  ///< name for getenv()
+static const char __attribute__((unused)) *ENV_INDEX_CACHE = "replay_index_cache";  ///< name for getenv()
 
 
 } //namespace replay
@@ -42,6 +42,7 @@
 __BEGIN_DECLS
 
 extern int test_microbench_atomic(int argc, char *argv[]);
+extern int test_microbench_compress(int argc, char *argv[]);
 extern int test_microbench_hrt(int argc, char *argv[]);
 extern int test_microbench_math(int argc, char *argv[]);
 extern int test_microbench_matrix(int argc, char *argv[]);
@@ -64,6 +65,7 @@ const struct {
 	{"all",		microbench_all,		OPT_NOALLTEST},
 
 	{"microbench_atomic",	test_microbench_atomic,	0},
+	{"microbench_compress",	test_microbench_compress,	0},
 	{"microbench_hrt",	test_microbench_hrt,	0},
 	{"microbench_math",	test_microbench_math,	0},
 	{"microbench_matrix",	test_microbench_matrix,	0},
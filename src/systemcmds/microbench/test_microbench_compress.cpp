@@ -0,0 +1,155 @@
+/****************************************************************************
+ *
+ *  Copyright (C) 2020-2021 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file test_microbench_compress.cpp
+ * Microbenchmark of the log compression (SDLOG_COMPRESS) with a recorded log.
+ *
+ * Usage: microbench microbench_compress <log file>
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <drivers/drv_hrt.h>
+#include <lib/log_compression/LogCompression.hpp>
+#include <px4_platform_common/log.h>
+#include <px4_platform_common/px4_config.h>
+
+using namespace log_compression;
+
+#if defined(__PX4_NUTTX)
+static constexpr size_t MAX_INPUT_SIZE = 256 * 1024;
+#else
+static constexpr size_t MAX_INPUT_SIZE = 64 * 1024 * 1024;
+#endif
+
+static size_t read_log(const char *file_name, uint8_t **data)
+{
+	int fd = open(file_name, O_RDONLY);
+
+	if (fd < 0) {
+		PX4_ERR("failed to open %s", file_name);
+		return 0;
+	}
+
+	const off_t file_size = lseek(fd, 0, SEEK_END);
+	lseek(fd, 0, SEEK_SET);
+	const size_t size = file_size > (off_t)MAX_INPUT_SIZE ? MAX_INPUT_SIZE : (size_t)file_size;
+
+	*data = (uint8_t *)malloc(size);
+	size_t total = 0;
+
+	while (*data && total < size) {
+		const ssize_t ret = read(fd, *data + total, size - total);
+
+		if (ret <= 0) {
+			break;
+		}
+
+		total += ret;
+	}
+
+	close(fd);
+	return total;
+}
+
+extern "C" int test_microbench_compress(int argc, char *argv[])
+{
+	if (argc < 2) {
+		PX4_INFO("no log file given (microbench microbench_compress <log file>), skipping");
+		return 0;
+	}
+
+	uint8_t *input = nullptr;
+	const size_t input_size = read_log(argv[1], &input);
+	uint8_t *output = (uint8_t *)malloc((input_size / BLOCK_SIZE + 1) * MAX_FRAME_SIZE);
+	uint8_t *decompressed = (uint8_t *)malloc(input_size);
+	FrameEncoder encoder;
+	int ret = 0;
+
+	if (input_size == 0 || !output || !decompressed) {
+		PX4_ERR("failed to read the log or to allocate memory");
+		ret = 1;
+		goto out;
+	}
+
+	printf("%s: %zu bytes, %zu byte blocks\n", argv[1], input_size, BLOCK_SIZE);
+	printf("acceleration   ratio   compress [MB/s]   decompress [MB/s]\n");
+
+	static constexpr int accelerations[] = {1, 2, 4, 8, 16, 32};
+
+	for (int acceleration : accelerations) {
+		if (!encoder.allocate(acceleration)) {
+			ret = 1;
+			break;
+		}
+
+		// compress the same way as the log writer does
+		size_t output_size = 0;
+		size_t position = 0;
+		const hrt_abstime compress_start = hrt_absolute_time();
+
+		while (position < input_size) {
+			position += encoder.append(input + position, input_size - position);
+
+			if (encoder.full() || position == input_size) {
+				output_size += encoder.encodeFrame(output + output_size);
+			}
+		}
+
+		const hrt_abstime compress_time = hrt_elapsed_time(&compress_start);
+
+		const hrt_abstime decompress_start = hrt_absolute_time();
+		const int64_t decompressed_size = decompress(output, output_size, decompressed, input_size);
+		const hrt_abstime decompress_time = hrt_elapsed_time(&decompress_start);
+
+		if (decompressed_size != (int64_t)input_size || memcmp(decompressed, input, input_size) != 0) {
+			PX4_ERR("decompressed data does not match");
+			ret = 1;
+			break;
+		}
+
+		printf("%12i   %5.2f   %15.1f   %17.1f\n", acceleration, (double)input_size / output_size,
+		       (double)input_size / (compress_time + 1), (double)input_size / (decompress_time + 1));
+	}
+
+out:
+	free(input);
+	free(output);
+	free(decompressed);
+	return ret;
+}
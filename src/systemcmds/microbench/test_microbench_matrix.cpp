@@ -99,6 +99,9 @@ private:
 	bool time_matrix_quaternion();
 	bool time_matrix_dcm();
 	bool time_matrix_pseduo_inverse();
+	bool time_matrix_multiply();
+	bool time_matrix_transpose();
+	bool time_matrix_inverse();
 
 	void reset();
 
@@ -108,6 +111,14 @@ private:
 	matrix::Matrix<float, 16, 6> A16;
 	matrix::Matrix<float, 6, 16> B16;
 	matrix::Matrix<float, 6, 16> B16_4;
+
+	matrix::SquareMatrix<float, 3> M3;
+	matrix::SquareMatrix<float, 4> M4;
+	matrix::SquareMatrix<float, 6> M6;
+	matrix::SquareMatrix<float, 12> M12;
+	matrix::SquareMatrix<float, 24> M24;
+	matrix::SquareMatrix<float, 24> N24;
+	matrix::SquareMatrix<float, 24> R24;
 };
 
 bool MicroBenchMatrix::run_tests()
@@ -116,6 +127,9 @@ bool MicroBenchMatrix::run_tests()
 	ut_run_test(time_matrix_quaternion);
 	ut_run_test(time_matrix_dcm);
 	ut_run_test(time_matrix_pseduo_inverse);
+	ut_run_test(time_matrix_multiply);
+	ut_run_test(time_matrix_transpose);
+	ut_run_test(time_matrix_inverse);
 
 	return (_tests_failed == 0);
 }
@@ -127,6 +141,42 @@ T random(T min, T max)
 	return min + scale * (max - min);      /* [min, max] */
 }
 
+// scalar reference implementations, matching operator*() and transpose() built with MATRIX_NO_SIMD
+template<typename Type, size_t M, size_t N, size_t P>
+void multiply_scalar(const matrix::Matrix<Type, M, N> &a, const matrix::Matrix<Type, N, P> &b,
+		     matrix::Matrix<Type, M, P> &res)
+{
+	res.setZero();
+
+	for (size_t i = 0; i < M; i++) {
+		for (size_t k = 0; k < P; k++) {
+			for (size_t j = 0; j < N; j++) {
+				res(i, k) += a(i, j) * b(j, k);
+			}
+		}
+	}
+}
+
+template<typename Type, size_t M, size_t N>
+void transpose_scalar(const matrix::Matrix<Type, M, N> &a, matrix::Matrix<Type, N, M> &res)
+{
+	for (size_t i = 0; i < M; i++) {
+		for (size_t j = 0; j < N; j++) {
+			res(j, i) = a(i, j);
+		}
+	}
+}
+
+template<typename Type, size_t M, size_t N>
+void randomize(matrix::Matrix<Type, M, N> &m)
+{
+	for (size_t i = 0; i < M; i++) {
+		for (size_t j = 0; j < N; j++) {
+			m(i, j) = random(Type(-10), Type(10));
+		}
+	}
+}
+
 void MicroBenchMatrix::reset()
 {
 	srand(time(nullptr));
@@ -145,6 +195,22 @@ void MicroBenchMatrix::reset()
 			B16_4(j, i) = random(-10.0, 10.0);
 		}
 	}
+
+	randomize(M3);
+	randomize(M4);
+	randomize(M6);
+	randomize(M12);
+	randomize(M24);
+	randomize(N24);
+
+	// keep the matrices to invert well conditioned
+	for (size_t i = 0; i < 12; i++) {
+		M12(i, i) += 100.f;
+
+		if (i < 6) {
+			M6(i, i) += 100.f;
+		}
+	}
 }
 
 bool MicroBenchMatrix::time_matrix_euler()
@@ -175,6 +241,48 @@ bool MicroBenchMatrix::time_matrix_pseduo_inverse()
 	return true;
 }
 
+bool MicroBenchMatrix::time_matrix_multiply()
+{
+	matrix::SquareMatrix<float, 3> R3;
+	matrix::SquareMatrix<float, 4> R4;
+	matrix::Matrix<float, 6, 6> R6;
+
+	PERF("matrix 3x3 * 3x3 (scalar)", multiply_scalar(M3, M3, R3), 100);
+	PERF("matrix 3x3 * 3x3", R3 = M3 * M3, 100);
+	PERF("matrix 4x4 * 4x4 (scalar)", multiply_scalar(M4, M4, R4), 100);
+	PERF("matrix 4x4 * 4x4", R4 = M4 * M4, 100);
+	PERF("matrix 6x16 * 16x6 (scalar)", multiply_scalar(B16, A16, R6), 100);
+	PERF("matrix 6x16 * 16x6", R6 = B16 * A16, 100);
+	PERF("matrix 24x24 * 24x24 (scalar)", multiply_scalar(M24, N24, R24), 100);
+	PERF("matrix 24x24 * 24x24", R24 = M24 * N24, 100);
+	return true;
+}
+
+bool MicroBenchMatrix::time_matrix_transpose()
+{
+	matrix::SquareMatrix<float, 4> R4;
+	matrix::Matrix<float, 16, 6> R16;
+
+	PERF("matrix 4x4 transpose (scalar)", transpose_scalar(M4, R4), 100);
+	PERF("matrix 4x4 transpose", R4 = M4.transpose(), 100);
+	PERF("matrix 6x16 transpose (scalar)", transpose_scalar(B16, R16), 100);
+	PERF("matrix 6x16 transpose", R16 = B16.transpose(), 100);
+	PERF("matrix 24x24 transpose (scalar)", transpose_scalar(M24, R24), 100);
+	PERF("matrix 24x24 transpose", R24 = M24.transpose(), 100);
+	return true;
+}
+
+bool MicroBenchMatrix::time_matrix_inverse()
+{
+	// no scalar reference, compare against a build with MATRIX_NO_SIMD defined
+	matrix::SquareMatrix<float, 6> R6;
+	matrix::SquareMatrix<float, 12> R12;
+
+	PERF("matrix 6x6 inverse", matrix::inv(M6, R6), 100);
+	PERF("matrix 12x12 inverse", matrix::inv(M12, R12), 100);
+	return true;
+}
+
 ut_declare_test_c(test_microbench_matrix, MicroBenchMatrix)
 
 } // namespace MicroBenchMatrix
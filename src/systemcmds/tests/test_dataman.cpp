@@ -46,6 +46,20 @@
 
 #include "dataman_client/DatamanClient.hpp"
 
+#if defined(__PX4_POSIX)
+#include <crc32.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+
+__BEGIN_DECLS
+__EXPORT int dataman_main(int argc, char *argv[]);
+__END_DECLS
+
+#define DM_MMAP_TEST_PATH PX4_STORAGEDIR "/dataman_mmap_test"
+#define DM_MMAP_TEST_JOURNAL_PATH DM_MMAP_TEST_PATH ".journal"
+#endif
+
 class DatamanTest : public UnitTest
 {
 public:
@@ -94,6 +108,19 @@ private:
 	//This will reset the items but it will not restore the compact key.
 	bool testResetItems();
 
+#if defined(__PX4_POSIX)
+	//Memory mapped backend, restarts dataman with a test file and restores the running instance afterwards
+	bool testMmapBatchedCommit();
+	bool testMmapJournalReplay();
+
+	bool startMmapTest();
+	bool endMmapTest();
+	void stopDataman();
+	bool restartDataman(const char *path, bool mmap);
+	static int findInFile(const char *path, const uint8_t *pattern, size_t length);
+	void fillSignature(uint32_t index);
+#endif
+
 	DatamanClient _dataman_client1{};
 	DatamanClient _dataman_client2{};
 	DatamanClient _dataman_client3{};
@@ -118,6 +145,11 @@ private:
 
 	uint16_t _max_index[DM_KEY_NUM_KEYS] {};
 
+#if defined(__PX4_POSIX)
+	char _original_path[PATH_MAX] {};	///< storage file of the running instance, empty for the RAM backend
+	bool _original_mmap{false};
+#endif
+
 	static constexpr uint32_t OVERFLOW_LENGTH = sizeof(_buffer_write) + 1;
 };
 
@@ -1118,6 +1150,279 @@ DatamanTest::testResetItems()
 	return success;
 }
 
+#if defined(__PX4_POSIX)
+void
+DatamanTest::stopDataman()
+{
+	char name[] = "dataman";
+	char stop[] = "stop";
+	char *argv[] = {name, stop, nullptr};
+	dataman_main(2, argv);
+}
+
+bool
+DatamanTest::restartDataman(const char *path, bool mmap)
+{
+	stopDataman();
+
+	char name[] = "dataman";
+	char start[] = "start";
+	char file[] = "-f";
+	char ram[] = "-r";
+	char use_mmap[] = "-m";
+	char file_path[PATH_MAX];
+	strncpy(file_path, path, sizeof(file_path) - 1);
+	file_path[sizeof(file_path) - 1] = '\0';
+
+	char *argv[6] = {name, start};
+	int argc = 2;
+
+	if (file_path[0] == '\0') {
+		argv[argc++] = ram;
+
+	} else {
+		argv[argc++] = file;
+		argv[argc++] = file_path;
+
+		if (mmap) {
+			argv[argc++] = use_mmap;
+		}
+	}
+
+	argv[argc] = nullptr;
+
+	if (dataman_main(argc, argv) != 0) {
+		PX4_ERR("dataman restart failed");
+		return false;
+	}
+
+	return true;
+}
+
+bool
+DatamanTest::startMmapTest()
+{
+	// the running instance is restored with its own backend and file afterwards
+	if (!dataman_get_start_options(_original_path, sizeof(_original_path), _original_mmap)) {
+		PX4_ERR("dataman not running");
+		return false;
+	}
+
+	unlink(DM_MMAP_TEST_PATH);
+	unlink(DM_MMAP_TEST_JOURNAL_PATH);
+
+	return restartDataman(DM_MMAP_TEST_PATH, true);
+}
+
+bool
+DatamanTest::endMmapTest()
+{
+	const bool success = restartDataman(_original_path, _original_mmap);
+
+	unlink(DM_MMAP_TEST_PATH);
+	unlink(DM_MMAP_TEST_JOURNAL_PATH);
+
+	return success;
+}
+
+int
+DatamanTest::findInFile(const char *path, const uint8_t *pattern, size_t length)
+{
+	int fd = open(path, O_RDONLY);
+
+	if (fd < 0) {
+		return -1;
+	}
+
+	// the mapping is shared, so read() sees what dataman wrote to it
+	uint8_t buffer[1024];
+	int offset = 0;
+	int found = -1;
+	ssize_t len;
+
+	while (found < 0 && (len = pread(fd, buffer, sizeof(buffer), offset)) >= (ssize_t)length) {
+		for (ssize_t i = 0; i + (ssize_t)length <= len; ++i) {
+			if (memcmp(&buffer[i], pattern, length) == 0) {
+				found = offset + i;
+				break;
+			}
+		}
+
+		offset += len - length + 1;
+	}
+
+	close(fd);
+	return found;
+}
+
+void
+DatamanTest::fillSignature(uint32_t index)
+{
+	memset(_buffer_write, 0, sizeof(_buffer_write));
+	snprintf(reinterpret_cast<char *>(_buffer_write), sizeof(_buffer_write), "dm_mmap_test_%02" PRIu32, index);
+}
+
+bool
+DatamanTest::testMmapBatchedCommit()
+{
+	if (!startMmapTest()) {
+		return false;
+	}
+
+	bool success = true;
+	static constexpr uint32_t num_items = 5;
+	const dm_item_t item = DM_KEY_WAYPOINTS_OFFBOARD_0;
+
+	for (uint32_t index = 0; index < num_items && success; ++index) {
+		fillSignature(index);
+		success = _dataman_client1.writeSync(item, index, _buffer_write, sizeof(_buffer_write));
+	}
+
+	if (!success) {
+		PX4_ERR("writeSync failed");
+	}
+
+	// the writes are collected in the journal, the data file is not written yet
+	for (uint32_t index = 0; index < num_items && success; ++index) {
+		fillSignature(index);
+
+		if (findInFile(DM_MMAP_TEST_PATH, _buffer_write, 16) >= 0) {
+			PX4_ERR("item %" PRIu32 " committed too early", index);
+			success = false;
+		}
+	}
+
+	// uncommitted items are read back from the journal
+	for (uint32_t index = 0; index < num_items && success; ++index) {
+		fillSignature(index);
+		success = _dataman_client1.readSync(item, index, _buffer_read, sizeof(_buffer_read))
+			  && (memcmp(_buffer_read, _buffer_write, sizeof(_buffer_write)) == 0);
+
+		if (!success) {
+			PX4_ERR("wrong uncommitted data at index %" PRIu32, index);
+		}
+	}
+
+	// an open upload is not committed while waiting for more items
+	px4_usleep(500_ms);
+
+	for (uint32_t index = 0; index < num_items && success; ++index) {
+		fillSignature(index);
+
+		if (findInFile(DM_MMAP_TEST_PATH, _buffer_write, 16) >= 0) {
+			PX4_ERR("item %" PRIu32 " committed before the state write", index);
+			success = false;
+		}
+	}
+
+	// writing the mission state completes the upload and commits the transaction
+	mission_s mission{};
+	mission.timestamp = hrt_absolute_time();
+	mission.mission_dataman_id = item;
+	mission.count = num_items;
+
+	if (success && !_dataman_client1.writeSync(DM_KEY_MISSION_STATE, 0, reinterpret_cast<uint8_t *>(&mission),
+			sizeof(mission_s))) {
+		PX4_ERR("mission state write failed");
+		success = false;
+	}
+
+	for (uint32_t index = 0; index < num_items && success; ++index) {
+		fillSignature(index);
+
+		if (findInFile(DM_MMAP_TEST_PATH, _buffer_write, 16) < 0) {
+			PX4_ERR("item %" PRIu32 " not committed", index);
+			success = false;
+		}
+	}
+
+	return endMmapTest() && success;
+}
+
+bool
+DatamanTest::testMmapJournalReplay()
+{
+	if (!startMmapTest()) {
+		return false;
+	}
+
+	const dm_item_t item = DM_KEY_WAYPOINTS_OFFBOARD_0;
+
+	// a committed item tells where the item is stored in the data file
+	fillSignature(0);
+	bool success = _dataman_client1.writeSync(item, 0, _buffer_write, sizeof(_buffer_write));
+
+	// stopping commits everything that is left
+	stopDataman();
+
+	const int data_offset = findInFile(DM_MMAP_TEST_PATH, _buffer_write, 16);
+
+	if (!success || data_offset < 0) {
+		PX4_ERR("initial write failed");
+		endMmapTest();
+		return false;
+	}
+
+	// Leave a transaction in the journal that was committed but not applied to the data file,
+	// as if dataman was interrupted. Layout: header, record, item (4 byte length header + data).
+	struct {
+		uint32_t magic;
+		uint32_t sequence;
+		uint32_t length;
+		uint32_t crc;
+	} header{};
+
+	struct {
+		uint32_t offset;
+		uint16_t length;
+		uint8_t item;
+		uint8_t reserved;
+	} record{};
+
+	static constexpr uint32_t item_header_size = 4;
+	uint8_t records[(sizeof(record) + item_header_size + DM_MAX_DATA_SIZE + 3) & ~3u] {};
+
+	fillSignature(1);
+	record.offset = data_offset - item_header_size;
+	record.length = item_header_size + DM_MAX_DATA_SIZE;
+	record.item = item;
+	memcpy(records, &record, sizeof(record));
+	records[sizeof(record)] = DM_MAX_DATA_SIZE;
+	memcpy(&records[sizeof(record) + item_header_size], _buffer_write, DM_MAX_DATA_SIZE);
+
+	header.magic = 0x4a4d4450;
+	header.sequence = 1000;
+	header.length = sizeof(records);
+	header.crc = crc32part(records, header.length, 0);
+
+	int fd = open(DM_MMAP_TEST_JOURNAL_PATH, O_WRONLY);
+	success = (fd >= 0)
+		  && (pwrite(fd, &header, sizeof(header), 0) == sizeof(header))
+		  && (pwrite(fd, records, sizeof(records), sizeof(header)) == sizeof(records));
+
+	if (fd >= 0) {
+		close(fd);
+	}
+
+	if (!success) {
+		PX4_ERR("failed to write the journal");
+		endMmapTest();
+		return false;
+	}
+
+	// the journal is replayed on startup
+	success = restartDataman(DM_MMAP_TEST_PATH, true)
+		  && _dataman_client1.readSync(item, 0, _buffer_read, sizeof(_buffer_read))
+		  && (memcmp(_buffer_read, _buffer_write, sizeof(_buffer_write)) == 0);
+
+	if (!success) {
+		PX4_ERR("journal not replayed");
+	}
+
+	return endMmapTest() && success;
+}
+#endif
+
 bool DatamanTest::run_tests()
 {
 	ut_run_test(testSyncReadInvalidItem);
@@ -1144,6 +1449,11 @@ bool DatamanTest::run_tests()
 
 	ut_run_test(testResetItems);
 
+#if defined(__PX4_POSIX)
+	ut_run_test(testMmapBatchedCommit);
+	ut_run_test(testMmapJournalReplay);
+#endif
+
 	return (_tests_failed == 0);
 }
 
@@ -34,17 +34,133 @@
 #include <px4_platform_common/px4_config.h>
 #include <px4_platform_common/module.h>
 #include <px4_platform_common/getopt.h>
+#include <px4_platform_common/log.h>
 #include <px4_platform_common/px4_work_queue/WorkQueueManager.hpp>
 
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
 static void	usage();
 
 extern "C" {
 	__EXPORT int work_queue_main(int argc, char *argv[]);
 }
 
+// parse a CPU list (eg "4-6" or "1,3") into a CPU mask
+static uint32_t
+parse_cpu_list(const char *list)
+{
+	uint32_t cpu_mask = 0;
+
+	while (*list) {
+		char *end = nullptr;
+		const long first = strtol(list, &end, 10);
+		long last = first;
+
+		if (end == list) {
+			return 0;
+		}
+
+		if (*end == '-') {
+			list = end + 1;
+			last = strtol(list, &end, 10);
+
+			if (end == list) {
+				return 0;
+			}
+		}
+
+		if ((first < 0) || (last < first) || (last > 31)) {
+			return 0;
+		}
+
+		for (long cpu = first; cpu <= last; cpu++) {
+			cpu_mask |= 1u << cpu;
+		}
+
+		if ((*end != ',') && (*end != '\0')) {
+			return 0;
+		}
+
+		list = (*end == ',') ? end + 1 : end;
+	}
+
+	return cpu_mask;
+}
+
+static int
+work_queue_sched(int argc, char *argv[])
+{
+	int myoptind = 1;
+	int ch;
+	const char *myoptarg = nullptr;
+
+	uint32_t cpu_mask = 0;
+	int relative_priority = px4::WQ_PRIORITY_UNCHANGED;
+
+	while ((ch = px4_getopt(argc, argv, "c:p:", &myoptind, &myoptarg)) != EOF) {
+		switch (ch) {
+		case 'c':
+			cpu_mask = parse_cpu_list(myoptarg);
+
+			if (cpu_mask == 0) {
+				PX4_ERR("invalid CPU list %s", myoptarg);
+				return 1;
+			}
+
+			break;
+
+		case 'p':
+			relative_priority = strtol(myoptarg, nullptr, 10);
+
+			// the result has to be a valid SCHED_FIFO priority (Linux: 1-99) and fit into int8_t
+			if ((relative_priority > 0) || (relative_priority < INT8_MIN)
+			    || (relative_priority < sched_get_priority_min(SCHED_FIFO) - sched_get_priority_max(SCHED_FIFO))) {
+				PX4_ERR("invalid relative priority %s", myoptarg);
+				return 1;
+			}
+
+			break;
+
+		default:
+			usage();
+			return 1;
+		}
+	}
+
+	if ((myoptind >= argc) || (cpu_mask == 0 && relative_priority == px4::WQ_PRIORITY_UNCHANGED)) {
+		usage();
+		return 1;
+	}
+
+	// accept the work queue name with or without the "wq:" prefix
+	char name[32];
+	const char *wq_name = argv[myoptind];
+
+	if (strncmp(wq_name, "wq:", 3) == 0) {
+		snprintf(name, sizeof(name), "%s", wq_name);
+
+	} else {
+		snprintf(name, sizeof(name), "wq:%s", wq_name);
+	}
+
+	return (px4::WorkQueueSetSchedPolicy(name, cpu_mask, relative_priority) == PX4_OK) ? 0 : 1;
+}
+
 int
 work_queue_main(int argc, char *argv[])
 {
+	if (argc >= 2 && !strcmp(argv[1], "sched")) {
+		return work_queue_sched(argc - 1, argv + 1);
+	}
+
+	if (argc == 3 && !strcmp(argv[1], "status") && !strcmp(argv[2], "-h")) {
+		px4::WorkQueueManagerStatus(true);
+		return 0;
+	}
+
 	if (argc != 2) {
 		usage();
 		return 1;
@@ -78,9 +194,30 @@ usage()
 
 Command-line tool to show work queue status.
 
+On Linux the status also shows the priority, CPU affinity, context switches (voluntary/involuntary),
+CPU migrations and scheduling latency (signal to wake-up) of each work queue thread.
+
+The CPU affinity and SCHED_FIFO priority of a work queue can be changed with the `sched` command,
+either at runtime or from the startup script before the work queue is created.
+Boards can provide defaults with BOARD_WQ_SCHED_POLICIES.
+
+`status -h` adds the scheduling latency (from ScheduleNow() or a timer until Run() starts) and run time
+of each work item, as percentiles, maximum and log2 histogram buckets (<lower bound us>:<count>).
+The same statistics are published by load_mon as work_item_stats.
+
+### Examples
+Pin the rate controller work queue to CPUs 6 and 7:
+$ work_queue sched rate_ctrl -c 6-7
+
 )DESCR_STR");
 
 	PRINT_MODULE_USAGE_NAME("work_queue", "system");
 	PRINT_MODULE_USAGE_COMMAND("start");
-	PRINT_MODULE_USAGE_DEFAULT_COMMANDS();
+	PRINT_MODULE_USAGE_COMMAND_DESCR("sched", "Set the scheduling policy of a work queue (Linux only)");
+	PRINT_MODULE_USAGE_ARG("<name>", "Work queue name (eg rate_ctrl)", false);
+	PRINT_MODULE_USAGE_PARAM_STRING('c', nullptr, "<cpus>", "CPU list (eg 4-6 or 1,3)", true);
+	PRINT_MODULE_USAGE_PARAM_INT('p', 0, -98, 0, "Priority relative to max", true);
+	PRINT_MODULE_USAGE_COMMAND("stop");
+	PRINT_MODULE_USAGE_COMMAND_DESCR("status", "print status info");
+	PRINT_MODULE_USAGE_PARAM_FLAG('h', "Also print latency and run time histograms of each work item", true);
 }